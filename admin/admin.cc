@@ -29,6 +29,7 @@
 
 // STL
 #include <sstream>
+#include <string>
 
 // e
 #include <e/endian.h>
@@ -37,6 +38,7 @@
 #include <busybee_constants.h>
 
 // HyperDex
+#include <hyperdex/client.h>
 #include <hyperdex/hyperspace_builder.h>
 #include "visibility.h"
 #include "common/macros.h"
@@ -377,6 +379,47 @@ admin :: add_index(const char* space, const char* attr,
     }
 }
 
+int64_t
+admin :: add_partial_index(const char* space, const char* attr,
+                           const hyperdex_client_attribute_check* checks,
+                           size_t checks_sz,
+                           hyperdex_admin_returncode* status)
+{
+    if (!maintain_coord_connection(status))
+    {
+        return -1;
+    }
+
+    // the coordinator resolves the attribute names against the schema
+    std::string buf(space, strlen(space) + 1);
+    buf.append(attr, strlen(attr) + 1);
+
+    for (size_t i = 0; i < checks_sz; ++i)
+    {
+        e::packer(&buf) << e::slice(checks[i].attr, strlen(checks[i].attr))
+                        << e::slice(checks[i].value, checks[i].value_sz)
+                        << checks[i].datatype
+                        << checks[i].predicate;
+    }
+
+    int64_t id = m_next_admin_id;
+    ++m_next_admin_id;
+    e::intrusive_ptr<coord_rpc> op = new coord_rpc_generic(id, status, "add_index");
+    int64_t cid = rpc("index_add", buf.data(), buf.size(),
+                      &op->repl_status, &op->repl_output, &op->repl_output_sz);
+
+    if (cid >= 0)
+    {
+        m_coord_ops[cid] = op;
+        return op->admin_visible_id();
+    }
+    else
+    {
+        interpret_replicant_returncode(op->repl_status, status, &m_last_error);
+        return -1;
+    }
+}
+
 int64_t
 admin :: rm_index(uint64_t idxid,
                   enum hyperdex_admin_returncode* status)
@@ -78,6 +78,10 @@ class admin
                          enum hyperdex_admin_returncode* status);
         int64_t add_index(const char* space, const char* attr,
                           enum hyperdex_admin_returncode* status);
+        int64_t add_partial_index(const char* space, const char* attr,
+                                  const hyperdex_client_attribute_check* checks,
+                                  size_t checks_sz,
+                                  enum hyperdex_admin_returncode* status);
         int64_t list_indices(const char* space, enum hyperdex_admin_returncode* status,
                             const char** spaces);
         int64_t rm_index(uint64_t idxid,
@@ -337,6 +337,20 @@ hyperdex_admin_disable_perf_counters(struct hyperdex_admin* _adm)
     return adm->disable_perf_counters();
 }
 
+HYPERDEX_API int64_t
+hyperdex_admin_add_partial_index(struct hyperdex_admin* _adm,
+                                 const char* space,
+                                 const char* attribute,
+                                 const struct hyperdex_client_attribute_check* checks,
+                                 size_t checks_sz,
+                                 enum hyperdex_admin_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    hyperdex::admin* adm = reinterpret_cast<hyperdex::admin*>(_adm);
+    return adm->add_partial_index(space, attribute, checks, checks_sz, status);
+    );
+}
+
 HYPERDEX_API int64_t
 hyperdex_admin_loop(struct hyperdex_admin* _adm, int timeout,
                     enum hyperdex_admin_returncode* status)
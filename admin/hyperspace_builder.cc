@@ -106,6 +106,9 @@ class hyperspace
         uint64_t fault_tolerance;
         uint64_t partitions;
         bool authorization;
+        bool parallel_subspaces;
+        const char* ttl_attr;
+        uint64_t ttl;
 
     private:
         hyperspace(const hyperspace&);
@@ -124,6 +127,9 @@ hyperspace :: hyperspace()
     , fault_tolerance(1)
     , partitions(64)
     , authorization(false)
+    , parallel_subspaces(false)
+    , ttl_attr(NULL)
+    , ttl(0)
 {
     memset(buffer, 0, 1024);
 }
@@ -495,6 +501,53 @@ hyperspace_use_authorization(struct hyperspace* space)
     return HYPERSPACE_SUCCESS;
 }
 
+HYPERDEX_API enum hyperspace_returncode
+hyperspace_use_parallel_subspaces(struct hyperspace* space)
+{
+    space->parallel_subspaces = true;
+    return HYPERSPACE_SUCCESS;
+}
+
+HYPERDEX_API enum hyperspace_returncode
+hyperspace_set_ttl(struct hyperspace* space, const char* attr, uint64_t seconds)
+{
+    if (seconds < 1)
+    {
+        snprintf(space->buffer, BUFFER_SIZE, "objects must expire after a positive number of seconds, not 0");
+        space->buffer[BUFFER_SIZE - 1] = '\0';
+        space->error = space->buffer;
+        return HYPERSPACE_OUT_OF_BOUNDS;
+    }
+
+    if (attr && strcmp(space->key.name, attr) == 0)
+    {
+        snprintf(space->buffer, BUFFER_SIZE, "cannot expire objects by \"%s\" because it is the key", attr);
+        space->buffer[BUFFER_SIZE - 1] = '\0';
+        space->error = space->buffer;
+        return HYPERSPACE_IS_KEY;
+    }
+
+    if (attr && !space->has_attr(attr))
+    {
+        snprintf(space->buffer, BUFFER_SIZE, "cannot expire objects by \"%s\" because there is no attribute by that name", attr);
+        space->buffer[BUFFER_SIZE - 1] = '\0';
+        space->error = space->buffer;
+        return HYPERSPACE_UNKNOWN_ATTR;
+    }
+
+    if (attr && CONTAINER_TYPE(space->attr_type(attr)) != HYPERDATATYPE_TIMESTAMP_GENERIC)
+    {
+        snprintf(space->buffer, BUFFER_SIZE, "cannot expire objects by \"%s\" because it is not a timestamp", attr);
+        space->buffer[BUFFER_SIZE - 1] = '\0';
+        space->error = space->buffer;
+        return HYPERSPACE_INVALID_TYPE;
+    }
+
+    space->ttl_attr = attr ? space->internalize(attr) : NULL;
+    space->ttl = seconds;
+    return HYPERSPACE_SUCCESS;
+}
+
 char*
 hyperspace_buffer(hyperspace* space)
 {
@@ -532,9 +585,22 @@ hyperdex :: space_to_space(hyperspace* in, hyperdex::space* out)
         attrs.push_back(hyperdex::attribute(HYPERDEX_ATTRIBUTE_SECRET, HYPERDATATYPE_MACAROON_SECRET));
     }
 
+    if (in->ttl > 0 && !in->ttl_attr)
+    {
+        attrs.push_back(hyperdex::attribute(HYPERDEX_ATTRIBUTE_WRITTEN, HYPERDATATYPE_TIMESTAMP_SECOND));
+    }
+
     schema sc;
     sc.attrs_sz = attrs.size();
     sc.attrs = &attrs.front();
+
+    if (in->ttl > 0)
+    {
+        sc.ttl_attr = sc.lookup_attr(in->ttl_attr ? in->ttl_attr : HYPERDEX_ATTRIBUTE_WRITTEN);
+        sc.ttl = in->ttl * 1000000;
+        sc.ttl_on_write = !in->ttl_attr;
+    }
+
     space sp(in->name, sc);
     sp.subspaces.push_back(subspace());
     sp.subspaces.back().attrs.push_back(0);
@@ -557,6 +623,7 @@ hyperdex :: space_to_space(hyperspace* in, hyperdex::space* out)
     }
 
     sp.fault_tolerance = in->fault_tolerance;
+    sp.replication = in->parallel_subspaces ? space::PARALLEL : space::SERIAL;
 
     if (!sp.validate())
     {
@@ -75,6 +75,9 @@ yyerror(YYLTYPE* yylloc, struct hyperspace* space, void* scanner, const char* ms
 %token INDEX
 %token WITH
 %token AUTHORIZATION
+%token PARALLEL
+%token EXPIRE
+%token AFTER
 
 %token <str> IDENTIFIER
 %token <num> NUMBER
@@ -89,9 +92,13 @@ yyerror(YYLTYPE* yylloc, struct hyperspace* space, void* scanner, const char* ms
 %token INT64
 %token FLOAT
 %token DOCUMENT
+%token HYPERLOGLOG
+%token COUNTMIN
 %token LIST
 %token SET
 %token MAP
+%token VECTOR
+%token BITMAP
 
 %type <type> type
 %type <attr> attribute
@@ -144,11 +151,16 @@ options :                { }
 option : TOLERATE NUMBER FAILURES { hyperspace_set_fault_tolerance(space, $2); }
        | CREATE NUMBER PARTITIONS { hyperspace_set_number_of_partitions(space, $2); }
        | WITH AUTHORIZATION { hyperspace_use_authorization(space); }
+       | WITH PARALLEL SUBSPACE { hyperspace_use_parallel_subspaces(space); }
+       | EXPIRE IDENTIFIER AFTER NUMBER SECOND { hyperspace_set_ttl(space, $2, $4); free($2); }
+       | EXPIRE AFTER NUMBER SECOND { hyperspace_set_ttl(space, NULL, $3); }
 
 type : STRING                        { $$ = HYPERDATATYPE_STRING; }
      | INT64                         { $$ = HYPERDATATYPE_INT64; }
      | FLOAT                         { $$ = HYPERDATATYPE_FLOAT; }
      | DOCUMENT                      { $$ = HYPERDATATYPE_DOCUMENT; }
+     | HYPERLOGLOG                   { $$ = HYPERDATATYPE_HYPERLOGLOG; }
+     | COUNTMIN                      { $$ = HYPERDATATYPE_COUNTMIN; }
      | TIMESTAMP '(' SECOND ')'      { $$ = HYPERDATATYPE_TIMESTAMP_SECOND; }
      | TIMESTAMP '(' MINUTE  ')'     { $$ = HYPERDATATYPE_TIMESTAMP_MINUTE; }
      | TIMESTAMP '(' HOUR  ')'       { $$ = HYPERDATATYPE_TIMESTAMP_HOUR; }
@@ -169,7 +181,9 @@ type : STRING                        { $$ = HYPERDATATYPE_STRING; }
      | MAP '(' INT64 ',' FLOAT ')'   { $$ = HYPERDATATYPE_MAP_INT64_FLOAT; }
      | MAP '(' FLOAT ',' STRING ')'  { $$ = HYPERDATATYPE_MAP_FLOAT_STRING; }
      | MAP '(' FLOAT ',' INT64 ')'   { $$ = HYPERDATATYPE_MAP_FLOAT_INT64; }
-     | MAP '(' FLOAT ',' FLOAT ')'   { $$ = HYPERDATATYPE_MAP_FLOAT_FLOAT; };
+     | MAP '(' FLOAT ',' FLOAT ')'   { $$ = HYPERDATATYPE_MAP_FLOAT_FLOAT; }
+     | VECTOR '(' FLOAT ')'          { $$ = HYPERDATATYPE_VECTOR_FLOAT; }
+     | BITMAP                        { $$ = HYPERDATATYPE_BITMAP_INT64; };
 
 %%
 
@@ -191,6 +191,9 @@ Client = [
     Method('set_union', AsyncCall, (SpaceName, Key, Attributes), (Status,)),
     Method('cond_set_union', AsyncCall, (SpaceName, Key, Predicates, Attributes), (Status,)),
     Method('group_set_union', AsyncCall, (SpaceName, Predicates, Attributes), (Status, Count)),
+    Method('set_difference', AsyncCall, (SpaceName, Key, Attributes), (Status,)),
+    Method('cond_set_difference', AsyncCall, (SpaceName, Key, Predicates, Attributes), (Status,)),
+    Method('group_set_difference', AsyncCall, (SpaceName, Predicates, Attributes), (Status, Count)),
     Method('document_rename', AsyncCall, (SpaceName, Key, Attributes), (Status,)),
     Method('uxact_document_rename', MicrotransactionCall, (Microtransaction, Attributes), ()),
     Method('cond_document_rename', AsyncCall, (SpaceName, Key, Predicates, Attributes), (Status,)),
@@ -199,6 +202,12 @@ Client = [
     Method('uxact_document_unset', MicrotransactionCall, (Microtransaction, Attributes), ()),
     Method('cond_document_unset', AsyncCall, (SpaceName, Key, Predicates, Attributes), (Status,)),
     Method('group_document_unset', AsyncCall, (SpaceName, Predicates, Attributes), (Status, Count)),
+    Method('sketch_add', AsyncCall, (SpaceName, Key, Attributes), (Status,)),
+    Method('cond_sketch_add', AsyncCall, (SpaceName, Key, Predicates, Attributes), (Status,)),
+    Method('group_sketch_add', AsyncCall, (SpaceName, Predicates, Attributes), (Status, Count)),
+    Method('sketch_merge', AsyncCall, (SpaceName, Key, Attributes), (Status,)),
+    Method('cond_sketch_merge', AsyncCall, (SpaceName, Key, Predicates, Attributes), (Status,)),
+    Method('group_sketch_merge', AsyncCall, (SpaceName, Predicates, Attributes), (Status, Count)),
     Method('map_add', AsyncCall, (SpaceName, Key, MapAttributes), (Status,)),
     Method('cond_map_add', AsyncCall, (SpaceName, Key, Predicates, MapAttributes), (Status,)),
     Method('group_map_add', AsyncCall, (SpaceName, Predicates, MapAttributes), (Status, Count)),
@@ -392,6 +392,28 @@ enum hyperdex_client_returncode
 };
 
 #define HYPERDEX_ATTRIBUTE_SECRET "__secret"
+#define HYPERDEX_ATTRIBUTE_WRITTEN "__written"
+
+/* Where the client sends GET and GET_PARTIAL operations */
+enum hyperdex_client_read_policy
+{
+    /* the point leader (head) of the key's chain */
+    HYPERDEX_CLIENT_READ_POINT_LEADER = 0,
+    /* the tail of the key's chain; consistent with the point leader */
+    HYPERDEX_CLIENT_READ_TAIL         = 1,
+    /* any replica in the key's chain; a replica with writes in flight for
+     * the key redirects the read to the tail */
+    HYPERDEX_CLIENT_READ_ANY_REPLICA  = 2
+};
+
+/* How hyperdex_client_nearest_search measures distance between vectors */
+enum hyperdex_client_distance
+{
+    /* euclidean distance */
+    HYPERDEX_CLIENT_DISTANCE_L2     = 0,
+    /* one minus the cosine similarity */
+    HYPERDEX_CLIENT_DISTANCE_COSINE = 1
+};
 
 struct hyperdex_client*
 hyperdex_client_create(const char* coordinator, uint16_t port);
@@ -433,6 +455,33 @@ hyperdex_client_uxact_cond_commit(struct hyperdex_client* _cl,
 '''
 
 CLIENT_HEADER_FOOT = '''
+int64_t
+hyperdex_client_get_many(struct hyperdex_client* client,
+                         const char* space,
+                         const char** keys, const size_t* keys_sz, size_t keys_num,
+                         enum hyperdex_client_returncode* status,
+                         enum hyperdex_client_returncode* statuses,
+                         const struct hyperdex_client_attribute** attrs, size_t* attrs_sz);
+
+int64_t
+hyperdex_client_put_many(struct hyperdex_client* client,
+                         const char* space,
+                         const char** keys, const size_t* keys_sz, size_t keys_num,
+                         const struct hyperdex_client_attribute** attrs, const size_t* attrs_sz,
+                         enum hyperdex_client_returncode* status,
+                         enum hyperdex_client_returncode* statuses);
+
+int64_t
+hyperdex_client_nearest_search(struct hyperdex_client* client,
+                               const char* space,
+                               const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                               const char* attr,
+                               const float* vector, size_t vector_sz,
+                               enum hyperdex_client_distance distance,
+                               uint64_t limit,
+                               enum hyperdex_client_returncode* status,
+                               const struct hyperdex_client_attribute** attrs, size_t* attrs_sz);
+
 int64_t
 hyperdex_client_loop(struct hyperdex_client* client, int timeout,
                      enum hyperdex_client_returncode* status);
@@ -443,6 +492,10 @@ hyperdex_client_poll_fd(struct hyperdex_client* client);
 int
 hyperdex_client_block(struct hyperdex_client* client, int timeout);
 
+void
+hyperdex_client_set_read_policy(struct hyperdex_client* client,
+                                enum hyperdex_client_read_policy policy);
+
 enum hyperdatatype
 hyperdex_client_attribute_type(struct hyperdex_client* client,
                                const char* space, const char* name,
@@ -740,6 +793,50 @@ hyperdex_client_uxact_cond_commit(struct hyperdex_client* _cl,
 '''
 
 CLIENT_WRAPPER_FOOT = '''
+HYPERDEX_API int64_t
+hyperdex_client_get_many(hyperdex_client* _cl,
+                         const char* space,
+                         const char** keys, const size_t* keys_sz, size_t keys_num,
+                         hyperdex_client_returncode* status,
+                         hyperdex_client_returncode* statuses,
+                         const hyperdex_client_attribute** attrs, size_t* attrs_sz)
+{
+    C_WRAP_EXCEPT(
+    return cl->get_many(space, keys, keys_sz, keys_num, status, statuses, attrs, attrs_sz);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_put_many(hyperdex_client* _cl,
+                         const char* space,
+                         const char** keys, const size_t* keys_sz, size_t keys_num,
+                         const hyperdex_client_attribute** attrs, const size_t* attrs_sz,
+                         hyperdex_client_returncode* status,
+                         hyperdex_client_returncode* statuses)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(put), strlen(XSTR(put)));
+    return cl->perform_funcall_many(opinfo, space, keys, keys_sz, keys_num, attrs, attrs_sz, status, statuses);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_nearest_search(hyperdex_client* _cl,
+                               const char* space,
+                               const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                               const char* attr,
+                               const float* vector, size_t vector_sz,
+                               hyperdex_client_distance distance,
+                               uint64_t limit,
+                               hyperdex_client_returncode* status,
+                               const hyperdex_client_attribute** attrs, size_t* attrs_sz)
+{
+    C_WRAP_EXCEPT(
+    return cl->nearest_search(space, checks, checks_sz, attr, vector, vector_sz, distance, limit, status, attrs, attrs_sz);
+    );
+}
+
 HYPERDEX_API int64_t
 hyperdex_client_loop(hyperdex_client* _cl, int timeout,
                      hyperdex_client_returncode* status)
@@ -774,6 +871,14 @@ hyperdex_client_set_type_conversion(hyperdex_client* _cl, bool enabled)
     cl->set_type_conversion(enabled);
 }
 
+HYPERDEX_API void
+hyperdex_client_set_read_policy(hyperdex_client* _cl,
+                                hyperdex_client_read_policy policy)
+{
+    hyperdex::client* cl = reinterpret_cast<hyperdex::client*>(_cl);
+    cl->set_read_policy(policy);
+}
+
 #ifdef __cplusplus
 } // extern "C"
 #endif // __cplusplus
@@ -825,6 +930,19 @@ hyperdex_admin_dump_config(struct hyperdex_admin* admin,
 '''
 
 ADMIN_HEADER_FOOT = '''
+/* An index holding only the objects that pass every check; the checks are
+ * built as for client searches (see hyperdex/client.h) and may only compare
+ * primitive attributes */
+struct hyperdex_client_attribute_check;
+
+int64_t
+hyperdex_admin_add_partial_index(struct hyperdex_admin* admin,
+                                 const char* space,
+                                 const char* attribute,
+                                 const struct hyperdex_client_attribute_check* checks,
+                                 size_t checks_sz,
+                                 enum hyperdex_admin_returncode* status);
+
 int64_t
 hyperdex_admin_loop(struct hyperdex_admin* admin, int timeout,
                     enum hyperdex_admin_returncode* status);
@@ -943,6 +1061,20 @@ hyperdex_admin_dump_config(struct hyperdex_admin* _adm,
 '''
 
 ADMIN_WRAPPER_FOOT = '''
+HYPERDEX_API int64_t
+hyperdex_admin_add_partial_index(struct hyperdex_admin* _adm,
+                                 const char* space,
+                                 const char* attribute,
+                                 const struct hyperdex_client_attribute_check* checks,
+                                 size_t checks_sz,
+                                 enum hyperdex_admin_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    hyperdex::admin* adm = reinterpret_cast<hyperdex::admin*>(_adm);
+    return adm->add_partial_index(space, attribute, checks, checks_sz, status);
+    );
+}
+
 HYPERDEX_API int64_t
 hyperdex_admin_loop(struct hyperdex_admin* _adm, int timeout,
                     enum hyperdex_admin_returncode* status)
@@ -130,6 +130,29 @@ class Client
 
 CLIENT_HEADER_FOOT = '''
 
+    public:
+        int64_t get_many(const char* space,
+                         const char** keys, const size_t* keys_sz, size_t keys_num,
+                         hyperdex_client_returncode* status,
+                         hyperdex_client_returncode* statuses,
+                         const hyperdex_client_attribute** attrs, size_t* attrs_sz)
+            { return hyperdex_client_get_many(m_cl, space, keys, keys_sz, keys_num, status, statuses, attrs, attrs_sz); }
+        int64_t put_many(const char* space,
+                         const char** keys, const size_t* keys_sz, size_t keys_num,
+                         const hyperdex_client_attribute** attrs, const size_t* attrs_sz,
+                         hyperdex_client_returncode* status,
+                         hyperdex_client_returncode* statuses)
+            { return hyperdex_client_put_many(m_cl, space, keys, keys_sz, keys_num, attrs, attrs_sz, status, statuses); }
+        int64_t nearest_search(const char* space,
+                               const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                               const char* attr,
+                               const float* vector, size_t vector_sz,
+                               hyperdex_client_distance distance,
+                               uint64_t limit,
+                               hyperdex_client_returncode* status,
+                               const hyperdex_client_attribute** attrs, size_t* attrs_sz)
+            { return hyperdex_client_nearest_search(m_cl, space, checks, checks_sz, attr, vector, vector_sz, distance, limit, status, attrs, attrs_sz); }
+
     public:
         void clear_auth_context()
             { return hyperdex_client_clear_auth_context(m_cl); }
@@ -143,6 +166,8 @@ CLIENT_HEADER_FOOT = '''
             { return hyperdex_client_poll_fd(m_cl); }
         int block(int timeout)
             { return hyperdex_client_block(m_cl, timeout); }
+        void set_read_policy(hyperdex_client_read_policy policy)
+            { hyperdex_client_set_read_policy(m_cl, policy); }
         std::string error_message()
             { return hyperdex_client_error_message(m_cl); }
         std::string error_location()
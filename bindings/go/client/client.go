@@ -52,6 +52,7 @@ const (
 	LENGTH_LESS_EQUAL    = C.HYPERPREDICATE_LENGTH_LESS_EQUAL
 	LENGTH_GREATER_EQUAL = C.HYPERPREDICATE_LENGTH_GREATER_EQUAL
 	CONTAINS             = C.HYPERPREDICATE_CONTAINS
+	STARTS_WITH          = C.HYPERPREDICATE_STARTS_WITH
 )
 
 type Status int
@@ -2351,6 +2352,27 @@ func (client *Client) GroupSetUnion(spacename string, predicates []Predicate, at
 	return client.AsynccallSpacenamePredicatesAttributesStatusCount(stub_group_set_union, spacename, predicates, attributes)
 }
 
+func stub_set_difference(client *C.struct_hyperdex_client, space *C.char, key *C.char, key_sz C.size_t, attrs *C.struct_hyperdex_client_attribute, attrs_sz C.size_t, status *C.enum_hyperdex_client_returncode) int64 {
+	return int64(C.hyperdex_client_set_difference(client, space, key, key_sz, attrs, attrs_sz, status))
+}
+func (client *Client) SetDifference(spacename string, key Value, attributes Attributes) (err *Error) {
+	return client.AsynccallSpacenameKeyAttributesStatus(stub_set_difference, spacename, key, attributes)
+}
+
+func stub_cond_set_difference(client *C.struct_hyperdex_client, space *C.char, key *C.char, key_sz C.size_t, checks *C.struct_hyperdex_client_attribute_check, checks_sz C.size_t, attrs *C.struct_hyperdex_client_attribute, attrs_sz C.size_t, status *C.enum_hyperdex_client_returncode) int64 {
+	return int64(C.hyperdex_client_cond_set_difference(client, space, key, key_sz, checks, checks_sz, attrs, attrs_sz, status))
+}
+func (client *Client) CondSetDifference(spacename string, key Value, predicates []Predicate, attributes Attributes) (err *Error) {
+	return client.AsynccallSpacenameKeyPredicatesAttributesStatus(stub_cond_set_difference, spacename, key, predicates, attributes)
+}
+
+func stub_group_set_difference(client *C.struct_hyperdex_client, space *C.char, checks *C.struct_hyperdex_client_attribute_check, checks_sz C.size_t, attrs *C.struct_hyperdex_client_attribute, attrs_sz C.size_t, status *C.enum_hyperdex_client_returncode, count *C.uint64_t) int64 {
+	return int64(C.hyperdex_client_group_set_difference(client, space, checks, checks_sz, attrs, attrs_sz, status, count))
+}
+func (client *Client) GroupSetDifference(spacename string, predicates []Predicate, attributes Attributes) (count uint64, err *Error) {
+	return client.AsynccallSpacenamePredicatesAttributesStatusCount(stub_group_set_difference, spacename, predicates, attributes)
+}
+
 func stub_document_rename(client *C.struct_hyperdex_client, space *C.char, key *C.char, key_sz C.size_t, attrs *C.struct_hyperdex_client_attribute, attrs_sz C.size_t, status *C.enum_hyperdex_client_returncode) int64 {
 	return int64(C.hyperdex_client_document_rename(client, space, key, key_sz, attrs, attrs_sz, status))
 }
@@ -2393,6 +2415,48 @@ func (client *Client) GroupDocumentUnset(spacename string, predicates []Predicat
 	return client.AsynccallSpacenamePredicatesAttributesStatusCount(stub_group_document_unset, spacename, predicates, attributes)
 }
 
+func stub_sketch_add(client *C.struct_hyperdex_client, space *C.char, key *C.char, key_sz C.size_t, attrs *C.struct_hyperdex_client_attribute, attrs_sz C.size_t, status *C.enum_hyperdex_client_returncode) int64 {
+	return int64(C.hyperdex_client_sketch_add(client, space, key, key_sz, attrs, attrs_sz, status))
+}
+func (client *Client) SketchAdd(spacename string, key Value, attributes Attributes) (err *Error) {
+	return client.AsynccallSpacenameKeyAttributesStatus(stub_sketch_add, spacename, key, attributes)
+}
+
+func stub_cond_sketch_add(client *C.struct_hyperdex_client, space *C.char, key *C.char, key_sz C.size_t, checks *C.struct_hyperdex_client_attribute_check, checks_sz C.size_t, attrs *C.struct_hyperdex_client_attribute, attrs_sz C.size_t, status *C.enum_hyperdex_client_returncode) int64 {
+	return int64(C.hyperdex_client_cond_sketch_add(client, space, key, key_sz, checks, checks_sz, attrs, attrs_sz, status))
+}
+func (client *Client) CondSketchAdd(spacename string, key Value, predicates []Predicate, attributes Attributes) (err *Error) {
+	return client.AsynccallSpacenameKeyPredicatesAttributesStatus(stub_cond_sketch_add, spacename, key, predicates, attributes)
+}
+
+func stub_group_sketch_add(client *C.struct_hyperdex_client, space *C.char, checks *C.struct_hyperdex_client_attribute_check, checks_sz C.size_t, attrs *C.struct_hyperdex_client_attribute, attrs_sz C.size_t, status *C.enum_hyperdex_client_returncode, count *C.uint64_t) int64 {
+	return int64(C.hyperdex_client_group_sketch_add(client, space, checks, checks_sz, attrs, attrs_sz, status, count))
+}
+func (client *Client) GroupSketchAdd(spacename string, predicates []Predicate, attributes Attributes) (count uint64, err *Error) {
+	return client.AsynccallSpacenamePredicatesAttributesStatusCount(stub_group_sketch_add, spacename, predicates, attributes)
+}
+
+func stub_sketch_merge(client *C.struct_hyperdex_client, space *C.char, key *C.char, key_sz C.size_t, attrs *C.struct_hyperdex_client_attribute, attrs_sz C.size_t, status *C.enum_hyperdex_client_returncode) int64 {
+	return int64(C.hyperdex_client_sketch_merge(client, space, key, key_sz, attrs, attrs_sz, status))
+}
+func (client *Client) SketchMerge(spacename string, key Value, attributes Attributes) (err *Error) {
+	return client.AsynccallSpacenameKeyAttributesStatus(stub_sketch_merge, spacename, key, attributes)
+}
+
+func stub_cond_sketch_merge(client *C.struct_hyperdex_client, space *C.char, key *C.char, key_sz C.size_t, checks *C.struct_hyperdex_client_attribute_check, checks_sz C.size_t, attrs *C.struct_hyperdex_client_attribute, attrs_sz C.size_t, status *C.enum_hyperdex_client_returncode) int64 {
+	return int64(C.hyperdex_client_cond_sketch_merge(client, space, key, key_sz, checks, checks_sz, attrs, attrs_sz, status))
+}
+func (client *Client) CondSketchMerge(spacename string, key Value, predicates []Predicate, attributes Attributes) (err *Error) {
+	return client.AsynccallSpacenameKeyPredicatesAttributesStatus(stub_cond_sketch_merge, spacename, key, predicates, attributes)
+}
+
+func stub_group_sketch_merge(client *C.struct_hyperdex_client, space *C.char, checks *C.struct_hyperdex_client_attribute_check, checks_sz C.size_t, attrs *C.struct_hyperdex_client_attribute, attrs_sz C.size_t, status *C.enum_hyperdex_client_returncode, count *C.uint64_t) int64 {
+	return int64(C.hyperdex_client_group_sketch_merge(client, space, checks, checks_sz, attrs, attrs_sz, status, count))
+}
+func (client *Client) GroupSketchMerge(spacename string, predicates []Predicate, attributes Attributes) (count uint64, err *Error) {
+	return client.AsynccallSpacenamePredicatesAttributesStatusCount(stub_group_sketch_merge, spacename, predicates, attributes)
+}
+
 func stub_map_add(client *C.struct_hyperdex_client, space *C.char, key *C.char, key_sz C.size_t, mapattrs *C.struct_hyperdex_client_map_attribute, mapattrs_sz C.size_t, status *C.enum_hyperdex_client_returncode) int64 {
 	return int64(C.hyperdex_client_map_add(client, space, key, key_sz, mapattrs, mapattrs_sz, status))
 }
@@ -528,6 +528,24 @@ public class Client
         return (Long) async_group_set_union(spacename, predicates, attributes).waitForIt();
     }
 
+    public native Deferred async_set_difference(String spacename, Object key, Map<String, Object> attributes) throws HyperDexClientException;
+    public Boolean set_difference(String spacename, Object key, Map<String, Object> attributes) throws HyperDexClientException
+    {
+        return (Boolean) async_set_difference(spacename, key, attributes).waitForIt();
+    }
+
+    public native Deferred async_cond_set_difference(String spacename, Object key, Map<String, Object> predicates, Map<String, Object> attributes) throws HyperDexClientException;
+    public Boolean cond_set_difference(String spacename, Object key, Map<String, Object> predicates, Map<String, Object> attributes) throws HyperDexClientException
+    {
+        return (Boolean) async_cond_set_difference(spacename, key, predicates, attributes).waitForIt();
+    }
+
+    public native Deferred async_group_set_difference(String spacename, Map<String, Object> predicates, Map<String, Object> attributes) throws HyperDexClientException;
+    public Long group_set_difference(String spacename, Map<String, Object> predicates, Map<String, Object> attributes) throws HyperDexClientException
+    {
+        return (Long) async_group_set_difference(spacename, predicates, attributes).waitForIt();
+    }
+
     public native Deferred async_document_rename(String spacename, Object key, Map<String, Object> attributes) throws HyperDexClientException;
     public Boolean document_rename(String spacename, Object key, Map<String, Object> attributes) throws HyperDexClientException
     {
@@ -564,6 +582,42 @@ public class Client
         return (Long) async_group_document_unset(spacename, predicates, attributes).waitForIt();
     }
 
+    public native Deferred async_sketch_add(String spacename, Object key, Map<String, Object> attributes) throws HyperDexClientException;
+    public Boolean sketch_add(String spacename, Object key, Map<String, Object> attributes) throws HyperDexClientException
+    {
+        return (Boolean) async_sketch_add(spacename, key, attributes).waitForIt();
+    }
+
+    public native Deferred async_cond_sketch_add(String spacename, Object key, Map<String, Object> predicates, Map<String, Object> attributes) throws HyperDexClientException;
+    public Boolean cond_sketch_add(String spacename, Object key, Map<String, Object> predicates, Map<String, Object> attributes) throws HyperDexClientException
+    {
+        return (Boolean) async_cond_sketch_add(spacename, key, predicates, attributes).waitForIt();
+    }
+
+    public native Deferred async_group_sketch_add(String spacename, Map<String, Object> predicates, Map<String, Object> attributes) throws HyperDexClientException;
+    public Long group_sketch_add(String spacename, Map<String, Object> predicates, Map<String, Object> attributes) throws HyperDexClientException
+    {
+        return (Long) async_group_sketch_add(spacename, predicates, attributes).waitForIt();
+    }
+
+    public native Deferred async_sketch_merge(String spacename, Object key, Map<String, Object> attributes) throws HyperDexClientException;
+    public Boolean sketch_merge(String spacename, Object key, Map<String, Object> attributes) throws HyperDexClientException
+    {
+        return (Boolean) async_sketch_merge(spacename, key, attributes).waitForIt();
+    }
+
+    public native Deferred async_cond_sketch_merge(String spacename, Object key, Map<String, Object> predicates, Map<String, Object> attributes) throws HyperDexClientException;
+    public Boolean cond_sketch_merge(String spacename, Object key, Map<String, Object> predicates, Map<String, Object> attributes) throws HyperDexClientException
+    {
+        return (Boolean) async_cond_sketch_merge(spacename, key, predicates, attributes).waitForIt();
+    }
+
+    public native Deferred async_group_sketch_merge(String spacename, Map<String, Object> predicates, Map<String, Object> attributes) throws HyperDexClientException;
+    public Long group_sketch_merge(String spacename, Map<String, Object> predicates, Map<String, Object> attributes) throws HyperDexClientException
+    {
+        return (Long) async_group_sketch_merge(spacename, predicates, attributes).waitForIt();
+    }
+
     public native Deferred async_map_add(String spacename, Object key, Map<String, Map<Object, Object>> mapattributes) throws HyperDexClientException;
     public Boolean map_add(String spacename, Object key, Map<String, Map<Object, Object>> mapattributes) throws HyperDexClientException
     {
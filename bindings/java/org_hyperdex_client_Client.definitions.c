@@ -973,6 +973,24 @@ Java_org_hyperdex_client_Client_async_1group_1set_1union(JNIEnv* env, jobject ob
     return hyperdex_java_client_asynccall__spacename_predicates_attributes__status_count(env, obj, hyperdex_client_group_set_union, spacename, predicates, attributes);
 }
 
+JNIEXPORT HYPERDEX_API jobject JNICALL
+Java_org_hyperdex_client_Client_async_1set_1difference(JNIEnv* env, jobject obj, jstring spacename, jobject key, jobject attributes)
+{
+    return hyperdex_java_client_asynccall__spacename_key_attributes__status(env, obj, hyperdex_client_set_difference, spacename, key, attributes);
+}
+
+JNIEXPORT HYPERDEX_API jobject JNICALL
+Java_org_hyperdex_client_Client_async_1cond_1set_1difference(JNIEnv* env, jobject obj, jstring spacename, jobject key, jobject predicates, jobject attributes)
+{
+    return hyperdex_java_client_asynccall__spacename_key_predicates_attributes__status(env, obj, hyperdex_client_cond_set_difference, spacename, key, predicates, attributes);
+}
+
+JNIEXPORT HYPERDEX_API jobject JNICALL
+Java_org_hyperdex_client_Client_async_1group_1set_1difference(JNIEnv* env, jobject obj, jstring spacename, jobject predicates, jobject attributes)
+{
+    return hyperdex_java_client_asynccall__spacename_predicates_attributes__status_count(env, obj, hyperdex_client_group_set_difference, spacename, predicates, attributes);
+}
+
 JNIEXPORT HYPERDEX_API jobject JNICALL
 Java_org_hyperdex_client_Client_async_1document_1rename(JNIEnv* env, jobject obj, jstring spacename, jobject key, jobject attributes)
 {
@@ -1009,6 +1027,42 @@ Java_org_hyperdex_client_Client_async_1group_1document_1unset(JNIEnv* env, jobje
     return hyperdex_java_client_asynccall__spacename_predicates_attributes__status_count(env, obj, hyperdex_client_group_document_unset, spacename, predicates, attributes);
 }
 
+JNIEXPORT HYPERDEX_API jobject JNICALL
+Java_org_hyperdex_client_Client_async_1sketch_1add(JNIEnv* env, jobject obj, jstring spacename, jobject key, jobject attributes)
+{
+    return hyperdex_java_client_asynccall__spacename_key_attributes__status(env, obj, hyperdex_client_sketch_add, spacename, key, attributes);
+}
+
+JNIEXPORT HYPERDEX_API jobject JNICALL
+Java_org_hyperdex_client_Client_async_1cond_1sketch_1add(JNIEnv* env, jobject obj, jstring spacename, jobject key, jobject predicates, jobject attributes)
+{
+    return hyperdex_java_client_asynccall__spacename_key_predicates_attributes__status(env, obj, hyperdex_client_cond_sketch_add, spacename, key, predicates, attributes);
+}
+
+JNIEXPORT HYPERDEX_API jobject JNICALL
+Java_org_hyperdex_client_Client_async_1group_1sketch_1add(JNIEnv* env, jobject obj, jstring spacename, jobject predicates, jobject attributes)
+{
+    return hyperdex_java_client_asynccall__spacename_predicates_attributes__status_count(env, obj, hyperdex_client_group_sketch_add, spacename, predicates, attributes);
+}
+
+JNIEXPORT HYPERDEX_API jobject JNICALL
+Java_org_hyperdex_client_Client_async_1sketch_1merge(JNIEnv* env, jobject obj, jstring spacename, jobject key, jobject attributes)
+{
+    return hyperdex_java_client_asynccall__spacename_key_attributes__status(env, obj, hyperdex_client_sketch_merge, spacename, key, attributes);
+}
+
+JNIEXPORT HYPERDEX_API jobject JNICALL
+Java_org_hyperdex_client_Client_async_1cond_1sketch_1merge(JNIEnv* env, jobject obj, jstring spacename, jobject key, jobject predicates, jobject attributes)
+{
+    return hyperdex_java_client_asynccall__spacename_key_predicates_attributes__status(env, obj, hyperdex_client_cond_sketch_merge, spacename, key, predicates, attributes);
+}
+
+JNIEXPORT HYPERDEX_API jobject JNICALL
+Java_org_hyperdex_client_Client_async_1group_1sketch_1merge(JNIEnv* env, jobject obj, jstring spacename, jobject predicates, jobject attributes)
+{
+    return hyperdex_java_client_asynccall__spacename_predicates_attributes__status_count(env, obj, hyperdex_client_group_sketch_merge, spacename, predicates, attributes);
+}
+
 JNIEXPORT HYPERDEX_API jobject JNICALL
 Java_org_hyperdex_client_Client_async_1map_1add(JNIEnv* env, jobject obj, jstring spacename, jobject key, jobject mapattributes)
 {
@@ -88,6 +88,7 @@ class HyperDexClient : public node::ObjectWrap
         static v8::Handle<v8::Value> LengthLessEqual(const v8::Arguments& args);
         static v8::Handle<v8::Value> LengthGreaterEqual(const v8::Arguments& args);
         static v8::Handle<v8::Value> Contains(const v8::Arguments& args);
+        static v8::Handle<v8::Value> StartsWith(const v8::Arguments& args);
 
 #include "client.declarations.cc"
 
@@ -369,6 +370,7 @@ HyperDexClient :: Init(v8::Handle<v8::Object> target)
     NODE_SET_PROTOTYPE_METHOD(tpl, "LengthLessEqual", HyperDexClient::LengthLessEqual);
     NODE_SET_PROTOTYPE_METHOD(tpl, "LengthGreaterEqual", HyperDexClient::LengthGreaterEqual);
     NODE_SET_PROTOTYPE_METHOD(tpl, "Contains", HyperDexClient::Contains);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "StartsWith", HyperDexClient::StartsWith);
 
     NODE_SET_PROTOTYPE_METHOD(tpl, "loop", HyperDexClient::loop);
 #include "client.prototypes.cc"
@@ -781,6 +783,7 @@ Predicate :: New(const v8::Arguments& args)
         case HYPERPREDICATE_LENGTH_LESS_EQUAL:
         case HYPERPREDICATE_LENGTH_GREATER_EQUAL:
         case HYPERPREDICATE_CONTAINS:
+        case HYPERPREDICATE_STARTS_WITH:
             break;
         default:
             abort();
@@ -831,6 +834,7 @@ HYPERDEX_PRED_CAST(LengthEquals,        HYPERPREDICATE_LENGTH_EQUALS)
 HYPERDEX_PRED_CAST(LengthLessEqual,     HYPERPREDICATE_LENGTH_LESS_EQUAL)
 HYPERDEX_PRED_CAST(LengthGreaterEqual,  HYPERPREDICATE_LENGTH_GREATER_EQUAL)
 HYPERDEX_PRED_CAST(Contains,            HYPERPREDICATE_CONTAINS)
+HYPERDEX_PRED_CAST(StartsWith,          HYPERPREDICATE_STARTS_WITH)
 
 v8::Handle<v8::Value>
 Predicate :: value()
@@ -113,12 +113,21 @@ static v8::Handle<v8::Value> group_set_intersect(const v8::Arguments& args);
 static v8::Handle<v8::Value> set_union(const v8::Arguments& args);
 static v8::Handle<v8::Value> cond_set_union(const v8::Arguments& args);
 static v8::Handle<v8::Value> group_set_union(const v8::Arguments& args);
+static v8::Handle<v8::Value> set_difference(const v8::Arguments& args);
+static v8::Handle<v8::Value> cond_set_difference(const v8::Arguments& args);
+static v8::Handle<v8::Value> group_set_difference(const v8::Arguments& args);
 static v8::Handle<v8::Value> document_rename(const v8::Arguments& args);
 static v8::Handle<v8::Value> cond_document_rename(const v8::Arguments& args);
 static v8::Handle<v8::Value> group_document_rename(const v8::Arguments& args);
 static v8::Handle<v8::Value> document_unset(const v8::Arguments& args);
 static v8::Handle<v8::Value> cond_document_unset(const v8::Arguments& args);
 static v8::Handle<v8::Value> group_document_unset(const v8::Arguments& args);
+static v8::Handle<v8::Value> sketch_add(const v8::Arguments& args);
+static v8::Handle<v8::Value> cond_sketch_add(const v8::Arguments& args);
+static v8::Handle<v8::Value> group_sketch_add(const v8::Arguments& args);
+static v8::Handle<v8::Value> sketch_merge(const v8::Arguments& args);
+static v8::Handle<v8::Value> cond_sketch_merge(const v8::Arguments& args);
+static v8::Handle<v8::Value> group_sketch_merge(const v8::Arguments& args);
 static v8::Handle<v8::Value> map_add(const v8::Arguments& args);
 static v8::Handle<v8::Value> cond_map_add(const v8::Arguments& args);
 static v8::Handle<v8::Value> group_map_add(const v8::Arguments& args);
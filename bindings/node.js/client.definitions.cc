@@ -1150,6 +1150,24 @@ HyperDexClient :: group_set_union(const v8::Arguments& args)
     return asynccall__spacename_predicates_attributes__status_count(hyperdex_client_group_set_union, args);
 }
 
+v8::Handle<v8::Value>
+HyperDexClient :: set_difference(const v8::Arguments& args)
+{
+    return asynccall__spacename_key_attributes__status(hyperdex_client_set_difference, args);
+}
+
+v8::Handle<v8::Value>
+HyperDexClient :: cond_set_difference(const v8::Arguments& args)
+{
+    return asynccall__spacename_key_predicates_attributes__status(hyperdex_client_cond_set_difference, args);
+}
+
+v8::Handle<v8::Value>
+HyperDexClient :: group_set_difference(const v8::Arguments& args)
+{
+    return asynccall__spacename_predicates_attributes__status_count(hyperdex_client_group_set_difference, args);
+}
+
 v8::Handle<v8::Value>
 HyperDexClient :: document_rename(const v8::Arguments& args)
 {
@@ -1186,6 +1204,42 @@ HyperDexClient :: group_document_unset(const v8::Arguments& args)
     return asynccall__spacename_predicates_attributes__status_count(hyperdex_client_group_document_unset, args);
 }
 
+v8::Handle<v8::Value>
+HyperDexClient :: sketch_add(const v8::Arguments& args)
+{
+    return asynccall__spacename_key_attributes__status(hyperdex_client_sketch_add, args);
+}
+
+v8::Handle<v8::Value>
+HyperDexClient :: cond_sketch_add(const v8::Arguments& args)
+{
+    return asynccall__spacename_key_predicates_attributes__status(hyperdex_client_cond_sketch_add, args);
+}
+
+v8::Handle<v8::Value>
+HyperDexClient :: group_sketch_add(const v8::Arguments& args)
+{
+    return asynccall__spacename_predicates_attributes__status_count(hyperdex_client_group_sketch_add, args);
+}
+
+v8::Handle<v8::Value>
+HyperDexClient :: sketch_merge(const v8::Arguments& args)
+{
+    return asynccall__spacename_key_attributes__status(hyperdex_client_sketch_merge, args);
+}
+
+v8::Handle<v8::Value>
+HyperDexClient :: cond_sketch_merge(const v8::Arguments& args)
+{
+    return asynccall__spacename_key_predicates_attributes__status(hyperdex_client_cond_sketch_merge, args);
+}
+
+v8::Handle<v8::Value>
+HyperDexClient :: group_sketch_merge(const v8::Arguments& args)
+{
+    return asynccall__spacename_predicates_attributes__status_count(hyperdex_client_group_sketch_merge, args);
+}
+
 v8::Handle<v8::Value>
 HyperDexClient :: map_add(const v8::Arguments& args)
 {
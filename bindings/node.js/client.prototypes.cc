@@ -98,12 +98,21 @@ NODE_SET_PROTOTYPE_METHOD(tpl, "group_set_intersect", HyperDexClient::group_set_
 NODE_SET_PROTOTYPE_METHOD(tpl, "set_union", HyperDexClient::set_union);
 NODE_SET_PROTOTYPE_METHOD(tpl, "cond_set_union", HyperDexClient::cond_set_union);
 NODE_SET_PROTOTYPE_METHOD(tpl, "group_set_union", HyperDexClient::group_set_union);
+NODE_SET_PROTOTYPE_METHOD(tpl, "set_difference", HyperDexClient::set_difference);
+NODE_SET_PROTOTYPE_METHOD(tpl, "cond_set_difference", HyperDexClient::cond_set_difference);
+NODE_SET_PROTOTYPE_METHOD(tpl, "group_set_difference", HyperDexClient::group_set_difference);
 NODE_SET_PROTOTYPE_METHOD(tpl, "document_rename", HyperDexClient::document_rename);
 NODE_SET_PROTOTYPE_METHOD(tpl, "cond_document_rename", HyperDexClient::cond_document_rename);
 NODE_SET_PROTOTYPE_METHOD(tpl, "group_document_rename", HyperDexClient::group_document_rename);
 NODE_SET_PROTOTYPE_METHOD(tpl, "document_unset", HyperDexClient::document_unset);
 NODE_SET_PROTOTYPE_METHOD(tpl, "cond_document_unset", HyperDexClient::cond_document_unset);
 NODE_SET_PROTOTYPE_METHOD(tpl, "group_document_unset", HyperDexClient::group_document_unset);
+NODE_SET_PROTOTYPE_METHOD(tpl, "sketch_add", HyperDexClient::sketch_add);
+NODE_SET_PROTOTYPE_METHOD(tpl, "cond_sketch_add", HyperDexClient::cond_sketch_add);
+NODE_SET_PROTOTYPE_METHOD(tpl, "group_sketch_add", HyperDexClient::group_sketch_add);
+NODE_SET_PROTOTYPE_METHOD(tpl, "sketch_merge", HyperDexClient::sketch_merge);
+NODE_SET_PROTOTYPE_METHOD(tpl, "cond_sketch_merge", HyperDexClient::cond_sketch_merge);
+NODE_SET_PROTOTYPE_METHOD(tpl, "group_sketch_merge", HyperDexClient::group_sketch_merge);
 NODE_SET_PROTOTYPE_METHOD(tpl, "map_add", HyperDexClient::map_add);
 NODE_SET_PROTOTYPE_METHOD(tpl, "cond_map_add", HyperDexClient::cond_map_add);
 NODE_SET_PROTOTYPE_METHOD(tpl, "group_map_add", HyperDexClient::group_map_add);
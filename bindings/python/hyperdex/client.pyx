@@ -86,6 +86,8 @@ cdef extern from "hyperdex.h":
         HYPERDATATYPE_TIMESTAMP_DAY      = 9476
         HYPERDATATYPE_TIMESTAMP_WEEK     = 9477
         HYPERDATATYPE_TIMESTAMP_MONTH    = 9478
+        HYPERDATATYPE_BITMAP_GENERIC     = 9600
+        HYPERDATATYPE_BITMAP_INT64       = 9602
         HYPERDATATYPE_MACAROON_SECRET    = 9664
         HYPERDATATYPE_GARBAGE            = 9727
 
@@ -101,6 +103,7 @@ cdef extern from "hyperdex.h":
         HYPERPREDICATE_LENGTH_LESS_EQUAL    = 9735
         HYPERPREDICATE_LENGTH_GREATER_EQUAL = 9736
         HYPERPREDICATE_CONTAINS      = 9737
+        HYPERPREDICATE_STARTS_WITH   = 9740
 
 
 cdef extern from "macaroons.h":
@@ -258,6 +261,9 @@ cdef extern from "hyperdex/client.h":
     int64_t hyperdex_client_set_union(hyperdex_client* client, const char* space, const char* key, size_t key_sz, const hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
     int64_t hyperdex_client_cond_set_union(hyperdex_client* client, const char* space, const char* key, size_t key_sz, const hyperdex_client_attribute_check* checks, size_t checks_sz, const hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
     int64_t hyperdex_client_group_set_union(hyperdex_client* client, const char* space, const hyperdex_client_attribute_check* checks, size_t checks_sz, const hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status, uint64_t* count)
+    int64_t hyperdex_client_set_difference(hyperdex_client* client, const char* space, const char* key, size_t key_sz, const hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_cond_set_difference(hyperdex_client* client, const char* space, const char* key, size_t key_sz, const hyperdex_client_attribute_check* checks, size_t checks_sz, const hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_set_difference(hyperdex_client* client, const char* space, const hyperdex_client_attribute_check* checks, size_t checks_sz, const hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status, uint64_t* count)
     int64_t hyperdex_client_document_rename(hyperdex_client* client, const char* space, const char* key, size_t key_sz, const hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
     int64_t hyperdex_client_uxact_document_rename(hyperdex_client* client, hyperdex_client_microtransaction* microtransaction, const hyperdex_client_attribute* attrs, size_t attrs_sz)
     int64_t hyperdex_client_cond_document_rename(hyperdex_client* client, const char* space, const char* key, size_t key_sz, const hyperdex_client_attribute_check* checks, size_t checks_sz, const hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
@@ -266,6 +272,12 @@ cdef extern from "hyperdex/client.h":
     int64_t hyperdex_client_uxact_document_unset(hyperdex_client* client, hyperdex_client_microtransaction* microtransaction, const hyperdex_client_attribute* attrs, size_t attrs_sz)
     int64_t hyperdex_client_cond_document_unset(hyperdex_client* client, const char* space, const char* key, size_t key_sz, const hyperdex_client_attribute_check* checks, size_t checks_sz, const hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
     int64_t hyperdex_client_group_document_unset(hyperdex_client* client, const char* space, const hyperdex_client_attribute_check* checks, size_t checks_sz, const hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status, uint64_t* count)
+    int64_t hyperdex_client_sketch_add(hyperdex_client* client, const char* space, const char* key, size_t key_sz, const hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_cond_sketch_add(hyperdex_client* client, const char* space, const char* key, size_t key_sz, const hyperdex_client_attribute_check* checks, size_t checks_sz, const hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_sketch_add(hyperdex_client* client, const char* space, const hyperdex_client_attribute_check* checks, size_t checks_sz, const hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status, uint64_t* count)
+    int64_t hyperdex_client_sketch_merge(hyperdex_client* client, const char* space, const char* key, size_t key_sz, const hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_cond_sketch_merge(hyperdex_client* client, const char* space, const char* key, size_t key_sz, const hyperdex_client_attribute_check* checks, size_t checks_sz, const hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_sketch_merge(hyperdex_client* client, const char* space, const hyperdex_client_attribute_check* checks, size_t checks_sz, const hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status, uint64_t* count)
     int64_t hyperdex_client_map_add(hyperdex_client* client, const char* space, const char* key, size_t key_sz, const hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz, hyperdex_client_returncode* status)
     int64_t hyperdex_client_cond_map_add(hyperdex_client* client, const char* space, const char* key, size_t key_sz, const hyperdex_client_attribute_check* checks, size_t checks_sz, const hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz, hyperdex_client_returncode* status)
     int64_t hyperdex_client_group_map_add(hyperdex_client* client, const char* space, const hyperdex_client_attribute_check* checks, size_t checks_sz, const hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz, hyperdex_client_returncode* status, uint64_t* count)
@@ -896,6 +908,8 @@ cdef hyperdex_python_client_build_attributes(const hyperdex_client_attribute* at
             val = hyperdex_python_client_build_set_string(attrs[i].value, attrs[i].value_sz)
         elif attrs[i].datatype == HYPERDATATYPE_SET_INT64:
             val = hyperdex_python_client_build_set_int(attrs[i].value, attrs[i].value_sz)
+        elif attrs[i].datatype == HYPERDATATYPE_BITMAP_INT64:
+            val = hyperdex_python_client_build_set_int(attrs[i].value, attrs[i].value_sz)
         elif attrs[i].datatype == HYPERDATATYPE_SET_FLOAT:
             val = hyperdex_python_client_build_set_float(attrs[i].value, attrs[i].value_sz)
         elif attrs[i].datatype == HYPERDATATYPE_MAP_STRING_STRING:
@@ -1062,6 +1076,11 @@ cdef class Regex(Predicate):
     def __init__(self, regex):
         Predicate.__init__(self, ((HYPERPREDICATE_REGEX, regex),))
 
+cdef class StartsWith(Predicate):
+
+    def __init__(self, prefix):
+        Predicate.__init__(self, ((HYPERPREDICATE_STARTS_WITH, prefix),))
+
 cdef class LengthEquals(Predicate):
 
     def __init__(self, length):
@@ -2157,6 +2176,21 @@ cdef class Client:
     def group_set_union(self, bytes spacename, dict predicates, dict attributes, auth=None):
         return self.async_group_set_union(spacename, predicates, attributes, auth).wait()
 
+    def async_set_difference(self, bytes spacename, key, dict attributes, auth=None):
+        return self.asynccall__spacename_key_attributes__status(hyperdex_client_set_difference, spacename, key, attributes, auth)
+    def set_difference(self, bytes spacename, key, dict attributes, auth=None):
+        return self.async_set_difference(spacename, key, attributes, auth).wait()
+
+    def async_cond_set_difference(self, bytes spacename, key, dict predicates, dict attributes, auth=None):
+        return self.asynccall__spacename_key_predicates_attributes__status(hyperdex_client_cond_set_difference, spacename, key, predicates, attributes, auth)
+    def cond_set_difference(self, bytes spacename, key, dict predicates, dict attributes, auth=None):
+        return self.async_cond_set_difference(spacename, key, predicates, attributes, auth).wait()
+
+    def async_group_set_difference(self, bytes spacename, dict predicates, dict attributes, auth=None):
+        return self.asynccall__spacename_predicates_attributes__status_count(hyperdex_client_group_set_difference, spacename, predicates, attributes, auth)
+    def group_set_difference(self, bytes spacename, dict predicates, dict attributes, auth=None):
+        return self.async_group_set_difference(spacename, predicates, attributes, auth).wait()
+
     def async_document_rename(self, bytes spacename, key, dict attributes, auth=None):
         return self.asynccall__spacename_key_attributes__status(hyperdex_client_document_rename, spacename, key, attributes, auth)
     def document_rename(self, bytes spacename, key, dict attributes, auth=None):
@@ -2187,6 +2221,36 @@ cdef class Client:
     def group_document_unset(self, bytes spacename, dict predicates, dict attributes, auth=None):
         return self.async_group_document_unset(spacename, predicates, attributes, auth).wait()
 
+    def async_sketch_add(self, bytes spacename, key, dict attributes, auth=None):
+        return self.asynccall__spacename_key_attributes__status(hyperdex_client_sketch_add, spacename, key, attributes, auth)
+    def sketch_add(self, bytes spacename, key, dict attributes, auth=None):
+        return self.async_sketch_add(spacename, key, attributes, auth).wait()
+
+    def async_cond_sketch_add(self, bytes spacename, key, dict predicates, dict attributes, auth=None):
+        return self.asynccall__spacename_key_predicates_attributes__status(hyperdex_client_cond_sketch_add, spacename, key, predicates, attributes, auth)
+    def cond_sketch_add(self, bytes spacename, key, dict predicates, dict attributes, auth=None):
+        return self.async_cond_sketch_add(spacename, key, predicates, attributes, auth).wait()
+
+    def async_group_sketch_add(self, bytes spacename, dict predicates, dict attributes, auth=None):
+        return self.asynccall__spacename_predicates_attributes__status_count(hyperdex_client_group_sketch_add, spacename, predicates, attributes, auth)
+    def group_sketch_add(self, bytes spacename, dict predicates, dict attributes, auth=None):
+        return self.async_group_sketch_add(spacename, predicates, attributes, auth).wait()
+
+    def async_sketch_merge(self, bytes spacename, key, dict attributes, auth=None):
+        return self.asynccall__spacename_key_attributes__status(hyperdex_client_sketch_merge, spacename, key, attributes, auth)
+    def sketch_merge(self, bytes spacename, key, dict attributes, auth=None):
+        return self.async_sketch_merge(spacename, key, attributes, auth).wait()
+
+    def async_cond_sketch_merge(self, bytes spacename, key, dict predicates, dict attributes, auth=None):
+        return self.asynccall__spacename_key_predicates_attributes__status(hyperdex_client_cond_sketch_merge, spacename, key, predicates, attributes, auth)
+    def cond_sketch_merge(self, bytes spacename, key, dict predicates, dict attributes, auth=None):
+        return self.async_cond_sketch_merge(spacename, key, predicates, attributes, auth).wait()
+
+    def async_group_sketch_merge(self, bytes spacename, dict predicates, dict attributes, auth=None):
+        return self.asynccall__spacename_predicates_attributes__status_count(hyperdex_client_group_sketch_merge, spacename, predicates, attributes, auth)
+    def group_sketch_merge(self, bytes spacename, dict predicates, dict attributes, auth=None):
+        return self.async_group_sketch_merge(spacename, predicates, attributes, auth).wait()
+
     def async_map_add(self, bytes spacename, key, dict mapattributes, auth=None):
         return self.asynccall__spacename_key_mapattributes__status(hyperdex_client_map_add, spacename, key, mapattributes, auth)
     def map_add(self, bytes spacename, key, dict mapattributes, auth=None):
@@ -57,6 +57,7 @@ static VALUE class_lengthequals;
 static VALUE class_lengthlessequal;
 static VALUE class_lengthgreaterequal;
 static VALUE class_contains;
+static VALUE class_startswith;
 
 /******************************* Error Handling *******************************/
 
@@ -1674,6 +1675,16 @@ hyperdex_ruby_client_predicate_contains_init(VALUE self, VALUE v)
     return self;
 }
 
+static VALUE
+hyperdex_ruby_client_predicate_startswith_init(VALUE self, VALUE v)
+{
+    struct hyperdex_ruby_client_predicate* pred = NULL;
+    Data_Get_Struct(self, struct hyperdex_ruby_client_predicate, pred);
+    pred->checks[0].v = v;
+    pred->checks[0].predicate = HYPERPREDICATE_STARTS_WITH;
+    return self;
+}
+
 /******************************* Inititalization ******************************/
 
 void
@@ -1774,4 +1785,9 @@ Init_hyperdex_client()
     class_contains = rb_define_class_under(mod_hyperdex_client, "Contains", class_predicate);
     rb_define_alloc_func(class_contains , hyperdex_ruby_client_predicate_alloc1);
     rb_define_method(class_contains , "initialize", hyperdex_ruby_client_predicate_contains_init, 1);
+
+    /* create the StartsWith class */
+    class_startswith = rb_define_class_under(mod_hyperdex_client, "StartsWith", class_predicate);
+    rb_define_alloc_func(class_startswith , hyperdex_ruby_client_predicate_alloc1);
+    rb_define_method(class_startswith , "initialize", hyperdex_ruby_client_predicate_startswith_init, 1);
 }
@@ -1294,6 +1294,42 @@ hyperdex_ruby_client_wait_group_set_union(VALUE self, VALUE spacename, VALUE pre
     return rb_funcall(deferred, rb_intern("wait"), 0);
 }
 
+static VALUE
+hyperdex_ruby_client_set_difference(VALUE self, VALUE spacename, VALUE key, VALUE attributes)
+{
+    return hyperdex_ruby_client_asynccall__spacename_key_attributes__status(hyperdex_client_set_difference, self, spacename, key, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_set_difference(VALUE self, VALUE spacename, VALUE key, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_set_difference(self, spacename, key, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_cond_set_difference(VALUE self, VALUE spacename, VALUE key, VALUE predicates, VALUE attributes)
+{
+    return hyperdex_ruby_client_asynccall__spacename_key_predicates_attributes__status(hyperdex_client_cond_set_difference, self, spacename, key, predicates, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_cond_set_difference(VALUE self, VALUE spacename, VALUE key, VALUE predicates, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_cond_set_difference(self, spacename, key, predicates, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_set_difference(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    return hyperdex_ruby_client_asynccall__spacename_predicates_attributes__status_count(hyperdex_client_group_set_difference, self, spacename, predicates, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_set_difference(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_set_difference(self, spacename, predicates, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
 static VALUE
 hyperdex_ruby_client_document_rename(VALUE self, VALUE spacename, VALUE key, VALUE attributes)
 {
@@ -1366,6 +1402,78 @@ hyperdex_ruby_client_wait_group_document_unset(VALUE self, VALUE spacename, VALU
     return rb_funcall(deferred, rb_intern("wait"), 0);
 }
 
+static VALUE
+hyperdex_ruby_client_sketch_add(VALUE self, VALUE spacename, VALUE key, VALUE attributes)
+{
+    return hyperdex_ruby_client_asynccall__spacename_key_attributes__status(hyperdex_client_sketch_add, self, spacename, key, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_sketch_add(VALUE self, VALUE spacename, VALUE key, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_sketch_add(self, spacename, key, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_cond_sketch_add(VALUE self, VALUE spacename, VALUE key, VALUE predicates, VALUE attributes)
+{
+    return hyperdex_ruby_client_asynccall__spacename_key_predicates_attributes__status(hyperdex_client_cond_sketch_add, self, spacename, key, predicates, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_cond_sketch_add(VALUE self, VALUE spacename, VALUE key, VALUE predicates, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_cond_sketch_add(self, spacename, key, predicates, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_sketch_add(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    return hyperdex_ruby_client_asynccall__spacename_predicates_attributes__status_count(hyperdex_client_group_sketch_add, self, spacename, predicates, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_sketch_add(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_sketch_add(self, spacename, predicates, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_sketch_merge(VALUE self, VALUE spacename, VALUE key, VALUE attributes)
+{
+    return hyperdex_ruby_client_asynccall__spacename_key_attributes__status(hyperdex_client_sketch_merge, self, spacename, key, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_sketch_merge(VALUE self, VALUE spacename, VALUE key, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_sketch_merge(self, spacename, key, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_cond_sketch_merge(VALUE self, VALUE spacename, VALUE key, VALUE predicates, VALUE attributes)
+{
+    return hyperdex_ruby_client_asynccall__spacename_key_predicates_attributes__status(hyperdex_client_cond_sketch_merge, self, spacename, key, predicates, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_cond_sketch_merge(VALUE self, VALUE spacename, VALUE key, VALUE predicates, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_cond_sketch_merge(self, spacename, key, predicates, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_sketch_merge(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    return hyperdex_ruby_client_asynccall__spacename_predicates_attributes__status_count(hyperdex_client_group_sketch_merge, self, spacename, predicates, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_sketch_merge(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_sketch_merge(self, spacename, predicates, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
 static VALUE
 hyperdex_ruby_client_map_add(VALUE self, VALUE spacename, VALUE key, VALUE mapattributes)
 {
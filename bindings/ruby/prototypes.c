@@ -167,6 +167,12 @@ rb_define_method(class_client, "async_cond_set_union", hyperdex_ruby_client_cond
 rb_define_method(class_client, "cond_set_union", hyperdex_ruby_client_wait_cond_set_union, 4);
 rb_define_method(class_client, "async_group_set_union", hyperdex_ruby_client_group_set_union, 3);
 rb_define_method(class_client, "group_set_union", hyperdex_ruby_client_wait_group_set_union, 3);
+rb_define_method(class_client, "async_set_difference", hyperdex_ruby_client_set_difference, 3);
+rb_define_method(class_client, "set_difference", hyperdex_ruby_client_wait_set_difference, 3);
+rb_define_method(class_client, "async_cond_set_difference", hyperdex_ruby_client_cond_set_difference, 4);
+rb_define_method(class_client, "cond_set_difference", hyperdex_ruby_client_wait_cond_set_difference, 4);
+rb_define_method(class_client, "async_group_set_difference", hyperdex_ruby_client_group_set_difference, 3);
+rb_define_method(class_client, "group_set_difference", hyperdex_ruby_client_wait_group_set_difference, 3);
 rb_define_method(class_client, "async_document_rename", hyperdex_ruby_client_document_rename, 3);
 rb_define_method(class_client, "document_rename", hyperdex_ruby_client_wait_document_rename, 3);
 rb_define_method(class_client, "async_cond_document_rename", hyperdex_ruby_client_cond_document_rename, 4);
@@ -179,6 +185,18 @@ rb_define_method(class_client, "async_cond_document_unset", hyperdex_ruby_client
 rb_define_method(class_client, "cond_document_unset", hyperdex_ruby_client_wait_cond_document_unset, 4);
 rb_define_method(class_client, "async_group_document_unset", hyperdex_ruby_client_group_document_unset, 3);
 rb_define_method(class_client, "group_document_unset", hyperdex_ruby_client_wait_group_document_unset, 3);
+rb_define_method(class_client, "async_sketch_add", hyperdex_ruby_client_sketch_add, 3);
+rb_define_method(class_client, "sketch_add", hyperdex_ruby_client_wait_sketch_add, 3);
+rb_define_method(class_client, "async_cond_sketch_add", hyperdex_ruby_client_cond_sketch_add, 4);
+rb_define_method(class_client, "cond_sketch_add", hyperdex_ruby_client_wait_cond_sketch_add, 4);
+rb_define_method(class_client, "async_group_sketch_add", hyperdex_ruby_client_group_sketch_add, 3);
+rb_define_method(class_client, "group_sketch_add", hyperdex_ruby_client_wait_group_sketch_add, 3);
+rb_define_method(class_client, "async_sketch_merge", hyperdex_ruby_client_sketch_merge, 3);
+rb_define_method(class_client, "sketch_merge", hyperdex_ruby_client_wait_sketch_merge, 3);
+rb_define_method(class_client, "async_cond_sketch_merge", hyperdex_ruby_client_cond_sketch_merge, 4);
+rb_define_method(class_client, "cond_sketch_merge", hyperdex_ruby_client_wait_cond_sketch_merge, 4);
+rb_define_method(class_client, "async_group_sketch_merge", hyperdex_ruby_client_group_sketch_merge, 3);
+rb_define_method(class_client, "group_sketch_merge", hyperdex_ruby_client_wait_group_sketch_merge, 3);
 rb_define_method(class_client, "async_map_add", hyperdex_ruby_client_map_add, 3);
 rb_define_method(class_client, "map_add", hyperdex_ruby_client_wait_map_add, 3);
 rb_define_method(class_client, "async_cond_map_add", hyperdex_ruby_client_cond_map_add, 4);
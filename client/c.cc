@@ -1493,6 +1493,50 @@ hyperdex_client_group_set_union(struct hyperdex_client* _cl,
     );
 }
 
+HYPERDEX_API int64_t
+hyperdex_client_set_difference(struct hyperdex_client* _cl,
+                               const char* space,
+                               const char* key, size_t key_sz,
+                               const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                               enum hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(set_difference), strlen(XSTR(set_difference)));
+    return cl->perform_funcall(opinfo, space, key, key_sz, NULL, 0, attrs, attrs_sz, NULL, 0, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_cond_set_difference(struct hyperdex_client* _cl,
+                                    const char* space,
+                                    const char* key, size_t key_sz,
+                                    const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                    const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                    enum hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(cond_set_difference), strlen(XSTR(cond_set_difference)));
+    return cl->perform_funcall(opinfo, space, key, key_sz, checks, checks_sz, attrs, attrs_sz, NULL, 0, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_set_difference(struct hyperdex_client* _cl,
+                                     const char* space,
+                                     const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                     enum hyperdex_client_returncode* status,
+                                     uint64_t* count)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_set_difference), strlen(XSTR(group_set_difference)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, attrs, attrs_sz, NULL, 0, status, count);
+    );
+}
+
 HYPERDEX_API int64_t
 hyperdex_client_document_rename(struct hyperdex_client* _cl,
                                 const char* space,
@@ -1609,6 +1653,94 @@ hyperdex_client_group_document_unset(struct hyperdex_client* _cl,
     );
 }
 
+HYPERDEX_API int64_t
+hyperdex_client_sketch_add(struct hyperdex_client* _cl,
+                           const char* space,
+                           const char* key, size_t key_sz,
+                           const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                           enum hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(sketch_add), strlen(XSTR(sketch_add)));
+    return cl->perform_funcall(opinfo, space, key, key_sz, NULL, 0, attrs, attrs_sz, NULL, 0, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_cond_sketch_add(struct hyperdex_client* _cl,
+                                const char* space,
+                                const char* key, size_t key_sz,
+                                const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                enum hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(cond_sketch_add), strlen(XSTR(cond_sketch_add)));
+    return cl->perform_funcall(opinfo, space, key, key_sz, checks, checks_sz, attrs, attrs_sz, NULL, 0, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_sketch_add(struct hyperdex_client* _cl,
+                                 const char* space,
+                                 const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 enum hyperdex_client_returncode* status,
+                                 uint64_t* count)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_sketch_add), strlen(XSTR(group_sketch_add)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, attrs, attrs_sz, NULL, 0, status, count);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_sketch_merge(struct hyperdex_client* _cl,
+                             const char* space,
+                             const char* key, size_t key_sz,
+                             const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                             enum hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(sketch_merge), strlen(XSTR(sketch_merge)));
+    return cl->perform_funcall(opinfo, space, key, key_sz, NULL, 0, attrs, attrs_sz, NULL, 0, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_cond_sketch_merge(struct hyperdex_client* _cl,
+                                  const char* space,
+                                  const char* key, size_t key_sz,
+                                  const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                  const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                  enum hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(cond_sketch_merge), strlen(XSTR(cond_sketch_merge)));
+    return cl->perform_funcall(opinfo, space, key, key_sz, checks, checks_sz, attrs, attrs_sz, NULL, 0, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_sketch_merge(struct hyperdex_client* _cl,
+                                   const char* space,
+                                   const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                   const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                   enum hyperdex_client_returncode* status,
+                                   uint64_t* count)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_sketch_merge), strlen(XSTR(group_sketch_merge)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, attrs, attrs_sz, NULL, 0, status, count);
+    );
+}
+
 HYPERDEX_API int64_t
 hyperdex_client_map_add(struct hyperdex_client* _cl,
                         const char* space,
@@ -2304,6 +2436,50 @@ hyperdex_client_count(struct hyperdex_client* _cl,
     );
 }
 
+HYPERDEX_API int64_t
+hyperdex_client_get_many(hyperdex_client* _cl,
+                         const char* space,
+                         const char** keys, const size_t* keys_sz, size_t keys_num,
+                         hyperdex_client_returncode* status,
+                         hyperdex_client_returncode* statuses,
+                         const hyperdex_client_attribute** attrs, size_t* attrs_sz)
+{
+    C_WRAP_EXCEPT(
+    return cl->get_many(space, keys, keys_sz, keys_num, status, statuses, attrs, attrs_sz);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_put_many(hyperdex_client* _cl,
+                         const char* space,
+                         const char** keys, const size_t* keys_sz, size_t keys_num,
+                         const hyperdex_client_attribute** attrs, const size_t* attrs_sz,
+                         hyperdex_client_returncode* status,
+                         hyperdex_client_returncode* statuses)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(put), strlen(XSTR(put)));
+    return cl->perform_funcall_many(opinfo, space, keys, keys_sz, keys_num, attrs, attrs_sz, status, statuses);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_nearest_search(hyperdex_client* _cl,
+                               const char* space,
+                               const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                               const char* attr,
+                               const float* vector, size_t vector_sz,
+                               hyperdex_client_distance distance,
+                               uint64_t limit,
+                               hyperdex_client_returncode* status,
+                               const hyperdex_client_attribute** attrs, size_t* attrs_sz)
+{
+    C_WRAP_EXCEPT(
+    return cl->nearest_search(space, checks, checks_sz, attr, vector, vector_sz, distance, limit, status, attrs, attrs_sz);
+    );
+}
+
 HYPERDEX_API int64_t
 hyperdex_client_loop(hyperdex_client* _cl, int timeout,
                      hyperdex_client_returncode* status)
@@ -2338,6 +2514,14 @@ hyperdex_client_set_type_conversion(hyperdex_client* _cl, bool enabled)
     cl->set_type_conversion(enabled);
 }
 
+HYPERDEX_API void
+hyperdex_client_set_read_policy(hyperdex_client* _cl,
+                                hyperdex_client_read_policy policy)
+{
+    hyperdex::client* cl = reinterpret_cast<hyperdex::client*>(_cl);
+    cl->set_read_policy(policy);
+}
+
 #ifdef __cplusplus
 } // extern "C"
 #endif // __cplusplus
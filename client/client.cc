@@ -34,6 +34,7 @@
 #include <algorithm>
 
 // e
+#include <e/endian.h>
 #include <e/intrusive_ptr.h>
 #include <e/strescape.h>
 
@@ -45,6 +46,7 @@
 #include "common/attribute_check.h"
 #include "common/auth_wallet.h"
 #include "common/datatype_info.h"
+#include "common/datatype_vector.h"
 #include "common/documents.h"
 #include "common/funcall.h"
 #include "common/macros.h"
@@ -57,6 +59,9 @@
 #include "client/pending_count.h"
 #include "client/pending_get.h"
 #include "client/pending_get_partial.h"
+#include "client/pending_multi_atomic.h"
+#include "client/pending_multi_get.h"
+#include "client/pending_nearest_search.h"
 #include "client/pending_search.h"
 #include "client/pending_search_describe.h"
 #include "client/pending_sorted_search.h"
@@ -103,6 +108,8 @@ client :: client(const char* coordinator, uint16_t port)
     , m_macaroons(NULL)
     , m_macaroons_sz(0)
     , m_convert_types(true)
+    , m_read_policy(HYPERDEX_CLIENT_READ_POINT_LEADER)
+    , m_next_read_replica(0)
 {
     if (!m_coord)
     {
@@ -135,6 +142,8 @@ client :: client(const char* conn_str)
     , m_macaroons(NULL)
     , m_macaroons_sz(0)
     , m_convert_types(true)
+    , m_read_policy(HYPERDEX_CLIENT_READ_POINT_LEADER)
+    , m_next_read_replica(0)
 {
     if (!m_coord)
     {
@@ -222,7 +231,16 @@ client :: get_partial(const char* space, const char* _key, size_t _key_sz,
 
     for (size_t i = 0; i < attrnames_sz; ++i)
     {
-        uint16_t attr = sc->lookup_attr(attrnames[i]);
+        const char* attrname = attrnames[i];
+        const size_t prefix_sz = strlen(HYPERDEX_ATTRIBUTE_LENGTH_PREFIX);
+        bool want_length = strncmp(attrname, HYPERDEX_ATTRIBUTE_LENGTH_PREFIX, prefix_sz) == 0;
+
+        if (want_length)
+        {
+            attrname += prefix_sz;
+        }
+
+        uint16_t attr = sc->lookup_attr(attrname);
 
         if (attr == UINT16_MAX)
         {
@@ -240,6 +258,18 @@ client :: get_partial(const char* space, const char* _key, size_t _key_sz,
             return -1;
         }
 
+        if (want_length)
+        {
+            if (!datatype_info::lookup(sc->attrs[attr].type)->has_length())
+            {
+                ERROR(WRONGTYPE) << "attribute \"" << e::strescape(attrname)
+                                 << "\" has no length";
+                return -1;
+            }
+
+            attr |= HYPERDEX_ATTRIBUTE_LENGTH_BIT;
+        }
+
         attrnums.push_back(attr);
     }
 
@@ -277,6 +307,101 @@ client :: get_partial(const char* space, const char* _key, size_t _key_sz,
     return send_keyop(space, key, REQ_GET_PARTIAL, msg, op, status);
 }
 
+int64_t
+client :: get_many(const char* space,
+                   const char** keys, const size_t* keys_sz, size_t keys_num,
+                   hyperdex_client_returncode* status,
+                   hyperdex_client_returncode* statuses,
+                   const hyperdex_client_attribute** attrs, size_t* attrs_sz)
+{
+    if (!maintain_coord_connection(status))
+    {
+        return -1;
+    }
+
+    const schema* sc = m_config.get_schema(space);
+
+    if (!sc)
+    {
+        ERROR(UNKNOWNSPACE) << "space \"" << e::strescape(space) << "\" does not exist";
+        return -1;
+    }
+
+    datatype_info* di = datatype_info::lookup(sc->attrs[0].type);
+    assert(di);
+    typedef std::map<virtual_server_id, std::vector<size_t> > batch_map_t;
+    batch_map_t batches;
+
+    for (size_t i = 0; i < keys_num; ++i)
+    {
+        e::slice key(keys[i], keys_sz[i]);
+        attrs[i] = NULL;
+        attrs_sz[i] = 0;
+
+        if (!di->validate(key))
+        {
+            ERROR(WRONGTYPE) << "key " << i << " must be type " << sc->attrs[0].type;
+            return -1;
+        }
+
+        virtual_server_id vsi = m_config.point_leader(space, key);
+
+        if (vsi == virtual_server_id())
+        {
+            statuses[i] = HYPERDEX_CLIENT_OFFLINE;
+            continue;
+        }
+
+        batches[vsi].push_back(i);
+    }
+
+    e::intrusive_ptr<pending_multi_get> op;
+    op = new pending_multi_get(m_next_client_id++, status, statuses, attrs, attrs_sz);
+    auth_wallet aw(m_macaroons, m_macaroons_sz);
+
+    for (batch_map_t::iterator it = batches.begin(); it != batches.end(); ++it)
+    {
+        std::vector<e::slice> batch_keys;
+        batch_keys.reserve(it->second.size());
+
+        for (size_t i = 0; i < it->second.size(); ++i)
+        {
+            const size_t idx = it->second[i];
+            batch_keys.push_back(e::slice(keys[idx], keys_sz[idx]));
+        }
+
+        size_t sz = HYPERDEX_CLIENT_HEADER_SIZE_REQ + pack_size(batch_keys);
+
+        if (m_macaroons_sz)
+        {
+            sz += pack_size(aw);
+        }
+
+        std::auto_ptr<e::buffer> msg(e::buffer::create(sz));
+        e::packer pa = msg->pack_at(HYPERDEX_CLIENT_HEADER_SIZE_REQ) << batch_keys;
+
+        if (m_macaroons_sz)
+        {
+            pa = pa << aw;
+        }
+
+        op->expect(it->first, it->second);
+        uint64_t nonce = m_next_server_nonce++;
+
+        if (!send(REQ_MULTI_GET, it->first, nonce, msg, op.get(), status))
+        {
+            m_failed.push_back(pending_server_pair(m_config.get_server_id(it->first), it->first, op.get()));
+        }
+    }
+
+    if (batches.empty())
+    {
+        m_yieldable.push_back(op.get());
+    }
+
+    return op->client_visible_id();
+}
+
 #define SEARCH_BOILERPLATE \
     if (!maintain_coord_connection(status)) \
     { \
@@ -375,6 +500,77 @@ client :: sorted_search(const char* space,
     return perform_aggregation(servers, op, REQ_SORTED_SEARCH, msg, status);
 }
 
+int64_t
+client :: nearest_search(const char* space,
+                         const hyperdex_client_attribute_check* chks, size_t chks_sz,
+                         const char* attr,
+                         const float* vector, size_t vector_sz,
+                         hyperdex_client_distance distance,
+                         uint64_t limit,
+                         hyperdex_client_returncode* status,
+                         const hyperdex_client_attribute** attrs, size_t* attrs_sz)
+{
+    SEARCH_BOILERPLATE
+    uint16_t attr_num = sc->lookup_attr(attr);
+
+    if (attr_num == sc->attrs_sz)
+    {
+        ERROR(UNKNOWNATTR) << "\"" << e::strescape(attr)
+                           << "\" is not an attribute of space \""
+                           << e::strescape(space) << "\"";
+        return -1 - chks_sz;
+    }
+
+    if (sc->attrs[attr_num].type != HYPERDATATYPE_VECTOR_FLOAT)
+    {
+        ERROR(WRONGTYPE) << "cannot search by distance to attribute \""
+                         << e::strescape(attr)
+                         << "\": it is not a vector";
+        return -1 - chks_sz;
+    }
+
+    if (distance != HYPERDEX_CLIENT_DISTANCE_L2 &&
+        distance != HYPERDEX_CLIENT_DISTANCE_COSINE)
+    {
+        ERROR(WRONGTYPE) << "unknown distance metric " << static_cast<int>(distance);
+        return -1 - chks_sz;
+    }
+
+    std::vector<uint8_t> packed(vector_sz * sizeof(float));
+
+    for (size_t i = 0; i < vector_sz; ++i)
+    {
+        uint32_t bits;
+        memmove(&bits, vector + i, sizeof(bits));
+        e::pack32le(bits, &packed[i * sizeof(float)]);
+    }
+
+    e::slice query(packed.empty() ? NULL : &packed[0], packed.size());
+
+    if (vector_sz == 0 || !datatype_vector::static_validate(query))
+    {
+        ERROR(WRONGTYPE) << "cannot search by distance to attribute \""
+                         << e::strescape(attr)
+                         << "\": the query vector is empty or not finite";
+        return -1 - chks_sz;
+    }
+
+    int64_t client_id = m_next_client_id++;
+    e::intrusive_ptr<pending_aggregation> op;
+    op = new pending_nearest_search(this, client_id, limit, status, attrs, attrs_sz);
+    uint8_t metric = distance == HYPERDEX_CLIENT_DISTANCE_COSINE
+                   ? datatype_vector::COSINE : datatype_vector::L2;
+    size_t sz = HYPERDEX_CLIENT_HEADER_SIZE_REQ
+              + pack_size(checks)
+              + sizeof(limit)
+              + sizeof(attr_num)
+              + sizeof(metric)
+              + pack_size(query);
+    std::auto_ptr<e::buffer> msg(e::buffer::create(sz));
+    msg->pack_at(HYPERDEX_CLIENT_HEADER_SIZE_REQ) << checks << limit << attr_num << metric << query;
+    return perform_aggregation(servers, op, REQ_NEAREST_SEARCH, msg, status);
+}
+
 int64_t
 client :: count(const char* space,
                 const hyperdex_client_attribute_check* chks, size_t chks_sz,
@@ -458,6 +654,113 @@ client :: perform_funcall(const hyperdex_client_keyop_info* opinfo,
     return send_keyop(space, key, REQ_ATOMIC, msg, op, status);
 }
 
+int64_t
+client :: perform_funcall_many(const hyperdex_client_keyop_info* opinfo,
+                               const char* space,
+                               const char** keys, const size_t* keys_sz, size_t keys_num,
+                               const hyperdex_client_attribute** attrs, const size_t* attrs_sz,
+                               hyperdex_client_returncode* status,
+                               hyperdex_client_returncode* statuses)
+{
+    if (!maintain_coord_connection(status))
+    {
+        return -1;
+    }
+
+    const schema* sc = m_config.get_schema(space);
+
+    if (!sc)
+    {
+        ERROR(UNKNOWNSPACE) << "space \"" << e::strescape(space) << "\" does not exist";
+        return -1;
+    }
+
+    datatype_info* di = datatype_info::lookup(sc->attrs[0].type);
+    assert(di);
+    auth_wallet aw(m_macaroons, m_macaroons_sz);
+    size_t footer_sz = m_macaroons_sz ? pack_size(aw) : 0;
+    typedef std::map<virtual_server_id, std::vector<size_t> > batch_map_t;
+    batch_map_t batches;
+    std::vector<std::string> ops(keys_num);
+
+    // encode every op exactly as the body of a REQ_ATOMIC
+    for (size_t i = 0; i < keys_num; ++i)
+    {
+        e::slice key(keys[i], keys_sz[i]);
+
+        if (!di->validate(key))
+        {
+            ERROR(WRONGTYPE) << "key " << i << " must be type " << sc->attrs[0].type;
+            return -1;
+        }
+
+        std::auto_ptr<e::buffer> msg;
+        int64_t ret = perform_funcall(space, sc, opinfo,
+                                      NULL, 0,
+                                      attrs[i], attrs_sz[i],
+                                      NULL, 0,
+                                      pack_size(key), footer_sz,
+                                      status, &msg);
+
+        if (ret < 0)
+        {
+            return ret;
+        }
+
+        msg->pack_at(0) << key;
+
+        if (m_macaroons_sz)
+        {
+            msg->pack_at(msg->capacity() - footer_sz) << aw;
+        }
+
+        e::slice packed = msg->as_slice();
+        ops[i].assign(reinterpret_cast<const char*>(packed.data()), packed.size());
+        virtual_server_id vsi = m_config.point_leader(space, key);
+
+        if (vsi == virtual_server_id())
+        {
+            statuses[i] = HYPERDEX_CLIENT_OFFLINE;
+            continue;
+        }
+
+        batches[vsi].push_back(i);
+    }
+
+    e::intrusive_ptr<pending_multi_atomic> op;
+    op = new pending_multi_atomic(m_next_client_id++, status, statuses);
+
+    for (batch_map_t::iterator it = batches.begin(); it != batches.end(); ++it)
+    {
+        std::vector<e::slice> batch_ops;
+        batch_ops.reserve(it->second.size());
+
+        for (size_t i = 0; i < it->second.size(); ++i)
+        {
+            const std::string& packed(ops[it->second[i]]);
+            batch_ops.push_back(e::slice(packed.data(), packed.size()));
+        }
+
+        size_t sz = HYPERDEX_CLIENT_HEADER_SIZE_REQ + pack_size(batch_ops);
+        std::auto_ptr<e::buffer> msg(e::buffer::create(sz));
+        msg->pack_at(HYPERDEX_CLIENT_HEADER_SIZE_REQ) << batch_ops;
+        op->expect(it->first, it->second);
+        uint64_t nonce = m_next_server_nonce++;
+
+        if (!send(REQ_MULTI_ATOMIC, it->first, nonce, msg, op.get(), status))
+        {
+            m_failed.push_back(pending_server_pair(m_config.get_server_id(it->first), it->first, op.get()));
+        }
+    }
+
+    if (batches.empty())
+    {
+        m_yieldable.push_back(op.get());
+    }
+
+    return op->client_visible_id();
+}
+
 int64_t
 client :: perform_group_funcall(const hyperdex_client_keyop_info* opinfo,
                                 const char* space,
@@ -608,7 +911,12 @@ client :: loop(int timeout, hyperdex_client_returncode* status)
 
         const pending_server_pair psp(it->second);
         e::intrusive_ptr<pending> op = psp.op;
-        m_pending_ops.erase(it);
+
+        // a progress report leaves the op waiting for the server's response
+        if (msg_type != RESP_GROUP_ATOMIC_PROGRESS)
+        {
+            m_pending_ops.erase(it);
+        }
 
         if (msg_type == CONFIGMISMATCH)
         {
@@ -867,6 +1175,14 @@ client :: prepare_funcs(const char* space, const schema& sc,
             return i;
         }
 
+        if (sc.hidden_attr(attrnum))
+        {
+            ERROR(UNKNOWNATTR) << "attribute \""
+                               << e::strescape(attrs[i].attr)
+                               << "\" is maintained by HyperDex and cannot be changed";
+            return i;
+        }
+
         hyperdatatype datatype = attrs[i].datatype;
 
         if (datatype == CONTAINER_TYPE(datatype) &&
@@ -881,6 +1197,14 @@ client :: prepare_funcs(const char* space, const schema& sc,
             datatype = HYPERDATATYPE_MACAROON_SECRET;
         }
 
+        // bitmaps are written as sets of integers
+        if (sc.attrs[attrnum].type == HYPERDATATYPE_BITMAP_INT64 &&
+            (datatype == HYPERDATATYPE_SET_INT64 ||
+             (datatype == HYPERDATATYPE_SET_GENERIC && attrs[i].value_sz == 0)))
+        {
+            datatype = HYPERDATATYPE_BITMAP_INT64;
+        }
+
         funcall o;
         o.attr = attrnum;
         o.name = opinfo->fname;
@@ -950,6 +1274,14 @@ client :: prepare_funcs(const char* space, const schema& sc,
             return i;
         }
 
+        if (sc.hidden_attr(attrnum))
+        {
+            ERROR(UNKNOWNATTR) << "attribute \""
+                               << e::strescape(mapattrs[i].attr)
+                               << "\" is maintained by HyperDex and cannot be changed";
+            return i;
+        }
+
         hyperdatatype k_datatype = mapattrs[i].map_key_datatype;
 
         if (k_datatype == CONTAINER_TYPE(k_datatype) &&
@@ -1248,6 +1580,17 @@ client :: send_keyop(const char* space,
         return -1;
     }
 
+    if (mt == REQ_GET || mt == REQ_GET_PARTIAL)
+    {
+        virtual_server_id fallback;
+        vsi = read_replica(vsi, &fallback);
+
+        if (fallback != virtual_server_id())
+        {
+            op->set_read_fallback(fallback, std::auto_ptr<e::buffer>(msg->copy()));
+        }
+    }
+
     int64_t nonce = m_next_server_nonce++;
 
     if (send(mt, vsi, nonce, msg, op, status))
@@ -1261,6 +1604,65 @@ client :: send_keyop(const char* space,
     }
 }
 
+virtual_server_id
+client :: read_replica(const virtual_server_id& pl,
+                       virtual_server_id* fallback)
+{
+    *fallback = virtual_server_id();
+
+    if (m_read_policy == HYPERDEX_CLIENT_READ_POINT_LEADER)
+    {
+        return pl;
+    }
+
+    std::vector<virtual_server_id> chain;
+
+    for (virtual_server_id it = pl; it != virtual_server_id();
+            it = m_config.next_in_region(it))
+    {
+        chain.push_back(it);
+    }
+
+    if (chain.back() != m_config.tail_of_region(m_config.get_region_id(pl)))
+    {
+        return pl;
+    }
+
+    return choose_read_replica(m_read_policy, chain, m_next_read_replica++, fallback);
+}
+
+virtual_server_id
+client :: choose_read_replica(hyperdex_client_read_policy policy,
+                              const std::vector<virtual_server_id>& chain,
+                              uint64_t counter,
+                              virtual_server_id* fallback)
+{
+    *fallback = virtual_server_id();
+    assert(!chain.empty());
+    const virtual_server_id& pl(chain.front());
+    const virtual_server_id& tail(chain.back());
+
+    switch (policy)
+    {
+        case HYPERDEX_CLIENT_READ_TAIL:
+            return tail;
+        case HYPERDEX_CLIENT_READ_ANY_REPLICA:
+            break;
+        case HYPERDEX_CLIENT_READ_POINT_LEADER:
+        default:
+            return pl;
+    }
+
+    virtual_server_id vsi = chain[counter % chain.size()];
+
+    if (vsi != pl && vsi != tail)
+    {
+        *fallback = tail;
+    }
+
+    return vsi;
+}
+
 void
 client :: handle_disruption(const server_id& si)
 {
@@ -1517,6 +1919,12 @@ client :: set_type_conversion(bool enabled)
     m_convert_types = enabled;
 }
 
+void
+client :: set_read_policy(hyperdex_client_read_policy policy)
+{
+    m_read_policy = policy;
+}
+
 int64_t
 microtransaction::generate_message(size_t header_sz, size_t footer_sz,
                                    const std::vector<attribute_check>& checks,
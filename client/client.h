@@ -33,6 +33,7 @@
 // STL
 #include <map>
 #include <list>
+#include <vector>
 
 // BusyBee
 #include <busybee_st.h>
@@ -94,6 +95,13 @@ class client
                             const char** attrnames, size_t attrnames_sz,
                             hyperdex_client_returncode* status,
                             const hyperdex_client_attribute** attrs, size_t* attrs_sz);
+        // retrieve many keys with one request per point leader; the result
+        // for keys[i] is stored in statuses[i], attrs[i], and attrs_sz[i]
+        int64_t get_many(const char* space,
+                         const char** keys, const size_t* keys_sz, size_t keys_num,
+                         hyperdex_client_returncode* status,
+                         hyperdex_client_returncode* statuses,
+                         const hyperdex_client_attribute** attrs, size_t* attrs_sz);
         int64_t search(const char* space,
                        const hyperdex_client_attribute_check* checks, size_t checks_sz,
                        hyperdex_client_returncode* status,
@@ -108,6 +116,16 @@ class client
                               bool maximize,
                               hyperdex_client_returncode* status,
                               const hyperdex_client_attribute** attrs, size_t* attrs_sz);
+        // the "limit" objects matching checks whose vector attribute "attr"
+        // is nearest to "vector", nearest first
+        int64_t nearest_search(const char* space,
+                               const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                               const char* attr,
+                               const float* vector, size_t vector_sz,
+                               hyperdex_client_distance distance,
+                               uint64_t limit,
+                               hyperdex_client_returncode* status,
+                               const hyperdex_client_attribute** attrs, size_t* attrs_sz);
         int64_t group_del(const char* space,
                           const hyperdex_client_attribute_check* checks, size_t checks_sz,
                           hyperdex_client_returncode* status);
@@ -124,6 +142,15 @@ class client
                                 const hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
                                 hyperdex_client_returncode* status);
 
+        // General keyop call applied to many keys, with one request per
+        // point leader; the result for keys[i] is stored in statuses[i]
+        int64_t perform_funcall_many(const hyperdex_client_keyop_info* opinfo,
+                                     const char* space,
+                                     const char** keys, const size_t* keys_sz, size_t keys_num,
+                                     const hyperdex_client_attribute** attrs, const size_t* attrs_sz,
+                                     hyperdex_client_returncode* status,
+                                     hyperdex_client_returncode* statuses);
+
         // General keyop call for group operations
         // This will be called by the bindings from c.cc
         int64_t perform_group_funcall(const hyperdex_client_keyop_info* opinfo,
@@ -176,6 +203,15 @@ class client
                                      hyperdex_client_returncode* status);
         // enable or disable type conversion on the client-side
         void set_type_conversion(bool enabled);
+        // choose which replicas serve get and get_partial
+        void set_read_policy(hyperdex_client_read_policy policy);
+        // the replica of "chain" (point leader first, tail last) that serves
+        // the "counter"th read under "policy"; sets "fallback" to the tail
+        // when that replica may redirect the read
+        static virtual_server_id choose_read_replica(hyperdex_client_read_policy policy,
+                                                     const std::vector<virtual_server_id>& chain,
+                                                     uint64_t counter,
+                                                     virtual_server_id* fallback);
 
     private:
         struct pending_server_pair
@@ -193,10 +229,13 @@ class client
         };
         typedef std::map<uint64_t, pending_server_pair> pending_map_t;
         typedef std::list<pending_server_pair> pending_queue_t;
+        friend class pending;
         friend class pending_get;
         friend class pending_get_partial;
+        friend class pending_multi_get;
         friend class pending_search;
         friend class pending_sorted_search;
+        friend class pending_nearest_search;
 
     private:
         size_t prepare_checks(const char* space, const schema& sc,
@@ -250,6 +289,10 @@ class client
                            std::auto_ptr<e::buffer> msg,
                            e::intrusive_ptr<pending> op,
                            hyperdex_client_returncode* status);
+        // the replica that should serve a read whose point leader is "pl";
+        // sets "fallback" when that replica may redirect the read
+        virtual_server_id read_replica(const virtual_server_id& pl,
+                                       virtual_server_id* fallback);
         void handle_disruption(const server_id& si);
 
     private:
@@ -278,6 +321,8 @@ class client
         const char** m_macaroons;
         size_t m_macaroons_sz;
         bool m_convert_types;
+        hyperdex_client_read_policy m_read_policy;
+        uint64_t m_next_read_replica;
 
     private:
         client(const client&);
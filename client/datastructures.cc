@@ -44,10 +44,12 @@
 
 // HyperDex
 #include <hyperdex/datastructures.h>
+#include "common/datatype_countmin.h"
 #include "common/datatype_info.h"
 #include "common/macros.h"
 #include "visibility.h"
 
+using hyperdex::datatype_countmin;
 using hyperdex::datatype_info;
 
 class hyperdex_ds_arena
@@ -369,6 +371,22 @@ hyperdex_ds_unpack_float(const char* value, size_t value_sz, double* num)
     return 0;
 }
 
+HYPERDEX_API int
+hyperdex_ds_countmin_estimate(const char* sketch, size_t sketch_sz,
+                              const char* elem, size_t elem_sz,
+                              uint64_t* count)
+{
+    e::slice value(sketch, sketch_sz);
+
+    if (!datatype_countmin::static_validate(value))
+    {
+        return -1;
+    }
+
+    *count = datatype_countmin::estimate(value, e::slice(elem, elem_sz));
+    return 0;
+}
+
 HYPERDEX_API int
 hyperdex_ds_copy_string(struct hyperdex_ds_arena* arena,
                         const char* str, size_t str_sz,
@@ -1210,7 +1228,9 @@ hyperdex_ds_iterate_set_string_next(struct hyperdex_ds_iterator* iter,
 HYPERDEX_API int
 hyperdex_ds_iterate_set_int_next(struct hyperdex_ds_iterator* iter, int64_t* num)
 {
-    if (iter->datatype != HYPERDATATYPE_SET_INT64)
+    // bitmaps reach clients in the set(int64) encoding
+    if (iter->datatype != HYPERDATATYPE_SET_INT64 &&
+        iter->datatype != HYPERDATATYPE_BITMAP_INT64)
     {
         return -1;
     }
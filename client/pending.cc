@@ -26,6 +26,7 @@
 // POSSIBILITY OF SUCH DAMAGE.
 
 // HyperDex
+#include "client/client.h"
 #include "client/pending.h"
 
 using hyperdex::pending;
@@ -35,6 +36,8 @@ pending :: pending(uint64_t id, hyperdex_client_returncode* status)
     , m_client_visible_id(id)
     , m_status(status)
     , m_error()
+    , m_fallback()
+    , m_fallback_msg()
 {
 }
 
@@ -54,3 +57,41 @@ pending :: set_error(const e::error& err)
 {
     m_error = err;
 }
+
+void
+pending :: set_read_fallback(const virtual_server_id& vsi,
+                             std::auto_ptr<e::buffer> msg)
+{
+    m_fallback = vsi;
+    m_fallback_msg = msg;
+}
+
+bool
+pending :: take_read_fallback(virtual_server_id* vsi,
+                              std::auto_ptr<e::buffer>* msg)
+{
+    if (!m_fallback_msg.get())
+    {
+        return false;
+    }
+
+    *vsi = m_fallback;
+    *msg = m_fallback_msg;
+    return true;
+}
+
+bool
+pending :: send_read_fallback(client* cl, network_msgtype mt)
+{
+    virtual_server_id vsi;
+    std::auto_ptr<e::buffer> msg;
+
+    if (!take_read_fallback(&vsi, &msg))
+    {
+        return false;
+    }
+
+    hyperdex_client_returncode status;
+    uint64_t nonce = cl->m_next_server_nonce++;
+    return cl->send(mt, vsi, nonce, msg, this, &status);
+}
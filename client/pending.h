@@ -32,6 +32,7 @@
 #include <memory>
 
 // e
+#include <e/buffer.h>
 #include <e/error.h>
 #include <e/intrusive_ptr.h>
 
@@ -56,6 +57,14 @@ class pending
         int64_t client_visible_id() const { return m_client_visible_id; }
         void set_status(hyperdex_client_returncode status) { *m_status = status; }
         e::error error() const { return m_error; }
+        // a read sent to a replica other than the point leader or tail is
+        // re-issued once to "vsi" if the replica redirects it
+        void set_read_fallback(const virtual_server_id& vsi,
+                               std::auto_ptr<e::buffer> msg);
+        // hand out the read's fallback, at most once; false if there is none
+        // or it was already taken
+        bool take_read_fallback(virtual_server_id* vsi,
+                                std::auto_ptr<e::buffer>* msg);
 
     // return to client
     public:
@@ -87,6 +96,9 @@ class pending
     protected:
         std::ostream& error(const char* file, size_t line);
         void set_error(const e::error& err);
+        // re-issue the read to its fallback; false if there is none or it
+        // could not be sent
+        bool send_read_fallback(client* cl, network_msgtype mt);
 
     // noncopyable
     private:
@@ -98,6 +110,8 @@ class pending
         int64_t m_client_visible_id;
         hyperdex_client_returncode* m_status;
         e::error m_error;
+        virtual_server_id m_fallback;
+        std::auto_ptr<e::buffer> m_fallback_msg;
 };
 
 #define PENDING_ERROR(CODE) \
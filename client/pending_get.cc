@@ -51,7 +51,7 @@ pending_get :: ~pending_get() throw ()
 bool
 pending_get :: can_yield()
 {
-    assert(m_state == RECV || m_state == YIELDED);
+    assert(m_state == SENT || m_state == RECV || m_state == YIELDED);
     return m_state == RECV;
 }
 
@@ -128,6 +128,14 @@ pending_get :: handle_message(client* cl,
                                        << " check its log for details";
             return true;
         case NET_NOTUS:
+            m_state = INITIALIZED;
+
+            if (send_read_fallback(cl, REQ_GET))
+            {
+                return true;
+            }
+
+            m_state = RECV;
             PENDING_ERROR(RECONFIGURE) << "server " << si
                                        << " reports that it is no longer reponsible"
                                        << " for the requested object";
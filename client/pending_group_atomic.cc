@@ -37,6 +37,8 @@ pending_group_atomic :: pending_group_atomic(uint64_t id,
     : pending_aggregation(id, status)
     , m_state(INITIALIZED)
     , m_update_count(update_count)
+    , m_finished(0)
+    , m_progress()
 {
     *m_update_count = 0;
 }
@@ -80,6 +82,11 @@ pending_group_atomic :: handle_failure(const server_id& si,
 {
     pending_aggregation::handle_failure(si, vsi);
 
+    // the ops the server reported did happen
+    m_finished += m_progress[vsi];
+    m_progress.erase(vsi);
+    set_update_count();
+
     assert(m_state == SENT);
     m_state = RECV;
     PENDING_ERROR(RECONFIGURE) << "reconfiguration affecting "
@@ -96,11 +103,29 @@ pending_group_atomic :: handle_message(client* cl,
                                        hyperdex_client_returncode* status,
                                        e::error* err)
 {
+    if (mt == RESP_GROUP_ATOMIC_PROGRESS)
+    {
+        // the server is still running; keep waiting for it
+        uint64_t completed;
+
+        if (!(up >> completed).error())
+        {
+            m_progress[vsi] = completed;
+            set_update_count();
+        }
+
+        *status = HYPERDEX_CLIENT_SUCCESS;
+        *err = e::error();
+        return true;
+    }
+
     bool handled = pending_aggregation::handle_message(cl, si, vsi, mt, std::auto_ptr<e::buffer>(), up, status, err);
     assert(handled);
+    m_progress.erase(vsi);
 
     if (mt != RESP_GROUP_ATOMIC)
     {
+        set_update_count();
         PENDING_ERROR(SERVERERROR) << "server " << vsi << " responded to GROUP_ATOMIC with " << mt;
         return true;
     }
@@ -108,11 +133,9 @@ pending_group_atomic :: handle_message(client* cl,
     uint64_t response;
     up = up >> response;
 
-    // Remember how many fields we updated
-    *m_update_count += response;
-
     if (up.error())
     {
+        set_update_count();
         PENDING_ERROR(SERVERERROR) << "communication error: server "
                                    << vsi << " sent corrupt message="
                                    << msg->as_slice().hex()
@@ -120,6 +143,10 @@ pending_group_atomic :: handle_message(client* cl,
         return true;
     }
 
+    // Remember how many fields we updated
+    m_finished += response;
+    set_update_count();
+
     if(this->aggregation_done())
     {
         m_state = DONE;
@@ -129,3 +156,15 @@ pending_group_atomic :: handle_message(client* cl,
 
     return true;
 }
+
+void
+pending_group_atomic :: set_update_count()
+{
+    *m_update_count = m_finished;
+
+    for (std::map<virtual_server_id, uint64_t>::iterator it = m_progress.begin();
+            it != m_progress.end(); ++it)
+    {
+        *m_update_count += it->second;
+    }
+}
@@ -28,6 +28,9 @@
 #ifndef hyperdex_client_pending_group_atomic_h_
 #define hyperdex_client_pending_group_atomic_h_
 
+// STL
+#include <map>
+
 // HyperDex
 #include "namespace.h"
 #include "client/pending_aggregation.h"
@@ -62,9 +65,16 @@ class pending_group_atomic : public pending_aggregation
                                     hyperdex_client_returncode* status,
                                     e::error* error);
 
+    private:
+        // "update_count" is the total of the servers that finished plus the
+        // last progress reported by each server still running
+        void set_update_count();
+
     private:
         enum { INITIALIZED, SENT, RECV, DONE, FAILURE, YIELDED } m_state;
         uint64_t* m_update_count;
+        uint64_t m_finished;
+        std::map<virtual_server_id, uint64_t> m_progress;
 
     private:
         pending_group_atomic(const pending_group_atomic&);
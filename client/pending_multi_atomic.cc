@@ -0,0 +1,183 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// HyperDex
+#include "common/network_returncode.h"
+#include "client/pending_multi_atomic.h"
+
+using hyperdex::pending_multi_atomic;
+
+pending_multi_atomic :: pending_multi_atomic(uint64_t id,
+                                             hyperdex_client_returncode* status,
+                                             hyperdex_client_returncode* statuses)
+    : pending_aggregation(id, status)
+    , m_statuses(statuses)
+    , m_expected()
+    , m_done(false)
+{
+    set_status(HYPERDEX_CLIENT_SUCCESS);
+    set_error(e::error());
+}
+
+pending_multi_atomic :: ~pending_multi_atomic() throw ()
+{
+}
+
+void
+pending_multi_atomic :: expect(const virtual_server_id& vsi,
+                               const std::vector<size_t>& idxs)
+{
+    m_expected[vsi] = idxs;
+    set_statuses(vsi, HYPERDEX_CLIENT_GARBAGE);
+}
+
+bool
+pending_multi_atomic :: can_yield()
+{
+    return this->aggregation_done() && !m_done;
+}
+
+bool
+pending_multi_atomic :: yield(hyperdex_client_returncode* status, e::error* err)
+{
+    *status = HYPERDEX_CLIENT_SUCCESS;
+    *err = e::error();
+    assert(this->can_yield());
+    m_done = true;
+    return true;
+}
+
+void
+pending_multi_atomic :: handle_failure(const server_id& si,
+                                       const virtual_server_id& vsi)
+{
+    set_statuses(vsi, HYPERDEX_CLIENT_RECONFIGURE);
+    PENDING_ERROR(RECONFIGURE) << "reconfiguration affecting "
+                               << vsi << "/" << si;
+    return pending_aggregation::handle_failure(si, vsi);
+}
+
+bool
+pending_multi_atomic :: handle_message(client* cl,
+                                       const server_id& si,
+                                       const virtual_server_id& vsi,
+                                       network_msgtype mt,
+                                       std::auto_ptr<e::buffer> msg,
+                                       e::unpacker up,
+                                       hyperdex_client_returncode* status,
+                                       e::error* err)
+{
+    bool handled = pending_aggregation::handle_message(cl, si, vsi, mt, std::auto_ptr<e::buffer>(), up, status, err);
+    assert(handled);
+
+    *status = HYPERDEX_CLIENT_SUCCESS;
+    *err = e::error();
+
+    if (mt != RESP_MULTI_ATOMIC)
+    {
+        set_statuses(vsi, HYPERDEX_CLIENT_SERVERERROR);
+        PENDING_ERROR(SERVERERROR) << "server " << vsi << " responded to MULTI_ATOMIC with " << mt;
+        return true;
+    }
+
+    const std::vector<size_t>& idxs(m_expected[vsi]);
+    std::vector<uint16_t> responses(idxs.size());
+    uint64_t count;
+    up = up >> count;
+
+    for (size_t i = 0; !up.error() && count == idxs.size() && i < idxs.size(); ++i)
+    {
+        up = up >> responses[i];
+    }
+
+    if (up.error() || count != idxs.size())
+    {
+        set_statuses(vsi, HYPERDEX_CLIENT_SERVERERROR);
+        PENDING_ERROR(SERVERERROR) << "communication error: server "
+                                   << vsi << " sent corrupt message="
+                                   << msg->as_slice().hex()
+                                   << " in response to a MULTI_ATOMIC";
+        return true;
+    }
+
+    for (size_t i = 0; i < idxs.size(); ++i)
+    {
+        hyperdex_client_returncode* s = &m_statuses[idxs[i]];
+
+        switch (static_cast<network_returncode>(responses[i]))
+        {
+            case NET_SUCCESS:
+                *s = HYPERDEX_CLIENT_SUCCESS;
+                break;
+            case NET_NOTFOUND:
+                *s = HYPERDEX_CLIENT_NOTFOUND;
+                break;
+            case NET_CMPFAIL:
+                *s = HYPERDEX_CLIENT_CMPFAIL;
+                break;
+            case NET_NOTUS:
+                *s = HYPERDEX_CLIENT_RECONFIGURE;
+                break;
+            case NET_OVERFLOW:
+                *s = HYPERDEX_CLIENT_OVERFLOW;
+                break;
+            case NET_READONLY:
+                *s = HYPERDEX_CLIENT_READONLY;
+                break;
+            case NET_UNAUTHORIZED:
+                *s = HYPERDEX_CLIENT_UNAUTHORIZED;
+                break;
+            case NET_BADDIMSPEC:
+            case NET_SERVERERROR:
+            default:
+                *s = HYPERDEX_CLIENT_SERVERERROR;
+                break;
+        }
+    }
+
+    // Don't set the status or error on success so that errors will carry
+    // through.  It was set to the success state in the constructor
+    return true;
+}
+
+void
+pending_multi_atomic :: set_statuses(const virtual_server_id& vsi,
+                                     hyperdex_client_returncode status)
+{
+    std::map<virtual_server_id, std::vector<size_t> >::iterator it;
+    it = m_expected.find(vsi);
+
+    if (it == m_expected.end())
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < it->second.size(); ++i)
+    {
+        m_statuses[it->second[i]] = status;
+    }
+}
@@ -0,0 +1,90 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef hyperdex_client_pending_multi_atomic_h_
+#define hyperdex_client_pending_multi_atomic_h_
+
+// STL
+#include <map>
+#include <vector>
+
+// HyperDex
+#include "namespace.h"
+#include "client/pending_aggregation.h"
+
+BEGIN_HYPERDEX_NAMESPACE
+
+class pending_multi_atomic : public pending_aggregation
+{
+    public:
+        pending_multi_atomic(uint64_t client_visible_id,
+                             hyperdex_client_returncode* status,
+                             hyperdex_client_returncode* statuses);
+        virtual ~pending_multi_atomic() throw ();
+
+    // the ops in a REQ_MULTI_ATOMIC sent to vsi; "idxs" are their positions
+    // in the caller's arrays
+    public:
+        void expect(const virtual_server_id& vsi,
+                    const std::vector<size_t>& idxs);
+
+    // return to client
+    public:
+        virtual bool can_yield();
+        virtual bool yield(hyperdex_client_returncode* status, e::error* error);
+
+    // events
+    public:
+        virtual void handle_failure(const server_id& si,
+                                    const virtual_server_id& vsi);
+        virtual bool handle_message(client*,
+                                    const server_id& si,
+                                    const virtual_server_id& vsi,
+                                    network_msgtype mt,
+                                    std::auto_ptr<e::buffer> msg,
+                                    e::unpacker up,
+                                    hyperdex_client_returncode* status,
+                                    e::error* error);
+
+    // noncopyable
+    private:
+        pending_multi_atomic(const pending_multi_atomic& other);
+        pending_multi_atomic& operator = (const pending_multi_atomic& rhs);
+
+    private:
+        void set_statuses(const virtual_server_id& vsi,
+                          hyperdex_client_returncode status);
+
+    private:
+        hyperdex_client_returncode* m_statuses;
+        std::map<virtual_server_id, std::vector<size_t> > m_expected;
+        bool m_done;
+};
+
+END_HYPERDEX_NAMESPACE
+
+#endif // hyperdex_client_pending_multi_atomic_h_
@@ -0,0 +1,274 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// STL
+#include <algorithm>
+
+// HyperDex
+#include "client/client.h"
+#include "client/pending_nearest_search.h"
+#include "client/util.h"
+
+using hyperdex::pending_nearest_search;
+
+pending_nearest_search :: pending_nearest_search(client* cl,
+                                                 uint64_t id,
+                                                 uint64_t limit,
+                                                 hyperdex_client_returncode* status,
+                                                 const hyperdex_client_attribute** attrs,
+                                                 size_t* attrs_sz)
+    : pending_aggregation(id, status)
+    , m_cl(cl)
+    , m_yield(false)
+    , m_error_pending(false)
+    , m_failed(false)
+    , m_ri()
+    , m_limit(limit)
+    , m_attrs(attrs)
+    , m_attrs_sz(attrs_sz)
+    , m_results()
+    , m_results_idx()
+{
+}
+
+pending_nearest_search :: ~pending_nearest_search() throw ()
+{
+}
+
+bool
+pending_nearest_search :: can_yield()
+{
+    return m_yield;
+}
+
+bool
+pending_nearest_search :: yield(hyperdex_client_returncode* status, e::error* err)
+{
+    *status = HYPERDEX_CLIENT_SUCCESS;
+    *err = e::error();
+    m_yield = false;
+
+    if (m_error_pending)
+    {
+        // the failure's status and error are already set
+        m_error_pending = false;
+        m_yield = this->aggregation_done();
+        return true;
+    }
+
+    if (!this->aggregation_done())
+    {
+        return true;
+    }
+
+    if (m_failed || m_results_idx >= m_results.size())
+    {
+        set_status(HYPERDEX_CLIENT_SEARCHDONE);
+        set_error(e::error());
+        return true;
+    }
+
+    m_yield = true;
+
+    hyperdex_client_returncode op_status;
+    e::error op_error;
+    const e::slice& key(m_results[m_results_idx].key);
+    const std::vector<e::slice>& value(m_results[m_results_idx].value);
+    ++m_results_idx;
+
+    if (!value_to_attributes(m_cl->m_config, m_ri, key.data(), key.size(),
+                             value, &op_status, &op_error, m_attrs, m_attrs_sz, m_cl->m_convert_types))
+    {
+        set_status(op_status);
+        set_error(op_error);
+        return true;
+    }
+
+    set_status(HYPERDEX_CLIENT_SUCCESS);
+    set_error(e::error());
+    return true;
+}
+
+void
+pending_nearest_search :: fail()
+{
+    m_yield = true;
+    m_error_pending = true;
+    m_failed = true;
+}
+
+void
+pending_nearest_search :: handle_sent_to(const server_id& si,
+                                         const virtual_server_id& vsi)
+{
+    if (m_ri == region_id())
+    {
+        m_ri = m_cl->m_config.get_region_id(vsi);
+    }
+
+    return pending_aggregation::handle_sent_to(si, vsi);
+}
+
+void
+pending_nearest_search :: handle_failure(const server_id& si,
+                                         const virtual_server_id& vsi)
+{
+    fail();
+    PENDING_ERROR(RECONFIGURE) << "reconfiguration affecting "
+                               << vsi << "/" << si;
+    return pending_aggregation::handle_failure(si, vsi);
+}
+
+bool
+pending_nearest_search :: handle_message(client* cl,
+                                         const server_id& si,
+                                         const virtual_server_id& vsi,
+                                         network_msgtype mt,
+                                         std::auto_ptr<e::buffer> msg,
+                                         e::unpacker up,
+                                         hyperdex_client_returncode* status,
+                                         e::error* err)
+{
+    bool handled = pending_aggregation::handle_message(cl, si, vsi, mt, std::auto_ptr<e::buffer>(), up, status, err);
+    assert(handled);
+
+    *status = HYPERDEX_CLIENT_SUCCESS;
+    *err = e::error();
+
+    if (mt != RESP_NEAREST_SEARCH)
+    {
+        PENDING_ERROR(SERVERERROR) << "server " << vsi << " responded to NEAREST_SEARCH with " << mt;
+        fail();
+        return true;
+    }
+
+    uint64_t num_results = 0;
+    up = up >> num_results;
+
+    if (up.error())
+    {
+        PENDING_ERROR(SERVERERROR) << "communication error: server "
+                                   << vsi << " sent corrupt message="
+                                   << msg->as_slice().hex()
+                                   << " in response to a NEAREST_SEARCH";
+        fail();
+        return true;
+    }
+
+    e::compat::shared_ptr<e::buffer> backing(msg.release());
+
+    for (uint64_t i = 0; i < num_results; ++i)
+    {
+        e::slice key;
+        std::vector<e::slice> value;
+        uint64_t distance;
+        up = up >> key >> value >> distance;
+
+        if (up.error())
+        {
+            PENDING_ERROR(SERVERERROR) << "communication error: server "
+                                       << vsi << " sent corrupt message="
+                                       << backing->as_slice().hex()
+                                       << " in response to a NEAREST_SEARCH";
+            fail();
+            return true;
+        }
+
+        // a max-heap, so the farthest of the nearest "limit" is evicted
+        m_results.push_back(item(distance, key, value, backing));
+        std::push_heap(m_results.begin(), m_results.end());
+
+        if (m_results.size() > m_limit)
+        {
+            std::pop_heap(m_results.begin(), m_results.end());
+            m_results.pop_back();
+        }
+    }
+
+    if (m_failed)
+    {
+        m_yield = m_error_pending || this->aggregation_done();
+        return true;
+    }
+
+    m_yield = this->aggregation_done();
+    set_status(HYPERDEX_CLIENT_SUCCESS);
+    set_error(e::error());
+
+    if (m_yield)
+    {
+        std::sort(m_results.begin(), m_results.end());
+    }
+
+    return true;
+}
+
+pending_nearest_search :: item :: item()
+    : distance()
+    , key()
+    , value()
+    , backing()
+{
+}
+
+pending_nearest_search :: item :: item(uint64_t _distance,
+                                       const e::slice& _key,
+                                       const std::vector<e::slice>& _value,
+                                       e::compat::shared_ptr<e::buffer> _backing)
+    : distance(_distance)
+    , key(_key)
+    , value(_value)
+    , backing(_backing)
+{
+}
+
+pending_nearest_search :: item :: item(const item& other)
+    : distance(other.distance)
+    , key(other.key)
+    , value(other.value)
+    , backing(other.backing)
+{
+}
+
+pending_nearest_search :: item :: ~item() throw ()
+{
+}
+
+pending_nearest_search::item&
+pending_nearest_search :: item :: operator = (const item& other)
+{
+    if (this != &other)
+    {
+        distance = other.distance;
+        key = other.key;
+        value = other.value;
+        backing = other.backing;
+    }
+
+    return *this;
+}
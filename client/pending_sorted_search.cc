@@ -48,6 +48,8 @@ pending_sorted_search :: pending_sorted_search(client* cl,
     : pending_aggregation(id, status)
     , m_cl(cl)
     , m_yield(false)
+    , m_error_pending(false)
+    , m_failed(false)
     , m_ri()
     , m_maximize(maximize)
     , m_limit(limit)
@@ -77,7 +79,20 @@ pending_sorted_search :: yield(hyperdex_client_returncode* status, e::error* err
     *err = e::error();
     m_yield = false;
 
-    if (this->aggregation_done() && m_results_idx >= m_results.size())
+    if (m_error_pending)
+    {
+        // the failure's status and error are already set
+        m_error_pending = false;
+        m_yield = this->aggregation_done();
+        return true;
+    }
+
+    if (!this->aggregation_done())
+    {
+        return true;
+    }
+
+    if (m_failed || m_results_idx >= m_results.size())
     {
         set_status(HYPERDEX_CLIENT_SEARCHDONE);
         set_error(e::error());
@@ -105,6 +120,14 @@ pending_sorted_search :: yield(hyperdex_client_returncode* status, e::error* err
     return true;
 }
 
+void
+pending_sorted_search :: fail()
+{
+    m_yield = true;
+    m_error_pending = true;
+    m_failed = true;
+}
+
 void
 pending_sorted_search :: handle_sent_to(const server_id& si,
                                         const virtual_server_id& vsi)
@@ -121,7 +144,7 @@ void
 pending_sorted_search :: handle_failure(const server_id& si,
                                         const virtual_server_id& vsi)
 {
-    m_yield = true;
+    fail();
     PENDING_ERROR(RECONFIGURE) << "reconfiguration affecting "
                                << vsi << "/" << si;
     return pending_aggregation::handle_failure(si, vsi);
@@ -206,7 +229,7 @@ pending_sorted_search :: handle_message(client* cl,
     if (mt != RESP_SORTED_SEARCH)
     {
         PENDING_ERROR(SERVERERROR) << "server " << vsi << " responded to SORTED_SEARCH with " << mt;
-        m_yield = true;
+        fail();
         return true;
     }
 
@@ -219,7 +242,7 @@ pending_sorted_search :: handle_message(client* cl,
                                    << vsi << " sent corrupt message="
                                    << msg->as_slice().hex()
                                    << " in response to a SORTED_SEARCH";
-        m_yield = true;
+        fail();
         return true;
     }
 
@@ -238,7 +261,7 @@ pending_sorted_search :: handle_message(client* cl,
                                        << vsi << " sent corrupt message="
                                        << msg->as_slice().hex()
                                        << " in response to a SORTED_SEARCH";
-            m_yield = true;
+            fail();
             return true;
         }
 
@@ -252,6 +275,12 @@ pending_sorted_search :: handle_message(client* cl,
         }
     }
 
+    if (m_failed)
+    {
+        m_yield = m_error_pending || this->aggregation_done();
+        return true;
+    }
+
     m_yield = this->aggregation_done();
     set_status(HYPERDEX_CLIENT_SUCCESS);
     set_error(e::error());
@@ -75,6 +75,10 @@ class pending_sorted_search : public pending_aggregation
     public:
         class item;
 
+    private:
+        // mark the search as failed; the caller sets the status and error
+        void fail();
+
     // noncopyable
     private:
         pending_sorted_search(const pending_sorted_search& other);
@@ -83,6 +87,10 @@ class pending_sorted_search : public pending_aggregation
     private:
         client* m_cl;
         bool m_yield;
+        // a failure's status is set and waits to be yielded
+        bool m_error_pending;
+        // some server's results are missing, so none are yielded
+        bool m_failed;
         region_id m_ri;
         bool m_maximize;
         const uint64_t m_limit;
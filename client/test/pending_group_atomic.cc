@@ -0,0 +1,117 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// C
+#include <stdint.h>
+
+// STL
+#include <memory>
+
+// e
+#include <e/buffer.h>
+
+// HyperDex
+#include "test/th.h"
+#include "client/pending_group_atomic.h"
+
+using hyperdex::pending_group_atomic;
+using hyperdex::server_id;
+using hyperdex::virtual_server_id;
+
+namespace
+{
+
+bool
+deliver(pending_group_atomic* op,
+        const server_id& si,
+        const virtual_server_id& vsi,
+        hyperdex::network_msgtype mt,
+        uint64_t count)
+{
+    std::auto_ptr<e::buffer> msg(e::buffer::create(sizeof(uint64_t)));
+    msg->pack_at(0) << count;
+    hyperdex_client_returncode status;
+    e::error err;
+    e::unpacker up = msg->unpack_from(0);
+    return op->handle_message(NULL, si, vsi, mt, msg, up, &status, &err);
+}
+
+} // namespace
+
+// Progress reports from servers still scanning add up, and are replaced by
+// each server's total when it finishes
+TEST(PendingGroupAtomic, Progress)
+{
+    hyperdex_client_returncode status;
+    uint64_t count = 42;
+    pending_group_atomic op(1, &status, &count);
+    ASSERT_EQ(0U, count);
+    op.handle_sent_to(server_id(10), virtual_server_id(1));
+    op.handle_sent_to(server_id(20), virtual_server_id(2));
+
+    ASSERT_TRUE(deliver(&op, server_id(10), virtual_server_id(1),
+                        hyperdex::RESP_GROUP_ATOMIC_PROGRESS, 4096));
+    ASSERT_EQ(4096U, count);
+    ASSERT_TRUE(deliver(&op, server_id(20), virtual_server_id(2),
+                        hyperdex::RESP_GROUP_ATOMIC_PROGRESS, 100));
+    ASSERT_EQ(4196U, count);
+    ASSERT_TRUE(deliver(&op, server_id(10), virtual_server_id(1),
+                        hyperdex::RESP_GROUP_ATOMIC_PROGRESS, 8192));
+    ASSERT_EQ(8292U, count);
+    ASSERT_FALSE(op.can_yield());
+
+    ASSERT_TRUE(deliver(&op, server_id(10), virtual_server_id(1),
+                        hyperdex::RESP_GROUP_ATOMIC, 9000));
+    ASSERT_EQ(9100U, count);
+    ASSERT_FALSE(op.can_yield());
+
+    ASSERT_TRUE(deliver(&op, server_id(20), virtual_server_id(2),
+                        hyperdex::RESP_GROUP_ATOMIC, 200));
+    ASSERT_EQ(9200U, count);
+    ASSERT_EQ(HYPERDEX_CLIENT_SUCCESS, status);
+    ASSERT_TRUE(op.can_yield());
+}
+
+// A server lost mid-scan keeps the progress it reported
+TEST(PendingGroupAtomic, FailureKeepsProgress)
+{
+    hyperdex_client_returncode status;
+    uint64_t count = 0;
+    pending_group_atomic op(1, &status, &count);
+    op.handle_sent_to(server_id(10), virtual_server_id(1));
+    op.handle_sent_to(server_id(20), virtual_server_id(2));
+
+    ASSERT_TRUE(deliver(&op, server_id(10), virtual_server_id(1),
+                        hyperdex::RESP_GROUP_ATOMIC_PROGRESS, 4096));
+    op.handle_failure(server_id(10), virtual_server_id(1));
+    ASSERT_EQ(4096U, count);
+    ASSERT_EQ(HYPERDEX_CLIENT_RECONFIGURE, status);
+
+    ASSERT_TRUE(deliver(&op, server_id(20), virtual_server_id(2),
+                        hyperdex::RESP_GROUP_ATOMIC, 7));
+    ASSERT_EQ(4103U, count);
+}
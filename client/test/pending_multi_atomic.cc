@@ -0,0 +1,190 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// C
+#include <stdint.h>
+
+// STL
+#include <memory>
+#include <vector>
+
+// e
+#include <e/buffer.h>
+
+// HyperDex
+#include "test/th.h"
+#include "common/network_returncode.h"
+#include "client/pending_multi_atomic.h"
+
+using hyperdex::pending_multi_atomic;
+using hyperdex::server_id;
+using hyperdex::virtual_server_id;
+
+namespace
+{
+
+// the body of a RESP_MULTI_ATOMIC after the nonce
+std::auto_ptr<e::buffer>
+multi_atomic_response(const std::vector<hyperdex::network_returncode>& results)
+{
+    std::auto_ptr<e::buffer> msg(e::buffer::create(sizeof(uint64_t) +
+                                                   results.size() * sizeof(uint16_t)));
+    e::packer pa = msg->pack_at(0);
+    pa = pa << static_cast<uint64_t>(results.size());
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        pa = pa << static_cast<uint16_t>(results[i]);
+    }
+
+    return msg;
+}
+
+bool
+deliver(pending_multi_atomic* op,
+        const server_id& si,
+        const virtual_server_id& vsi,
+        std::auto_ptr<e::buffer> msg)
+{
+    hyperdex_client_returncode status;
+    e::error err;
+    e::unpacker up = msg->unpack_from(0);
+    return op->handle_message(NULL, si, vsi, hyperdex::RESP_MULTI_ATOMIC,
+                              msg, up, &status, &err);
+}
+
+} // namespace
+
+// One op per caller index, batched into one request per point leader; the
+// batches' results land at the caller's indices as they arrive
+TEST(PendingMultiAtomic, ResultsFollowBatches)
+{
+    hyperdex_client_returncode status;
+    hyperdex_client_returncode statuses[3];
+    pending_multi_atomic op(1, &status, statuses);
+    std::vector<size_t> first;
+    first.push_back(0);
+    first.push_back(2);
+    std::vector<size_t> second;
+    second.push_back(1);
+    op.expect(virtual_server_id(1), first);
+    op.expect(virtual_server_id(2), second);
+    op.handle_sent_to(server_id(10), virtual_server_id(1));
+    op.handle_sent_to(server_id(20), virtual_server_id(2));
+    ASSERT_EQ(HYPERDEX_CLIENT_GARBAGE, statuses[0]);
+    ASSERT_EQ(HYPERDEX_CLIENT_GARBAGE, statuses[1]);
+    ASSERT_EQ(HYPERDEX_CLIENT_GARBAGE, statuses[2]);
+
+    std::vector<hyperdex::network_returncode> results;
+    results.push_back(hyperdex::NET_SUCCESS);
+    results.push_back(hyperdex::NET_CMPFAIL);
+    ASSERT_TRUE(deliver(&op, server_id(10), virtual_server_id(1),
+                        multi_atomic_response(results)));
+    ASSERT_EQ(HYPERDEX_CLIENT_SUCCESS, statuses[0]);
+    ASSERT_EQ(HYPERDEX_CLIENT_GARBAGE, statuses[1]);
+    ASSERT_EQ(HYPERDEX_CLIENT_CMPFAIL, statuses[2]);
+    ASSERT_FALSE(op.can_yield());
+
+    results.clear();
+    results.push_back(hyperdex::NET_SUCCESS);
+    ASSERT_TRUE(deliver(&op, server_id(20), virtual_server_id(2),
+                        multi_atomic_response(results)));
+    ASSERT_EQ(HYPERDEX_CLIENT_SUCCESS, statuses[1]);
+    ASSERT_EQ(HYPERDEX_CLIENT_SUCCESS, status);
+    ASSERT_TRUE(op.can_yield());
+    e::error err;
+    ASSERT_TRUE(op.yield(&status, &err));
+    ASSERT_FALSE(op.can_yield());
+}
+
+// A server that lost some ops to a reconfiguration answers NOTUS for just
+// those; a server that fails outright takes only its own batch with it
+TEST(PendingMultiAtomic, PartialFailure)
+{
+    hyperdex_client_returncode status;
+    hyperdex_client_returncode statuses[4];
+    pending_multi_atomic op(1, &status, statuses);
+    std::vector<size_t> first;
+    first.push_back(0);
+    first.push_back(1);
+    first.push_back(3);
+    std::vector<size_t> second;
+    second.push_back(2);
+    op.expect(virtual_server_id(1), first);
+    op.expect(virtual_server_id(2), second);
+    op.handle_sent_to(server_id(10), virtual_server_id(1));
+    op.handle_sent_to(server_id(20), virtual_server_id(2));
+
+    std::vector<hyperdex::network_returncode> results;
+    results.push_back(hyperdex::NET_SUCCESS);
+    results.push_back(hyperdex::NET_NOTUS);
+    results.push_back(hyperdex::NET_SUCCESS);
+    ASSERT_TRUE(deliver(&op, server_id(10), virtual_server_id(1),
+                        multi_atomic_response(results)));
+    ASSERT_EQ(HYPERDEX_CLIENT_SUCCESS, statuses[0]);
+    ASSERT_EQ(HYPERDEX_CLIENT_RECONFIGURE, statuses[1]);
+    ASSERT_EQ(HYPERDEX_CLIENT_SUCCESS, statuses[3]);
+    ASSERT_EQ(HYPERDEX_CLIENT_SUCCESS, status);
+
+    op.handle_failure(server_id(20), virtual_server_id(2));
+    ASSERT_EQ(HYPERDEX_CLIENT_RECONFIGURE, statuses[2]);
+    ASSERT_EQ(HYPERDEX_CLIENT_SUCCESS, statuses[0]);
+    ASSERT_EQ(HYPERDEX_CLIENT_SUCCESS, statuses[3]);
+    ASSERT_EQ(HYPERDEX_CLIENT_RECONFIGURE, status);
+    ASSERT_TRUE(op.can_yield());
+}
+
+// A response whose count disagrees with the batch poisons only that batch
+TEST(PendingMultiAtomic, CorruptResponse)
+{
+    hyperdex_client_returncode status;
+    hyperdex_client_returncode statuses[3];
+    pending_multi_atomic op(1, &status, statuses);
+    std::vector<size_t> first;
+    first.push_back(0);
+    first.push_back(1);
+    std::vector<size_t> second;
+    second.push_back(2);
+    op.expect(virtual_server_id(1), first);
+    op.expect(virtual_server_id(2), second);
+    op.handle_sent_to(server_id(10), virtual_server_id(1));
+    op.handle_sent_to(server_id(20), virtual_server_id(2));
+
+    std::vector<hyperdex::network_returncode> results;
+    results.push_back(hyperdex::NET_SUCCESS);
+    ASSERT_TRUE(deliver(&op, server_id(10), virtual_server_id(1),
+                        multi_atomic_response(results)));
+    ASSERT_EQ(HYPERDEX_CLIENT_SERVERERROR, statuses[0]);
+    ASSERT_EQ(HYPERDEX_CLIENT_SERVERERROR, statuses[1]);
+    ASSERT_EQ(HYPERDEX_CLIENT_GARBAGE, statuses[2]);
+    ASSERT_EQ(HYPERDEX_CLIENT_SERVERERROR, status);
+
+    ASSERT_TRUE(deliver(&op, server_id(20), virtual_server_id(2),
+                        multi_atomic_response(results)));
+    ASSERT_EQ(HYPERDEX_CLIENT_SUCCESS, statuses[2]);
+    ASSERT_TRUE(op.can_yield());
+}
@@ -0,0 +1,154 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <stdint.h>
+
+// STL
+#include <memory>
+#include <vector>
+
+// e
+#include <e/buffer.h>
+#include <e/serialization.h>
+
+// HyperDex
+#include "test/th.h"
+#include "client/pending_sorted_search.h"
+
+using hyperdex::pending_aggregation;
+using hyperdex::pending_sorted_search;
+using hyperdex::server_id;
+using hyperdex::virtual_server_id;
+
+namespace
+{
+
+bool
+deliver(pending_sorted_search* op,
+        const server_id& si,
+        const virtual_server_id& vsi,
+        hyperdex::network_msgtype mt,
+        uint64_t num_results)
+{
+    std::auto_ptr<e::buffer> msg(e::buffer::create(sizeof(uint64_t) + num_results * 64));
+    e::packer pa = msg->pack_at(0);
+    pa = pa << num_results;
+
+    for (uint64_t i = 0; i < num_results; ++i)
+    {
+        pa = pa << e::slice("key", 3) << std::vector<e::slice>();
+    }
+
+    hyperdex_client_returncode status;
+    e::error err;
+    e::unpacker up = msg->unpack_from(0);
+    return op->handle_message(NULL, si, vsi, mt, msg, up, &status, &err);
+}
+
+// handle_sent_to on the op itself wants the client's configuration
+void
+sent_to(pending_sorted_search* op,
+        const server_id& si,
+        const virtual_server_id& vsi)
+{
+    op->pending_aggregation::handle_sent_to(si, vsi);
+}
+
+} // namespace
+
+// a server that answers with the wrong message type fails the search once;
+// the other server's results are not handed out because the merged top-k
+// would be missing the failed server's objects
+TEST(PendingSortedSearch, BadResponseYieldsErrorThenDone)
+{
+    hyperdex_client_returncode status;
+    pending_sorted_search op(NULL, 1, false, 10, 1, NULL, &status, NULL, NULL);
+    sent_to(&op, server_id(10), virtual_server_id(1));
+    sent_to(&op, server_id(20), virtual_server_id(2));
+
+    ASSERT_TRUE(deliver(&op, server_id(10), virtual_server_id(1),
+                        hyperdex::RESP_GET, 0));
+    ASSERT_TRUE(op.can_yield());
+    hyperdex_client_returncode rc;
+    e::error err;
+    ASSERT_TRUE(op.yield(&rc, &err));
+    ASSERT_EQ(HYPERDEX_CLIENT_SERVERERROR, status);
+    ASSERT_FALSE(op.can_yield());
+
+    ASSERT_TRUE(deliver(&op, server_id(20), virtual_server_id(2),
+                        hyperdex::RESP_SORTED_SEARCH, 1));
+    ASSERT_TRUE(op.can_yield());
+    ASSERT_TRUE(op.yield(&rc, &err));
+    ASSERT_EQ(HYPERDEX_CLIENT_SEARCHDONE, status);
+    ASSERT_FALSE(op.can_yield());
+}
+
+TEST(PendingSortedSearch, FailureBeforeResults)
+{
+    hyperdex_client_returncode status;
+    pending_sorted_search op(NULL, 1, false, 10, 1, NULL, &status, NULL, NULL);
+    sent_to(&op, server_id(10), virtual_server_id(1));
+    sent_to(&op, server_id(20), virtual_server_id(2));
+
+    op.handle_failure(server_id(10), virtual_server_id(1));
+    ASSERT_TRUE(op.can_yield());
+    hyperdex_client_returncode rc;
+    e::error err;
+    ASSERT_TRUE(op.yield(&rc, &err));
+    ASSERT_EQ(HYPERDEX_CLIENT_RECONFIGURE, status);
+    ASSERT_FALSE(op.can_yield());
+
+    ASSERT_TRUE(deliver(&op, server_id(20), virtual_server_id(2),
+                        hyperdex::RESP_SORTED_SEARCH, 2));
+    ASSERT_TRUE(op.can_yield());
+    ASSERT_TRUE(op.yield(&rc, &err));
+    ASSERT_EQ(HYPERDEX_CLIENT_SEARCHDONE, status);
+    ASSERT_FALSE(op.can_yield());
+}
+
+// results arrive from every server before any are handed out
+TEST(PendingSortedSearch, WaitsForEveryServer)
+{
+    hyperdex_client_returncode status;
+    pending_sorted_search op(NULL, 1, false, 10, 1, NULL, &status, NULL, NULL);
+    sent_to(&op, server_id(10), virtual_server_id(1));
+    sent_to(&op, server_id(20), virtual_server_id(2));
+
+    ASSERT_TRUE(deliver(&op, server_id(10), virtual_server_id(1),
+                        hyperdex::RESP_SORTED_SEARCH, 0));
+    ASSERT_FALSE(op.can_yield());
+    ASSERT_TRUE(deliver(&op, server_id(20), virtual_server_id(2),
+                        hyperdex::RESP_SORTED_SEARCH, 0));
+    ASSERT_TRUE(op.can_yield());
+    hyperdex_client_returncode rc;
+    e::error err;
+    ASSERT_TRUE(op.yield(&rc, &err));
+    ASSERT_EQ(HYPERDEX_CLIENT_SEARCHDONE, status);
+    ASSERT_FALSE(op.can_yield());
+}
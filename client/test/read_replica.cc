@@ -0,0 +1,176 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <stdint.h>
+
+// STL
+#include <memory>
+#include <vector>
+
+// e
+#include <e/buffer.h>
+
+// HyperDex
+#include "test/th.h"
+#include "common/network_returncode.h"
+#include "client/client.h"
+#include "client/pending_get.h"
+
+using hyperdex::client;
+using hyperdex::pending_get;
+using hyperdex::server_id;
+using hyperdex::virtual_server_id;
+
+namespace
+{
+
+// point leader 1, middle replica 2, tail 3
+std::vector<virtual_server_id>
+three_replicas()
+{
+    std::vector<virtual_server_id> chain;
+    chain.push_back(virtual_server_id(1));
+    chain.push_back(virtual_server_id(2));
+    chain.push_back(virtual_server_id(3));
+    return chain;
+}
+
+bool
+deliver(pending_get* op, hyperdex::network_returncode rc)
+{
+    std::auto_ptr<e::buffer> msg(e::buffer::create(sizeof(uint16_t)));
+    msg->pack_at(0) << static_cast<uint16_t>(rc);
+    hyperdex_client_returncode status;
+    e::error err;
+    e::unpacker up = msg->unpack_from(0);
+    return op->handle_message(NULL, server_id(10), virtual_server_id(2),
+                              hyperdex::RESP_GET, msg, up, &status, &err);
+}
+
+} // namespace
+
+TEST(ReadReplica, PointLeader)
+{
+    std::vector<virtual_server_id> chain(three_replicas());
+    virtual_server_id fallback;
+
+    for (uint64_t i = 0; i < 3; ++i)
+    {
+        ASSERT_EQ(virtual_server_id(1),
+                  client::choose_read_replica(HYPERDEX_CLIENT_READ_POINT_LEADER,
+                                              chain, i, &fallback));
+        ASSERT_EQ(virtual_server_id(), fallback);
+    }
+}
+
+TEST(ReadReplica, Tail)
+{
+    std::vector<virtual_server_id> chain(three_replicas());
+    virtual_server_id fallback;
+
+    for (uint64_t i = 0; i < 3; ++i)
+    {
+        ASSERT_EQ(virtual_server_id(3),
+                  client::choose_read_replica(HYPERDEX_CLIENT_READ_TAIL,
+                                              chain, i, &fallback));
+        ASSERT_EQ(virtual_server_id(), fallback);
+    }
+}
+
+// reads rotate across the chain; only the middle replica may redirect a read,
+// because the point leader and the tail always hold the latest value
+TEST(ReadReplica, AnyReplicaRotates)
+{
+    std::vector<virtual_server_id> chain(three_replicas());
+    virtual_server_id fallback;
+
+    ASSERT_EQ(virtual_server_id(1),
+              client::choose_read_replica(HYPERDEX_CLIENT_READ_ANY_REPLICA,
+                                          chain, 0, &fallback));
+    ASSERT_EQ(virtual_server_id(), fallback);
+    ASSERT_EQ(virtual_server_id(2),
+              client::choose_read_replica(HYPERDEX_CLIENT_READ_ANY_REPLICA,
+                                          chain, 1, &fallback));
+    ASSERT_EQ(virtual_server_id(3), fallback);
+    ASSERT_EQ(virtual_server_id(3),
+              client::choose_read_replica(HYPERDEX_CLIENT_READ_ANY_REPLICA,
+                                          chain, 2, &fallback));
+    ASSERT_EQ(virtual_server_id(), fallback);
+    ASSERT_EQ(virtual_server_id(1),
+              client::choose_read_replica(HYPERDEX_CLIENT_READ_ANY_REPLICA,
+                                          chain, 3, &fallback));
+    ASSERT_EQ(virtual_server_id(), fallback);
+}
+
+TEST(ReadReplica, AnyReplicaWithoutReplicas)
+{
+    std::vector<virtual_server_id> chain;
+    chain.push_back(virtual_server_id(1));
+    virtual_server_id fallback;
+
+    for (uint64_t i = 0; i < 3; ++i)
+    {
+        ASSERT_EQ(virtual_server_id(1),
+                  client::choose_read_replica(HYPERDEX_CLIENT_READ_ANY_REPLICA,
+                                              chain, i, &fallback));
+        ASSERT_EQ(virtual_server_id(), fallback);
+    }
+}
+
+// the request is handed to the tail once; a second NET_NOTUS is an error
+TEST(ReadReplica, FallbackToTailOnce)
+{
+    hyperdex_client_returncode status = HYPERDEX_CLIENT_GARBAGE;
+    pending_get op(1, &status, NULL, NULL);
+    std::auto_ptr<e::buffer> req(e::buffer::create(8));
+    e::buffer* req_ptr = req.get();
+    op.set_read_fallback(virtual_server_id(3), req);
+
+    virtual_server_id vsi;
+    std::auto_ptr<e::buffer> msg;
+    ASSERT_TRUE(op.take_read_fallback(&vsi, &msg));
+    ASSERT_EQ(virtual_server_id(3), vsi);
+    ASSERT_TRUE(msg.get() == req_ptr);
+    ASSERT_FALSE(op.take_read_fallback(&vsi, &msg));
+
+    op.handle_sent_to(server_id(30), virtual_server_id(3));
+    ASSERT_TRUE(deliver(&op, hyperdex::NET_NOTUS));
+    ASSERT_EQ(HYPERDEX_CLIENT_RECONFIGURE, status);
+    ASSERT_TRUE(op.can_yield());
+}
+
+TEST(ReadReplica, NotUsWithoutFallback)
+{
+    hyperdex_client_returncode status = HYPERDEX_CLIENT_GARBAGE;
+    pending_get op(1, &status, NULL, NULL);
+    op.handle_sent_to(server_id(10), virtual_server_id(1));
+    ASSERT_TRUE(deliver(&op, hyperdex::NET_NOTUS));
+    ASSERT_EQ(HYPERDEX_CLIENT_RECONFIGURE, status);
+    ASSERT_TRUE(op.can_yield());
+}
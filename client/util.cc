@@ -116,7 +116,8 @@ hyperdex :: value_to_attributes(const configuration& config,
 
     for (size_t i = 0; i < value.size(); ++i)
     {
-        if (sc->attrs[i + 1].type == HYPERDATATYPE_MACAROON_SECRET)
+        if (sc->attrs[i + 1].type == HYPERDATATYPE_MACAROON_SECRET ||
+            sc->hidden_attr(i + 1))
         {
             continue;
         }
@@ -160,7 +161,8 @@ hyperdex :: value_to_attributes(const configuration& config,
 
     for (size_t i = 0; i < value.size(); ++i)
     {
-        uint16_t attr = value[i].first;
+        uint16_t attr = value[i].first & ~HYPERDEX_ATTRIBUTE_LENGTH_BIT;
+        bool is_length = value[i].first & HYPERDEX_ATTRIBUTE_LENGTH_BIT;
 
         if (attr >= sc->attrs_sz)
         {
@@ -171,6 +173,14 @@ hyperdex :: value_to_attributes(const configuration& config,
         }
 
         sz += strlen(sc->attrs[attr].name) + 1 + value[i].second.size();
+
+        if (is_length)
+        {
+            // lengths are always int64, and server/client forms match
+            sz += strlen(HYPERDEX_ATTRIBUTE_LENGTH_PREFIX);
+            continue;
+        }
+
         datatype_info* di = datatype_info::lookup(sc->attrs[attr].type);
 
         if (convert_types)
@@ -198,22 +208,33 @@ hyperdex :: value_to_attributes(const configuration& config,
 
     for (size_t i = 0; i < value.size(); ++i)
     {
-        if (sc->attrs[i + 1].type == HYPERDATATYPE_MACAROON_SECRET)
+        uint16_t attr = value[i].first & ~HYPERDEX_ATTRIBUTE_LENGTH_BIT;
+        bool is_length = value[i].first & HYPERDEX_ATTRIBUTE_LENGTH_BIT;
+
+        if ((sc->attrs[attr].type == HYPERDATATYPE_MACAROON_SECRET && !is_length) ||
+            sc->hidden_attr(attr))
         {
             continue;
         }
 
-        uint16_t attr = value[i].first;
         ha.push_back(hyperdex_client_attribute());
-        size_t attr_sz = strlen(sc->attrs[attr].name) + 1;
         ha.back().attr = data;
+
+        if (is_length)
+        {
+            size_t prefix_sz = strlen(HYPERDEX_ATTRIBUTE_LENGTH_PREFIX);
+            memmove(data, HYPERDEX_ATTRIBUTE_LENGTH_PREFIX, prefix_sz);
+            data += prefix_sz;
+        }
+
+        size_t attr_sz = strlen(sc->attrs[attr].name) + 1;
         memmove(data, sc->attrs[attr].name, attr_sz);
         data += attr_sz;
         ha.back().value = data;
         memmove(data, value[i].second.data(), value[i].second.size());
         data += value[i].second.size();
         ha.back().value_sz = value[i].second.size();
-        ha.back().datatype = sc->attrs[attr].type;
+        ha.back().datatype = is_length ? HYPERDATATYPE_INT64 : sc->attrs[attr].type;
     }
 
     memmove(ret, &ha.front(), sizeof(hyperdex_client_attribute) * ha.size());
@@ -32,6 +32,12 @@
 #include "namespace.h"
 #include "hyperdex.h"
 
+// get_partial may ask for the length of an attribute (e.g., the estimate held
+// in a sketch) instead of its value by naming it "length:<attr>"; on the wire
+// such requests carry the attribute number with this bit set.
+#define HYPERDEX_ATTRIBUTE_LENGTH_PREFIX "length:"
+#define HYPERDEX_ATTRIBUTE_LENGTH_BIT 0x8000U
+
 BEGIN_HYPERDEX_NAMESPACE
 
 class attribute
@@ -25,6 +25,9 @@
 // ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
 // POSSIBILITY OF SUCH DAMAGE.
 
+// C
+#include <cstring>
+
 // e
 #include <e/endian.h>
 
@@ -93,6 +96,9 @@ hyperdex :: validate_attribute_check(hyperdatatype type,
         case HYPERPREDICATE_CONTAINS:
             return di_attr->has_contains() &&
                    di_attr->contains_datatype() == di_check->datatype();
+        case HYPERPREDICATE_STARTS_WITH:
+            return di_attr->datatype() == HYPERDATATYPE_STRING &&
+                   di_check->datatype() == HYPERDATATYPE_STRING;
         default:
             return false;
     }
@@ -201,6 +207,11 @@ hyperdex :: passes_attribute_check(hyperdatatype type,
             return di_attr->has_contains() &&
                    di_attr->contains_datatype() == di_check->datatype() &&
                    di_attr->contains(value, check.value);
+        case HYPERPREDICATE_STARTS_WITH:
+            return di_attr->datatype() == HYPERDATATYPE_STRING &&
+                   di_check->datatype() == HYPERDATATYPE_STRING &&
+                   value.size() >= check.value.size() &&
+                   memcmp(value.data(), check.value.data(), check.value.size()) == 0;
         default:
             return false;
     }
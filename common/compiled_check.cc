@@ -0,0 +1,636 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <cassert>
+#include <cstring>
+
+// STL
+#include <algorithm>
+#include <list>
+
+// The widest ISA the compiler targets picks the filter loops.  SSE2 is part of
+// x86-64, so a default build compares float columns two at a time; int64 and
+// timestamp columns need SSE4.2's 64-bit compare and stay scalar unless the
+// target (e.g. -march) provides it.
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_2__)
+#include <nmmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// po6
+#include <po6/threads/mutex.h>
+
+// e
+#include <e/endian.h>
+
+// HyperDex
+#include "common/compiled_check.h"
+
+using hyperdex::compiled_check;
+using hyperdex::regex_dfa;
+
+namespace
+{
+
+// Decode a fixed-width number the way datatype_int64/datatype_float do:  the
+// empty slice is zero, and anything other than eight bytes is invalid.
+inline bool
+decode_int64(const e::slice& value, int64_t* num)
+{
+    if (value.size() == sizeof(int64_t))
+    {
+        e::unpack64le(value.data(), num);
+        return true;
+    }
+
+    *num = 0;
+    return value.empty();
+}
+
+inline bool
+decode_double(const e::slice& value, double* num)
+{
+    if (value.size() == sizeof(double))
+    {
+        e::unpackdoublele(value.data(), num);
+        return true;
+    }
+
+    *num = 0;
+    return value.empty();
+}
+
+// Matches datatype_float's compare, which treats NaN as equal to everything
+template <typename T>
+inline int
+compare_num(T lhs, T rhs)
+{
+    if (lhs < rhs)
+    {
+        return -1;
+    }
+
+    if (lhs > rhs)
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+// A block's worth of decoded values lives on the stack
+#define BATCH_COLUMN_SZ 256
+
+// Clear mask[i] unless "c" relates to column[i] in one of the permitted ways.
+// "lt" is c < column[i], "gt" is c > column[i], and "eq" is neither, which is
+// also how compare_num treats NaN.
+void
+filter_int64(int64_t c, const int64_t* column, size_t column_sz,
+             bool pass_lt, bool pass_gt, bool pass_eq, uint8_t* mask)
+{
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i vc = _mm256_set1_epi64x(c);
+    const __m256i mlt = _mm256_set1_epi64x(pass_lt ? -1 : 0);
+    const __m256i mgt = _mm256_set1_epi64x(pass_gt ? -1 : 0);
+    const __m256i meq = _mm256_set1_epi64x(pass_eq ? -1 : 0);
+
+    for (; i + 4 <= column_sz; i += 4)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(column + i));
+        __m256i lt = _mm256_cmpgt_epi64(v, vc);
+        __m256i gt = _mm256_cmpgt_epi64(vc, v);
+        __m256i pass = _mm256_or_si256(_mm256_and_si256(lt, mlt),
+                                       _mm256_and_si256(gt, mgt));
+        pass = _mm256_or_si256(pass, _mm256_andnot_si256(_mm256_or_si256(lt, gt), meq));
+        int bits = _mm256_movemask_pd(_mm256_castsi256_pd(pass));
+        mask[i + 0] &= bits & 1;
+        mask[i + 1] &= (bits >> 1) & 1;
+        mask[i + 2] &= (bits >> 2) & 1;
+        mask[i + 3] &= (bits >> 3) & 1;
+    }
+#elif defined(__SSE4_2__)
+    const __m128i vc = _mm_set1_epi64x(c);
+    const __m128i mlt = _mm_set1_epi64x(pass_lt ? -1 : 0);
+    const __m128i mgt = _mm_set1_epi64x(pass_gt ? -1 : 0);
+    const __m128i meq = _mm_set1_epi64x(pass_eq ? -1 : 0);
+
+    for (; i + 2 <= column_sz; i += 2)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + i));
+        __m128i lt = _mm_cmpgt_epi64(v, vc);
+        __m128i gt = _mm_cmpgt_epi64(vc, v);
+        __m128i pass = _mm_or_si128(_mm_and_si128(lt, mlt),
+                                    _mm_and_si128(gt, mgt));
+        pass = _mm_or_si128(pass, _mm_andnot_si128(_mm_or_si128(lt, gt), meq));
+        int bits = _mm_movemask_pd(_mm_castsi128_pd(pass));
+        mask[i + 0] &= bits & 1;
+        mask[i + 1] &= (bits >> 1) & 1;
+    }
+#endif
+
+    for (; i < column_sz; ++i)
+    {
+        int cmp = compare_num(c, column[i]);
+        bool pass = (cmp < 0 && pass_lt) || (cmp > 0 && pass_gt) || (cmp == 0 && pass_eq);
+        mask[i] &= pass ? 1 : 0;
+    }
+}
+
+void
+filter_double(double c, const double* column, size_t column_sz,
+              bool pass_lt, bool pass_gt, bool pass_eq, uint8_t* mask)
+{
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256d vc = _mm256_set1_pd(c);
+    const __m256d ones = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d mlt = pass_lt ? ones : zero;
+    const __m256d mgt = pass_gt ? ones : zero;
+    const __m256d meq = pass_eq ? ones : zero;
+
+    for (; i + 4 <= column_sz; i += 4)
+    {
+        __m256d v = _mm256_loadu_pd(column + i);
+        __m256d lt = _mm256_cmp_pd(vc, v, _CMP_LT_OQ);
+        __m256d gt = _mm256_cmp_pd(vc, v, _CMP_GT_OQ);
+        __m256d pass = _mm256_or_pd(_mm256_and_pd(lt, mlt),
+                                    _mm256_and_pd(gt, mgt));
+        pass = _mm256_or_pd(pass, _mm256_andnot_pd(_mm256_or_pd(lt, gt), meq));
+        int bits = _mm256_movemask_pd(pass);
+        mask[i + 0] &= bits & 1;
+        mask[i + 1] &= (bits >> 1) & 1;
+        mask[i + 2] &= (bits >> 2) & 1;
+        mask[i + 3] &= (bits >> 3) & 1;
+    }
+#elif defined(__SSE2__)
+    const __m128d vc = _mm_set1_pd(c);
+    const __m128d ones = _mm_castsi128_pd(_mm_set1_epi32(-1));
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d mlt = pass_lt ? ones : zero;
+    const __m128d mgt = pass_gt ? ones : zero;
+    const __m128d meq = pass_eq ? ones : zero;
+
+    for (; i + 2 <= column_sz; i += 2)
+    {
+        __m128d v = _mm_loadu_pd(column + i);
+        __m128d lt = _mm_cmplt_pd(vc, v);
+        __m128d gt = _mm_cmpgt_pd(vc, v);
+        __m128d pass = _mm_or_pd(_mm_and_pd(lt, mlt),
+                                 _mm_and_pd(gt, mgt));
+        pass = _mm_or_pd(pass, _mm_andnot_pd(_mm_or_pd(lt, gt), meq));
+        int bits = _mm_movemask_pd(pass);
+        mask[i + 0] &= bits & 1;
+        mask[i + 1] &= (bits >> 1) & 1;
+    }
+#endif
+
+    for (; i < column_sz; ++i)
+    {
+        int cmp = compare_num(c, column[i]);
+        bool pass = (cmp < 0 && pass_lt) || (cmp > 0 && pass_gt) || (cmp == 0 && pass_eq);
+        mask[i] &= pass ? 1 : 0;
+    }
+}
+
+// Hands out regex_dfas by pattern.  A borrowed automaton belongs to one search
+// at a time; when returned, it is kept (with the states it has built) for the
+// next search to use the same pattern.
+#define REGEX_CACHE_SZ 64
+
+class regex_cache
+{
+    public:
+        regex_cache();
+        ~regex_cache() throw ();
+
+    public:
+        regex_dfa* acquire(const e::slice& pattern);
+        void release(regex_dfa* dfa);
+
+    private:
+        po6::threads::mutex m_protect;
+        std::list<regex_dfa*> m_idle;
+
+    private:
+        regex_cache(const regex_cache&);
+        regex_cache& operator = (const regex_cache&);
+};
+
+regex_cache :: regex_cache()
+    : m_protect()
+    , m_idle()
+{
+}
+
+regex_cache :: ~regex_cache() throw ()
+{
+    for (std::list<regex_dfa*>::iterator it = m_idle.begin();
+            it != m_idle.end(); ++it)
+    {
+        delete *it;
+    }
+}
+
+regex_dfa*
+regex_cache :: acquire(const e::slice& pattern)
+{
+    {
+        po6::threads::mutex::hold hold(&m_protect);
+
+        for (std::list<regex_dfa*>::iterator it = m_idle.begin();
+                it != m_idle.end(); ++it)
+        {
+            const std::string& p((*it)->pattern());
+
+            if (p.size() == pattern.size() &&
+                memcmp(p.data(), pattern.data(), p.size()) == 0)
+            {
+                regex_dfa* dfa = *it;
+                m_idle.erase(it);
+                return dfa;
+            }
+        }
+    }
+
+    return new regex_dfa(pattern.data(), pattern.size());
+}
+
+void
+regex_cache :: release(regex_dfa* dfa)
+{
+    regex_dfa* evicted = NULL;
+
+    {
+        po6::threads::mutex::hold hold(&m_protect);
+        m_idle.push_front(dfa);
+
+        if (m_idle.size() > REGEX_CACHE_SZ)
+        {
+            evicted = m_idle.back();
+            m_idle.pop_back();
+        }
+    }
+
+    delete evicted;
+}
+
+regex_cache s_regexes;
+
+} // namespace
+
+compiled_check :: compiled_check()
+    : m_type(HYPERDATATYPE_GARBAGE)
+    , m_check()
+    , m_i(0)
+    , m_d(0)
+    , m_eval(&compiled_check::generic)
+    , m_batch(HYPERDATATYPE_GARBAGE)
+    , m_pass_lt(false)
+    , m_pass_gt(false)
+    , m_pass_eq(false)
+    , m_regex(NULL)
+{
+}
+
+compiled_check :: compiled_check(const compiled_check& other)
+    : m_type(HYPERDATATYPE_GARBAGE)
+    , m_check()
+    , m_i(0)
+    , m_d(0)
+    , m_eval(&compiled_check::generic)
+    , m_batch(HYPERDATATYPE_GARBAGE)
+    , m_pass_lt(false)
+    , m_pass_gt(false)
+    , m_pass_eq(false)
+    , m_regex(NULL)
+{
+    compile(other.m_type, other.m_check);
+}
+
+compiled_check :: ~compiled_check() throw ()
+{
+    if (m_regex)
+    {
+        s_regexes.release(m_regex);
+    }
+}
+
+compiled_check&
+compiled_check :: operator = (const compiled_check& rhs)
+{
+    if (this != &rhs)
+    {
+        compile(rhs.m_type, rhs.m_check);
+    }
+
+    return *this;
+}
+
+bool
+compiled_check :: generic(const compiled_check& cc, const e::slice& value)
+{
+    return passes_attribute_check(cc.m_type, cc.m_check, value);
+}
+
+template <hyperdatatype D, hyperpredicate P>
+bool
+compiled_check :: evaluate(const compiled_check& cc, const e::slice& value)
+{
+    return generic(cc, value);
+}
+
+#define INT64_EVALUATOR(P, OP) \
+    template <> \
+    bool \
+    compiled_check :: evaluate<HYPERDATATYPE_INT64, P>(const compiled_check& cc, const e::slice& value) \
+    { \
+        int64_t num; \
+        return decode_int64(value, &num) && compare_num(cc.m_i, num) OP 0; \
+    }
+
+#define FLOAT_EVALUATOR(P, OP) \
+    template <> \
+    bool \
+    compiled_check :: evaluate<HYPERDATATYPE_FLOAT, P>(const compiled_check& cc, const e::slice& value) \
+    { \
+        double num; \
+        return decode_double(value, &num) && compare_num(cc.m_d, num) OP 0; \
+    }
+
+#define LENGTH_EVALUATOR(P, OP) \
+    template <> \
+    bool \
+    compiled_check :: evaluate<HYPERDATATYPE_STRING, P>(const compiled_check& cc, const e::slice& value) \
+    { \
+        return static_cast<int64_t>(value.size()) OP cc.m_i; \
+    }
+
+BEGIN_HYPERDEX_NAMESPACE
+
+// Like passes_attribute_check, these compare the check's constant to the value
+INT64_EVALUATOR(HYPERPREDICATE_EQUALS, ==)
+INT64_EVALUATOR(HYPERPREDICATE_LESS_THAN, >)
+INT64_EVALUATOR(HYPERPREDICATE_LESS_EQUAL, >=)
+INT64_EVALUATOR(HYPERPREDICATE_GREATER_EQUAL, <=)
+INT64_EVALUATOR(HYPERPREDICATE_GREATER_THAN, <)
+FLOAT_EVALUATOR(HYPERPREDICATE_LESS_THAN, >)
+FLOAT_EVALUATOR(HYPERPREDICATE_LESS_EQUAL, >=)
+FLOAT_EVALUATOR(HYPERPREDICATE_GREATER_EQUAL, <=)
+FLOAT_EVALUATOR(HYPERPREDICATE_GREATER_THAN, <)
+LENGTH_EVALUATOR(HYPERPREDICATE_LENGTH_EQUALS, ==)
+LENGTH_EVALUATOR(HYPERPREDICATE_LENGTH_LESS_EQUAL, <=)
+LENGTH_EVALUATOR(HYPERPREDICATE_LENGTH_GREATER_EQUAL, >=)
+
+#undef INT64_EVALUATOR
+#undef FLOAT_EVALUATOR
+#undef LENGTH_EVALUATOR
+
+// Float equality also holds for identical bytes, so that NaN matches itself
+template <>
+bool
+compiled_check :: evaluate<HYPERDATATYPE_FLOAT, HYPERPREDICATE_EQUALS>(const compiled_check& cc, const e::slice& value)
+{
+    double num;
+    return decode_double(value, &num) &&
+           (value == cc.m_check.value || compare_num(cc.m_d, num) == 0);
+}
+
+template <>
+bool
+compiled_check :: evaluate<HYPERDATATYPE_STRING, HYPERPREDICATE_EQUALS>(const compiled_check& cc, const e::slice& value)
+{
+    return value == cc.m_check.value;
+}
+
+template <>
+bool
+compiled_check :: evaluate<HYPERDATATYPE_STRING, HYPERPREDICATE_REGEX>(const compiled_check& cc, const e::slice& value)
+{
+    assert(cc.m_regex);
+    return cc.m_regex->match(value.data(), value.size());
+}
+
+template <>
+bool
+compiled_check :: evaluate<HYPERDATATYPE_STRING, HYPERPREDICATE_STARTS_WITH>(const compiled_check& cc, const e::slice& value)
+{
+    return value.size() >= cc.m_check.value.size() &&
+           memcmp(value.data(), cc.m_check.value.data(), cc.m_check.value.size()) == 0;
+}
+
+END_HYPERDEX_NAMESPACE
+
+template <hyperdatatype D>
+compiled_check::evaluator
+compiled_check :: select(hyperpredicate p)
+{
+    switch (p)
+    {
+        case HYPERPREDICATE_EQUALS:
+            return &compiled_check::evaluate<D, HYPERPREDICATE_EQUALS>;
+        case HYPERPREDICATE_LESS_THAN:
+            return &compiled_check::evaluate<D, HYPERPREDICATE_LESS_THAN>;
+        case HYPERPREDICATE_LESS_EQUAL:
+            return &compiled_check::evaluate<D, HYPERPREDICATE_LESS_EQUAL>;
+        case HYPERPREDICATE_GREATER_EQUAL:
+            return &compiled_check::evaluate<D, HYPERPREDICATE_GREATER_EQUAL>;
+        case HYPERPREDICATE_GREATER_THAN:
+            return &compiled_check::evaluate<D, HYPERPREDICATE_GREATER_THAN>;
+        case HYPERPREDICATE_LENGTH_EQUALS:
+            return &compiled_check::evaluate<D, HYPERPREDICATE_LENGTH_EQUALS>;
+        case HYPERPREDICATE_LENGTH_LESS_EQUAL:
+            return &compiled_check::evaluate<D, HYPERPREDICATE_LENGTH_LESS_EQUAL>;
+        case HYPERPREDICATE_LENGTH_GREATER_EQUAL:
+            return &compiled_check::evaluate<D, HYPERPREDICATE_LENGTH_GREATER_EQUAL>;
+        case HYPERPREDICATE_REGEX:
+            return &compiled_check::evaluate<D, HYPERPREDICATE_REGEX>;
+        case HYPERPREDICATE_STARTS_WITH:
+            return &compiled_check::evaluate<D, HYPERPREDICATE_STARTS_WITH>;
+        case HYPERPREDICATE_FAIL:
+        case HYPERPREDICATE_CONTAINS_LESS_THAN:
+        case HYPERPREDICATE_CONTAINS:
+        default:
+            return NULL;
+    }
+}
+
+void
+compiled_check :: compile(hyperdatatype type, const attribute_check& check)
+{
+    m_type = type;
+    m_check = check;
+    m_i = 0;
+    m_d = 0;
+    m_eval = &compiled_check::generic;
+    m_batch = HYPERDATATYPE_GARBAGE;
+    m_pass_lt = false;
+    m_pass_gt = false;
+    m_pass_eq = false;
+    evaluator eval = NULL;
+
+    if (m_regex)
+    {
+        s_regexes.release(m_regex);
+        m_regex = NULL;
+    }
+    hyperdatatype batch = HYPERDATATYPE_GARBAGE;
+
+    // Specialize only those checks that passes_attribute_check would accept.
+    // Everything else, including every check on a document, keeps the generic
+    // path so that its (possibly false) answer is unchanged.
+    if (!validate_attribute_check(type, check))
+    {
+        return;
+    }
+
+    // timestamps are int64 under the hood and compare as such
+    if ((type == HYPERDATATYPE_INT64 ||
+         CONTAINER_TYPE(type) == HYPERDATATYPE_TIMESTAMP_GENERIC) &&
+        check.datatype == type)
+    {
+        decode_int64(check.value, &m_i);
+        eval = select<HYPERDATATYPE_INT64>(check.predicate);
+        batch = HYPERDATATYPE_INT64;
+    }
+    else if (type == HYPERDATATYPE_FLOAT && check.datatype == HYPERDATATYPE_FLOAT)
+    {
+        decode_double(check.value, &m_d);
+        eval = select<HYPERDATATYPE_FLOAT>(check.predicate);
+        batch = HYPERDATATYPE_FLOAT;
+    }
+    else if (type == HYPERDATATYPE_STRING && check.datatype == HYPERDATATYPE_STRING)
+    {
+        if (check.predicate == HYPERPREDICATE_REGEX)
+        {
+            m_regex = s_regexes.acquire(check.value);
+        }
+
+        eval = select<HYPERDATATYPE_STRING>(check.predicate);
+    }
+    else if (type == HYPERDATATYPE_STRING && check.datatype == HYPERDATATYPE_INT64 &&
+             check.predicate != HYPERPREDICATE_CONTAINS_LESS_THAN)
+    {
+        decode_int64(check.value, &m_i);
+        eval = select<HYPERDATATYPE_STRING>(check.predicate);
+    }
+
+    if (eval)
+    {
+        m_eval = eval;
+    }
+
+    // the predicate says which outcomes of comparing the constant to the
+    // value pass
+    switch (check.predicate)
+    {
+        case HYPERPREDICATE_EQUALS:
+            m_pass_eq = true;
+            break;
+        case HYPERPREDICATE_LESS_THAN:
+            m_pass_gt = true;
+            break;
+        case HYPERPREDICATE_LESS_EQUAL:
+            m_pass_gt = true;
+            m_pass_eq = true;
+            break;
+        case HYPERPREDICATE_GREATER_EQUAL:
+            m_pass_lt = true;
+            m_pass_eq = true;
+            break;
+        case HYPERPREDICATE_GREATER_THAN:
+            m_pass_lt = true;
+            break;
+        case HYPERPREDICATE_FAIL:
+        case HYPERPREDICATE_REGEX:
+        case HYPERPREDICATE_STARTS_WITH:
+        case HYPERPREDICATE_LENGTH_EQUALS:
+        case HYPERPREDICATE_LENGTH_LESS_EQUAL:
+        case HYPERPREDICATE_LENGTH_GREATER_EQUAL:
+        case HYPERPREDICATE_CONTAINS_LESS_THAN:
+        case HYPERPREDICATE_CONTAINS:
+        default:
+            batch = HYPERDATATYPE_GARBAGE;
+            break;
+    }
+
+    m_batch = batch;
+}
+
+void
+compiled_check :: filter(const e::slice* values, size_t values_sz, uint8_t* mask) const
+{
+    if (m_batch == HYPERDATATYPE_GARBAGE)
+    {
+        for (size_t i = 0; i < values_sz; ++i)
+        {
+            mask[i] = mask[i] && passes(values[i]) ? 1 : 0;
+        }
+
+        return;
+    }
+
+    for (size_t off = 0; off < values_sz; off += BATCH_COLUMN_SZ)
+    {
+        size_t sz = std::min(values_sz - off, size_t(BATCH_COLUMN_SZ));
+
+        if (m_batch == HYPERDATATYPE_INT64)
+        {
+            int64_t column[BATCH_COLUMN_SZ];
+
+            for (size_t i = 0; i < sz; ++i)
+            {
+                if (!decode_int64(values[off + i], column + i))
+                {
+                    mask[off + i] = 0;
+                }
+            }
+
+            filter_int64(m_i, column, sz, m_pass_lt, m_pass_gt, m_pass_eq, mask + off);
+        }
+        else
+        {
+            double column[BATCH_COLUMN_SZ];
+
+            for (size_t i = 0; i < sz; ++i)
+            {
+                if (!decode_double(values[off + i], column + i))
+                {
+                    mask[off + i] = 0;
+                }
+            }
+
+            filter_double(m_d, column, sz, m_pass_lt, m_pass_gt, m_pass_eq, mask + off);
+        }
+    }
+}
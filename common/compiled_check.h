@@ -0,0 +1,97 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef hyperdex_common_compiled_check_h_
+#define hyperdex_common_compiled_check_h_
+
+// C
+#include <stdint.h>
+
+// e
+#include <e/slice.h>
+
+// HyperDex
+#include "namespace.h"
+#include "hyperdex.h"
+#include "common/attribute_check.h"
+#include "common/regex_match.h"
+
+BEGIN_HYPERDEX_NAMESPACE
+
+// An attribute_check bound to the type of the attribute it tests.  Compiling
+// resolves the datatype and decodes the constant once, so that evaluating the
+// check against each object in a search is a single indirect call.  Checks
+// with no specialized evaluator fall back to passes_attribute_check, which
+// remains the reference implementation.  Regex checks on strings borrow a
+// regex_dfa from a process-wide cache keyed by pattern, so searches that reuse
+// a pattern also reuse the automaton states built by earlier searches.
+class compiled_check
+{
+    public:
+        compiled_check();
+        compiled_check(const compiled_check& other);
+        ~compiled_check() throw ();
+
+    public:
+        void compile(hyperdatatype type, const attribute_check& check);
+        bool passes(const e::slice& value) const { return m_eval(*this, value); }
+        // Clear mask[i] for every values[i] that fails the check.  Range and
+        // equality checks on int64, float, and timestamp attributes decode the
+        // block into a column and compare it with SIMD when the build allows.
+        bool batchable() const { return m_batch != HYPERDATATYPE_GARBAGE; }
+        void filter(const e::slice* values, size_t values_sz, uint8_t* mask) const;
+
+    private:
+        typedef bool (*evaluator)(const compiled_check& cc, const e::slice& value);
+        // the primary template is the generic path; see compiled_check.cc for
+        // the specializations
+        template <hyperdatatype D, hyperpredicate P>
+        static bool evaluate(const compiled_check& cc, const e::slice& value);
+        static bool generic(const compiled_check& cc, const e::slice& value);
+        template <hyperdatatype D>
+        static evaluator select(hyperpredicate p);
+
+    private:
+        hyperdatatype m_type;
+        attribute_check m_check;
+        int64_t m_i;
+        double m_d;
+        evaluator m_eval;
+        hyperdatatype m_batch;
+        bool m_pass_lt;
+        bool m_pass_gt;
+        bool m_pass_eq;
+        regex_dfa* m_regex;
+
+    public:
+        compiled_check& operator = (const compiled_check& rhs);
+};
+
+END_HYPERDEX_NAMESPACE
+
+#endif // hyperdex_common_compiled_check_h_
@@ -61,6 +61,7 @@ configuration :: configuration()
     , m_subspace_ids_by_region()
     , m_subspace_ids_for_prev()
     , m_subspace_ids_for_next()
+    , m_subspace_ids_for_fanout()
     , m_heads_by_region()
     , m_tails_by_region()
     , m_next_by_virtual()
@@ -83,6 +84,7 @@ configuration :: configuration(const configuration& other)
     , m_subspace_ids_by_region(other.m_subspace_ids_by_region)
     , m_subspace_ids_for_prev(other.m_subspace_ids_for_prev)
     , m_subspace_ids_for_next(other.m_subspace_ids_for_next)
+    , m_subspace_ids_for_fanout(other.m_subspace_ids_for_fanout)
     , m_heads_by_region(other.m_heads_by_region)
     , m_tails_by_region(other.m_tails_by_region)
     , m_next_by_virtual(other.m_next_by_virtual)
@@ -231,6 +233,22 @@ configuration :: get_schema(const region_id& ri) const
     return NULL;
 }
 
+const char*
+configuration :: get_space_name(const region_id& ri) const
+{
+    const schema* sc = get_schema(ri);
+
+    for (size_t s = 0; sc && s < m_spaces.size(); ++s)
+    {
+        if (&m_spaces[s].sc == sc)
+        {
+            return m_spaces[s].name;
+        }
+    }
+
+    return NULL;
+}
+
 const subspace*
 configuration :: get_subspace(const region_id& ri) const
 {
@@ -331,6 +349,21 @@ configuration :: subspace_next(const subspace_id& ss) const
     return subspace_id();
 }
 
+void
+configuration :: subspace_fanout(const subspace_id& ss, std::vector<subspace_id>* fanout) const
+{
+    std::vector<pair_uint64_t>::const_iterator it;
+    it = std::lower_bound(m_subspace_ids_for_fanout.begin(),
+                          m_subspace_ids_for_fanout.end(),
+                          pair_uint64_t(ss.get(), 0));
+
+    while (it != m_subspace_ids_for_fanout.end() && it->first == ss.get())
+    {
+        fanout->push_back(subspace_id(it->second));
+        ++it;
+    }
+}
+
 virtual_server_id
 configuration :: head_of_region(const region_id& ri) const
 {
@@ -503,7 +536,16 @@ configuration :: subspace_adjacent(const virtual_server_id& lhs, const virtual_s
     region_id rrhs = get_region_id(rhs);
     subspace_id slhs = subspace_of(rlhs);
     subspace_id srhs = subspace_of(rrhs);
-    return subspace_next(slhs) == srhs &&
+    bool adjacent = subspace_next(slhs) == srhs;
+
+    if (!adjacent && subspace_prev(srhs) == slhs)
+    {
+        std::vector<subspace_id> fanout;
+        subspace_fanout(slhs, &fanout);
+        adjacent = std::find(fanout.begin(), fanout.end(), srhs) != fanout.end();
+    }
+
+    return adjacent &&
            lhs == tail_of_region(rlhs) &&
            rhs == head_of_region(rrhs);
 }
@@ -960,6 +1002,12 @@ configuration :: dump() const
         out << "space " << s.id.get() << " " << s.name << "\n";
         out << "  fault_tolerance " << s.fault_tolerance << "\n";
         out << "  predecessor_width " << s.predecessor_width << "\n";
+
+        if (s.replication == space::PARALLEL)
+        {
+            out << "  replication parallel\n";
+        }
+
         out << "  schema" << "\n";
 
         for (size_t i = 0; i < s.sc.attrs_sz; ++i)
@@ -974,6 +1022,12 @@ configuration :: dump() const
             out << "    with authorization\n";
         }
 
+        if (s.sc.ttl_attr != 0)
+        {
+            out << "    expire " << s.sc.attrs[s.sc.ttl_attr].name
+                << " after " << s.sc.ttl / 1000000 << " seconds\n";
+        }
+
         for (size_t x = 0; x < s.subspaces.size(); ++x)
         {
             const subspace& ss(s.subspaces[x]);
@@ -1027,6 +1081,34 @@ configuration :: dump() const
             {
                 out << " " << idx.extra.str();
             }
+            else if (idx.type == index::TRIGRAM)
+            {
+                out << " trigram";
+            }
+            else if (idx.type == index::LENGTH)
+            {
+                out << " length";
+            }
+            else if (idx.type == index::BUCKETED)
+            {
+                out << " bucketed";
+            }
+            else if (idx.type == index::COMPOSITE)
+            {
+                std::vector<uint16_t> attrs;
+                unpack_composite_attrs(idx.extra, &attrs);
+                out << " composite";
+
+                for (size_t a = 0; a < attrs.size(); ++a)
+                {
+                    out << (a > 0 ? "," : " ") << attrs[a];
+                }
+            }
+
+            if (!idx.predicate.empty())
+            {
+                out << " partial";
+            }
 
             out << "\n";
         }
@@ -1072,6 +1154,7 @@ configuration :: operator = (const configuration& rhs)
     m_subspace_ids_by_region = rhs.m_subspace_ids_by_region;
     m_subspace_ids_for_prev = rhs.m_subspace_ids_for_prev;
     m_subspace_ids_for_next = rhs.m_subspace_ids_for_next;
+    m_subspace_ids_for_fanout = rhs.m_subspace_ids_for_fanout;
     m_heads_by_region = rhs.m_heads_by_region;
     m_tails_by_region = rhs.m_tails_by_region;
     m_next_by_virtual = rhs.m_next_by_virtual;
@@ -1092,6 +1175,7 @@ configuration :: refill_cache()
     m_subspace_ids_by_region.clear();
     m_subspace_ids_for_prev.clear();
     m_subspace_ids_for_next.clear();
+    m_subspace_ids_for_fanout.clear();
     m_heads_by_region.clear();
     m_tails_by_region.clear();
     m_next_by_virtual.clear();
@@ -1105,16 +1189,29 @@ configuration :: refill_cache()
         {
             subspace& ss(s.subspaces[x]);
 
-            if (x > 0)
+            if (s.replication == space::PARALLEL)
             {
-                m_subspace_ids_for_prev.push_back(std::make_pair(ss.id.get(),
-                                                                 s.subspaces[x - 1].id.get()));
+                if (x > 0)
+                {
+                    m_subspace_ids_for_prev.push_back(std::make_pair(ss.id.get(),
+                                                                     s.subspaces[0].id.get()));
+                    m_subspace_ids_for_fanout.push_back(std::make_pair(s.subspaces[0].id.get(),
+                                                                       ss.id.get()));
+                }
             }
-
-            if (x + 1 < s.subspaces.size())
+            else
             {
-                m_subspace_ids_for_next.push_back(std::make_pair(ss.id.get(),
-                                                                 s.subspaces[x + 1].id.get()));
+                if (x > 0)
+                {
+                    m_subspace_ids_for_prev.push_back(std::make_pair(ss.id.get(),
+                                                                     s.subspaces[x - 1].id.get()));
+                }
+
+                if (x + 1 < s.subspaces.size())
+                {
+                    m_subspace_ids_for_next.push_back(std::make_pair(ss.id.get(),
+                                                                     s.subspaces[x + 1].id.get()));
+                }
             }
 
             for (size_t y = 0; y < ss.regions.size(); ++y)
@@ -1171,6 +1268,7 @@ configuration :: refill_cache()
     std::sort(m_subspace_ids_by_region.begin(), m_subspace_ids_by_region.end());
     std::sort(m_subspace_ids_for_prev.begin(), m_subspace_ids_for_prev.end());
     std::sort(m_subspace_ids_for_next.begin(), m_subspace_ids_for_next.end());
+    std::sort(m_subspace_ids_for_fanout.begin(), m_subspace_ids_for_fanout.end());
     std::sort(m_heads_by_region.begin(), m_heads_by_region.end());
     std::sort(m_tails_by_region.begin(), m_tails_by_region.end());
     std::sort(m_next_by_virtual.begin(), m_next_by_virtual.end());
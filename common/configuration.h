@@ -76,11 +76,15 @@ class configuration
     public:
         const schema* get_schema(const char* space) const;
         const schema* get_schema(const region_id& ri) const;
+        const char* get_space_name(const region_id& ri) const;
         const subspace* get_subspace(const region_id& ri) const;
         virtual_server_id get_virtual(const region_id& ri, const server_id& si) const;
         subspace_id subspace_of(const region_id& ri) const;
         subspace_id subspace_prev(const subspace_id& ss) const;
         subspace_id subspace_next(const subspace_id& ss) const;
+        // subspaces that the key subspace ss forwards to in parallel; empty
+        // for spaces that replicate their subspaces serially
+        void subspace_fanout(const subspace_id& ss, std::vector<subspace_id>* fanout) const;
         virtual_server_id head_of_region(const region_id& ri) const;
         virtual_server_id tail_of_region(const region_id& ri) const;
         virtual_server_id next_in_region(const virtual_server_id& vsi) const;
@@ -91,7 +95,8 @@ class configuration
         // point leader for this key in the same space as ri
         virtual_server_id point_leader(const region_id& ri, const e::slice& key) const;
         // lhs and rhs are in adjacent subspaces such that lhs sends CHAIN_PUT
-        // to rhs and rhs sends CHAIN_ACK to lhs
+        // to rhs and rhs sends CHAIN_ACK to lhs (with parallel replication,
+        // every subspace is adjacent to the key subspace)
         bool subspace_adjacent(const virtual_server_id& lhs, const virtual_server_id& rhs) const;
         // mapped regions -- regions mapped for server "us"
         void mapped_regions(const server_id& s, std::vector<region_id>* servers) const;
@@ -164,6 +169,7 @@ class configuration
         std::vector<pair_uint64_t> m_subspace_ids_by_region;
         std::vector<pair_uint64_t> m_subspace_ids_for_prev;
         std::vector<pair_uint64_t> m_subspace_ids_for_next;
+        std::vector<pair_uint64_t> m_subspace_ids_for_fanout;
         std::vector<pair_uint64_t> m_heads_by_region;
         std::vector<pair_uint64_t> m_tails_by_region;
         std::vector<pair_uint64_t> m_next_by_virtual;
@@ -0,0 +1,968 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#define __STDC_LIMIT_MACROS
+
+// C
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+// STL
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// e
+#include <e/endian.h>
+
+// HyperDex
+#include "common/datatype_bitmap.h"
+
+using hyperdex::datatype_bitmap;
+
+const size_t datatype_bitmap::ARRAY_MAX;
+const size_t datatype_bitmap::BITMAP_WORDS;
+
+#define HEADER_SZ (sizeof(uint16_t) + sizeof(uint8_t) + sizeof(uint16_t))
+#define KIND_ARRAY 0
+#define KIND_BITMAP 1
+
+namespace
+{
+
+// One container, decoded for modification.  Either "array" holds the sorted
+// low bits, or "words" holds BITMAP_WORDS words of bits; "card" is kept up to
+// date by every operation.
+struct container
+{
+    container() : key(0), is_bitmap(false), card(0), array(), words() {}
+    uint16_t key;
+    bool is_bitmap;
+    uint32_t card;
+    std::vector<uint16_t> array;
+    std::vector<uint64_t> words;
+};
+
+typedef std::vector<container> roaring;
+
+// A container as it sits in an encoded value
+struct encoded_container
+{
+    encoded_container() : key(0), kind(0), card(0), payload(NULL) {}
+    uint16_t key;
+    uint8_t kind;
+    uint32_t card;
+    const uint8_t* payload;
+};
+
+size_t
+payload_size(uint8_t kind, uint32_t card)
+{
+    return kind == KIND_ARRAY ? card * sizeof(uint16_t)
+                              : datatype_bitmap::BITMAP_WORDS * sizeof(uint64_t);
+}
+
+// Step over the container at *ptr.  Checks only that it fits in the value.
+bool
+step_container(const uint8_t** ptr, const uint8_t* end, encoded_container* ec)
+{
+    if (static_cast<size_t>(end - *ptr) < HEADER_SZ)
+    {
+        return false;
+    }
+
+    uint16_t card_minus_one;
+    e::unpack16le(*ptr, &ec->key);
+    ec->kind = (*ptr)[sizeof(uint16_t)];
+    e::unpack16le(*ptr + sizeof(uint16_t) + sizeof(uint8_t), &card_minus_one);
+    ec->card = static_cast<uint32_t>(card_minus_one) + 1;
+    ec->payload = *ptr + HEADER_SZ;
+
+    if (ec->kind != KIND_ARRAY && ec->kind != KIND_BITMAP)
+    {
+        return false;
+    }
+
+    size_t sz = payload_size(ec->kind, ec->card);
+
+    if (static_cast<size_t>(end - ec->payload) < sz)
+    {
+        return false;
+    }
+
+    *ptr = ec->payload + sz;
+    return true;
+}
+
+inline uint16_t
+array_at(const encoded_container& ec, size_t idx)
+{
+    uint16_t x;
+    e::unpack16le(ec.payload + idx * sizeof(uint16_t), &x);
+    return x;
+}
+
+inline uint64_t
+word_at(const encoded_container& ec, size_t idx)
+{
+    uint64_t x;
+    e::unpack64le(ec.payload + idx * sizeof(uint64_t), &x);
+    return x;
+}
+
+bool
+encoded_contains(const encoded_container& ec, uint16_t low)
+{
+    if (ec.kind == KIND_BITMAP)
+    {
+        return word_at(ec, low / 64) & (1ULL << (low % 64));
+    }
+
+    size_t lo = 0;
+    size_t hi = ec.card;
+
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        uint16_t x = array_at(ec, mid);
+
+        if (x == low)
+        {
+            return true;
+        }
+        else if (x < low)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return false;
+}
+
+uint32_t
+popcount(const uint64_t* words)
+{
+    uint32_t card = 0;
+
+    for (size_t i = 0; i < datatype_bitmap::BITMAP_WORDS; ++i)
+    {
+        card += __builtin_popcountll(words[i]);
+    }
+
+    return card;
+}
+
+// The word-at-a-time kernels behind union/intersect/difference of two bitmap
+// containers.  Each writes into "dst" and returns the new cardinality.
+enum word_op { WORD_OR, WORD_AND, WORD_ANDNOT };
+
+uint32_t
+combine_words(word_op op, uint64_t* dst, const uint64_t* src)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 2 <= datatype_bitmap::BITMAP_WORDS; i += 2)
+    {
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+
+        switch (op)
+        {
+            case WORD_OR:
+                d = _mm_or_si128(d, s);
+                break;
+            case WORD_AND:
+                d = _mm_and_si128(d, s);
+                break;
+            case WORD_ANDNOT:
+                // _mm_andnot_si128 negates its first argument
+                d = _mm_andnot_si128(s, d);
+                break;
+            default:
+                abort();
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), d);
+    }
+#endif
+
+    for (; i < datatype_bitmap::BITMAP_WORDS; ++i)
+    {
+        switch (op)
+        {
+            case WORD_OR:
+                dst[i] |= src[i];
+                break;
+            case WORD_AND:
+                dst[i] &= src[i];
+                break;
+            case WORD_ANDNOT:
+                dst[i] &= ~src[i];
+                break;
+            default:
+                abort();
+        }
+    }
+
+    return popcount(dst);
+}
+
+void
+decode_container(const encoded_container& ec, container* c)
+{
+    c->key = ec.key;
+    c->card = ec.card;
+    c->is_bitmap = ec.kind == KIND_BITMAP;
+    c->array.clear();
+    c->words.clear();
+
+    if (c->is_bitmap)
+    {
+        c->words.resize(datatype_bitmap::BITMAP_WORDS);
+
+        for (size_t i = 0; i < datatype_bitmap::BITMAP_WORDS; ++i)
+        {
+            c->words[i] = word_at(ec, i);
+        }
+    }
+    else
+    {
+        c->array.resize(ec.card);
+
+        for (size_t i = 0; i < ec.card; ++i)
+        {
+            c->array[i] = array_at(ec, i);
+        }
+    }
+}
+
+// The caller must have validated "value"
+void
+decode(const e::slice& value, roaring* r)
+{
+    const uint8_t* ptr = value.data();
+    const uint8_t* end = value.data() + value.size();
+    encoded_container ec;
+    r->clear();
+
+    while (ptr < end)
+    {
+        bool stepped = step_container(&ptr, end, &ec);
+        assert(stepped);
+        r->push_back(container());
+        decode_container(ec, &r->back());
+    }
+}
+
+void
+to_bitmap(container* c)
+{
+    if (c->is_bitmap)
+    {
+        return;
+    }
+
+    c->words.assign(datatype_bitmap::BITMAP_WORDS, 0);
+
+    for (size_t i = 0; i < c->array.size(); ++i)
+    {
+        c->words[c->array[i] / 64] |= 1ULL << (c->array[i] % 64);
+    }
+
+    c->array.clear();
+    c->is_bitmap = true;
+}
+
+bool
+container_contains(const container& c, uint16_t low)
+{
+    if (c.is_bitmap)
+    {
+        return c.words[low / 64] & (1ULL << (low % 64));
+    }
+
+    return std::binary_search(c.array.begin(), c.array.end(), low);
+}
+
+void
+container_add(container* c, uint16_t low)
+{
+    if (!c->is_bitmap)
+    {
+        std::vector<uint16_t>::iterator it;
+        it = std::lower_bound(c->array.begin(), c->array.end(), low);
+
+        if (it != c->array.end() && *it == low)
+        {
+            return;
+        }
+
+        if (c->array.size() < datatype_bitmap::ARRAY_MAX)
+        {
+            c->array.insert(it, low);
+            ++c->card;
+            return;
+        }
+
+        to_bitmap(c);
+    }
+
+    uint64_t bit = 1ULL << (low % 64);
+
+    if (!(c->words[low / 64] & bit))
+    {
+        c->words[low / 64] |= bit;
+        ++c->card;
+    }
+}
+
+void
+container_remove(container* c, uint16_t low)
+{
+    if (!c->is_bitmap)
+    {
+        std::vector<uint16_t>::iterator it;
+        it = std::lower_bound(c->array.begin(), c->array.end(), low);
+
+        if (it != c->array.end() && *it == low)
+        {
+            c->array.erase(it);
+            --c->card;
+        }
+
+        return;
+    }
+
+    uint64_t bit = 1ULL << (low % 64);
+
+    if (c->words[low / 64] & bit)
+    {
+        c->words[low / 64] &= ~bit;
+        --c->card;
+    }
+}
+
+void
+container_union(container* dst, const container& src)
+{
+    if (!dst->is_bitmap && !src.is_bitmap &&
+        dst->array.size() + src.array.size() <= datatype_bitmap::ARRAY_MAX)
+    {
+        std::vector<uint16_t> out(dst->array.size() + src.array.size());
+        std::vector<uint16_t>::iterator it;
+        it = std::set_union(dst->array.begin(), dst->array.end(),
+                            src.array.begin(), src.array.end(), out.begin());
+        out.resize(it - out.begin());
+        dst->array.swap(out);
+        dst->card = dst->array.size();
+        return;
+    }
+
+    to_bitmap(dst);
+
+    if (src.is_bitmap)
+    {
+        dst->card = combine_words(WORD_OR, &dst->words[0], &src.words[0]);
+        return;
+    }
+
+    for (size_t i = 0; i < src.array.size(); ++i)
+    {
+        dst->words[src.array[i] / 64] |= 1ULL << (src.array[i] % 64);
+    }
+
+    dst->card = popcount(&dst->words[0]);
+}
+
+// keep the members of "dst" for which container_contains(src) == keep
+void
+container_filter(container* dst, const container& src, bool keep)
+{
+    if (!dst->is_bitmap)
+    {
+        size_t out = 0;
+
+        for (size_t i = 0; i < dst->array.size(); ++i)
+        {
+            if (container_contains(src, dst->array[i]) == keep)
+            {
+                dst->array[out] = dst->array[i];
+                ++out;
+            }
+        }
+
+        dst->array.resize(out);
+        dst->card = out;
+        return;
+    }
+
+    if (src.is_bitmap)
+    {
+        dst->card = combine_words(keep ? WORD_AND : WORD_ANDNOT,
+                                  &dst->words[0], &src.words[0]);
+        return;
+    }
+
+    if (keep)
+    {
+        // the intersection is no larger than the array, so keep it as one
+        std::vector<uint16_t> out;
+
+        for (size_t i = 0; i < src.array.size(); ++i)
+        {
+            if (container_contains(*dst, src.array[i]))
+            {
+                out.push_back(src.array[i]);
+            }
+        }
+
+        dst->words.clear();
+        dst->is_bitmap = false;
+        dst->array.swap(out);
+        dst->card = dst->array.size();
+        return;
+    }
+
+    for (size_t i = 0; i < src.array.size(); ++i)
+    {
+        container_remove(dst, src.array[i]);
+    }
+}
+
+container*
+find_container(roaring* r, uint16_t key, bool create)
+{
+    roaring::iterator it = r->begin();
+
+    // containers are few; a binary search would not pay for itself
+    while (it != r->end() && it->key < key)
+    {
+        ++it;
+    }
+
+    if (it != r->end() && it->key == key)
+    {
+        return &*it;
+    }
+
+    if (!create)
+    {
+        return NULL;
+    }
+
+    it = r->insert(it, container());
+    it->key = key;
+    return &*it;
+}
+
+void
+roaring_union(roaring* dst, const roaring& src)
+{
+    for (size_t i = 0; i < src.size(); ++i)
+    {
+        container_union(find_container(dst, src[i].key, true), src[i]);
+    }
+}
+
+void
+roaring_intersect(roaring* dst, const roaring& src)
+{
+    size_t s = 0;
+
+    for (size_t d = 0; d < dst->size(); ++d)
+    {
+        container* c = &(*dst)[d];
+
+        while (s < src.size() && src[s].key < c->key)
+        {
+            ++s;
+        }
+
+        if (s < src.size() && src[s].key == c->key)
+        {
+            container_filter(c, src[s], true);
+        }
+        else
+        {
+            // encode drops empty containers
+            c->is_bitmap = false;
+            c->card = 0;
+            c->array.clear();
+            c->words.clear();
+        }
+    }
+}
+
+void
+roaring_difference(roaring* dst, const roaring& src)
+{
+    size_t s = 0;
+
+    for (size_t d = 0; d < dst->size(); ++d)
+    {
+        while (s < src.size() && src[s].key < (*dst)[d].key)
+        {
+            ++s;
+        }
+
+        if (s < src.size() && src[s].key == (*dst)[d].key)
+        {
+            container_filter(&(*dst)[d], src[s], false);
+        }
+    }
+}
+
+void
+encode(const roaring& r, e::arena* new_memory, e::slice* value)
+{
+    size_t sz = 0;
+
+    for (size_t i = 0; i < r.size(); ++i)
+    {
+        if (r[i].card > 0)
+        {
+            uint8_t kind = r[i].card <= datatype_bitmap::ARRAY_MAX ? KIND_ARRAY : KIND_BITMAP;
+            sz += HEADER_SZ + payload_size(kind, r[i].card);
+        }
+    }
+
+    uint8_t* ptr = NULL;
+    new_memory->allocate(sz, &ptr);
+    *value = e::slice(ptr, sz);
+
+    for (size_t i = 0; i < r.size(); ++i)
+    {
+        const container& c(r[i]);
+
+        if (c.card == 0)
+        {
+            continue;
+        }
+
+        uint8_t kind = c.card <= datatype_bitmap::ARRAY_MAX ? KIND_ARRAY : KIND_BITMAP;
+        ptr = e::pack16le(c.key, ptr);
+        *ptr = kind;
+        ++ptr;
+        ptr = e::pack16le(static_cast<uint16_t>(c.card - 1), ptr);
+
+        if (kind == KIND_BITMAP)
+        {
+            assert(c.is_bitmap);
+
+            for (size_t w = 0; w < datatype_bitmap::BITMAP_WORDS; ++w)
+            {
+                ptr = e::pack64le(c.words[w], ptr);
+            }
+        }
+        else if (c.is_bitmap)
+        {
+            for (size_t w = 0; w < datatype_bitmap::BITMAP_WORDS; ++w)
+            {
+                uint64_t word = c.words[w];
+
+                while (word)
+                {
+                    unsigned bit = __builtin_ctzll(word);
+                    ptr = e::pack16le(static_cast<uint16_t>(w * 64 + bit), ptr);
+                    word &= word - 1;
+                }
+            }
+        }
+        else
+        {
+            for (size_t a = 0; a < c.array.size(); ++a)
+            {
+                ptr = e::pack16le(c.array[a], ptr);
+            }
+        }
+    }
+
+    assert(ptr == value->data() + value->size());
+}
+
+bool
+decode_member(const e::slice& elem, uint32_t* member)
+{
+    if (elem.size() != sizeof(int64_t))
+    {
+        return false;
+    }
+
+    int64_t x;
+    e::unpack64le(elem.data(), &x);
+
+    if (x < 0 || x > UINT32_MAX)
+    {
+        return false;
+    }
+
+    *member = static_cast<uint32_t>(x);
+    return true;
+}
+
+} // namespace
+
+bool
+datatype_bitmap :: static_validate(const e::slice& value)
+{
+    const uint8_t* ptr = value.data();
+    const uint8_t* end = value.data() + value.size();
+    encoded_container ec;
+    bool has_prev = false;
+    uint16_t prev = 0;
+
+    while (ptr < end)
+    {
+        if (!step_container(&ptr, end, &ec) ||
+            (has_prev && ec.key <= prev))
+        {
+            return false;
+        }
+
+        has_prev = true;
+        prev = ec.key;
+
+        if (ec.kind == KIND_ARRAY)
+        {
+            if (ec.card > ARRAY_MAX)
+            {
+                return false;
+            }
+
+            for (size_t i = 1; i < ec.card; ++i)
+            {
+                if (array_at(ec, i - 1) >= array_at(ec, i))
+                {
+                    return false;
+                }
+            }
+        }
+        else
+        {
+            uint32_t card = 0;
+
+            for (size_t i = 0; i < BITMAP_WORDS; ++i)
+            {
+                card += __builtin_popcountll(word_at(ec, i));
+            }
+
+            if (ec.card <= ARRAY_MAX || card != ec.card)
+            {
+                return false;
+            }
+        }
+    }
+
+    return ptr == end;
+}
+
+uint64_t
+datatype_bitmap :: cardinality(const e::slice& value)
+{
+    const uint8_t* ptr = value.data();
+    const uint8_t* end = value.data() + value.size();
+    encoded_container ec;
+    uint64_t card = 0;
+
+    while (ptr < end && step_container(&ptr, end, &ec))
+    {
+        card += ec.card;
+    }
+
+    return card;
+}
+
+bool
+datatype_bitmap :: static_contains(const e::slice& value, uint32_t member)
+{
+    const uint8_t* ptr = value.data();
+    const uint8_t* end = value.data() + value.size();
+    encoded_container ec;
+    uint16_t key = member >> 16;
+
+    while (ptr < end && step_container(&ptr, end, &ec) && ec.key <= key)
+    {
+        if (ec.key == key)
+        {
+            return encoded_contains(ec, member & 0xffffU);
+        }
+    }
+
+    return false;
+}
+
+void
+datatype_bitmap :: members(const e::slice& value, std::vector<uint32_t>* out)
+{
+    const uint8_t* ptr = value.data();
+    const uint8_t* end = value.data() + value.size();
+    encoded_container ec;
+
+    while (ptr < end && step_container(&ptr, end, &ec))
+    {
+        uint32_t high = static_cast<uint32_t>(ec.key) << 16;
+
+        if (ec.kind == KIND_ARRAY)
+        {
+            for (size_t i = 0; i < ec.card; ++i)
+            {
+                out->push_back(high | array_at(ec, i));
+            }
+
+            continue;
+        }
+
+        for (size_t w = 0; w < BITMAP_WORDS; ++w)
+        {
+            uint64_t word = word_at(ec, w);
+
+            while (word)
+            {
+                out->push_back(high | (w * 64 + __builtin_ctzll(word)));
+                word &= word - 1;
+            }
+        }
+    }
+}
+
+datatype_bitmap :: datatype_bitmap()
+{
+}
+
+datatype_bitmap :: ~datatype_bitmap() throw ()
+{
+}
+
+hyperdatatype
+datatype_bitmap :: datatype() const
+{
+    return HYPERDATATYPE_BITMAP_INT64;
+}
+
+bool
+datatype_bitmap :: validate(const e::slice& value) const
+{
+    return static_validate(value);
+}
+
+bool
+datatype_bitmap :: check_args(const funcall& func) const
+{
+    uint32_t member;
+    return (func.arg1_datatype == HYPERDATATYPE_BITMAP_INT64 &&
+            static_validate(func.arg1) &&
+            (func.name == FUNC_SET ||
+             func.name == FUNC_SET_UNION ||
+             func.name == FUNC_SET_INTERSECT ||
+             func.name == FUNC_SET_DIFFERENCE)) ||
+           (func.arg1_datatype == HYPERDATATYPE_INT64 &&
+            decode_member(func.arg1, &member) &&
+            (func.name == FUNC_SET_ADD ||
+             func.name == FUNC_SET_REMOVE));
+}
+
+bool
+datatype_bitmap :: apply(const e::slice& old_value,
+                         const funcall* funcs, size_t funcs_sz,
+                         e::arena* new_memory,
+                         e::slice* new_value) const
+{
+    roaring r;
+    roaring arg;
+    decode(old_value, &r);
+
+    for (size_t i = 0; i < funcs_sz; ++i)
+    {
+        uint32_t member = 0;
+        container* c = NULL;
+
+        switch (funcs[i].name)
+        {
+            case FUNC_SET:
+                decode(funcs[i].arg1, &r);
+                break;
+            case FUNC_SET_ADD:
+                decode_member(funcs[i].arg1, &member);
+                container_add(find_container(&r, member >> 16, true), member & 0xffffU);
+                break;
+            case FUNC_SET_REMOVE:
+                decode_member(funcs[i].arg1, &member);
+
+                if ((c = find_container(&r, member >> 16, false)))
+                {
+                    container_remove(c, member & 0xffffU);
+                }
+
+                break;
+            case FUNC_SET_UNION:
+                decode(funcs[i].arg1, &arg);
+                roaring_union(&r, arg);
+                break;
+            case FUNC_SET_INTERSECT:
+                decode(funcs[i].arg1, &arg);
+                roaring_intersect(&r, arg);
+                break;
+            case FUNC_SET_DIFFERENCE:
+                decode(funcs[i].arg1, &arg);
+                roaring_difference(&r, arg);
+                break;
+            case FUNC_FAIL:
+            case FUNC_STRING_APPEND:
+            case FUNC_STRING_PREPEND:
+            case FUNC_STRING_LTRIM:
+            case FUNC_STRING_RTRIM:
+            case FUNC_NUM_ADD:
+            case FUNC_NUM_SUB:
+            case FUNC_NUM_MUL:
+            case FUNC_NUM_DIV:
+            case FUNC_NUM_MOD:
+            case FUNC_NUM_AND:
+            case FUNC_NUM_OR:
+            case FUNC_NUM_XOR:
+            case FUNC_NUM_MIN:
+            case FUNC_NUM_MAX:
+            case FUNC_LIST_LPUSH:
+            case FUNC_LIST_RPUSH:
+            case FUNC_MAP_ADD:
+            case FUNC_MAP_REMOVE:
+            case FUNC_DOC_RENAME:
+            case FUNC_DOC_UNSET:
+            case FUNC_SKETCH_ADD:
+            case FUNC_SKETCH_MERGE:
+            default:
+                abort();
+        }
+    }
+
+    encode(r, new_memory, new_value);
+    return true;
+}
+
+bool
+datatype_bitmap :: client_to_server(const e::slice& client,
+                                    e::arena* new_memory,
+                                    e::slice* server) const
+{
+    // the client form is a set(int64):  sorted, distinct, packed int64s
+    if (client.size() % sizeof(int64_t) != 0)
+    {
+        return false;
+    }
+
+    roaring r;
+    bool has_prev = false;
+    uint32_t prev = 0;
+
+    for (size_t i = 0; i < client.size(); i += sizeof(int64_t))
+    {
+        uint32_t member;
+
+        if (!decode_member(e::slice(client.data() + i, sizeof(int64_t)), &member) ||
+            (has_prev && member <= prev))
+        {
+            return false;
+        }
+
+        has_prev = true;
+        prev = member;
+
+        if (r.empty() || r.back().key != (member >> 16))
+        {
+            r.push_back(container());
+            r.back().key = member >> 16;
+        }
+
+        container_add(&r.back(), member & 0xffffU);
+    }
+
+    encode(r, new_memory, server);
+    return true;
+}
+
+bool
+datatype_bitmap :: server_to_client(const e::slice& server,
+                                    e::arena* new_memory,
+                                    e::slice* client) const
+{
+    std::vector<uint32_t> ms;
+    members(server, &ms);
+    uint8_t* ptr = NULL;
+    new_memory->allocate(ms.size() * sizeof(int64_t), &ptr);
+    *client = e::slice(ptr, ms.size() * sizeof(int64_t));
+
+    for (size_t i = 0; i < ms.size(); ++i)
+    {
+        ptr = e::pack64le(static_cast<uint64_t>(ms[i]), ptr);
+    }
+
+    return true;
+}
+
+bool
+datatype_bitmap :: indexable() const
+{
+    return true;
+}
+
+bool
+datatype_bitmap :: has_length() const
+{
+    return true;
+}
+
+uint64_t
+datatype_bitmap :: length(const e::slice& value) const
+{
+    return cardinality(value);
+}
+
+bool
+datatype_bitmap :: has_contains() const
+{
+    return true;
+}
+
+hyperdatatype
+datatype_bitmap :: contains_datatype() const
+{
+    return HYPERDATATYPE_INT64;
+}
+
+bool
+datatype_bitmap :: contains(const e::slice& value, const e::slice& needle) const
+{
+    uint32_t member;
+    return decode_member(needle, &member) && static_contains(value, member);
+}
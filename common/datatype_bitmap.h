@@ -0,0 +1,99 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef hyperdex_common_datatype_bitmap_h_
+#define hyperdex_common_datatype_bitmap_h_
+
+// STL
+#include <vector>
+
+// HyperDex
+#include "namespace.h"
+#include "common/datatype_info.h"
+
+BEGIN_HYPERDEX_NAMESPACE
+
+// A compressed set of integers in [0, 2^32), split roaring-style into
+// containers that each hold the members sharing their upper 16 bits.  A
+// container is a little-endian header (uint16 key, uint8 kind, uint16
+// cardinality - 1) followed by either a sorted array of the low 16 bits
+// (cardinality <= ARRAY_MAX) or a bitmap of BITMAP_WORDS uint64s.  Containers
+// are sorted by key and never empty, so every set has exactly one encoding.
+//
+// Clients see the same encoding as set(int64), so bindings read and write
+// bitmaps as sets of integers.
+class datatype_bitmap : public datatype_info
+{
+    public:
+        static const size_t ARRAY_MAX = 4096;
+        static const size_t BITMAP_WORDS = 1024;
+
+    public:
+        static bool static_validate(const e::slice& value);
+        static uint64_t cardinality(const e::slice& value);
+        static bool static_contains(const e::slice& value, uint32_t member);
+        // append every member, in increasing order
+        static void members(const e::slice& value, std::vector<uint32_t>* out);
+
+    public:
+        datatype_bitmap();
+        virtual ~datatype_bitmap() throw ();
+
+    public:
+        virtual hyperdatatype datatype() const;
+        virtual bool validate(const e::slice& value) const;
+        virtual bool check_args(const funcall& func) const;
+        virtual bool apply(const e::slice& old_value,
+                           const funcall* funcs, size_t funcs_sz,
+                           e::arena* new_memory,
+                           e::slice* new_value) const;
+
+    public:
+        virtual bool client_to_server(const e::slice& client,
+                                      e::arena* new_memory,
+                                      e::slice* server) const;
+        virtual bool server_to_client(const e::slice& server,
+                                      e::arena* new_memory,
+                                      e::slice* client) const;
+
+    public:
+        virtual bool indexable() const;
+
+    public:
+        virtual bool has_length() const;
+        virtual uint64_t length(const e::slice& value) const;
+
+    public:
+        virtual bool has_contains() const;
+        virtual hyperdatatype contains_datatype() const;
+        virtual bool contains(const e::slice& value, const e::slice& needle) const;
+};
+
+END_HYPERDEX_NAMESPACE
+
+#endif // hyperdex_common_datatype_bitmap_h_
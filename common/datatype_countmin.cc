@@ -0,0 +1,300 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#define __STDC_LIMIT_MACROS
+
+// C
+#include <cstdlib>
+#include <cstring>
+
+// e
+#include <e/endian.h>
+
+// HyperDex
+#include "common/datatype_countmin.h"
+#include "common/datatype_hyperloglog.h"
+
+using hyperdex::datatype_countmin;
+using hyperdex::datatype_hyperloglog;
+
+const size_t datatype_countmin::WIDTH;
+const size_t datatype_countmin::DEPTH;
+const size_t datatype_countmin::SIZE;
+
+namespace
+{
+
+// the counter for "hash" in "row"; the rows' indices come from the two
+// halves of one hash (Kirsch and Mitzenmacher), so adds hash once
+size_t
+counter_offset(uint64_t hash, size_t row)
+{
+    const uint32_t h1 = hash;
+    const uint32_t h2 = hash >> 32;
+    const size_t col = (h1 + row * h2) % datatype_countmin::WIDTH;
+    return (row * datatype_countmin::WIDTH + col) * sizeof(uint32_t);
+}
+
+uint32_t
+read_counter(const uint8_t* counters, size_t off)
+{
+    uint32_t c;
+    e::unpack32le(counters + off, &c);
+    return c;
+}
+
+void
+add_counter(uint8_t* counters, size_t off, uint32_t x)
+{
+    uint32_t c = read_counter(counters, off);
+    c = c > UINT32_MAX - x ? UINT32_MAX : c + x;
+    e::pack32le(c, counters + off);
+}
+
+} // namespace
+
+bool
+datatype_countmin :: static_validate(const e::slice& value)
+{
+    return value.empty() || value.size() == SIZE;
+}
+
+void
+datatype_countmin :: add(uint64_t hash, uint8_t* counters)
+{
+    for (size_t row = 0; row < DEPTH; ++row)
+    {
+        add_counter(counters, counter_offset(hash, row), 1);
+    }
+}
+
+void
+datatype_countmin :: merge(const uint8_t* from, uint8_t* counters)
+{
+    for (size_t off = 0; off < SIZE; off += sizeof(uint32_t))
+    {
+        add_counter(counters, off, read_counter(from, off));
+    }
+}
+
+uint64_t
+datatype_countmin :: estimate(const e::slice& value, const e::slice& elem)
+{
+    if (value.size() != SIZE)
+    {
+        return 0;
+    }
+
+    const uint64_t hash = datatype_hyperloglog::hash_element(elem);
+    uint32_t est = UINT32_MAX;
+
+    for (size_t row = 0; row < DEPTH; ++row)
+    {
+        uint32_t c = read_counter(value.data(), counter_offset(hash, row));
+        est = c < est ? c : est;
+    }
+
+    return est;
+}
+
+uint64_t
+datatype_countmin :: total(const e::slice& value)
+{
+    if (value.size() != SIZE)
+    {
+        return 0;
+    }
+
+    // every add touches each row once, so any row sums to the total
+    uint64_t sum = 0;
+
+    for (size_t col = 0; col < WIDTH; ++col)
+    {
+        sum += read_counter(value.data(), col * sizeof(uint32_t));
+    }
+
+    return sum;
+}
+
+datatype_countmin :: datatype_countmin()
+{
+}
+
+datatype_countmin :: ~datatype_countmin() throw ()
+{
+}
+
+hyperdatatype
+datatype_countmin :: datatype() const
+{
+    return HYPERDATATYPE_COUNTMIN;
+}
+
+bool
+datatype_countmin :: validate(const e::slice& value) const
+{
+    return static_validate(value);
+}
+
+bool
+datatype_countmin :: check_args(const funcall& func) const
+{
+    switch (func.name)
+    {
+        case FUNC_SET:
+        case FUNC_SKETCH_MERGE:
+            return func.arg1_datatype == HYPERDATATYPE_COUNTMIN &&
+                   validate(func.arg1);
+        case FUNC_SKETCH_ADD:
+            return sketch_element_valid(func);
+        case FUNC_FAIL:
+        case FUNC_STRING_APPEND:
+        case FUNC_STRING_PREPEND:
+        case FUNC_STRING_LTRIM:
+        case FUNC_STRING_RTRIM:
+        case FUNC_NUM_ADD:
+        case FUNC_NUM_SUB:
+        case FUNC_NUM_MUL:
+        case FUNC_NUM_DIV:
+        case FUNC_NUM_MOD:
+        case FUNC_NUM_AND:
+        case FUNC_NUM_OR:
+        case FUNC_NUM_XOR:
+        case FUNC_NUM_MAX:
+        case FUNC_NUM_MIN:
+        case FUNC_LIST_LPUSH:
+        case FUNC_LIST_RPUSH:
+        case FUNC_SET_ADD:
+        case FUNC_SET_REMOVE:
+        case FUNC_SET_INTERSECT:
+        case FUNC_SET_UNION:
+        case FUNC_SET_DIFFERENCE:
+        case FUNC_MAP_ADD:
+        case FUNC_MAP_REMOVE:
+        case FUNC_DOC_RENAME:
+        case FUNC_DOC_UNSET:
+        default:
+            return false;
+    }
+}
+
+bool
+datatype_countmin :: apply(const e::slice& old_value,
+                           const funcall* funcs, size_t funcs_sz,
+                           e::arena* new_memory,
+                           e::slice* new_value) const
+{
+    // the counters are updated in place; the old value is never decoded
+    uint8_t* counters = NULL;
+    new_memory->allocate(SIZE, &counters);
+    bool empty = old_value.empty();
+
+    if (empty)
+    {
+        memset(counters, 0, SIZE);
+    }
+    else
+    {
+        memmove(counters, old_value.data(), SIZE);
+    }
+
+    for (size_t i = 0; i < funcs_sz; ++i)
+    {
+        switch (funcs[i].name)
+        {
+            case FUNC_SET:
+                empty = funcs[i].arg1.empty();
+
+                if (empty)
+                {
+                    memset(counters, 0, SIZE);
+                }
+                else
+                {
+                    memmove(counters, funcs[i].arg1.data(), SIZE);
+                }
+
+                break;
+            case FUNC_SKETCH_ADD:
+                add(datatype_hyperloglog::hash_element(funcs[i].arg1), counters);
+                empty = false;
+                break;
+            case FUNC_SKETCH_MERGE:
+                if (!funcs[i].arg1.empty())
+                {
+                    merge(funcs[i].arg1.data(), counters);
+                    empty = false;
+                }
+
+                break;
+            case FUNC_FAIL:
+            case FUNC_STRING_APPEND:
+            case FUNC_STRING_PREPEND:
+            case FUNC_STRING_LTRIM:
+            case FUNC_STRING_RTRIM:
+            case FUNC_NUM_ADD:
+            case FUNC_NUM_SUB:
+            case FUNC_NUM_MUL:
+            case FUNC_NUM_DIV:
+            case FUNC_NUM_MOD:
+            case FUNC_NUM_AND:
+            case FUNC_NUM_OR:
+            case FUNC_NUM_XOR:
+            case FUNC_NUM_MAX:
+            case FUNC_NUM_MIN:
+            case FUNC_LIST_LPUSH:
+            case FUNC_LIST_RPUSH:
+            case FUNC_SET_ADD:
+            case FUNC_SET_REMOVE:
+            case FUNC_SET_INTERSECT:
+            case FUNC_SET_UNION:
+            case FUNC_SET_DIFFERENCE:
+            case FUNC_MAP_ADD:
+            case FUNC_MAP_REMOVE:
+            case FUNC_DOC_RENAME:
+            case FUNC_DOC_UNSET:
+            default:
+                abort();
+        }
+    }
+
+    *new_value = empty ? e::slice() : e::slice(counters, SIZE);
+    return true;
+}
+
+bool
+datatype_countmin :: has_length() const
+{
+    return true;
+}
+
+uint64_t
+datatype_countmin :: length(const e::slice& value) const
+{
+    return total(value);
+}
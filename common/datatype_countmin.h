@@ -0,0 +1,78 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef hyperdex_common_datatype_countmin_h_
+#define hyperdex_common_datatype_countmin_h_
+
+// HyperDex
+#include "namespace.h"
+#include "common/datatype_info.h"
+
+BEGIN_HYPERDEX_NAMESPACE
+
+// A count-min sketch of how often each element was added.  The value is
+// DEPTH rows of WIDTH little-endian uint32 counters, so every non-empty sketch
+// is SIZE bytes; the empty value is the empty sketch.  An element's estimate
+// never undercounts, and overcounts by at most 2N/WIDTH with probability
+// 1 - 2^-DEPTH, where N is the sketch's length:  the total of all adds.
+// Counters saturate rather than wrap.
+class datatype_countmin : public datatype_info
+{
+    public:
+        static const size_t WIDTH = 512;
+        static const size_t DEPTH = 4;
+        static const size_t SIZE = WIDTH * DEPTH * sizeof(uint32_t);
+
+    public:
+        static bool static_validate(const e::slice& value);
+        static void add(uint64_t hash, uint8_t* counters);
+        static void merge(const uint8_t* from, uint8_t* counters);
+        static uint64_t estimate(const e::slice& value, const e::slice& elem);
+        static uint64_t total(const e::slice& value);
+
+    public:
+        datatype_countmin();
+        virtual ~datatype_countmin() throw ();
+
+    public:
+        virtual hyperdatatype datatype() const;
+        virtual bool validate(const e::slice& value) const;
+        virtual bool check_args(const funcall& func) const;
+        virtual bool apply(const e::slice& old_value,
+                           const funcall* funcs, size_t funcs_sz,
+                           e::arena* new_memory,
+                           e::slice* new_value) const;
+
+    public:
+        virtual bool has_length() const;
+        virtual uint64_t length(const e::slice& value) const;
+};
+
+END_HYPERDEX_NAMESPACE
+
+#endif // hyperdex_common_datatype_countmin_h_
@@ -25,6 +25,12 @@
 // ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
 // POSSIBILITY OF SUCH DAMAGE.
 
+// C
+#include <string.h>
+
+// STL
+#include <sstream>
+
 // e
 #include <e/guard.h>
 
@@ -383,6 +389,39 @@ datatype_document :: document_check(const attribute_check& check,
         return false;
     }
 
+    // CONTAINS on a path asks whether any element of the array there equals
+    // the value; a wildcard path matches when any of its elements does
+    if (check.predicate == HYPERPREDICATE_CONTAINS || is_wildcard_path(path))
+    {
+        std::string elems_path(path, path_sz);
+        attribute_check elem_check(check);
+
+        if (check.predicate == HYPERPREDICATE_CONTAINS)
+        {
+            elems_path += "[*]";
+            elem_check.predicate = HYPERPREDICATE_EQUALS;
+        }
+
+        std::vector<hyperdatatype> types;
+        std::vector<std::vector<char> > scratch;
+        std::vector<e::slice> values;
+
+        if (!extract_elements(elems_path.c_str(), doc, &types, &scratch, &values))
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            if (check_value(elem_check, path_sz, types[i], values[i]))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
     hyperdatatype type;
     std::vector<char> scratch;
     e::slice value;
@@ -392,6 +431,15 @@ datatype_document :: document_check(const attribute_check& check,
         return false;
     }
 
+    return check_value(check, path_sz, type, value);
+}
+
+bool
+datatype_document :: check_value(const attribute_check& check,
+                                 size_t path_sz,
+                                 hyperdatatype type,
+                                 const e::slice& value) const
+{
     if(type == HYPERDATATYPE_DOCUMENT)
     {
         // Compare two subdocuments
@@ -440,6 +488,143 @@ datatype_document :: extract_value(const char* path,
     return coerce_binary_to_primitive(e::slice(v, v_sz), type, scratch, value);
 }
 
+bool
+datatype_document :: extract_values(const std::vector<const char*>& paths,
+                                    const e::slice& data,
+                                    std::vector<hyperdatatype>* types,
+                                    std::vector<std::vector<char> >* scratch,
+                                    std::vector<e::slice>* values) const
+{
+    struct treadstone_transformer* trans = NULL;
+    trans = treadstone_transformer_create(data.data(), data.size());
+
+    if (!trans)
+    {
+        return false;
+    }
+
+    e::guard transg = e::makeguard(treadstone_transformer_destroy, trans);
+    extract_all(trans, paths, types, scratch, values);
+    return true;
+}
+
+bool
+datatype_document :: extract_elements(const char* path,
+                                      const e::slice& data,
+                                      std::vector<hyperdatatype>* types,
+                                      std::vector<std::vector<char> >* scratch,
+                                      std::vector<e::slice>* values) const
+{
+    struct treadstone_transformer* trans = NULL;
+    trans = treadstone_transformer_create(data.data(), data.size());
+
+    if (!trans)
+    {
+        return false;
+    }
+
+    e::guard transg = e::makeguard(treadstone_transformer_destroy, trans);
+    std::vector<std::string> concrete;
+    expand_path(trans, path, &concrete);
+    std::vector<const char*> paths;
+
+    for (size_t i = 0; i < concrete.size(); ++i)
+    {
+        paths.push_back(concrete[i].c_str());
+    }
+
+    extract_all(trans, paths, types, scratch, values);
+    size_t j = 0;
+
+    // elements without a value at the rest of the path are dropped
+    for (size_t i = 0; i < types->size(); ++i)
+    {
+        if ((*types)[i] == HYPERDATATYPE_GARBAGE)
+        {
+            continue;
+        }
+
+        (*types)[j] = (*types)[i];
+        (*values)[j] = (*values)[i];
+        ++j;
+    }
+
+    types->resize(j);
+    values->resize(j);
+    return true;
+}
+
+bool
+datatype_document :: is_wildcard_path(const char* path)
+{
+    return strstr(path, "[*]") != NULL;
+}
+
+void
+datatype_document :: expand_path(treadstone_transformer* trans,
+                                 const std::string& path,
+                                 std::vector<std::string>* paths) const
+{
+    size_t star = path.find("[*]");
+
+    if (star == std::string::npos)
+    {
+        paths->push_back(path);
+        return;
+    }
+
+    std::string prefix(path, 0, star);
+    std::string suffix(path, star + 3);
+
+    for (size_t i = 0; ; ++i)
+    {
+        std::ostringstream ostr;
+        ostr << prefix << "[" << i << "]";
+        std::string elem(ostr.str());
+        unsigned char* v = NULL;
+        size_t v_sz = 0;
+        e::guard g = e::makeguard(free_if_allocated, &v);
+
+        if (treadstone_transformer_extract_value(trans, elem.c_str(), &v, &v_sz) < 0)
+        {
+            break;
+        }
+
+        expand_path(trans, elem + suffix, paths);
+    }
+}
+
+void
+datatype_document :: extract_all(treadstone_transformer* trans,
+                                 const std::vector<const char*>& paths,
+                                 std::vector<hyperdatatype>* types,
+                                 std::vector<std::vector<char> >* scratch,
+                                 std::vector<e::slice>* values) const
+{
+    types->clear();
+    types->resize(paths.size(), HYPERDATATYPE_GARBAGE);
+    // size the scratch space up front; values point into it
+    scratch->clear();
+    scratch->resize(paths.size());
+    values->clear();
+    values->resize(paths.size());
+
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+        unsigned char* v = NULL;
+        size_t v_sz = 0;
+        e::guard g = e::makeguard(free_if_allocated, &v);
+
+        if (treadstone_transformer_extract_value(trans, paths[i], &v, &v_sz) < 0 ||
+            !coerce_binary_to_primitive(e::slice(v, v_sz), &(*types)[i],
+                                        &(*scratch)[i], &(*values)[i]))
+        {
+            (*types)[i] = HYPERDATATYPE_GARBAGE;
+            (*values)[i] = e::slice();
+        }
+    }
+}
+
 void
 datatype_document :: coerce_primitive_to_binary(hyperdatatype type,
                                                 const e::slice& in,
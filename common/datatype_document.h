@@ -28,10 +28,16 @@
 #ifndef hyperdex_common_datatype_document_h_
 #define hyperdex_common_datatype_document_h_
 
+// STL
+#include <string>
+#include <vector>
+
 // HyperDex
 #include "namespace.h"
 #include "common/datatype_info.h"
 
+struct treadstone_transformer;
+
 BEGIN_HYPERDEX_NAMESPACE
 
 class datatype_document : public datatype_info
@@ -68,8 +74,36 @@ class datatype_document : public datatype_info
                            hyperdatatype* type,
                            std::vector<char>* scratch,
                            e::slice* value) const;
+        // Extract every path in "paths" from one parse of "data".  Paths
+        // that are absent have their type set to HYPERDATATYPE_GARBAGE.
+        // Returns false only if "data" cannot be parsed.
+        bool extract_values(const std::vector<const char*>& paths,
+                            const e::slice& data,
+                            std::vector<hyperdatatype>* types,
+                            std::vector<std::vector<char> >* scratch,
+                            std::vector<e::slice>* values) const;
+        // Extract every value that "path" names.  Each "[*]" in the path
+        // stands for all elements of the array at that point.
+        bool extract_elements(const char* path,
+                              const e::slice& data,
+                              std::vector<hyperdatatype>* types,
+                              std::vector<std::vector<char> >* scratch,
+                              std::vector<e::slice>* values) const;
+        static bool is_wildcard_path(const char* path);
 
     private:
+        void expand_path(treadstone_transformer* trans,
+                         const std::string& path,
+                         std::vector<std::string>* paths) const;
+        void extract_all(treadstone_transformer* trans,
+                         const std::vector<const char*>& paths,
+                         std::vector<hyperdatatype>* types,
+                         std::vector<std::vector<char> >* scratch,
+                         std::vector<e::slice>* values) const;
+        bool check_value(const attribute_check& check,
+                         size_t path_sz,
+                         hyperdatatype type,
+                         const e::slice& value) const;
         void coerce_primitive_to_binary(hyperdatatype type,
                                         const e::slice& in,
                                         std::vector<char>* scratch,
@@ -0,0 +1,303 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+// HyperDex
+#include "cityhash/city.h"
+#include "common/datatype_hyperloglog.h"
+
+using hyperdex::datatype_hyperloglog;
+
+const unsigned datatype_hyperloglog::PRECISION;
+const size_t datatype_hyperloglog::REGISTERS;
+
+// registers hold the position of the first set bit in the hash bits left over
+// once the register index is taken, so they never exceed this
+#define MAX_RANK (64 - datatype_hyperloglog::PRECISION + 1)
+
+bool
+hyperdex :: sketch_element_valid(const funcall& func)
+{
+    if (func.arg1_datatype != HYPERDATATYPE_STRING &&
+        func.arg1_datatype != HYPERDATATYPE_INT64 &&
+        func.arg1_datatype != HYPERDATATYPE_FLOAT)
+    {
+        return false;
+    }
+
+    return datatype_info::lookup(func.arg1_datatype)->validate(func.arg1);
+}
+
+bool
+datatype_hyperloglog :: static_validate(const e::slice& value)
+{
+    if (value.empty())
+    {
+        return true;
+    }
+
+    if (value.size() != REGISTERS)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < REGISTERS; ++i)
+    {
+        if (value.data()[i] > MAX_RANK)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+uint64_t
+datatype_hyperloglog :: hash_element(const e::slice& elem)
+{
+    return CityHash64(reinterpret_cast<const char*>(elem.data()), elem.size());
+}
+
+void
+datatype_hyperloglog :: add(uint64_t hash, uint8_t* registers)
+{
+    const size_t idx = hash >> (64 - PRECISION);
+    // the sentinel bit bounds the rank when the remaining bits are all zero
+    const uint64_t rest = (hash << PRECISION) | (1ULL << (PRECISION - 1));
+    const uint8_t rank = __builtin_clzll(rest) + 1;
+
+    if (registers[idx] < rank)
+    {
+        registers[idx] = rank;
+    }
+}
+
+void
+datatype_hyperloglog :: merge(const uint8_t* from, uint8_t* registers)
+{
+    for (size_t i = 0; i < REGISTERS; ++i)
+    {
+        if (registers[i] < from[i])
+        {
+            registers[i] = from[i];
+        }
+    }
+}
+
+double
+datatype_hyperloglog :: estimate(const e::slice& value)
+{
+    if (value.size() != REGISTERS)
+    {
+        return 0;
+    }
+
+    const double m = REGISTERS;
+    const double alpha = 0.7213 / (1 + 1.079 / m);
+    double sum = 0;
+    size_t zeros = 0;
+
+    for (size_t i = 0; i < REGISTERS; ++i)
+    {
+        sum += ldexp(1.0, -static_cast<int>(value.data()[i]));
+        zeros += value.data()[i] == 0 ? 1 : 0;
+    }
+
+    double e = alpha * m * m / sum;
+
+    // small cardinalities are more accurately estimated by linear counting;
+    // 64-bit hashes make the large-range correction unnecessary
+    if (e <= 2.5 * m && zeros > 0)
+    {
+        e = m * log(m / zeros);
+    }
+
+    return e;
+}
+
+datatype_hyperloglog :: datatype_hyperloglog()
+{
+}
+
+datatype_hyperloglog :: ~datatype_hyperloglog() throw ()
+{
+}
+
+hyperdatatype
+datatype_hyperloglog :: datatype() const
+{
+    return HYPERDATATYPE_HYPERLOGLOG;
+}
+
+bool
+datatype_hyperloglog :: validate(const e::slice& value) const
+{
+    return static_validate(value);
+}
+
+bool
+datatype_hyperloglog :: check_args(const funcall& func) const
+{
+    switch (func.name)
+    {
+        case FUNC_SET:
+        case FUNC_SKETCH_MERGE:
+            return func.arg1_datatype == HYPERDATATYPE_HYPERLOGLOG &&
+                   validate(func.arg1);
+        case FUNC_SKETCH_ADD:
+            return sketch_element_valid(func);
+        case FUNC_FAIL:
+        case FUNC_STRING_APPEND:
+        case FUNC_STRING_PREPEND:
+        case FUNC_STRING_LTRIM:
+        case FUNC_STRING_RTRIM:
+        case FUNC_NUM_ADD:
+        case FUNC_NUM_SUB:
+        case FUNC_NUM_MUL:
+        case FUNC_NUM_DIV:
+        case FUNC_NUM_MOD:
+        case FUNC_NUM_AND:
+        case FUNC_NUM_OR:
+        case FUNC_NUM_XOR:
+        case FUNC_NUM_MAX:
+        case FUNC_NUM_MIN:
+        case FUNC_LIST_LPUSH:
+        case FUNC_LIST_RPUSH:
+        case FUNC_SET_ADD:
+        case FUNC_SET_REMOVE:
+        case FUNC_SET_INTERSECT:
+        case FUNC_SET_UNION:
+        case FUNC_SET_DIFFERENCE:
+        case FUNC_MAP_ADD:
+        case FUNC_MAP_REMOVE:
+        case FUNC_DOC_RENAME:
+        case FUNC_DOC_UNSET:
+        default:
+            return false;
+    }
+}
+
+bool
+datatype_hyperloglog :: apply(const e::slice& old_value,
+                              const funcall* funcs, size_t funcs_sz,
+                              e::arena* new_memory,
+                              e::slice* new_value) const
+{
+    // the registers are updated in place; the old value is never decoded
+    uint8_t* registers = NULL;
+    new_memory->allocate(REGISTERS, &registers);
+    bool empty = old_value.empty();
+
+    if (empty)
+    {
+        memset(registers, 0, REGISTERS);
+    }
+    else
+    {
+        memmove(registers, old_value.data(), REGISTERS);
+    }
+
+    for (size_t i = 0; i < funcs_sz; ++i)
+    {
+        switch (funcs[i].name)
+        {
+            case FUNC_SET:
+                empty = funcs[i].arg1.empty();
+
+                if (empty)
+                {
+                    memset(registers, 0, REGISTERS);
+                }
+                else
+                {
+                    memmove(registers, funcs[i].arg1.data(), REGISTERS);
+                }
+
+                break;
+            case FUNC_SKETCH_ADD:
+                add(hash_element(funcs[i].arg1), registers);
+                empty = false;
+                break;
+            case FUNC_SKETCH_MERGE:
+                if (!funcs[i].arg1.empty())
+                {
+                    merge(funcs[i].arg1.data(), registers);
+                    empty = false;
+                }
+
+                break;
+            case FUNC_FAIL:
+            case FUNC_STRING_APPEND:
+            case FUNC_STRING_PREPEND:
+            case FUNC_STRING_LTRIM:
+            case FUNC_STRING_RTRIM:
+            case FUNC_NUM_ADD:
+            case FUNC_NUM_SUB:
+            case FUNC_NUM_MUL:
+            case FUNC_NUM_DIV:
+            case FUNC_NUM_MOD:
+            case FUNC_NUM_AND:
+            case FUNC_NUM_OR:
+            case FUNC_NUM_XOR:
+            case FUNC_NUM_MAX:
+            case FUNC_NUM_MIN:
+            case FUNC_LIST_LPUSH:
+            case FUNC_LIST_RPUSH:
+            case FUNC_SET_ADD:
+            case FUNC_SET_REMOVE:
+            case FUNC_SET_INTERSECT:
+            case FUNC_SET_UNION:
+            case FUNC_SET_DIFFERENCE:
+            case FUNC_MAP_ADD:
+            case FUNC_MAP_REMOVE:
+            case FUNC_DOC_RENAME:
+            case FUNC_DOC_UNSET:
+            default:
+                abort();
+        }
+    }
+
+    *new_value = empty ? e::slice() : e::slice(registers, REGISTERS);
+    return true;
+}
+
+bool
+datatype_hyperloglog :: has_length() const
+{
+    return true;
+}
+
+uint64_t
+datatype_hyperloglog :: length(const e::slice& value) const
+{
+    return estimate(value) + 0.5;
+}
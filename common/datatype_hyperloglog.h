@@ -0,0 +1,81 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef hyperdex_common_datatype_hyperloglog_h_
+#define hyperdex_common_datatype_hyperloglog_h_
+
+// HyperDex
+#include "namespace.h"
+#include "common/datatype_info.h"
+
+BEGIN_HYPERDEX_NAMESPACE
+
+// A HyperLogLog sketch of the distinct elements added to it.  The value is
+// one byte per register, so every non-empty sketch is REGISTERS bytes no
+// matter how many elements it has seen; the empty value is the empty sketch.
+// Its length (for LENGTH_* predicates and get_partial) is the estimated number
+// of distinct elements, with a standard error of about 1.6%.
+class datatype_hyperloglog : public datatype_info
+{
+    public:
+        static const unsigned PRECISION = 12;
+        static const size_t REGISTERS = 1U << PRECISION;
+
+    public:
+        static bool static_validate(const e::slice& value);
+        // hash an element the same way the server does
+        static uint64_t hash_element(const e::slice& elem);
+        static void add(uint64_t hash, uint8_t* registers);
+        static void merge(const uint8_t* from, uint8_t* registers);
+        static double estimate(const e::slice& value);
+
+    public:
+        datatype_hyperloglog();
+        virtual ~datatype_hyperloglog() throw ();
+
+    public:
+        virtual hyperdatatype datatype() const;
+        virtual bool validate(const e::slice& value) const;
+        virtual bool check_args(const funcall& func) const;
+        virtual bool apply(const e::slice& old_value,
+                           const funcall* funcs, size_t funcs_sz,
+                           e::arena* new_memory,
+                           e::slice* new_value) const;
+
+    public:
+        virtual bool has_length() const;
+        virtual uint64_t length(const e::slice& value) const;
+};
+
+// true if "func" carries an element that a sketch may count
+bool
+sketch_element_valid(const funcall& func);
+
+END_HYPERDEX_NAMESPACE
+
+#endif // hyperdex_common_datatype_hyperloglog_h_
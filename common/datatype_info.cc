@@ -30,15 +30,19 @@
 
 // HyperDex
 #include "common/datatype_info.h"
+#include "common/datatype_bitmap.h"
 #include "common/datatype_document.h"
 #include "common/datatype_timestamp.h"
 #include "common/datatype_float.h"
+#include "common/datatype_countmin.h"
+#include "common/datatype_hyperloglog.h"
 #include "common/datatype_int64.h"
 #include "common/datatype_list.h"
 #include "common/datatype_macaroon_secret.h"
 #include "common/datatype_map.h"
 #include "common/datatype_set.h"
 #include "common/datatype_string.h"
+#include "common/datatype_vector.h"
 
 using hyperdex::datatype_info;
 
@@ -46,6 +50,8 @@ static hyperdex::datatype_string d_string;
 static hyperdex::datatype_int64 d_int64;
 static hyperdex::datatype_float d_float;
 static hyperdex::datatype_document d_document;
+static hyperdex::datatype_hyperloglog d_hyperloglog;
+static hyperdex::datatype_countmin d_countmin;
 static hyperdex::datatype_list d_list_string(&d_string);
 static hyperdex::datatype_list d_list_int64(&d_int64);
 static hyperdex::datatype_list d_list_float(&d_float);
@@ -67,6 +73,8 @@ static hyperdex::datatype_timestamp d_timestamp_hour(HYPERDATATYPE_TIMESTAMP_HOU
 static hyperdex::datatype_timestamp d_timestamp_day(HYPERDATATYPE_TIMESTAMP_DAY);
 static hyperdex::datatype_timestamp d_timestamp_week(HYPERDATATYPE_TIMESTAMP_WEEK);
 static hyperdex::datatype_timestamp d_timestamp_month(HYPERDATATYPE_TIMESTAMP_MONTH);
+static hyperdex::datatype_vector d_vector_float;
+static hyperdex::datatype_bitmap d_bitmap_int64;
 static hyperdex::datatype_macaroon_secret d_macaroon_secret;
 
 datatype_info*
@@ -82,6 +90,10 @@ datatype_info :: lookup(hyperdatatype datatype)
             return &d_float;
         case HYPERDATATYPE_DOCUMENT:
             return &d_document;
+        case HYPERDATATYPE_HYPERLOGLOG:
+            return &d_hyperloglog;
+        case HYPERDATATYPE_COUNTMIN:
+            return &d_countmin;
         case HYPERDATATYPE_LIST_STRING:
             return &d_list_string;
         case HYPERDATATYPE_LIST_INT64:
@@ -124,10 +136,16 @@ datatype_info :: lookup(hyperdatatype datatype)
           return &d_timestamp_week;
         case HYPERDATATYPE_TIMESTAMP_MONTH:
           return &d_timestamp_month;
+        case HYPERDATATYPE_VECTOR_FLOAT:
+            return &d_vector_float;
+        case HYPERDATATYPE_BITMAP_INT64:
+            return &d_bitmap_int64;
         case HYPERDATATYPE_MACAROON_SECRET:
             return &d_macaroon_secret;
         case HYPERDATATYPE_GENERIC:
         case HYPERDATATYPE_TIMESTAMP_GENERIC:
+        case HYPERDATATYPE_VECTOR_GENERIC:
+        case HYPERDATATYPE_BITMAP_GENERIC:
         case HYPERDATATYPE_LIST_GENERIC:
         case HYPERDATATYPE_SET_GENERIC:
         case HYPERDATATYPE_MAP_GENERIC:
@@ -29,9 +29,7 @@
 
 // C
 #include <cstdlib>
-
-// STL
-#include <list>
+#include <cstring>
 
 // e
 #include <e/endian.h>
@@ -94,40 +92,24 @@ datatype_list :: apply(const e::slice& old_value,
                        e::arena* new_memory,
                        e::slice* new_value) const
 {
-    std::list<e::slice> list;
-    const uint8_t* ptr = old_value.data();
-    const uint8_t* end = old_value.data() + old_value.size();
-    e::slice elem;
-
-    while (ptr < end)
-    {
-        bool stepped = m_elem->step(&ptr, end, &elem);
-        assert(stepped); // safe because of check_args
-        list.push_back(elem);
-    }
+    // An encoded list is the concatenation of its encoded elements, so there's
+    // no need to decode it.  The result is the elements pushed to the front
+    // (most recent first), then the bytes of the list being pushed onto, then
+    // the elements pushed to the back.  The list being pushed onto is the
+    // argument to the last FUNC_SET, or the old value if there isn't one.
+    e::slice list = old_value;
+    size_t pushes = 0;
 
     for (size_t i = 0; i < funcs_sz; ++i)
     {
         switch (funcs[i].name)
         {
             case FUNC_SET:
-                list.clear();
-                ptr = funcs[i].arg1.data();
-                end = funcs[i].arg1.data() + funcs[i].arg1.size();
-
-                while (ptr < end)
-                {
-                    bool stepped = m_elem->step(&ptr, end, &elem);
-                    assert(stepped); // safe because of check_args
-                    list.push_back(elem);
-                }
-
+                list = funcs[i].arg1;
+                pushes = i + 1;
                 break;
             case FUNC_LIST_LPUSH:
-                list.push_front(funcs[i].arg1);
-                break;
             case FUNC_LIST_RPUSH:
-                list.push_back(funcs[i].arg1);
                 break;
             case FUNC_FAIL:
             case FUNC_STRING_APPEND:
@@ -148,31 +130,49 @@ datatype_list :: apply(const e::slice& old_value,
             case FUNC_SET_REMOVE:
             case FUNC_SET_INTERSECT:
             case FUNC_SET_UNION:
+            case FUNC_SET_DIFFERENCE:
             case FUNC_MAP_ADD:
             case FUNC_MAP_REMOVE:
             case FUNC_DOC_RENAME:
             case FUNC_DOC_UNSET:
+            case FUNC_SKETCH_ADD:
+            case FUNC_SKETCH_MERGE:
             default:
                 abort();
         }
     }
 
-    size_t sz = 0;
+    size_t sz = list.size();
 
-    for (std::list<e::slice>::iterator i = list.begin(); i != list.end(); ++i)
+    for (size_t i = pushes; i < funcs_sz; ++i)
     {
-        sz += m_elem->write_sz(*i);
+        sz += m_elem->write_sz(funcs[i].arg1);
     }
 
     uint8_t* write_to = NULL;
     new_memory->allocate(sz, &write_to);
     *new_value = e::slice(write_to, sz);
 
-    for (std::list<e::slice>::iterator i = list.begin(); i != list.end(); ++i)
+    for (size_t i = funcs_sz; i > pushes; --i)
     {
-        write_to = m_elem->write(*i, write_to);
+        if (funcs[i - 1].name == FUNC_LIST_LPUSH)
+        {
+            write_to = m_elem->write(funcs[i - 1].arg1, write_to);
+        }
+    }
+
+    memmove(write_to, list.data(), list.size());
+    write_to += list.size();
+
+    for (size_t i = pushes; i < funcs_sz; ++i)
+    {
+        if (funcs[i].name == FUNC_LIST_RPUSH)
+        {
+            write_to = m_elem->write(funcs[i].arg1, write_to);
+        }
     }
 
+    assert(write_to == new_value->data() + sz);
     return true;
 }
 
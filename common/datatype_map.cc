@@ -27,8 +27,12 @@
 
 #define __STDC_LIMIT_MACROS
 
+// C
+#include <cstdlib>
+
 // STL
 #include <algorithm>
+#include <vector>
 
 // e
 #include <e/endian.h>
@@ -36,6 +40,7 @@
 
 // HyperDex
 #include "common/datatype_map.h"
+#include "common/sorted_merge.h"
 
 using hyperdex::datatype_map;
 
@@ -150,6 +155,21 @@ datatype_map :: apply(const e::slice& old_value,
                       e::arena* new_memory,
                       e::slice* new_value) const
 {
+    bool only_edits = true;
+
+    for (size_t i = 0; i < funcs_sz; ++i)
+    {
+        only_edits = only_edits &&
+                     (funcs[i].name == FUNC_SET ||
+                      funcs[i].name == FUNC_MAP_ADD ||
+                      funcs[i].name == FUNC_MAP_REMOVE);
+    }
+
+    if (only_edits)
+    {
+        return apply_edits(old_value, funcs, funcs_sz, new_memory, new_value);
+    }
+
     // Initialize map with the compare operator of the key's datatype
     map_t map(m_k->compare_less());
 
@@ -226,6 +246,9 @@ datatype_map :: apply(const e::slice& old_value,
             case FUNC_SET_REMOVE:
             case FUNC_SET_INTERSECT:
             case FUNC_SET_UNION:
+            case FUNC_SET_DIFFERENCE:
+            case FUNC_SKETCH_ADD:
+            case FUNC_SKETCH_MERGE:
             default:
                 abort();
         }
@@ -252,6 +275,42 @@ datatype_map :: apply(const e::slice& old_value,
     return true;
 }
 
+bool
+datatype_map :: apply_edits(const e::slice& old_value,
+                            const funcall* funcs, size_t funcs_sz,
+                            e::arena* new_memory,
+                            e::slice* new_value) const
+{
+    // Adds and removes are a linear merge into the sorted encoding; the
+    // map is never decoded.
+    sorted_merge sm(m_k, m_v);
+    std::vector<sorted_merge::edit> edits;
+    e::slice map = old_value;
+
+    for (size_t i = 0; i < funcs_sz; ++i)
+    {
+        switch (funcs[i].name)
+        {
+            case FUNC_SET:
+                edits.clear();
+                map = funcs[i].arg1;
+                break;
+            case FUNC_MAP_ADD:
+                edits.push_back(sorted_merge::edit(funcs[i].arg2, funcs[i].arg1, false));
+                break;
+            case FUNC_MAP_REMOVE:
+                edits.push_back(sorted_merge::edit(funcs[i].arg1, e::slice(), true));
+                break;
+            default:
+                abort();
+        }
+    }
+
+    // always produces a copy in new_memory, even without edits
+    sm.apply_edits(map, &edits, new_memory, new_value);
+    return true;
+}
+
 bool
 datatype_map :: apply_inner(map_t* m,
                             const funcall* func,
@@ -326,25 +385,6 @@ datatype_map :: contains_datatype() const
 bool
 datatype_map :: contains(const e::slice& map, const e::slice& needle) const
 {
-    const uint8_t* ptr = map.data();
-    const uint8_t* end = map.data() + map.size();
-    e::slice key;
-    e::slice val;
-
-    while (ptr < end)
-    {
-        bool stepped;
-        stepped = m_k->step(&ptr, end, &key);
-        assert(stepped);
-        stepped = m_v->step(&ptr, end, &val);
-        assert(stepped);
-
-        if (key == needle)
-        {
-            return true;
-        }
-    }
-
-    assert(ptr == end);
-    return false;
+    sorted_merge sm(m_k, m_v);
+    return sm.contains(map, needle);
 }
@@ -75,6 +75,10 @@ class datatype_map : public datatype_info
         datatype_map& operator = (const datatype_map&);
 
     private:
+        bool apply_edits(const e::slice& old_value,
+                         const funcall* funcs, size_t funcs_sz,
+                         e::arena* new_memory,
+                         e::slice* new_value) const;
         bool apply_inner(map_t* m,
                          const funcall* func,
                          e::arena* new_memory) const;
@@ -29,10 +29,11 @@
 
 // C
 #include <cstdlib>
+#include <cstring>
 
 // STL
 #include <algorithm>
-#include <set>
+#include <vector>
 
 // e
 #include <e/endian.h>
@@ -40,6 +41,7 @@
 
 // HyperDex
 #include "common/datatype_set.h"
+#include "common/sorted_merge.h"
 
 using hyperdex::datatype_set;
 
@@ -98,7 +100,8 @@ datatype_set :: check_args(const funcall& func) const
             validate(func.arg1) &&
             (func.name == FUNC_SET ||
              func.name == FUNC_SET_UNION ||
-             func.name == FUNC_SET_INTERSECT)) ||
+             func.name == FUNC_SET_INTERSECT ||
+             func.name == FUNC_SET_DIFFERENCE)) ||
            (func.arg1_datatype == m_elem->datatype() &&
             m_elem->validate(func.arg1) &&
             (func.name == FUNC_SET_ADD ||
@@ -111,62 +114,47 @@ datatype_set :: apply(const e::slice& old_value,
                       e::arena* new_memory,
                       e::slice* new_value) const
 {
-    typedef std::set<e::slice, datatype_info::compares_less> set_t;
-    set_t set(m_elem->compare_less());
-    set_t tmp(m_elem->compare_less());
-    const uint8_t* ptr = old_value.data();
-    const uint8_t* end = old_value.data() + old_value.size();
-    e::slice elem;
-
-    while (ptr < end)
-    {
-        bool stepped = m_elem->step(&ptr, end, &elem);
-        assert(stepped); // safe because of check_args
-        set.insert(elem);
-    }
+    // Every funcall is a linear merge of sorted encodings.  Runs of adds and
+    // removes are batched into one merge.
+    sorted_merge sm(m_elem, NULL);
+    std::vector<sorted_merge::edit> edits;
+    e::slice set = old_value;
+    bool copied = false;
 
     for (size_t i = 0; i < funcs_sz; ++i)
     {
+        if (!edits.empty() &&
+            funcs[i].name != FUNC_SET_ADD &&
+            funcs[i].name != FUNC_SET_REMOVE)
+        {
+            sm.apply_edits(set, &edits, new_memory, &set);
+            edits.clear();
+            copied = true;
+        }
+
         switch (funcs[i].name)
         {
             case FUNC_SET:
-                set.clear();
-                // intentional fall-through
+                set = funcs[i].arg1;
+                copied = false;
+                break;
             case FUNC_SET_UNION:
-                ptr = funcs[i].arg1.data();
-                end = funcs[i].arg1.data() + funcs[i].arg1.size();
-
-                while (ptr < end)
-                {
-                    bool stepped = m_elem->step(&ptr, end, &elem);
-                    assert(stepped); // safe because of check_args
-                    set.insert(elem);
-                }
-
+                sm.set_union(set, funcs[i].arg1, new_memory, &set);
+                copied = true;
                 break;
             case FUNC_SET_ADD:
-                set.insert(funcs[i].arg1);
+                edits.push_back(sorted_merge::edit(funcs[i].arg1, e::slice(), false));
                 break;
             case FUNC_SET_REMOVE:
-                set.erase(funcs[i].arg1);
+                edits.push_back(sorted_merge::edit(funcs[i].arg1, e::slice(), true));
                 break;
             case FUNC_SET_INTERSECT:
-                tmp.clear();
-                ptr = funcs[i].arg1.data();
-                end = funcs[i].arg1.data() + funcs[i].arg1.size();
-
-                while (ptr < end)
-                {
-                    bool stepped = m_elem->step(&ptr, end, &elem);
-                    assert(stepped); // safe because of check_args
-
-                    if (set.find(elem) != set.end())
-                    {
-                        tmp.insert(elem);
-                    }
-                }
-
-                set.swap(tmp);
+                sm.set_intersect(set, funcs[i].arg1, new_memory, &set);
+                copied = true;
+                break;
+            case FUNC_SET_DIFFERENCE:
+                sm.set_difference(set, funcs[i].arg1, new_memory, &set);
+                copied = true;
                 break;
             case FUNC_FAIL:
             case FUNC_STRING_APPEND:
@@ -189,27 +177,29 @@ datatype_set :: apply(const e::slice& old_value,
             case FUNC_LIST_RPUSH:
             case FUNC_MAP_ADD:
             case FUNC_MAP_REMOVE:
+            case FUNC_SKETCH_ADD:
+            case FUNC_SKETCH_MERGE:
             default:
                 abort();
         }
     }
 
-    size_t sz = 0;
-
-    for (set_t::iterator i = set.begin(); i != set.end(); ++i)
+    if (!edits.empty())
     {
-        sz += m_elem->write_sz(*i);
+        sm.apply_edits(set, &edits, new_memory, &set);
+        copied = true;
     }
 
-    uint8_t* write_to = NULL;
-    new_memory->allocate(sz, &write_to);
-    *new_value = e::slice(write_to, sz);
-
-    for (set_t::iterator i = set.begin(); i != set.end(); ++i)
+    // the result must live in new_memory
+    if (!copied)
     {
-        write_to = m_elem->write(*i, write_to);
+        uint8_t* write_to = NULL;
+        new_memory->allocate(set.size(), &write_to);
+        memmove(write_to, set.data(), set.size());
+        set = e::slice(write_to, set.size());
     }
 
+    *new_value = set;
     return true;
 }
 
@@ -259,21 +249,6 @@ datatype_set :: contains_datatype() const
 bool
 datatype_set :: contains(const e::slice& set, const e::slice& needle) const
 {
-    const uint8_t* ptr = set.data();
-    const uint8_t* end = set.data() + set.size();
-    e::slice elem;
-
-    while (ptr < end)
-    {
-        bool stepped = m_elem->step(&ptr, end, &elem);
-        assert(stepped);
-
-        if (elem == needle)
-        {
-            return true;
-        }
-    }
-
-    assert(ptr == end);
-    return false;
+    sorted_merge sm(m_elem, NULL);
+    return sm.contains(set, needle);
 }
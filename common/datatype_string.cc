@@ -159,10 +159,13 @@ datatype_string :: apply(const e::slice& old_value,
             case FUNC_SET_REMOVE:
             case FUNC_SET_INTERSECT:
             case FUNC_SET_UNION:
+            case FUNC_SET_DIFFERENCE:
             case FUNC_MAP_ADD:
             case FUNC_MAP_REMOVE:
             case FUNC_DOC_RENAME:
             case FUNC_DOC_UNSET:
+            case FUNC_SKETCH_ADD:
+            case FUNC_SKETCH_MERGE:
             default:
                 abort();
         }
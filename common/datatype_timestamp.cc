@@ -166,6 +166,8 @@ datatype_timestamp :: hash(const e::slice& v) const
         case HYPERDATATYPE_STRING:
         case HYPERDATATYPE_INT64:
         case HYPERDATATYPE_FLOAT:
+        case HYPERDATATYPE_HYPERLOGLOG:
+        case HYPERDATATYPE_COUNTMIN:
         case HYPERDATATYPE_DOCUMENT:
         case HYPERDATATYPE_LIST_GENERIC:
         case HYPERDATATYPE_LIST_STRING:
@@ -189,6 +191,10 @@ datatype_timestamp :: hash(const e::slice& v) const
         case HYPERDATATYPE_MAP_FLOAT_INT64:
         case HYPERDATATYPE_MAP_FLOAT_FLOAT:
         case HYPERDATATYPE_TIMESTAMP_GENERIC:
+        case HYPERDATATYPE_VECTOR_GENERIC:
+        case HYPERDATATYPE_VECTOR_FLOAT:
+        case HYPERDATATYPE_BITMAP_GENERIC:
+        case HYPERDATATYPE_BITMAP_INT64:
         case HYPERDATATYPE_MACAROON_SECRET:
         case HYPERDATATYPE_GARBAGE:
         default:
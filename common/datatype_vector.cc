@@ -0,0 +1,280 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+// e
+#include <e/endian.h>
+
+// HyperDex
+#include "common/datatype_vector.h"
+
+using hyperdex::datatype_vector;
+
+bool
+datatype_vector :: static_validate(const e::slice& value)
+{
+    if (value.size() % sizeof(float) != 0)
+    {
+        return false;
+    }
+
+    std::vector<float> v;
+    unpack(value, &v);
+
+    for (size_t i = 0; i < v.size(); ++i)
+    {
+        // NaN and infinity would make every distance meaningless
+        if (v[i] - v[i] != 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+size_t
+datatype_vector :: dimension(const e::slice& value)
+{
+    return value.size() / sizeof(float);
+}
+
+void
+datatype_vector :: unpack(const e::slice& value, std::vector<float>* out)
+{
+    const size_t n = dimension(value);
+    out->resize(n);
+
+    if (n == 0)
+    {
+        return;
+    }
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    memmove(&(*out)[0], value.data(), n * sizeof(float));
+#else
+    for (size_t i = 0; i < n; ++i)
+    {
+        uint32_t bits;
+        e::unpack32le(value.data() + i * sizeof(float), &bits);
+        memmove(&(*out)[i], &bits, sizeof(float));
+    }
+#endif
+}
+
+double
+datatype_vector :: l2_squared(const float* a, const float* b, size_t n)
+{
+    size_t i = 0;
+    float sum = 0;
+
+#ifdef __SSE__
+    __m128 acc = _mm_setzero_ps();
+
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 d = _mm_sub_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i));
+        acc = _mm_add_ps(acc, _mm_mul_ps(d, d));
+    }
+
+    float lanes[4];
+    _mm_storeu_ps(lanes, acc);
+    sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+
+    for (; i < n; ++i)
+    {
+        float d = a[i] - b[i];
+        sum += d * d;
+    }
+
+    return sum;
+}
+
+double
+datatype_vector :: cosine_distance(const float* a, const float* b, size_t n)
+{
+    size_t i = 0;
+    float dot = 0;
+    float aa = 0;
+    float bb = 0;
+
+#ifdef __SSE__
+    __m128 acc_dot = _mm_setzero_ps();
+    __m128 acc_aa = _mm_setzero_ps();
+    __m128 acc_bb = _mm_setzero_ps();
+
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(a + i);
+        __m128 y = _mm_loadu_ps(b + i);
+        acc_dot = _mm_add_ps(acc_dot, _mm_mul_ps(x, y));
+        acc_aa = _mm_add_ps(acc_aa, _mm_mul_ps(x, x));
+        acc_bb = _mm_add_ps(acc_bb, _mm_mul_ps(y, y));
+    }
+
+    float lanes[4];
+    _mm_storeu_ps(lanes, acc_dot);
+    dot = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    _mm_storeu_ps(lanes, acc_aa);
+    aa = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    _mm_storeu_ps(lanes, acc_bb);
+    bb = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+
+    for (; i < n; ++i)
+    {
+        dot += a[i] * b[i];
+        aa += a[i] * a[i];
+        bb += b[i] * b[i];
+    }
+
+    if (aa == 0 || bb == 0)
+    {
+        return 1;
+    }
+
+    return 1 - dot / sqrt(static_cast<double>(aa) * static_cast<double>(bb));
+}
+
+double
+datatype_vector :: distance(metric_t m, const float* a, const float* b, size_t n)
+{
+    switch (m)
+    {
+        case L2:
+            return l2_squared(a, b, n);
+        case COSINE:
+            return cosine_distance(a, b, n);
+        default:
+            abort();
+    }
+}
+
+datatype_vector :: datatype_vector()
+{
+}
+
+datatype_vector :: ~datatype_vector() throw ()
+{
+}
+
+hyperdatatype
+datatype_vector :: datatype() const
+{
+    return HYPERDATATYPE_VECTOR_FLOAT;
+}
+
+bool
+datatype_vector :: validate(const e::slice& value) const
+{
+    return static_validate(value);
+}
+
+bool
+datatype_vector :: check_args(const funcall& func) const
+{
+    return func.name == FUNC_SET &&
+           func.arg1_datatype == HYPERDATATYPE_VECTOR_FLOAT &&
+           validate(func.arg1);
+}
+
+bool
+datatype_vector :: apply(const e::slice& old_value,
+                         const funcall* funcs, size_t funcs_sz,
+                         e::arena* new_memory,
+                         e::slice* new_value) const
+{
+    e::slice value = old_value;
+
+    for (size_t i = 0; i < funcs_sz; ++i)
+    {
+        switch (funcs[i].name)
+        {
+            case FUNC_SET:
+                value = funcs[i].arg1;
+                break;
+            case FUNC_FAIL:
+            case FUNC_STRING_APPEND:
+            case FUNC_STRING_PREPEND:
+            case FUNC_STRING_LTRIM:
+            case FUNC_STRING_RTRIM:
+            case FUNC_NUM_ADD:
+            case FUNC_NUM_SUB:
+            case FUNC_NUM_MUL:
+            case FUNC_NUM_DIV:
+            case FUNC_NUM_MOD:
+            case FUNC_NUM_AND:
+            case FUNC_NUM_OR:
+            case FUNC_NUM_XOR:
+            case FUNC_NUM_MAX:
+            case FUNC_NUM_MIN:
+            case FUNC_LIST_LPUSH:
+            case FUNC_LIST_RPUSH:
+            case FUNC_SET_ADD:
+            case FUNC_SET_REMOVE:
+            case FUNC_SET_INTERSECT:
+            case FUNC_SET_UNION:
+            case FUNC_SET_DIFFERENCE:
+            case FUNC_DOC_RENAME:
+            case FUNC_DOC_UNSET:
+            case FUNC_MAP_ADD:
+            case FUNC_MAP_REMOVE:
+            case FUNC_SKETCH_ADD:
+            case FUNC_SKETCH_MERGE:
+            default:
+                abort();
+        }
+    }
+
+    uint8_t* ptr = NULL;
+    new_memory->allocate(value.size(), &ptr);
+    memmove(ptr, value.data(), value.size());
+    *new_value = e::slice(ptr, value.size());
+    return true;
+}
+
+bool
+datatype_vector :: has_length() const
+{
+    return true;
+}
+
+uint64_t
+datatype_vector :: length(const e::slice& value) const
+{
+    return dimension(value);
+}
@@ -71,16 +71,20 @@ enum funcall_t
     FUNC_LIST_LPUSH = 14,
     FUNC_LIST_RPUSH = 15,
 
-    FUNC_SET_ADD       = 16,
-    FUNC_SET_REMOVE    = 17,
-    FUNC_SET_INTERSECT = 18,
-    FUNC_SET_UNION     = 19,
+    FUNC_SET_ADD        = 16,
+    FUNC_SET_REMOVE     = 17,
+    FUNC_SET_INTERSECT  = 18,
+    FUNC_SET_UNION      = 19,
+    FUNC_SET_DIFFERENCE = 28,
 
     FUNC_MAP_ADD    = 20,
     FUNC_MAP_REMOVE = 21,
 
     FUNC_DOC_RENAME = 22,
-    FUNC_DOC_UNSET  = 23
+    FUNC_DOC_UNSET  = 23,
+
+    FUNC_SKETCH_ADD   = 26,
+    FUNC_SKETCH_MERGE = 27
 };
 
 class funcall
@@ -39,6 +39,8 @@ operator << (std::ostream& lhs, hyperdatatype rhs)
         STRINGIFY(HYPERDATATYPE_STRING);
         STRINGIFY(HYPERDATATYPE_INT64);
         STRINGIFY(HYPERDATATYPE_FLOAT);
+        STRINGIFY(HYPERDATATYPE_HYPERLOGLOG);
+        STRINGIFY(HYPERDATATYPE_COUNTMIN);
         STRINGIFY(HYPERDATATYPE_DOCUMENT);
         STRINGIFY(HYPERDATATYPE_LIST_GENERIC);
         STRINGIFY(HYPERDATATYPE_LIST_STRING);
@@ -68,6 +70,10 @@ operator << (std::ostream& lhs, hyperdatatype rhs)
         STRINGIFY(HYPERDATATYPE_TIMESTAMP_DAY);
         STRINGIFY(HYPERDATATYPE_TIMESTAMP_WEEK);
         STRINGIFY(HYPERDATATYPE_TIMESTAMP_MONTH);
+        STRINGIFY(HYPERDATATYPE_VECTOR_GENERIC);
+        STRINGIFY(HYPERDATATYPE_VECTOR_FLOAT);
+        STRINGIFY(HYPERDATATYPE_BITMAP_GENERIC);
+        STRINGIFY(HYPERDATATYPE_BITMAP_INT64);
         STRINGIFY(HYPERDATATYPE_MACAROON_SECRET);
         STRINGIFY(HYPERDATATYPE_GARBAGE);
         default:
@@ -95,6 +101,7 @@ operator << (std::ostream& lhs, hyperpredicate rhs)
         STRINGIFY(HYPERPREDICATE_LENGTH_LESS_EQUAL);
         STRINGIFY(HYPERPREDICATE_LENGTH_GREATER_EQUAL);
         STRINGIFY(HYPERPREDICATE_CONTAINS);
+        STRINGIFY(HYPERPREDICATE_STARTS_WITH);
         default:
             lhs << "unknown hyperpredicate";
             break;
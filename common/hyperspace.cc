@@ -39,6 +39,7 @@ space :: space()
     , name("")
     , fault_tolerance()
     , predecessor_width(1)
+    , replication(SERIAL)
     , sc()
     , subspaces()
     , indices()
@@ -52,6 +53,7 @@ space :: space(const char* new_name, const hyperdex::schema& _sc)
     , name(new_name)
     , fault_tolerance()
     , predecessor_width(1)
+    , replication(SERIAL)
     , sc(_sc)
     , subspaces()
     , indices()
@@ -66,6 +68,7 @@ space :: space(const space& other)
     , name(other.name)
     , fault_tolerance(other.fault_tolerance)
     , predecessor_width(other.predecessor_width)
+    , replication(other.replication)
     , sc(other.sc)
     , subspaces(other.subspaces)
     , indices(other.indices)
@@ -131,6 +134,13 @@ space :: validate() const
         }
     }
 
+    if (sc.ttl_attr != 0 &&
+        (sc.ttl_attr >= sc.attrs_sz || sc.ttl == 0 ||
+         CONTAINER_TYPE(sc.attrs[sc.ttl_attr].type) != HYPERDATATYPE_TIMESTAMP_GENERIC))
+    {
+        return false;
+    }
+
     return true;
 }
 
@@ -140,6 +150,7 @@ space :: operator = (const space& rhs)
     id = rhs.id;
     name = rhs.name;
     fault_tolerance = rhs.fault_tolerance;
+    replication = rhs.replication;
     sc = rhs.sc;
     subspaces = rhs.subspaces;
     indices = rhs.indices;
@@ -161,6 +172,7 @@ space :: reestablish_backing()
     for (size_t i = 0; i < indices.size(); ++i)
     {
         sz += indices[i].extra.size();
+        sz += indices[i].predicate.size();
     }
 
     // Create the two new backings
@@ -190,18 +202,45 @@ space :: reestablish_backing()
         memmove(ptr, indices[i].extra.data(), indices[i].extra.size());
         indices[i].extra = e::slice(ptr, indices[i].extra.size());
         ptr += indices[i].extra.size();
+        memmove(ptr, indices[i].predicate.data(), indices[i].predicate.size());
+        indices[i].predicate = e::slice(ptr, indices[i].predicate.size());
+        ptr += indices[i].predicate.size();
+    }
+}
+
+// Packed spaces lead with a format word.  Records written before the format
+// was versioned lead with the space id instead, which the coordinator hands
+// out counting up from one, so it can never collide with the marker.  Fields
+// added by a version are appended after the indices so that the older part of
+// the record keeps its layout.
+#define SPACE_FORMAT_MARKER 0xffffffffffff0000ULL
+#define SPACE_FORMAT_VERSION_MASK 0x000000000000ffffULL
+#define SPACE_FORMAT_VERSION 3
+
+static e::unpacker
+unpack_error(e::unpacker up)
+{
+    uint8_t x;
+
+    while (!up.error())
+    {
+        up = up >> x;
     }
+
+    return up;
 }
 
 e::packer
 hyperdex :: operator << (e::packer pa, const space& s)
 {
     e::slice name;
+    uint64_t format = SPACE_FORMAT_MARKER | SPACE_FORMAT_VERSION;
     uint16_t num_subspaces = s.subspaces.size();
     uint16_t num_indices = s.indices.size();
+    uint8_t ttl_on_write = s.sc.ttl_on_write ? 1 : 0;
     name = e::slice(s.name, strlen(s.name));
-    pa = pa << s.id.get() << name << s.fault_tolerance << s.sc.attrs_sz
-            << num_subspaces << num_indices;
+    pa = pa << format << s.id.get() << name << s.fault_tolerance
+            << s.sc.attrs_sz << num_subspaces << num_indices;
 
     for (size_t i = 0; i < s.sc.attrs_sz; ++i)
     {
@@ -219,6 +258,16 @@ hyperdex :: operator << (e::packer pa, const space& s)
         pa = pa << s.indices[i];
     }
 
+    // version 1
+    pa = pa << s.replication;
+    // version 2
+    pa = pa << s.sc.ttl_attr << s.sc.ttl << ttl_on_write;
+    // version 3
+    for (size_t i = 0; i < num_indices; ++i)
+    {
+        pa = pa << s.indices[i].predicate;
+    }
+
     return pa;
 }
 
@@ -228,9 +277,28 @@ hyperdex :: operator >> (e::unpacker up, space& s)
     e::slice name;
     std::vector<std::string> strs;
     std::vector<attribute> attrs;
+    uint64_t format;
+    uint64_t version = 0;
     uint16_t num_subspaces;
     uint16_t num_indices;
-    up = up >> s.id >> name >> s.fault_tolerance >> s.sc.attrs_sz
+    up = up >> format;
+
+    if ((format & SPACE_FORMAT_MARKER) == SPACE_FORMAT_MARKER)
+    {
+        version = format & SPACE_FORMAT_VERSION_MASK;
+        up = up >> s.id;
+    }
+    else
+    {
+        s.id = space_id(format);
+    }
+
+    if (version > SPACE_FORMAT_VERSION)
+    {
+        return unpack_error(up);
+    }
+
+    up = up >> name >> s.fault_tolerance >> s.sc.attrs_sz
             >> num_subspaces >> num_indices;
     strs.reserve(s.sc.attrs_sz + 1);
     attrs.reserve(s.sc.attrs_sz);
@@ -271,6 +339,29 @@ hyperdex :: operator >> (e::unpacker up, space& s)
         up = up >> s.indices[i];
     }
 
+    // Fields from later versions take their defaults in older records
+    s.replication = space::SERIAL;
+    s.sc.ttl_attr = 0;
+    s.sc.ttl = 0;
+    s.sc.ttl_on_write = false;
+
+    if (!up.error() && version >= 1)
+    {
+        up = up >> s.replication;
+    }
+
+    if (!up.error() && version >= 2)
+    {
+        uint8_t ttl_on_write;
+        up = up >> s.sc.ttl_attr >> s.sc.ttl >> ttl_on_write;
+        s.sc.ttl_on_write = ttl_on_write != 0;
+    }
+
+    for (size_t i = 0; !up.error() && version >= 3 && i < num_indices; ++i)
+    {
+        up = up >> s.indices[i].predicate;
+    }
+
     s.reestablish_backing();
     return up;
 }
@@ -278,7 +369,8 @@ hyperdex :: operator >> (e::unpacker up, space& s)
 size_t
 hyperdex :: pack_size(const space& s)
 {
-    size_t sz = sizeof(uint64_t) /* id */
+    size_t sz = sizeof(uint64_t) /* format */
+              + sizeof(uint64_t) /* id */
               + sizeof(uint32_t) + strlen(s.name) /* name */
               + sizeof(uint64_t) /* fault_tolerance */
               + sizeof(uint16_t) /* sc.attrs_sz */
@@ -301,9 +393,41 @@ hyperdex :: pack_size(const space& s)
         sz += pack_size(s.indices[i]);
     }
 
+    sz += pack_size(s.replication) /* version 1 */
+        + sizeof(uint16_t) /* sc.ttl_attr, version 2 */
+        + sizeof(uint64_t) /* sc.ttl, version 2 */
+        + sizeof(uint8_t); /* sc.ttl_on_write, version 2 */
+
+    for (size_t i = 0; i < s.indices.size(); ++i)
+    {
+        sz += sizeof(uint32_t) + s.indices[i].predicate.size(); /* version 3 */
+    }
+
     return sz;
 }
 
+e::packer
+hyperdex :: operator << (e::packer pa, const space::replication_t& r)
+{
+    uint8_t x = r;
+    return pa << x;
+}
+
+e::unpacker
+hyperdex :: operator >> (e::unpacker up, space::replication_t& r)
+{
+    uint8_t x;
+    up = up >> x;
+    r = static_cast<space::replication_t>(x);
+    return up;
+}
+
+size_t
+hyperdex :: pack_size(const space::replication_t&)
+{
+    return sizeof(uint8_t);
+}
+
 subspace :: subspace()
     : id()
     , attrs()
@@ -49,6 +49,12 @@ class replica;
 
 class space
 {
+    public:
+        // SERIAL replication forwards each write through the subspaces one
+        // after another; PARALLEL forwards from the tail of the key subspace
+        // to every other subspace at once and collects all of their acks.
+        enum replication_t { SERIAL, PARALLEL };
+
     public:
         space();
         space(const char* name, const schema& sc);
@@ -67,6 +73,7 @@ class space
         const char* name;
         uint64_t fault_tolerance;
         uint64_t predecessor_width;
+        replication_t replication;
         hyperdex::schema sc;
         std::vector<subspace> subspaces;
         std::vector<index> indices;
@@ -96,6 +103,13 @@ operator >> (e::unpacker, space& s);
 size_t
 pack_size(const space& s);
 
+e::packer
+operator << (e::packer, const space::replication_t& r);
+e::unpacker
+operator >> (e::unpacker, space::replication_t& r);
+size_t
+pack_size(const space::replication_t& r);
+
 class subspace
 {
     public:
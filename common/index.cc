@@ -27,6 +27,9 @@
 
 #define __STDC_LIMIT_MACROS
 
+// e
+#include <e/endian.h>
+
 // HyperDex
 #include "common/index.h"
 
@@ -37,6 +40,7 @@ index :: index()
     , id()
     , attr(UINT16_MAX)
     , extra()
+    , predicate()
 {
 }
 
@@ -45,6 +49,16 @@ index :: index(index_t t, index_id i, uint16_t a, const e::slice& e)
     , id(i)
     , attr(a)
     , extra(e)
+    , predicate()
+{
+}
+
+index :: index(index_t t, index_id i, uint16_t a, const e::slice& e, const e::slice& p)
+    : type(t)
+    , id(i)
+    , attr(a)
+    , extra(e)
+    , predicate(p)
 {
 }
 
@@ -57,13 +71,95 @@ index :: operator = (const index& rhs)
 {
     if (this != &rhs)
     {
+        type = rhs.type;
         id = rhs.id;
         attr = rhs.attr;
+        extra = rhs.extra;
+        predicate = rhs.predicate;
     }
 
     return *this;
 }
 
+void
+hyperdex :: pack_composite_attrs(const std::vector<uint16_t>& attrs, std::string* extra)
+{
+    extra->resize(attrs.size() * sizeof(uint16_t));
+    char* ptr = &(*extra)[0];
+
+    for (size_t i = 0; i < attrs.size(); ++i)
+    {
+        ptr = e::pack16be(attrs[i], ptr);
+    }
+}
+
+bool
+hyperdex :: unpack_composite_attrs(const e::slice& extra, std::vector<uint16_t>* attrs)
+{
+    if (extra.size() % sizeof(uint16_t) != 0)
+    {
+        return false;
+    }
+
+    attrs->resize(extra.size() / sizeof(uint16_t));
+    const uint8_t* ptr = extra.data();
+
+    for (size_t i = 0; i < attrs->size(); ++i)
+    {
+        ptr = e::unpack16be(ptr, &(*attrs)[i]);
+    }
+
+    return true;
+}
+
+bool
+hyperdex :: composite_indexable(hyperdatatype t)
+{
+    switch (t)
+    {
+        case HYPERDATATYPE_STRING:
+        case HYPERDATATYPE_INT64:
+        case HYPERDATATYPE_FLOAT:
+        case HYPERDATATYPE_TIMESTAMP_SECOND:
+        case HYPERDATATYPE_TIMESTAMP_MINUTE:
+        case HYPERDATATYPE_TIMESTAMP_HOUR:
+        case HYPERDATATYPE_TIMESTAMP_DAY:
+        case HYPERDATATYPE_TIMESTAMP_WEEK:
+        case HYPERDATATYPE_TIMESTAMP_MONTH:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool
+hyperdex :: length_indexable(hyperdatatype t)
+{
+    switch (t)
+    {
+        case HYPERDATATYPE_STRING:
+        case HYPERDATATYPE_LIST_STRING:
+        case HYPERDATATYPE_LIST_INT64:
+        case HYPERDATATYPE_LIST_FLOAT:
+        case HYPERDATATYPE_SET_STRING:
+        case HYPERDATATYPE_SET_INT64:
+        case HYPERDATATYPE_SET_FLOAT:
+        case HYPERDATATYPE_MAP_STRING_STRING:
+        case HYPERDATATYPE_MAP_STRING_INT64:
+        case HYPERDATATYPE_MAP_STRING_FLOAT:
+        case HYPERDATATYPE_MAP_INT64_STRING:
+        case HYPERDATATYPE_MAP_INT64_INT64:
+        case HYPERDATATYPE_MAP_INT64_FLOAT:
+        case HYPERDATATYPE_MAP_FLOAT_STRING:
+        case HYPERDATATYPE_MAP_FLOAT_INT64:
+        case HYPERDATATYPE_MAP_FLOAT_FLOAT:
+        case HYPERDATATYPE_BITMAP_INT64:
+            return true;
+        default:
+            return false;
+    }
+}
+
 std::ostream&
 hyperdex :: operator << (std::ostream& lhs, const index& rhs)
 {
@@ -77,6 +173,26 @@ hyperdex :: operator << (std::ostream& lhs, const index& rhs)
                 << ", " << rhs.extra.str()
                 << ", " << rhs.attr <<  ")";
             break;
+        case index::TRIGRAM:
+            lhs << "index(" << rhs.id.get()
+                << ", trigram"
+                << ", " << rhs.attr <<  ")";
+            break;
+        case index::COMPOSITE:
+            lhs << "index(" << rhs.id.get()
+                << ", composite"
+                << ", " << rhs.extra.hex() <<  ")";
+            break;
+        case index::LENGTH:
+            lhs << "index(" << rhs.id.get()
+                << ", length"
+                << ", " << rhs.attr <<  ")";
+            break;
+        case index::BUCKETED:
+            lhs << "index(" << rhs.id.get()
+                << ", bucketed"
+                << ", " << rhs.attr <<  ")";
+            break;
         default:
             abort();
     }
@@ -84,6 +200,8 @@ hyperdex :: operator << (std::ostream& lhs, const index& rhs)
     return lhs;
 }
 
+// The predicate is not part of the packed index; the enclosing space packs it
+// with the fields of its versioned format so that older records still parse.
 e::packer
 hyperdex :: operator << (e::packer pa, const index& t)
 {
@@ -94,6 +212,7 @@ e::unpacker
 hyperdex :: operator >> (e::unpacker up, index& t)
 {
     up = up >> t.type >> t.id >> t.attr >> t.extra;
+    t.predicate = e::slice();
     return up;
 }
 
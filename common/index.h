@@ -28,11 +28,16 @@
 #ifndef hyperdex_common_index_h_
 #define hyperdex_common_index_h_
 
+// STL
+#include <string>
+#include <vector>
+
 // e
 #include <e/buffer.h>
 
 // HyperDex
 #include "namespace.h"
+#include "hyperdex.h"
 #include "common/ids.h"
 #include "common/range_searches.h"
 
@@ -41,11 +46,12 @@ BEGIN_HYPERDEX_NAMESPACE
 class index
 {
     public:
-        enum index_t { NORMAL, DOCUMENT };
+        enum index_t { NORMAL, DOCUMENT, TRIGRAM, COMPOSITE, LENGTH, BUCKETED };
 
     public:
         index();
         index(index_t t, index_id i, uint16_t a, const e::slice& e);
+        index(index_t t, index_id i, uint16_t a, const e::slice& e, const e::slice& p);
         ~index() throw ();
 
     public:
@@ -56,8 +62,24 @@ class index
         index_id id;
         uint16_t attr;
         e::slice extra;
+        // packed attribute_checks an object must pass to be in the index;
+        // empty for indices that cover every object
+        e::slice predicate;
 };
 
+// A COMPOSITE index covers several attributes in order.  Its "extra" holds
+// their numbers as big-endian uint16s, and "attr" is the first of them.
+void
+pack_composite_attrs(const std::vector<uint16_t>& attrs, std::string* extra);
+bool
+unpack_composite_attrs(const e::slice& extra, std::vector<uint16_t>* attrs);
+// can attributes of this type be part of a COMPOSITE index?
+bool
+composite_indexable(hyperdatatype t);
+// can attributes of this type have a LENGTH index?
+bool
+length_indexable(hyperdatatype t);
+
 std::ostream&
 operator << (std::ostream& lhs, const index& rhs);
 
@@ -69,6 +69,15 @@ key_change :: ~key_change() throw ()
 bool
 key_change :: validate(const schema& sc) const
 {
+    for (size_t i = 0; i < funcs.size(); ++i)
+    {
+        // only the point leader writes the hidden attributes
+        if (sc.hidden_attr(funcs[i].attr))
+        {
+            return false;
+        }
+    }
+
     return datatype_info::lookup(sc.attrs[0].type)->validate(key) &&
            validate_attribute_checks(sc, checks) == checks.size() &&
            validate_funcs(sc, funcs) == funcs.size() &&
@@ -38,8 +38,12 @@ hyperdex :: operator << (std::ostream& lhs, const network_msgtype& rhs)
         STRINGIFY(RESP_GET);
         STRINGIFY(REQ_GET_PARTIAL);
         STRINGIFY(RESP_GET_PARTIAL);
+        STRINGIFY(REQ_MULTI_GET);
+        STRINGIFY(RESP_MULTI_GET);
         STRINGIFY(REQ_ATOMIC);
         STRINGIFY(RESP_ATOMIC);
+        STRINGIFY(REQ_MULTI_ATOMIC);
+        STRINGIFY(RESP_MULTI_ATOMIC);
         STRINGIFY(REQ_SEARCH_START);
         STRINGIFY(REQ_SEARCH_NEXT);
         STRINGIFY(REQ_SEARCH_STOP);
@@ -47,12 +51,15 @@ hyperdex :: operator << (std::ostream& lhs, const network_msgtype& rhs)
         STRINGIFY(RESP_SEARCH_DONE);
         STRINGIFY(REQ_SORTED_SEARCH);
         STRINGIFY(RESP_SORTED_SEARCH);
+        STRINGIFY(REQ_NEAREST_SEARCH);
+        STRINGIFY(RESP_NEAREST_SEARCH);
         STRINGIFY(REQ_COUNT);
         STRINGIFY(RESP_COUNT);
         STRINGIFY(REQ_SEARCH_DESCRIBE);
         STRINGIFY(RESP_SEARCH_DESCRIBE);
         STRINGIFY(REQ_GROUP_ATOMIC);
         STRINGIFY(RESP_GROUP_ATOMIC);
+        STRINGIFY(RESP_GROUP_ATOMIC_PROGRESS);
         STRINGIFY(CHAIN_OP);
         STRINGIFY(CHAIN_SUBSPACE);
         STRINGIFY(CHAIN_ACK);
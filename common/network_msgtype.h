@@ -44,9 +44,15 @@ enum network_msgtype
     REQ_GET_PARTIAL = 10,
     RESP_GET_PARTIAL = 11,
 
+    REQ_MULTI_GET   = 12,
+    RESP_MULTI_GET  = 13,
+
     REQ_ATOMIC      = 16,
     RESP_ATOMIC     = 17,
 
+    REQ_MULTI_ATOMIC    = 18,
+    RESP_MULTI_ATOMIC   = 19,
+
     REQ_SEARCH_START    = 32,
     REQ_SEARCH_NEXT     = 33,
     REQ_SEARCH_STOP     = 34,
@@ -56,6 +62,9 @@ enum network_msgtype
     REQ_SORTED_SEARCH   = 40,
     RESP_SORTED_SEARCH  = 41,
 
+    REQ_NEAREST_SEARCH  = 42,
+    RESP_NEAREST_SEARCH = 43,
+
     /* 48, 49 retired */
 
     REQ_COUNT       = 50,
@@ -66,6 +75,7 @@ enum network_msgtype
 
     REQ_GROUP_ATOMIC = 54,
     RESP_GROUP_ATOMIC = 55,
+    RESP_GROUP_ATOMIC_PROGRESS = 56,
 
     CHAIN_OP        = 64,
     CHAIN_SUBSPACE  = 65,
@@ -86,6 +86,7 @@ range_search(const attribute_check& check, range* r)
         case HYPERPREDICATE_LENGTH_LESS_EQUAL:
         case HYPERPREDICATE_LENGTH_GREATER_EQUAL:
         case HYPERPREDICATE_CONTAINS:
+        case HYPERPREDICATE_STARTS_WITH:
         default:
             return false;
     }
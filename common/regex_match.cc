@@ -1,107 +1,382 @@
+// Copyright (c) 2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
 // C
 #include <cassert>
 
 // HyperDex
 #include "common/regex_match.h"
 
-static bool
-anchored(const char* regex, const char* regex_end,
-         const char* text,  const char* text_end);
+using hyperdex::regex_dfa;
+
+// Bound the memory of one regex_dfa.  Past this many states the cache starts
+// over; matching stays linear, it just rebuilds states as it goes.
+#define REGEX_DFA_MAX_STATES 256
+#define NO_TRANSITION 0xffffffffU
+
+namespace
+{
+
+struct element
+{
+    element() : any(false), never(false), star(false), c(0) {}
+    bool any;
+    bool never;
+    bool star;
+    uint8_t c;
+};
+
+inline bool
+has_position(const std::vector<uint64_t>& ps, size_t pos)
+{
+    return ps[pos / 64] & (1ULL << (pos % 64));
+}
 
-static bool
-starred(int c,
-        const char* regex, const char* regex_end,
-        const char* text,  const char* text_end);
+inline void
+add_position(std::vector<uint64_t>* ps, size_t pos)
+{
+    (*ps)[pos / 64] |= 1ULL << (pos % 64);
+}
+
+} // namespace
+
+bool
+hyperdex :: regex_match(const uint8_t* regex, size_t regex_sz,
+                        const uint8_t* text, size_t text_sz)
+{
+    regex_dfa dfa(regex, regex_sz);
+    return dfa.match(text, text_sz);
+}
 
 bool
-anchored(const char* regex, const char* regex_end,
-         const char* text,  const char* text_end)
+hyperdex :: regex_literal_prefix(const uint8_t* _regex, size_t regex_sz,
+                                 std::string* prefix)
 {
-    assert(regex <= regex_end);
-    assert(text <= text_end);
+    const char* regex = reinterpret_cast<const char*>(_regex);
+    prefix->clear();
 
-    if (regex == regex_end)
+    if (regex_sz == 0 || regex[0] != '^')
     {
-        return true;
+        return false;
     }
 
-    if (regex[0] == '\\')
+    // walk the pattern in the same order regex_dfa::parse does, stopping at
+    // the first piece that is not a single literal byte
+    size_t i = 1;
+
+    while (i < regex_sz)
     {
-        if (regex + 1 < regex_end &&
-            text < text_end &&
-            regex[1] == text[0])
+        if (regex[i] == '\\' && i + 1 < regex_sz)
+        {
+            prefix->push_back(regex[i + 1]);
+            i += 2;
+        }
+        else if (regex[i] == '\\' ||
+                 regex[i] == '.' ||
+                 (i + 1 < regex_sz && regex[i + 1] == '*') ||
+                 (regex[i] == '$' && i + 1 == regex_sz))
+        {
+            break;
+        }
+        else
         {
-            return anchored(regex + 2, regex_end, text + 1, text_end);
+            prefix->push_back(regex[i]);
+            ++i;
         }
+    }
 
-        return false;
+    return !prefix->empty();
+}
+
+void
+hyperdex :: regex_literal_runs(const uint8_t* _regex, size_t regex_sz,
+                               std::vector<std::string>* runs)
+{
+    const char* regex = reinterpret_cast<const char*>(_regex);
+    std::string run;
+    runs->clear();
+    size_t i = regex_sz > 0 && regex[0] == '^' ? 1 : 0;
+
+    while (i < regex_sz)
+    {
+        if (regex[i] == '\\' && i + 1 < regex_sz)
+        {
+            run.push_back(regex[i + 1]);
+            i += 2;
+            continue;
+        }
+        else if (regex[i] == '\\' ||
+                 regex[i] == '.' ||
+                 (i + 1 < regex_sz && regex[i + 1] == '*') ||
+                 (regex[i] == '$' && i + 1 == regex_sz))
+        {
+            i += i + 1 < regex_sz && regex[i + 1] == '*' ? 2 : 1;
+        }
+        else
+        {
+            run.push_back(regex[i]);
+            ++i;
+            continue;
+        }
+
+        if (!run.empty())
+        {
+            runs->push_back(run);
+            run.clear();
+        }
     }
 
-    if (regex + 1 < regex_end && regex[1] == '*')
+    if (!run.empty())
     {
-        return starred(regex[0], regex + 2, regex_end, text, text_end);
+        runs->push_back(run);
     }
+}
+
+regex_dfa :: regex_dfa(const uint8_t* regex, size_t regex_sz)
+    : m_pattern(reinterpret_cast<const char*>(regex), regex_sz)
+    , m_positions(0)
+    , m_anchor_start(false)
+    , m_anchor_end(false)
+    , m_words(0)
+    , m_matches()
+    , m_starred()
+    , m_start_set()
+    , m_state_ids()
+    , m_states()
+    , m_accepts()
+    , m_dead()
+    , m_transitions()
+    , m_start(0)
+{
+    parse();
+    reset();
+}
+
+regex_dfa :: ~regex_dfa() throw ()
+{
+}
 
-    if (regex[0] == '$' && regex + 1 == regex_end)
+bool
+regex_dfa :: match(const uint8_t* text, size_t text_sz)
+{
+    uint32_t state = m_start;
+
+    if (m_accepts[state] && !m_anchor_end)
     {
-        return text == text_end;
+        return true;
     }
 
-    if (text < text_end && (regex[0] == '.' || regex[0] == text[0]))
+    for (size_t i = 0; i < text_sz; ++i)
     {
-        return anchored(regex + 1, regex_end, text + 1, text_end);
+        uint32_t next = m_transitions[state * 256 + text[i]];
+        state = next != NO_TRANSITION ? next : step(state, text[i]);
+
+        if (m_accepts[state] && !m_anchor_end)
+        {
+            return true;
+        }
+
+        if (m_dead[state])
+        {
+            return false;
+        }
     }
 
-    return false;
+    return m_accepts[state];
 }
 
-bool
-starred(int c,
-        const char* regex, const char* regex_end,
-        const char* text,  const char* text_end)
+// Position i is "about to match element i"; position m_positions means the
+// whole pattern matched.  This mirrors the order in which the old recursive
+// matcher looked at each piece of the pattern.
+void
+regex_dfa :: parse()
 {
-    for (; text <= text_end; ++text)
+    const char* regex = m_pattern.data();
+    const size_t regex_sz = m_pattern.size();
+    std::vector<element> elements;
+    size_t i = 0;
+
+    if (regex_sz > 0 && regex[0] == '^')
+    {
+        m_anchor_start = true;
+        ++i;
+    }
+
+    while (i < regex_sz)
     {
-        if (anchored(regex, regex_end, text, text_end))
+        element el;
+
+        if (regex[i] == '\\')
         {
-            return true;
+            // a trailing backslash matches nothing
+            el.never = i + 1 == regex_sz;
+            el.c = el.never ? 0 : regex[i + 1];
+            i += el.never ? 1 : 2;
+        }
+        else if (i + 1 < regex_sz && regex[i + 1] == '*')
+        {
+            el.any = regex[i] == '.';
+            el.c = regex[i];
+            el.star = true;
+            i += 2;
+        }
+        else if (regex[i] == '$' && i + 1 == regex_sz)
+        {
+            m_anchor_end = true;
+            ++i;
+            continue;
+        }
+        else
+        {
+            el.any = regex[i] == '.';
+            el.c = regex[i];
+            ++i;
+        }
+
+        elements.push_back(el);
+    }
+
+    m_positions = elements.size();
+    m_words = (m_positions + 1 + 63) / 64;
+    m_matches.resize(256 * m_words);
+    m_starred.resize(m_words);
+    m_start_set.resize(m_words);
+
+    for (size_t pos = 0; pos < elements.size(); ++pos)
+    {
+        const element& el(elements[pos]);
+
+        if (el.star)
+        {
+            add_position(&m_starred, pos);
         }
 
-        if (text < text_end && *text != c && c != '.')
+        for (unsigned c = 0; c < 256; ++c)
         {
-            break;
+            if (!el.never && (el.any || el.c == c))
+            {
+                m_matches[c * m_words + pos / 64] |= 1ULL << (pos % 64);
+            }
         }
     }
 
-    return false;
+    add_position(&m_start_set, 0);
+    closure(&m_start_set);
 }
 
-bool
-hyperdex :: regex_match(const uint8_t* _regex, size_t regex_sz,
-                        const uint8_t* _text, size_t text_sz)
+// Starred elements may match nothing, so a position on one implies the next
+void
+regex_dfa :: closure(position_set* ps) const
 {
-    const char* regex = reinterpret_cast<const char*>(_regex);
-    const char* text  = reinterpret_cast<const char*>(_text);
-    const char* regex_end = regex + regex_sz;
-    const char* text_end  = text + text_sz;
+    for (size_t pos = 0; pos < m_positions; ++pos)
+    {
+        if (has_position(*ps, pos) && has_position(m_starred, pos))
+        {
+            add_position(ps, pos + 1);
+        }
+    }
+}
+
+uint32_t
+regex_dfa :: intern(const position_set& ps)
+{
+    std::map<position_set, uint32_t>::iterator it = m_state_ids.find(ps);
 
-    if (regex_sz == 0)
+    if (it != m_state_ids.end())
     {
-        return true;
+        return it->second;
     }
 
-    if (regex[0] == '^')
+    uint32_t id = m_states.size();
+    bool dead = true;
+
+    for (size_t w = 0; w < m_words; ++w)
     {
-        return anchored(regex + 1, regex_end, text, text_end);
+        dead = dead && ps[w] == 0;
     }
 
-    for (; text <= text_end; ++text)
+    m_state_ids.insert(std::make_pair(ps, id));
+    m_states.push_back(ps);
+    m_accepts.push_back(has_position(ps, m_positions) ? 1 : 0);
+    m_dead.push_back(dead ? 1 : 0);
+    m_transitions.resize(m_transitions.size() + 256, NO_TRANSITION);
+    return id;
+}
+
+uint32_t
+regex_dfa :: step(uint32_t state, uint8_t c)
+{
+    assert(state < m_states.size());
+    const position_set& cur(m_states[state]);
+    const uint64_t* matches = &m_matches[c * m_words];
+    position_set next(m_words, 0);
+
+    for (size_t w = 0; w < m_words; ++w)
     {
-        if (anchored(regex, regex_end, text, text_end))
+        uint64_t matched = cur[w] & matches[w];
+        uint64_t advance = matched & ~m_starred[w];
+        next[w] |= matched & m_starred[w];
+        next[w] |= advance << 1;
+
+        if (w + 1 < m_words)
         {
-            return true;
+            next[w + 1] |= advance >> 63;
+        }
+    }
+
+    closure(&next);
+
+    // an unanchored pattern may begin matching at any byte
+    if (!m_anchor_start)
+    {
+        for (size_t w = 0; w < m_words; ++w)
+        {
+            next[w] |= m_start_set[w];
         }
     }
 
-    return false;
+    if (m_states.size() >= REGEX_DFA_MAX_STATES)
+    {
+        reset();
+        return intern(next);
+    }
+
+    uint32_t id = intern(next);
+    m_transitions[state * 256 + c] = id;
+    return id;
+}
+
+void
+regex_dfa :: reset()
+{
+    m_state_ids.clear();
+    m_states.clear();
+    m_accepts.clear();
+    m_dead.clear();
+    m_transitions.clear();
+    m_start = intern(m_start_set);
 }
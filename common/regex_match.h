@@ -32,15 +32,85 @@
 #include <cstdlib>
 #include <stdint.h>
 
+// STL
+#include <map>
+#include <string>
+#include <vector>
+
 // HyperDex
 #include "namespace.h"
 
 BEGIN_HYPERDEX_NAMESPACE
 
+// The pattern language is the small one HyperDex has always had:  literals,
+// "." for any byte, "c*" for zero or more of "c", "\c" for a literal "c", and
+// "^" and "$" to anchor the start and end.  An unanchored pattern matches if it
+// matches a prefix of any suffix of the text.
 bool
 regex_match(const uint8_t* regex, size_t regex_sz,
             const uint8_t* text, size_t text_sz);
 
+// The literal bytes that every text matching an anchored pattern starts with,
+// e.g. "user:12" for "^user:12.*3".  False if there are none.
+bool
+regex_literal_prefix(const uint8_t* regex, size_t regex_sz,
+                     std::string* prefix);
+
+// The runs of literal bytes that every text matching the pattern contains,
+// anchored or not, e.g. "err" and "disk" for "err.*disk".
+void
+regex_literal_runs(const uint8_t* regex, size_t regex_sz,
+                   std::vector<std::string>* runs);
+
+// A pattern compiled to an automaton.  Matching follows the set of pattern
+// positions that could be live after each byte, so it is linear in the size
+// of the text no matter the pattern.  Each set is built once and cached as a
+// DFA state with a lazily filled transition table, so repeated matches with
+// the same regex_dfa cost one table lookup per byte.  A regex_dfa is not safe
+// to share between threads.
+class regex_dfa
+{
+    public:
+        regex_dfa(const uint8_t* regex, size_t regex_sz);
+        ~regex_dfa() throw ();
+
+    public:
+        const std::string& pattern() const { return m_pattern; }
+        bool match(const uint8_t* text, size_t text_sz);
+
+    private:
+        typedef std::vector<uint64_t> position_set;
+
+    private:
+        void parse();
+        void closure(position_set* ps) const;
+        uint32_t intern(const position_set& ps);
+        uint32_t step(uint32_t state, uint8_t c);
+        void reset();
+
+    private:
+        const std::string m_pattern;
+        size_t m_positions;
+        bool m_anchor_start;
+        bool m_anchor_end;
+        size_t m_words;
+        // for each byte, the positions whose element it matches
+        std::vector<uint64_t> m_matches;
+        std::vector<uint64_t> m_starred;
+        position_set m_start_set;
+        // the DFA states built so far
+        std::map<position_set, uint32_t> m_state_ids;
+        std::vector<position_set> m_states;
+        std::vector<uint8_t> m_accepts;
+        std::vector<uint8_t> m_dead;
+        std::vector<uint32_t> m_transitions;
+        uint32_t m_start;
+
+    private:
+        regex_dfa(const regex_dfa&);
+        regex_dfa& operator = (const regex_dfa&);
+};
+
 END_HYPERDEX_NAMESPACE
 
 #endif // hyperdex_common_regex_match_h_
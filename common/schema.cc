@@ -37,6 +37,9 @@ schema :: schema()
     : attrs_sz(0)
     , attrs(NULL)
     , authorization(false)
+    , ttl_attr(0)
+    , ttl(0)
+    , ttl_on_write(false)
 {
 }
 
@@ -53,3 +56,9 @@ schema :: lookup_attr(const char* name) const
 
     return attrs_sz;
 }
+
+bool
+schema :: hidden_attr(uint16_t attr) const
+{
+    return ttl_on_write && attr != 0 && attr == ttl_attr;
+}
@@ -44,11 +44,20 @@ class schema
 
     public:
         uint16_t lookup_attr(const char* name) const;
+        // attributes HyperDex maintains itself, which clients neither see
+        // nor write
+        bool hidden_attr(uint16_t attr) const;
 
     public:
         uint16_t attrs_sz;
         const attribute* attrs;
         bool authorization;
+        // objects expire "ttl" microseconds after the timestamp in attribute
+        // "ttl_attr"; zero disables expiry
+        uint16_t ttl_attr;
+        uint64_t ttl;
+        // "ttl_attr" is the hidden write time stamped on every write
+        bool ttl_on_write;
 };
 
 END_HYPERDEX_NAMESPACE
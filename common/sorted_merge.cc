@@ -0,0 +1,420 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <cassert>
+#include <cstring>
+
+// STL
+#include <algorithm>
+
+// e
+#include <e/endian.h>
+
+// HyperDex
+#include "common/sorted_merge.h"
+
+using hyperdex::sorted_merge;
+
+class sorted_merge::edit_order
+{
+    public:
+        edit_order(const sorted_merge* sm) : m_sm(sm) {}
+        bool operator () (const edit& lhs, const edit& rhs) const
+        { return m_sm->compare(lhs.key, rhs.key) < 0; }
+
+    private:
+        const sorted_merge* m_sm;
+};
+
+sorted_merge :: sorted_merge(const datatype_info* k, const datatype_info* v)
+    : m_k(k)
+    , m_v(v)
+    , m_fixed(HYPERDATATYPE_GARBAGE)
+    , m_stride(0)
+{
+    if (m_k->datatype() == HYPERDATATYPE_INT64 ||
+        m_k->datatype() == HYPERDATATYPE_FLOAT)
+    {
+        m_fixed = m_k->datatype();
+        m_stride = sizeof(uint64_t);
+    }
+
+    if (m_stride && m_v)
+    {
+        if (m_v->datatype() == HYPERDATATYPE_INT64 ||
+            m_v->datatype() == HYPERDATATYPE_FLOAT)
+        {
+            m_stride += sizeof(uint64_t);
+        }
+        else
+        {
+            m_stride = 0;
+        }
+    }
+}
+
+sorted_merge :: ~sorted_merge() throw ()
+{
+}
+
+void
+sorted_merge :: apply_edits(const e::slice& in,
+                            std::vector<edit>* edits,
+                            e::arena* new_memory,
+                            e::slice* out) const
+{
+    // sort the edits by key; for duplicate keys only the last edit counts
+    std::stable_sort(edits->begin(), edits->end(), edit_order(this));
+    size_t uniq = 0;
+    size_t sz = in.size();
+
+    for (size_t i = 0; i < edits->size(); ++i)
+    {
+        if (i + 1 < edits->size() &&
+            compare((*edits)[i].key, (*edits)[i + 1].key) == 0)
+        {
+            continue;
+        }
+
+        (*edits)[uniq] = (*edits)[i];
+        const edit& ed((*edits)[uniq]);
+        ++uniq;
+
+        if (!ed.remove)
+        {
+            sz += m_k->write_sz(ed.key) + (m_v ? m_v->write_sz(ed.val) : 0);
+        }
+    }
+
+    edits->resize(uniq);
+    uint8_t* write_to = NULL;
+    new_memory->allocate(sz, &write_to);
+    uint8_t* const start = write_to;
+    const uint8_t* ptr = in.data();
+    const uint8_t* const end = in.data() + in.size();
+    size_t idx = 0;
+
+    while (ptr < end)
+    {
+        const uint8_t* entry = ptr;
+        e::slice key;
+        bool stepped = step(&ptr, end, &key);
+        assert(stepped);
+        int cmp = -1;
+
+        // write the edits that precede this entry
+        while (idx < edits->size() &&
+               (cmp = compare((*edits)[idx].key, key)) < 0)
+        {
+            const edit& ed((*edits)[idx]);
+
+            if (!ed.remove)
+            {
+                write_to = m_k->write(ed.key, write_to);
+                write_to = m_v ? m_v->write(ed.val, write_to) : write_to;
+            }
+
+            ++idx;
+            cmp = -1;
+        }
+
+        if (idx < edits->size() && cmp == 0)
+        {
+            // the edit replaces the entry
+            const edit& ed((*edits)[idx]);
+
+            if (!ed.remove)
+            {
+                write_to = m_k->write(ed.key, write_to);
+                write_to = m_v ? m_v->write(ed.val, write_to) : write_to;
+            }
+
+            ++idx;
+        }
+        else
+        {
+            memmove(write_to, entry, ptr - entry);
+            write_to += ptr - entry;
+        }
+    }
+
+    for (; idx < edits->size(); ++idx)
+    {
+        const edit& ed((*edits)[idx]);
+
+        if (!ed.remove)
+        {
+            write_to = m_k->write(ed.key, write_to);
+            write_to = m_v ? m_v->write(ed.val, write_to) : write_to;
+        }
+    }
+
+    assert(write_to <= start + sz);
+    *out = e::slice(start, write_to - start);
+}
+
+void
+sorted_merge :: set_union(const e::slice& lhs,
+                          const e::slice& rhs,
+                          e::arena* new_memory,
+                          e::slice* out) const
+{
+    assert(!m_v);
+    uint8_t* write_to = NULL;
+    new_memory->allocate(lhs.size() + rhs.size(), &write_to);
+    uint8_t* const start = write_to;
+    const uint8_t* lptr = lhs.data();
+    const uint8_t* const lend = lhs.data() + lhs.size();
+    const uint8_t* rptr = rhs.data();
+    const uint8_t* const rend = rhs.data() + rhs.size();
+    const uint8_t* lentry = lptr;
+    const uint8_t* rentry = rptr;
+    e::slice lkey;
+    e::slice rkey;
+    bool lvalid = lptr < lend && step(&lptr, lend, &lkey);
+    bool rvalid = rptr < rend && step(&rptr, rend, &rkey);
+
+    while (lvalid || rvalid)
+    {
+        int cmp = !lvalid ? 1 : !rvalid ? -1 : compare(lkey, rkey);
+
+        if (cmp <= 0)
+        {
+            memmove(write_to, lentry, lptr - lentry);
+            write_to += lptr - lentry;
+        }
+        else
+        {
+            memmove(write_to, rentry, rptr - rentry);
+            write_to += rptr - rentry;
+        }
+
+        if (cmp <= 0)
+        {
+            lentry = lptr;
+            lvalid = lptr < lend && step(&lptr, lend, &lkey);
+        }
+
+        if (cmp >= 0)
+        {
+            rentry = rptr;
+            rvalid = rptr < rend && step(&rptr, rend, &rkey);
+        }
+    }
+
+    *out = e::slice(start, write_to - start);
+}
+
+void
+sorted_merge :: set_intersect(const e::slice& lhs,
+                              const e::slice& rhs,
+                              e::arena* new_memory,
+                              e::slice* out) const
+{
+    assert(!m_v);
+    uint8_t* write_to = NULL;
+    new_memory->allocate(std::min(lhs.size(), rhs.size()), &write_to);
+    uint8_t* const start = write_to;
+    const uint8_t* lptr = lhs.data();
+    const uint8_t* const lend = lhs.data() + lhs.size();
+    const uint8_t* rptr = rhs.data();
+    const uint8_t* const rend = rhs.data() + rhs.size();
+    const uint8_t* lentry = lptr;
+    e::slice lkey;
+    e::slice rkey;
+    bool lvalid = lptr < lend && step(&lptr, lend, &lkey);
+    bool rvalid = rptr < rend && step(&rptr, rend, &rkey);
+
+    while (lvalid && rvalid)
+    {
+        int cmp = compare(lkey, rkey);
+
+        if (cmp == 0)
+        {
+            memmove(write_to, lentry, lptr - lentry);
+            write_to += lptr - lentry;
+        }
+
+        if (cmp <= 0)
+        {
+            lentry = lptr;
+            lvalid = lptr < lend && step(&lptr, lend, &lkey);
+        }
+
+        if (cmp >= 0)
+        {
+            rvalid = rptr < rend && step(&rptr, rend, &rkey);
+        }
+    }
+
+    *out = e::slice(start, write_to - start);
+}
+
+void
+sorted_merge :: set_difference(const e::slice& lhs,
+                               const e::slice& rhs,
+                               e::arena* new_memory,
+                               e::slice* out) const
+{
+    assert(!m_v);
+    uint8_t* write_to = NULL;
+    new_memory->allocate(lhs.size(), &write_to);
+    uint8_t* const start = write_to;
+    const uint8_t* lptr = lhs.data();
+    const uint8_t* const lend = lhs.data() + lhs.size();
+    const uint8_t* rptr = rhs.data();
+    const uint8_t* const rend = rhs.data() + rhs.size();
+    const uint8_t* lentry = lptr;
+    e::slice lkey;
+    e::slice rkey;
+    bool lvalid = lptr < lend && step(&lptr, lend, &lkey);
+    bool rvalid = rptr < rend && step(&rptr, rend, &rkey);
+
+    while (lvalid)
+    {
+        int cmp = !rvalid ? -1 : compare(lkey, rkey);
+
+        if (cmp < 0)
+        {
+            memmove(write_to, lentry, lptr - lentry);
+            write_to += lptr - lentry;
+        }
+
+        if (cmp <= 0)
+        {
+            lentry = lptr;
+            lvalid = lptr < lend && step(&lptr, lend, &lkey);
+        }
+
+        if (cmp >= 0)
+        {
+            rvalid = rptr < rend && step(&rptr, rend, &rkey);
+        }
+    }
+
+    *out = e::slice(start, write_to - start);
+}
+
+bool
+sorted_merge :: contains(const e::slice& in, const e::slice& needle) const
+{
+    if (m_stride && in.size() % m_stride == 0 &&
+        needle.size() == sizeof(uint64_t))
+    {
+        size_t lo = 0;
+        size_t hi = in.size() / m_stride;
+
+        while (lo < hi)
+        {
+            size_t mid = lo + (hi - lo) / 2;
+            e::slice key(in.data() + mid * m_stride, sizeof(uint64_t));
+            int cmp = compare(key, needle);
+
+            if (cmp < 0)
+            {
+                lo = mid + 1;
+            }
+            else if (cmp > 0)
+            {
+                hi = mid;
+            }
+            else
+            {
+                // compare-equal floats may differ in bytes (e.g., -0.0)
+                return key == needle;
+            }
+        }
+
+        return false;
+    }
+
+    const uint8_t* ptr = in.data();
+    const uint8_t* const end = in.data() + in.size();
+    e::slice key;
+
+    while (ptr < end && step(&ptr, end, &key))
+    {
+        if (key == needle)
+        {
+            return true;
+        }
+
+        if (compare(key, needle) > 0)
+        {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+bool
+sorted_merge :: step(const uint8_t** ptr, const uint8_t* end, e::slice* key) const
+{
+    if (m_stride)
+    {
+        if (static_cast<size_t>(end - *ptr) < m_stride)
+        {
+            return false;
+        }
+
+        *key = e::slice(*ptr, sizeof(uint64_t));
+        *ptr += m_stride;
+        return true;
+    }
+
+    e::slice val;
+    return m_k->step(ptr, end, key) &&
+           (!m_v || m_v->step(ptr, end, &val));
+}
+
+int
+sorted_merge :: compare(const e::slice& lhs, const e::slice& rhs) const
+{
+    if (m_fixed == HYPERDATATYPE_INT64 &&
+        lhs.size() == sizeof(int64_t) && rhs.size() == sizeof(int64_t))
+    {
+        int64_t l;
+        int64_t r;
+        e::unpack64le(lhs.data(), &l);
+        e::unpack64le(rhs.data(), &r);
+        return l < r ? -1 : (l > r ? 1 : 0);
+    }
+    else if (m_fixed == HYPERDATATYPE_FLOAT &&
+             lhs.size() == sizeof(double) && rhs.size() == sizeof(double))
+    {
+        double l;
+        double r;
+        e::unpackdoublele(lhs.data(), &l);
+        e::unpackdoublele(rhs.data(), &r);
+        return l < r ? -1 : (l > r ? 1 : 0);
+    }
+
+    return m_k->compare(lhs, rhs);
+}
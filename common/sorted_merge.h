@@ -0,0 +1,111 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef hyperdex_common_sorted_merge_h_
+#define hyperdex_common_sorted_merge_h_
+
+// STL
+#include <vector>
+
+// e
+#include <e/arena.h>
+#include <e/slice.h>
+
+// HyperDex
+#include "namespace.h"
+#include "common/datatype_info.h"
+
+BEGIN_HYPERDEX_NAMESPACE
+
+// Sets and maps are encoded as a sequence of elements (or key/value pairs)
+// sorted by element (or key) without duplicates.  sorted_merge mutates such
+// encodings with one linear merge into arena memory.  Entries that survive are
+// copied as raw bytes and are never decoded into a tree.
+class sorted_merge
+{
+    public:
+        class edit;
+
+    public:
+        // "v" is NULL for sets
+        sorted_merge(const datatype_info* k, const datatype_info* v);
+        ~sorted_merge() throw ();
+
+    public:
+        // Apply the edits, in order, to "in".  Reorders "edits".
+        void apply_edits(const e::slice& in,
+                         std::vector<edit>* edits,
+                         e::arena* new_memory,
+                         e::slice* out) const;
+        // The union/intersection/difference of two sets
+        void set_union(const e::slice& lhs,
+                       const e::slice& rhs,
+                       e::arena* new_memory,
+                       e::slice* out) const;
+        void set_intersect(const e::slice& lhs,
+                           const e::slice& rhs,
+                           e::arena* new_memory,
+                           e::slice* out) const;
+        void set_difference(const e::slice& lhs,
+                            const e::slice& rhs,
+                            e::arena* new_memory,
+                            e::slice* out) const;
+        // Does "in" hold the element (or key) "needle"?  Binary search when
+        // every entry has the same width, otherwise a scan that stops at the
+        // first entry greater than "needle".
+        bool contains(const e::slice& in, const e::slice& needle) const;
+
+    private:
+        class edit_order;
+        bool step(const uint8_t** ptr, const uint8_t* end, e::slice* key) const;
+        int compare(const e::slice& lhs, const e::slice& rhs) const;
+
+    private:
+        const datatype_info* m_k;
+        const datatype_info* m_v;
+        // int64 and float keys are 8 bytes, and are compared without a virtual call
+        hyperdatatype m_fixed;
+        // the width of every entry, or 0 if entries vary in width
+        size_t m_stride;
+};
+
+class sorted_merge::edit
+{
+    public:
+        edit() : key(), val(), remove(false) {}
+        edit(const e::slice& k, const e::slice& v, bool r) : key(k), val(v), remove(r) {}
+
+    public:
+        e::slice key;
+        e::slice val;
+        bool remove;
+};
+
+END_HYPERDEX_NAMESPACE
+
+#endif // hyperdex_common_sorted_merge_h_
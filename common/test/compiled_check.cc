@@ -0,0 +1,190 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#define __STDC_LIMIT_MACROS
+
+// C
+#include <cmath>
+#include <stdint.h>
+
+// STL
+#include <string>
+#include <vector>
+
+// e
+#include <e/endian.h>
+
+// HyperDex
+#include "test/th.h"
+#include "common/attribute_check.h"
+#include "common/compiled_check.h"
+
+using hyperdex::attribute_check;
+using hyperdex::compiled_check;
+
+namespace
+{
+
+std::string
+pack_int(int64_t num)
+{
+    char buf[sizeof(int64_t)];
+    e::pack64le(num, buf);
+    return std::string(buf, sizeof(int64_t));
+}
+
+std::string
+pack_double(double num)
+{
+    char buf[sizeof(double)];
+    e::packdoublele(num, buf);
+    return std::string(buf, sizeof(double));
+}
+
+const hyperpredicate predicates[] = {HYPERPREDICATE_FAIL,
+                                     HYPERPREDICATE_EQUALS,
+                                     HYPERPREDICATE_LESS_THAN,
+                                     HYPERPREDICATE_LESS_EQUAL,
+                                     HYPERPREDICATE_GREATER_EQUAL,
+                                     HYPERPREDICATE_GREATER_THAN,
+                                     HYPERPREDICATE_REGEX,
+                                     HYPERPREDICATE_STARTS_WITH,
+                                     HYPERPREDICATE_LENGTH_EQUALS,
+                                     HYPERPREDICATE_LENGTH_LESS_EQUAL,
+                                     HYPERPREDICATE_LENGTH_GREATER_EQUAL,
+                                     HYPERPREDICATE_CONTAINS};
+
+// Every compiled check must agree with passes_attribute_check on every value,
+// both one at a time and as a block
+void
+agree(hyperdatatype type,
+      hyperdatatype check_type,
+      const std::vector<std::string>& constants,
+      const std::vector<std::string>& values)
+{
+    for (size_t p = 0; p < sizeof(predicates) / sizeof(hyperpredicate); ++p)
+    {
+        for (size_t c = 0; c < constants.size(); ++c)
+        {
+            attribute_check chk;
+            chk.attr = 1;
+            chk.value = e::slice(constants[c]);
+            chk.datatype = check_type;
+            chk.predicate = predicates[p];
+            compiled_check cc;
+            cc.compile(type, chk);
+
+            std::vector<e::slice> slices;
+            std::vector<uint8_t> mask(values.size(), 1);
+
+            for (size_t v = 0; v < values.size(); ++v)
+            {
+                e::slice value(values[v]);
+                ASSERT_EQ(passes_attribute_check(type, chk, value), cc.passes(value));
+                slices.push_back(value);
+            }
+
+            cc.filter(&slices[0], slices.size(), &mask[0]);
+
+            for (size_t v = 0; v < values.size(); ++v)
+            {
+                ASSERT_EQ(cc.passes(slices[v]), mask[v] != 0);
+            }
+        }
+    }
+}
+
+std::vector<std::string>
+ints()
+{
+    std::vector<std::string> xs;
+    xs.push_back(std::string());
+    xs.push_back(std::string("abc"));
+    xs.push_back(pack_int(INT64_MIN));
+    xs.push_back(pack_int(-1));
+    xs.push_back(pack_int(0));
+    xs.push_back(pack_int(1));
+    xs.push_back(pack_int(5));
+    xs.push_back(pack_int(INT64_MAX));
+    return xs;
+}
+
+std::vector<std::string>
+doubles()
+{
+    std::vector<std::string> xs;
+    xs.push_back(std::string());
+    xs.push_back(std::string("abc"));
+    xs.push_back(pack_double(-INFINITY));
+    xs.push_back(pack_double(-1.5));
+    xs.push_back(pack_double(-0.));
+    xs.push_back(pack_double(0.));
+    xs.push_back(pack_double(2.25));
+    xs.push_back(pack_double(INFINITY));
+    xs.push_back(pack_double(NAN));
+    return xs;
+}
+
+std::vector<std::string>
+strings()
+{
+    std::vector<std::string> xs;
+    xs.push_back(std::string());
+    xs.push_back(std::string("a"));
+    xs.push_back(std::string("ab"));
+    xs.push_back(std::string("abc"));
+    xs.push_back(std::string("b"));
+    xs.push_back(std::string("hello world"));
+    return xs;
+}
+
+} // namespace
+
+TEST(CompiledCheck, Int64)
+{
+    agree(HYPERDATATYPE_INT64, HYPERDATATYPE_INT64, ints(), ints());
+    agree(HYPERDATATYPE_INT64, HYPERDATATYPE_FLOAT, doubles(), ints());
+}
+
+TEST(CompiledCheck, Float)
+{
+    agree(HYPERDATATYPE_FLOAT, HYPERDATATYPE_FLOAT, doubles(), doubles());
+    agree(HYPERDATATYPE_FLOAT, HYPERDATATYPE_INT64, ints(), doubles());
+}
+
+TEST(CompiledCheck, Timestamp)
+{
+    agree(HYPERDATATYPE_TIMESTAMP_SECOND, HYPERDATATYPE_TIMESTAMP_SECOND, ints(), ints());
+    agree(HYPERDATATYPE_TIMESTAMP_DAY, HYPERDATATYPE_INT64, ints(), ints());
+}
+
+TEST(CompiledCheck, String)
+{
+    agree(HYPERDATATYPE_STRING, HYPERDATATYPE_STRING, strings(), strings());
+    agree(HYPERDATATYPE_STRING, HYPERDATATYPE_INT64, ints(), strings());
+}
@@ -0,0 +1,250 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <cstdlib>
+#include <stdint.h>
+
+// STL
+#include <set>
+#include <string>
+#include <vector>
+
+// e
+#include <e/arena.h>
+#include <e/endian.h>
+
+// HyperDex
+#include "test/th.h"
+#include "common/datatype_bitmap.h"
+#include "common/funcall.h"
+
+using hyperdex::datatype_bitmap;
+using hyperdex::funcall;
+
+namespace
+{
+
+// the client form of a bitmap, which is the set(int64) encoding
+std::string
+pack_members(const std::set<uint32_t>& ms)
+{
+    std::string out;
+
+    for (std::set<uint32_t>::const_iterator it = ms.begin(); it != ms.end(); ++it)
+    {
+        char buf[sizeof(int64_t)];
+        e::pack64le(static_cast<uint64_t>(*it), buf);
+        out.append(buf, sizeof(buf));
+    }
+
+    return out;
+}
+
+void
+to_server(const std::set<uint32_t>& ms, e::arena* memory, e::slice* value)
+{
+    datatype_bitmap di;
+    std::string packed(pack_members(ms));
+    ASSERT_TRUE(di.client_to_server(e::slice(packed), memory, value));
+    ASSERT_TRUE(di.validate(*value));
+}
+
+void
+assert_same(const e::slice& value, const std::set<uint32_t>& ms)
+{
+    std::vector<uint32_t> out;
+    ASSERT_TRUE(datatype_bitmap::static_validate(value));
+    datatype_bitmap::members(value, &out);
+    ASSERT_EQ(out.size(), ms.size());
+    ASSERT_EQ(datatype_bitmap::cardinality(value), ms.size());
+    ASSERT_TRUE(std::vector<uint32_t>(ms.begin(), ms.end()) == out);
+}
+
+// members clustered in a few containers, some of them dense
+std::set<uint32_t>
+random_members(size_t n)
+{
+    std::set<uint32_t> ms;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        uint32_t high = rand() % 4;
+        uint32_t low = rand() % (high == 0 ? 8192 : 65536);
+        ms.insert((high << 16) | low);
+    }
+
+    // a run long enough to need a bitmap container
+    if (rand() % 2 == 0)
+    {
+        uint32_t start = rand() % 8192;
+
+        for (uint32_t i = start; i < start + 6000; ++i)
+        {
+            ms.insert(i);
+        }
+    }
+
+    return ms;
+}
+
+} // namespace
+
+TEST(DatatypeBitmap, Validate)
+{
+    ASSERT_TRUE(datatype_bitmap::static_validate(e::slice("", 0)));
+    // key 1, array, cardinality 2:  members 65541, 65543
+    const char good[] = "\x01\x00\x00\x01\x00\x05\x00\x07\x00";
+    ASSERT_TRUE(datatype_bitmap::static_validate(e::slice(good, 9)));
+    ASSERT_TRUE(datatype_bitmap::static_contains(e::slice(good, 9), 65541));
+    ASSERT_FALSE(datatype_bitmap::static_contains(e::slice(good, 9), 5));
+    // unsorted array
+    const char unsorted[] = "\x01\x00\x00\x01\x00\x07\x00\x05\x00";
+    ASSERT_FALSE(datatype_bitmap::static_validate(e::slice(unsorted, 9)));
+    // truncated
+    ASSERT_FALSE(datatype_bitmap::static_validate(e::slice(good, 8)));
+    // unknown kind
+    const char kind[] = "\x01\x00\x02\x00\x00\x05\x00";
+    ASSERT_FALSE(datatype_bitmap::static_validate(e::slice(kind, 7)));
+}
+
+TEST(DatatypeBitmap, ClientForm)
+{
+    datatype_bitmap di;
+    e::arena memory;
+    std::set<uint32_t> ms(random_members(20000));
+    e::slice value;
+    to_server(ms, &memory, &value);
+    assert_same(value, ms);
+    e::slice client;
+    ASSERT_TRUE(di.server_to_client(value, &memory, &client));
+    ASSERT_TRUE(client == e::slice(pack_members(ms)));
+    // out of range and unsorted members are rejected
+    char buf[2 * sizeof(int64_t)];
+    e::pack64le(static_cast<uint64_t>(1ULL << 32), buf);
+    ASSERT_FALSE(di.client_to_server(e::slice(buf, sizeof(int64_t)), &memory, &value));
+    e::pack64le(static_cast<uint64_t>(7), buf);
+    e::pack64le(static_cast<uint64_t>(3), buf + sizeof(int64_t));
+    ASSERT_FALSE(di.client_to_server(e::slice(buf, sizeof(buf)), &memory, &value));
+}
+
+TEST(DatatypeBitmap, AddRemove)
+{
+    datatype_bitmap di;
+    e::arena memory;
+    std::set<uint32_t> ref;
+    e::slice value;
+    srand(0);
+
+    for (size_t round = 0; round < 50; ++round)
+    {
+        std::vector<funcall> funcs(200);
+        std::vector<std::string> args(funcs.size());
+
+        for (size_t i = 0; i < funcs.size(); ++i)
+        {
+            uint32_t x = rand() % 3 == 0 ? rand() : rand() % 10000;
+            bool remove = round > 25 && rand() % 2 == 0;
+            char buf[sizeof(int64_t)];
+            e::pack64le(static_cast<uint64_t>(x), buf);
+            args[i].assign(buf, sizeof(buf));
+            funcs[i].name = remove ? hyperdex::FUNC_SET_REMOVE : hyperdex::FUNC_SET_ADD;
+            funcs[i].arg1 = e::slice(args[i]);
+            funcs[i].arg1_datatype = HYPERDATATYPE_INT64;
+            ASSERT_TRUE(di.check_args(funcs[i]));
+
+            if (remove)
+            {
+                ref.erase(x);
+            }
+            else
+            {
+                ref.insert(x);
+            }
+        }
+
+        ASSERT_TRUE(di.apply(value, &funcs[0], funcs.size(), &memory, &value));
+        assert_same(value, ref);
+    }
+
+    char needle[sizeof(int64_t)];
+    e::pack64le(static_cast<uint64_t>(*ref.begin()), needle);
+    ASSERT_TRUE(di.contains(value, e::slice(needle, sizeof(needle))));
+}
+
+TEST(DatatypeBitmap, SetAlgebra)
+{
+    datatype_bitmap di;
+    e::arena memory;
+    srand(1);
+
+    for (size_t round = 0; round < 20; ++round)
+    {
+        std::set<uint32_t> a(random_members(rand() % 20000));
+        std::set<uint32_t> b(random_members(rand() % 20000));
+        e::slice va;
+        e::slice vb;
+        to_server(a, &memory, &va);
+        to_server(b, &memory, &vb);
+
+        hyperdex::funcall_t names[] = {hyperdex::FUNC_SET_UNION,
+                                       hyperdex::FUNC_SET_INTERSECT,
+                                       hyperdex::FUNC_SET_DIFFERENCE};
+
+        for (size_t n = 0; n < 3; ++n)
+        {
+            funcall func;
+            func.name = names[n];
+            func.arg1 = vb;
+            func.arg1_datatype = HYPERDATATYPE_BITMAP_INT64;
+            ASSERT_TRUE(di.check_args(func));
+            e::slice out;
+            ASSERT_TRUE(di.apply(va, &func, 1, &memory, &out));
+            std::set<uint32_t> expected;
+
+            for (std::set<uint32_t>::iterator it = a.begin(); it != a.end(); ++it)
+            {
+                bool in_b = b.find(*it) != b.end();
+
+                if (names[n] == hyperdex::FUNC_SET_UNION ||
+                    (names[n] == hyperdex::FUNC_SET_INTERSECT && in_b) ||
+                    (names[n] == hyperdex::FUNC_SET_DIFFERENCE && !in_b))
+                {
+                    expected.insert(*it);
+                }
+            }
+
+            if (names[n] == hyperdex::FUNC_SET_UNION)
+            {
+                expected.insert(b.begin(), b.end());
+            }
+
+            assert_same(out, expected);
+        }
+    }
+}
@@ -0,0 +1,140 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <cmath>
+#include <cstdio>
+#include <stdint.h>
+
+// STL
+#include <string>
+#include <vector>
+
+// e
+#include <e/arena.h>
+
+// HyperDex
+#include "test/th.h"
+#include "common/datatype_countmin.h"
+#include "common/datatype_hyperloglog.h"
+#include "common/funcall.h"
+
+using hyperdex::datatype_countmin;
+using hyperdex::datatype_hyperloglog;
+using hyperdex::funcall;
+
+namespace
+{
+
+// add elements [start, start + count) to the sketch in "value"
+void
+add_range(const hyperdex::datatype_info& di,
+          unsigned start, unsigned count,
+          e::arena* memory, e::slice* value)
+{
+    std::vector<std::string> elems(count);
+    std::vector<funcall> funcs(count);
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        char buf[32];
+        sprintf(buf, "element-%u", start + i);
+        elems[i] = buf;
+        funcs[i].name = hyperdex::FUNC_SKETCH_ADD;
+        funcs[i].arg1 = e::slice(elems[i]);
+        funcs[i].arg1_datatype = HYPERDATATYPE_STRING;
+        ASSERT_TRUE(di.check_args(funcs[i]));
+    }
+
+    ASSERT_TRUE(di.apply(*value, &funcs[0], funcs.size(), memory, value));
+}
+
+} // namespace
+
+TEST(DatatypeHyperLogLog, Validate)
+{
+    std::string regs(datatype_hyperloglog::REGISTERS, '\0');
+    ASSERT_TRUE(datatype_hyperloglog::static_validate(e::slice("", 0)));
+    ASSERT_TRUE(datatype_hyperloglog::static_validate(e::slice(regs)));
+    ASSERT_FALSE(datatype_hyperloglog::static_validate(e::slice(regs.data(), 17)));
+    regs[5] = 100;
+    ASSERT_FALSE(datatype_hyperloglog::static_validate(e::slice(regs)));
+}
+
+TEST(DatatypeHyperLogLog, Estimate)
+{
+    datatype_hyperloglog di;
+    e::arena memory;
+    e::slice value;
+    ASSERT_EQ(di.length(value), 0U);
+    add_range(di, 0, 10, &memory, &value);
+    ASSERT_EQ(value.size(), datatype_hyperloglog::REGISTERS);
+    ASSERT_EQ(di.length(value), 10U);
+    // adding the same elements again changes nothing
+    add_range(di, 0, 10, &memory, &value);
+    ASSERT_EQ(di.length(value), 10U);
+    add_range(di, 10, 99990, &memory, &value);
+    ASSERT_LT(fabs(static_cast<double>(di.length(value)) - 100000), 5000);
+}
+
+TEST(DatatypeHyperLogLog, Merge)
+{
+    datatype_hyperloglog di;
+    e::arena memory;
+    e::slice a;
+    e::slice b;
+    add_range(di, 0, 5000, &memory, &a);
+    add_range(di, 2500, 5000, &memory, &b);
+    funcall func;
+    func.name = hyperdex::FUNC_SKETCH_MERGE;
+    func.arg1 = b;
+    func.arg1_datatype = HYPERDATATYPE_HYPERLOGLOG;
+    ASSERT_TRUE(di.check_args(func));
+    ASSERT_TRUE(di.apply(a, &func, 1, &memory, &a));
+    ASSERT_LT(fabs(static_cast<double>(di.length(a)) - 7500), 375);
+}
+
+TEST(DatatypeCountMin, Estimate)
+{
+    datatype_countmin di;
+    e::arena memory;
+    e::slice value;
+    ASSERT_EQ(di.length(value), 0U);
+
+    for (unsigned i = 0; i < 10; ++i)
+    {
+        add_range(di, 0, i + 1, &memory, &value);
+    }
+
+    ASSERT_EQ(value.size(), datatype_countmin::SIZE);
+    ASSERT_EQ(di.length(value), 55U);
+    // count-min never underestimates
+    ASSERT_GE(datatype_countmin::estimate(value, e::slice("element-0")), 10U);
+    ASSERT_GE(datatype_countmin::estimate(value, e::slice("element-9")), 1U);
+    ASSERT_EQ(datatype_countmin::estimate(value, e::slice("no-such-element")), 0U);
+}
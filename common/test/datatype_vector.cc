@@ -0,0 +1,155 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+
+// STL
+#include <limits>
+#include <string>
+#include <vector>
+
+// e
+#include <e/endian.h>
+
+// HyperDex
+#include "test/th.h"
+#include "common/datatype_vector.h"
+
+using hyperdex::datatype_vector;
+
+namespace
+{
+
+std::string
+pack_floats(const std::vector<float>& fs)
+{
+    std::string out;
+
+    for (size_t i = 0; i < fs.size(); ++i)
+    {
+        uint32_t bits;
+        char buf[sizeof(uint32_t)];
+        memmove(&bits, &fs[i], sizeof(bits));
+        e::pack32le(bits, buf);
+        out.append(buf, sizeof(buf));
+    }
+
+    return out;
+}
+
+bool
+close_to(double x, double y)
+{
+    return fabs(x - y) <= 1e-4 * (1 + fabs(x) + fabs(y));
+}
+
+} // namespace
+
+TEST(DatatypeVector, Validate)
+{
+    std::vector<float> fs;
+    fs.push_back(1.5);
+    fs.push_back(-2);
+    std::string packed(pack_floats(fs));
+    ASSERT_TRUE(datatype_vector::static_validate(e::slice(packed)));
+    ASSERT_EQ(datatype_vector::dimension(e::slice(packed)), 2U);
+    ASSERT_TRUE(datatype_vector::static_validate(e::slice("", 0)));
+    // not a whole number of floats
+    ASSERT_FALSE(datatype_vector::static_validate(e::slice(packed.data(), 7)));
+    // no infinities or NaNs, which would poison every distance
+    fs.push_back(std::numeric_limits<float>::infinity());
+    packed = pack_floats(fs);
+    ASSERT_FALSE(datatype_vector::static_validate(e::slice(packed)));
+    fs.back() = std::numeric_limits<float>::quiet_NaN();
+    packed = pack_floats(fs);
+    ASSERT_FALSE(datatype_vector::static_validate(e::slice(packed)));
+}
+
+TEST(DatatypeVector, Unpack)
+{
+    std::vector<float> fs;
+
+    for (size_t i = 0; i < 13; ++i)
+    {
+        fs.push_back(i * 0.25f - 1);
+    }
+
+    std::string packed(pack_floats(fs));
+    std::vector<float> out;
+    datatype_vector::unpack(e::slice(packed), &out);
+    ASSERT_EQ(out.size(), fs.size());
+
+    for (size_t i = 0; i < fs.size(); ++i)
+    {
+        ASSERT_EQ(out[i], fs[i]);
+    }
+}
+
+TEST(DatatypeVector, KernelsMatchScalar)
+{
+    srand(0);
+
+    // every length up to a few SIMD widths, to cover the scalar tails
+    for (size_t n = 1; n < 40; ++n)
+    {
+        std::vector<float> a(n);
+        std::vector<float> b(n);
+        double l2 = 0;
+        double ab = 0;
+        double aa = 0;
+        double bb = 0;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            a[i] = static_cast<float>(rand()) / RAND_MAX - 0.5f;
+            b[i] = static_cast<float>(rand()) / RAND_MAX - 0.5f;
+            l2 += (a[i] - b[i]) * (a[i] - b[i]);
+            ab += a[i] * b[i];
+            aa += a[i] * a[i];
+            bb += b[i] * b[i];
+        }
+
+        ASSERT_TRUE(close_to(datatype_vector::l2_squared(&a[0], &b[0], n), l2));
+        ASSERT_TRUE(close_to(datatype_vector::cosine_distance(&a[0], &b[0], n),
+                             1 - ab / sqrt(aa * bb)));
+        ASSERT_TRUE(close_to(datatype_vector::distance(datatype_vector::L2, &a[0], &b[0], n), l2));
+    }
+}
+
+TEST(DatatypeVector, CosineOfZero)
+{
+    float zero[4] = {0, 0, 0, 0};
+    float one[4] = {1, 0, 0, 0};
+    ASSERT_EQ(datatype_vector::cosine_distance(zero, one, 4), 1.0);
+    ASSERT_EQ(datatype_vector::cosine_distance(zero, zero, 4), 1.0);
+    ASSERT_TRUE(close_to(datatype_vector::cosine_distance(one, one, 4), 0));
+}
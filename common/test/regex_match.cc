@@ -0,0 +1,172 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <cstring>
+
+// STL
+#include <string>
+#include <vector>
+
+// HyperDex
+#include "test/th.h"
+#include "common/regex_match.h"
+
+using hyperdex::regex_dfa;
+
+static bool
+matches(const char* regex, const char* text)
+{
+    const uint8_t* r = reinterpret_cast<const uint8_t*>(regex);
+    const uint8_t* t = reinterpret_cast<const uint8_t*>(text);
+    bool result = hyperdex::regex_match(r, strlen(regex), t, strlen(text));
+    // a reused automaton must give the same answer on the second pass
+    regex_dfa dfa(r, strlen(regex));
+    ASSERT_EQ(result, dfa.match(t, strlen(text)));
+    ASSERT_EQ(result, dfa.match(t, strlen(text)));
+    return result;
+}
+
+TEST(RegexMatch, Literals)
+{
+    ASSERT_TRUE(matches("", ""));
+    ASSERT_TRUE(matches("", "abc"));
+    ASSERT_TRUE(matches("abc", "abc"));
+    ASSERT_TRUE(matches("bc", "abcd"));
+    ASSERT_FALSE(matches("abd", "abc"));
+    ASSERT_FALSE(matches("abc", "ab"));
+    ASSERT_TRUE(matches("a.c", "xabcx"));
+    ASSERT_FALSE(matches("a.c", "ac"));
+}
+
+TEST(RegexMatch, Anchors)
+{
+    ASSERT_TRUE(matches("^", ""));
+    ASSERT_TRUE(matches("^ab", "abc"));
+    ASSERT_FALSE(matches("^bc", "abc"));
+    ASSERT_TRUE(matches("bc$", "abc"));
+    ASSERT_FALSE(matches("ab$", "abc"));
+    ASSERT_TRUE(matches("^abc$", "abc"));
+    ASSERT_FALSE(matches("^abc$", "abcc"));
+    ASSERT_TRUE(matches("$", "abc"));
+    ASSERT_TRUE(matches("^$", ""));
+    ASSERT_FALSE(matches("^$", "a"));
+    // "$" is only special at the end and "^" only at the start
+    ASSERT_TRUE(matches("a$b", "xa$b"));
+    ASSERT_TRUE(matches("a^b", "a^b"));
+}
+
+TEST(RegexMatch, Stars)
+{
+    ASSERT_TRUE(matches("^a*$", ""));
+    ASSERT_TRUE(matches("^a*$", "aaaa"));
+    ASSERT_FALSE(matches("^a*$", "aaba"));
+    ASSERT_TRUE(matches("^a*b", "aaab"));
+    ASSERT_TRUE(matches("^.*c$", "abc"));
+    ASSERT_TRUE(matches("^a.*b.*c$", "axxbyyc"));
+    ASSERT_FALSE(matches("^a.*b.*c$", "axxcyyb"));
+    ASSERT_TRUE(matches("^**$", "***"));
+}
+
+TEST(RegexMatch, Escapes)
+{
+    ASSERT_TRUE(matches("^a\\.c$", "a.c"));
+    ASSERT_FALSE(matches("^a\\.c$", "abc"));
+    ASSERT_TRUE(matches("^\\*$", "*"));
+    ASSERT_TRUE(matches("\\$$", "a$"));
+    // a trailing backslash matches nothing
+    ASSERT_FALSE(matches("a\\", "a\\"));
+}
+
+static std::string
+prefix(const char* regex)
+{
+    std::string p;
+
+    if (!hyperdex::regex_literal_prefix(reinterpret_cast<const uint8_t*>(regex),
+                                        strlen(regex), &p))
+    {
+        return "<none>";
+    }
+
+    return p;
+}
+
+TEST(RegexMatch, LiteralPrefix)
+{
+    ASSERT_EQ("<none>", prefix(""));
+    ASSERT_EQ("<none>", prefix("abc"));
+    ASSERT_EQ("<none>", prefix("^"));
+    ASSERT_EQ("<none>", prefix("^.abc"));
+    ASSERT_EQ("<none>", prefix("^a*bc"));
+    ASSERT_EQ("abc", prefix("^abc"));
+    ASSERT_EQ("abc", prefix("^abc$"));
+    ASSERT_EQ("user:12", prefix("^user:12.*"));
+    ASSERT_EQ("ab", prefix("^abc*"));
+    ASSERT_EQ("a.b", prefix("^a\\.b.c"));
+    ASSERT_EQ("ab$c", prefix("^ab$c"));
+}
+
+static std::string
+runs(const char* regex)
+{
+    std::vector<std::string> r;
+    hyperdex::regex_literal_runs(reinterpret_cast<const uint8_t*>(regex),
+                                 strlen(regex), &r);
+    std::string s;
+
+    for (size_t i = 0; i < r.size(); ++i)
+    {
+        s += i > 0 ? "|" : "";
+        s += r[i];
+    }
+
+    return s;
+}
+
+TEST(RegexMatch, LiteralRuns)
+{
+    ASSERT_EQ("", runs(""));
+    ASSERT_EQ("", runs(".*"));
+    ASSERT_EQ("abc", runs("abc"));
+    ASSERT_EQ("abc", runs("^abc$"));
+    ASSERT_EQ("err|disk", runs("err.*disk"));
+    ASSERT_EQ("a|cd", runs("ab*cd"));
+    ASSERT_EQ("a.b|c", runs("a\\.b.c"));
+    ASSERT_EQ("ab$c", runs("ab$c"));
+}
+
+TEST(RegexMatch, Pathological)
+{
+    // each star would multiply the work of a backtracking matcher
+    std::string text(10000, 'a');
+    const uint8_t* t = reinterpret_cast<const uint8_t*>(text.data());
+    const char* regex = ".*a.*a.*a.*a.*a.*a.*b";
+    ASSERT_FALSE(hyperdex::regex_match(reinterpret_cast<const uint8_t*>(regex),
+                                       strlen(regex), t, text.size()));
+}
@@ -702,7 +702,8 @@ coordinator :: space_mv(rsm_context* ctx, const char* src, const char* dst)
 
 void
 coordinator :: index_add(rsm_context* ctx,
-                         const char* space, const char* what)
+                         const char* space, const char* what,
+                         const e::slice& predicate)
 {
     space_map_t::iterator it;
     it = m_spaces.find(std::string(space));
@@ -721,8 +722,39 @@ coordinator :: index_add(rsm_context* ctx,
     std::string dotpath;
     index::index_t type;
     const char* ptr = strchr(what, '.');
-
-    if (ptr)
+    const char* comma = strchr(what, ',');
+    static const char trigram_prefix[] = "trigram:";
+    const size_t trigram_prefix_sz = sizeof(trigram_prefix) - 1;
+    static const char length_prefix[] = "length:";
+    const size_t length_prefix_sz = sizeof(length_prefix) - 1;
+    static const char bucket_prefix[] = "bucket:";
+    const size_t bucket_prefix_sz = sizeof(bucket_prefix) - 1;
+
+    if (strncmp(what, trigram_prefix, trigram_prefix_sz) == 0)
+    {
+        type = index::TRIGRAM;
+        attr.assign(what + trigram_prefix_sz, what_sz - trigram_prefix_sz);
+        dotpath.assign("", 0);
+    }
+    else if (strncmp(what, length_prefix, length_prefix_sz) == 0)
+    {
+        type = index::LENGTH;
+        attr.assign(what + length_prefix_sz, what_sz - length_prefix_sz);
+        dotpath.assign("", 0);
+    }
+    else if (strncmp(what, bucket_prefix, bucket_prefix_sz) == 0)
+    {
+        type = index::BUCKETED;
+        attr.assign(what + bucket_prefix_sz, what_sz - bucket_prefix_sz);
+        dotpath.assign("", 0);
+    }
+    else if (comma)
+    {
+        type = index::COMPOSITE;
+        attr.assign(what, comma - what);
+        dotpath.assign("", 0);
+    }
+    else if (ptr)
     {
         type = index::DOCUMENT;
         attr.assign(what, ptr - what);
@@ -751,6 +783,23 @@ coordinator :: index_add(rsm_context* ctx,
         return generate_response(ctx, COORD_NO_CAN_DO);
     }
 
+    if (type == index::NORMAL &&
+        CONTAINER_TYPE(sp->sc.attrs[attr_num].type) == HYPERDATATYPE_VECTOR_GENERIC)
+    {
+        rsm_log(ctx, "could not create index on \"%s\" on space \"%s\" because "
+                     "vectors are searched by distance, not indexed\n", what, space);
+        return generate_response(ctx, COORD_NO_CAN_DO);
+    }
+
+    if (type == index::NORMAL &&
+        (sp->sc.attrs[attr_num].type == HYPERDATATYPE_HYPERLOGLOG ||
+         sp->sc.attrs[attr_num].type == HYPERDATATYPE_COUNTMIN))
+    {
+        rsm_log(ctx, "could not create index on \"%s\" on space \"%s\" because "
+                     "sketches are summaries, not indexed values\n", what, space);
+        return generate_response(ctx, COORD_NO_CAN_DO);
+    }
+
     if (type == index::DOCUMENT &&
         sp->sc.attrs[attr_num].type != HYPERDATATYPE_DOCUMENT)
     {
@@ -759,11 +808,127 @@ coordinator :: index_add(rsm_context* ctx,
         return generate_response(ctx, COORD_NO_CAN_DO);
     }
 
+    if (type == index::TRIGRAM &&
+        sp->sc.attrs[attr_num].type != HYPERDATATYPE_STRING)
+    {
+        rsm_log(ctx, "could not create index on \"%s\" on space \"%s\" because "
+                     "trigram indices are only for strings\n", what, space);
+        return generate_response(ctx, COORD_NO_CAN_DO);
+    }
+
+    if (type == index::LENGTH &&
+        !length_indexable(sp->sc.attrs[attr_num].type))
+    {
+        rsm_log(ctx, "could not create index on \"%s\" on space \"%s\" because "
+                     "length indices are only for strings, lists, sets, maps, and bitmaps\n", what, space);
+        return generate_response(ctx, COORD_NO_CAN_DO);
+    }
+
+    if (type == index::BUCKETED &&
+        CONTAINER_TYPE(sp->sc.attrs[attr_num].type) != HYPERDATATYPE_TIMESTAMP_GENERIC)
+    {
+        rsm_log(ctx, "could not create index on \"%s\" on space \"%s\" because "
+                     "bucketed indices are only for timestamps\n", what, space);
+        return generate_response(ctx, COORD_NO_CAN_DO);
+    }
+
+    if (type == index::COMPOSITE)
+    {
+        // "a,b,c" covers a, then b, then c
+        std::vector<uint16_t> attrs;
+        const char* start = what;
+
+        while (true)
+        {
+            const char* end = strchr(start, ',');
+            end = end ? end : what + what_sz;
+            std::string name(start, end - start);
+            uint16_t num = sp->sc.lookup_attr(name.c_str());
+
+            if (num == 0 || num >= sp->sc.attrs_sz)
+            {
+                rsm_log(ctx, "could not create index on \"%s\" on space \"%s\" because "
+                             "\"%s\" is not a secondary attribute\n", what, space, name.c_str());
+                return generate_response(ctx, COORD_NOT_FOUND);
+            }
+
+            if (std::find(attrs.begin(), attrs.end(), num) != attrs.end() ||
+                !composite_indexable(sp->sc.attrs[num].type))
+            {
+                rsm_log(ctx, "could not create index on \"%s\" on space \"%s\" because "
+                             "\"%s\" cannot be part of a composite index\n", what, space, name.c_str());
+                return generate_response(ctx, COORD_NO_CAN_DO);
+            }
+
+            attrs.push_back(num);
+
+            if (*end == '\0')
+            {
+                break;
+            }
+
+            start = end + 1;
+        }
+
+        pack_composite_attrs(attrs, &dotpath);
+    }
+
+    // the predicate names attributes; the index stores them as checks
+    std::string checks;
+    e::unpacker up(predicate.data(), predicate.size());
+
+    while (!up.error() && up.remain())
+    {
+        e::slice name;
+        e::slice value;
+        hyperdatatype datatype;
+        hyperpredicate pred;
+        up = up >> name >> value >> datatype >> pred;
+
+        if (up.error())
+        {
+            break;
+        }
+
+        std::string name_str(name.cdata(), name.size());
+        uint16_t num = sp->sc.lookup_attr(name_str.c_str());
+
+        if (num >= sp->sc.attrs_sz)
+        {
+            rsm_log(ctx, "could not create index on \"%s\" on space \"%s\" because "
+                         "its predicate uses the unknown attribute \"%s\"\n", what, space, name_str.c_str());
+            return generate_response(ctx, COORD_NOT_FOUND);
+        }
+
+        if (datatype != sp->sc.attrs[num].type ||
+            !composite_indexable(datatype) ||
+            (pred != HYPERPREDICATE_EQUALS &&
+             pred != HYPERPREDICATE_LESS_THAN &&
+             pred != HYPERPREDICATE_LESS_EQUAL &&
+             pred != HYPERPREDICATE_GREATER_EQUAL &&
+             pred != HYPERPREDICATE_GREATER_THAN))
+        {
+            rsm_log(ctx, "could not create index on \"%s\" on space \"%s\" because "
+                         "its predicate on \"%s\" is not a comparison of a primitive\n", what, space, name_str.c_str());
+            return generate_response(ctx, COORD_NO_CAN_DO);
+        }
+
+        e::packer(&checks) << num << value << datatype << pred;
+    }
+
+    if (up.error())
+    {
+        rsm_log(ctx, "could not create index on \"%s\" on space \"%s\" because "
+                     "its predicate is malformed\n", what, space);
+        return generate_response(ctx, COORD_MALFORMED);
+    }
+
     for (size_t i = 0; i < sp->indices.size(); ++i)
     {
         if (sp->indices[i].type == type &&
             sp->indices[i].attr == attr_num &&
-            sp->indices[i].extra == e::slice(dotpath))
+            sp->indices[i].extra == e::slice(dotpath) &&
+            sp->indices[i].predicate == e::slice(checks))
         {
             rsm_log(ctx, "did not create index on \"%s\" on space \"%s\" because it is already indexed\n", what, space);
             return generate_response(ctx, COORD_DUPLICATE);
@@ -773,7 +938,7 @@ coordinator :: index_add(rsm_context* ctx,
     rsm_log(ctx, "creating index on \"%s\" on space \"%s\"\n", what, space);
     index_id id(m_counter);
     ++m_counter;
-    sp->indices.push_back(index(type, id, attr_num, e::slice(dotpath)));
+    sp->indices.push_back(index(type, id, attr_num, e::slice(dotpath), e::slice(checks)));
     sp->reestablish_backing();
     generate_next_configuration(ctx);
     return generate_response(ctx, COORD_SUCCESS);
@@ -99,7 +99,8 @@ class coordinator
 
     // index management
     public:
-        void index_add(rsm_context* ctx, const char* space, const char* attr);
+        void index_add(rsm_context* ctx, const char* space, const char* attr,
+                       const e::slice& predicate);
         void index_rm(rsm_context* ctx, index_id ii);
 
     // transfers management
@@ -328,7 +328,7 @@ hyperdex_coordinator_index_add(struct rsm_context* ctx,
     const char* space = data;
     size_t space_sz = strnlen(data, data_sz);
 
-    if (data_sz == 0 || data[data_sz - 1] != '\0' || space_sz + 2 >= data_sz)
+    if (data_sz == 0 || space_sz + 2 >= data_sz)
     {
         rsm_log(ctx, "received malformed \"add_index\" message\n");
         return generate_response(ctx, COORD_MALFORMED);
@@ -337,13 +337,16 @@ hyperdex_coordinator_index_add(struct rsm_context* ctx,
     const char* attr = data + space_sz + 1;
     size_t attr_sz = strnlen(attr, data_sz - space_sz - 1);
 
-    if (space_sz + attr_sz + 2 != data_sz)
+    if (space_sz + attr_sz + 2 > data_sz)
     {
         rsm_log(ctx, "received malformed \"add_index\" message\n");
         return generate_response(ctx, COORD_MALFORMED);
     }
 
-    c->index_add(ctx, space, attr);
+    // anything after the attribute is the predicate of a partial index
+    const char* pred = attr + attr_sz + 1;
+    size_t pred_sz = data_sz - space_sz - attr_sz - 2;
+    c->index_add(ctx, space, attr, e::slice(pred, pred_sz));
 }
 
 void
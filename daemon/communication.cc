@@ -450,7 +450,30 @@ communication :: recv(e::garbage_collector::thread_state* ts,
         uint64_t vidf;
         uint64_t vidt;
         *up = (*msg)->unpack_from(BUSYBEE_HEADER_SIZE);
-        *up = *up >> mt >> flags >> version >> vidt;
+        *up = *up >> mt;
+
+        // The answer to a batch that a group operation sent while imitating
+        // a client carries a client's header:  no flags, version, or
+        // destination
+        if (mt == static_cast<uint8_t>(RESP_MULTI_ATOMIC))
+        {
+            *up = *up >> vidf;
+            *msg_type = RESP_MULTI_ATOMIC;
+            *from = server_id(id);
+            *vfrom = virtual_server_id(vidf);
+            *vto = virtual_server_id(UINT64_MAX);
+
+            if (up->error() ||
+                *from != m_daemon->m_config.get_server_id(*vfrom))
+            {
+                LOG(WARNING) << "dropping RESP_MULTI_ATOMIC from the wrong server; here's some hex: " << (*msg)->hex();
+                continue;
+            }
+
+            return true;
+        }
+
+        *up = *up >> flags >> version >> vidt;
         *msg_type = static_cast<network_msgtype>(mt);
         *from = server_id(id);
         *vto = virtual_server_id(vidt);
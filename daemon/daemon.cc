@@ -36,6 +36,7 @@
 #include <unistd.h>
 
 // STL
+#include <algorithm>
 #include <sstream>
 
 // Google Log
@@ -51,7 +52,9 @@
 #include <e/strescape.h>
 
 // HyperDex
+#include <hyperdex/client.h>
 #include "common/coordinator_returncode.h"
+#include "common/datatype_info.h"
 #include "common/key_change.h"
 #include "common/serialization.h"
 #include "daemon/auth.h"
@@ -66,6 +69,7 @@ using hyperdex::daemon;
 
 int s_interrupts = 0;
 bool s_debug = false;
+bool s_measure = false;
 
 static void
 exit_on_signal(int /*signum*/)
@@ -93,6 +97,12 @@ handle_debug(int /*signum*/)
     s_debug = true;
 }
 
+static void
+handle_measure(int /*signum*/)
+{
+    s_measure = true;
+}
+
 daemon :: daemon()
     : m_us()
     , m_bind_to()
@@ -112,11 +122,14 @@ daemon :: daemon()
     , m_paused(false)
     , m_perf_req_get()
     , m_perf_req_get_partial()
+    , m_perf_req_multi_get()
     , m_perf_req_atomic()
+    , m_perf_req_multi_atomic()
     , m_perf_req_search_start()
     , m_perf_req_search_next()
     , m_perf_req_search_stop()
     , m_perf_req_sorted_search()
+    , m_perf_req_nearest_search()
     , m_perf_req_count()
     , m_perf_req_search_describe()
     , m_perf_req_group_atomic()
@@ -131,6 +144,7 @@ daemon :: daemon()
     , m_perf_xfer_ack()
     , m_perf_backup()
     , m_perf_perf_counters()
+    , m_perf_objects_expired()
     , m_block_stat_path()
     , m_stat_collector(make_obj_func(&daemon::collect_stats, this))
     , m_protect_stats()
@@ -173,6 +187,9 @@ generate_token(uint64_t* token)
     return true;
 }
 
+// how often, in nanoseconds, to sweep expired objects out of TTL spaces
+#define SWEEP_INTERVAL 10000000000ULL
+
 int
 daemon :: run(bool daemonize,
               std::string data,
@@ -188,6 +205,7 @@ daemon :: run(bool daemonize,
     if (!install_signal_handler(SIGHUP, exit_on_signal) ||
         !install_signal_handler(SIGINT, exit_on_signal) ||
         !install_signal_handler(SIGTERM, exit_on_signal) ||
+        !install_signal_handler(SIGUSR1, handle_measure) ||
         !install_signal_handler(SIGUSR2, handle_debug))
     {
         std::cerr << "could not install signal handlers: " << po6::strerror(errno) << std::endl;
@@ -354,6 +372,7 @@ daemon :: run(bool daemonize,
     uint64_t checkpoint = 0;
     uint64_t checkpoint_stable = 0;
     uint64_t checkpoint_gc = 0;
+    uint64_t next_sweep = po6::monotonic_time() + SWEEP_INTERVAL;
 
     while (__sync_fetch_and_add(&s_interrupts, 0) < 2)
     {
@@ -367,6 +386,13 @@ daemon :: run(bool daemonize,
             LOG(INFO) << "end debug dump";
         }
 
+        if (s_measure)
+        {
+            s_measure = false;
+            LOG(INFO) << "recieved SIGUSR1; measuring storage";
+            m_data.measure_storage();
+        }
+
         if (__sync_fetch_and_add(&s_interrupts, 0) == 1)
         {
             if (!install_signal_handler(SIGALRM, exit_after_timeout))
@@ -403,6 +429,12 @@ daemon :: run(bool daemonize,
             m_data.set_checkpoint_gc(checkpoint_gc);
         }
 
+        if (m_config.version() > 0 &&
+            po6::monotonic_time() >= next_sweep)
+        {
+            next_sweep = po6::monotonic_time() + SWEEP_INTERVAL;
+            m_data.sweep_expired();
+        }
 
         m_gc.offline(&m_gc_ts);
         bool have_config = m_coord->maintain();
@@ -590,10 +622,18 @@ daemon :: loop(size_t thread)
                 process_req_get_partial(from, vfrom, vto, msg, up);
                 m_perf_req_get_partial.tap();
                 break;
+            case REQ_MULTI_GET:
+                process_req_multi_get(from, vfrom, vto, msg, up);
+                m_perf_req_multi_get.tap();
+                break;
             case REQ_ATOMIC:
                 process_req_atomic(from, vfrom, vto, msg, up);
                 m_perf_req_atomic.tap();
                 break;
+            case REQ_MULTI_ATOMIC:
+                process_req_multi_atomic(from, vfrom, vto, msg, up);
+                m_perf_req_multi_atomic.tap();
+                break;
             case REQ_SEARCH_START:
                 process_req_search_start(from, vfrom, vto, msg, up);
                 m_perf_req_search_start.tap();
@@ -610,6 +650,10 @@ daemon :: loop(size_t thread)
                 process_req_sorted_search(from, vfrom, vto, msg, up);
                 m_perf_req_sorted_search.tap();
                 break;
+            case REQ_NEAREST_SEARCH:
+                process_req_nearest_search(from, vfrom, vto, msg, up);
+                m_perf_req_nearest_search.tap();
+                break;
             case REQ_COUNT:
                 process_req_count(from, vfrom, vto, msg, up);
                 m_perf_req_count.tap();
@@ -665,13 +709,19 @@ daemon :: loop(size_t thread)
                 process_perf_counters(from, vfrom, vto, msg, up);
                 m_perf_perf_counters.tap();
                 break;
+            case RESP_MULTI_ATOMIC:
+                process_resp_multi_atomic(from, vfrom, vto, msg, up);
+                break;
             case RESP_GET:
             case RESP_GET_PARTIAL:
+            case RESP_MULTI_GET:
             case RESP_ATOMIC:
             case RESP_GROUP_ATOMIC:
+            case RESP_GROUP_ATOMIC_PROGRESS:
             case RESP_SEARCH_ITEM:
             case RESP_SEARCH_DONE:
             case RESP_SORTED_SEARCH:
+            case RESP_NEAREST_SEARCH:
             case RESP_COUNT:
             case RESP_SEARCH_DESCRIBE:
             case CONFIGMISMATCH:
@@ -720,6 +770,10 @@ daemon :: process_req_get(server_id from,
     datalayer::reference ref;
     network_returncode result;
 
+    // sample in-flight writes before the read; see replica_may_serve_read
+    uint64_t pending = m_config.is_point_leader(vto)
+                     ? 0 : m_repl.max_pending_version(ri, key);
+
     switch (m_data.get(ri, key, &value, &version, &ref))
     {
         case datalayer::SUCCESS:
@@ -739,6 +793,15 @@ daemon :: process_req_get(server_id from,
             break;
     }
 
+    if (result != NET_SERVERERROR &&
+        !m_config.is_point_leader(vto) &&
+        !replica_may_serve_read(vto, ri, key, pending, has_value ? version : 0))
+    {
+        has_value = false;
+        value.clear();
+        result = NET_NOTUS;
+    }
+
     const schema* sc = m_config.get_schema(ri);
 
     if (!auth_verify_read(*sc, has_value, &value, (has_auth ? &aw : NULL)))
@@ -769,6 +832,37 @@ daemon :: process_req_get(server_id from,
     m_comm.send_client(vto, from, RESP_GET, msg);
 }
 
+// Reads usually go to the point leader, but the client's read policy may send
+// them to any replica of the key's region.  Every replica holds the value of
+// each write that has been acknowledged to a client.  The tail additionally
+// holds every write that has committed anywhere.  Other replicas only answer
+// if no write newer than "version" is in flight for the key, so that they
+// return the same value the tail would.  The read itself is not made under
+// the key's lock, so callers sample the in-flight writes before reading and
+// this checks them again afterwards; a write that came and went between the
+// two samples cannot be newer than the value read without showing up in one
+// of them.
+bool
+daemon :: replica_may_serve_read(const virtual_server_id& vto,
+                                 const region_id& ri,
+                                 const e::slice& key,
+                                 uint64_t pending_before,
+                                 uint64_t version)
+{
+    if (m_config.get_region_id(m_config.point_leader(ri, key)) != ri)
+    {
+        return false;
+    }
+
+    if (m_config.tail_of_region(ri) == vto)
+    {
+        return true;
+    }
+
+    uint64_t pending_after = m_repl.max_pending_version(ri, key);
+    return std::max(pending_before, pending_after) <= version;
+}
+
 void
 daemon :: process_req_get_partial(server_id from,
                                   virtual_server_id,
@@ -796,14 +890,37 @@ daemon :: process_req_get_partial(server_id from,
     }
 
     region_id ri = m_config.get_region_id(vto);
+    const schema* sc = m_config.get_schema(ri);
     std::sort(attrs.begin(), attrs.end());
+    // decode only what we'll return, plus the secret needed to authorize
+    std::vector<uint16_t> wanted;
+    size_t lengths = 0;
+
+    for (size_t i = 0; i < attrs.size(); ++i)
+    {
+        wanted.push_back(attrs[i] & ~HYPERDEX_ATTRIBUTE_LENGTH_BIT);
+        lengths += (attrs[i] & HYPERDEX_ATTRIBUTE_LENGTH_BIT) ? 1 : 0;
+    }
+
+    if (sc->authorization)
+    {
+        wanted.push_back(sc->lookup_attr(HYPERDEX_ATTRIBUTE_SECRET));
+    }
+
+    std::sort(wanted.begin(), wanted.end());
+    wanted.erase(std::unique(wanted.begin(), wanted.end()), wanted.end());
+
     bool has_value = false;
     std::vector<e::slice> value;
     uint64_t version;
     datalayer::reference ref;
     network_returncode result;
 
-    switch (m_data.get(ri, key, &value, &version, &ref))
+    // sample in-flight writes before the read; see replica_may_serve_read
+    uint64_t pending = m_config.is_point_leader(vto)
+                     ? 0 : m_repl.max_pending_version(ri, key);
+
+    switch (m_data.get_attrs(ri, key, wanted, &value, &version, &ref))
     {
         case datalayer::SUCCESS:
             has_value = true;
@@ -822,7 +939,14 @@ daemon :: process_req_get_partial(server_id from,
             break;
     }
 
-    const schema* sc = m_config.get_schema(ri);
+    if (result != NET_SERVERERROR &&
+        !m_config.is_point_leader(vto) &&
+        !replica_may_serve_read(vto, ri, key, pending, has_value ? version : 0))
+    {
+        has_value = false;
+        value.clear();
+        result = NET_NOTUS;
+    }
 
     if (!auth_verify_read(*sc, has_value, &value, (has_auth ? &aw : NULL)))
     {
@@ -839,7 +963,8 @@ daemon :: process_req_get_partial(server_id from,
                   + sizeof(uint64_t)
                   + sizeof(uint16_t)
                   + pack_size(value)
-                  + value.size() * sizeof(uint16_t);
+                  + value.size() * sizeof(uint16_t)
+                  + lengths * (sizeof(uint16_t) + sizeof(uint32_t) + sizeof(uint64_t));
         msg.reset(e::buffer::create(sz));
         e::packer pa = msg->pack_at(HYPERDEX_HEADER_SIZE_VC);
         pa = pa << nonce << static_cast<uint16_t>(result);
@@ -854,6 +979,17 @@ daemon :: process_req_get_partial(server_id from,
                 {
                     pa = pa << attr << value[i];
                 }
+
+                uint16_t length_attr = attr | HYPERDEX_ATTRIBUTE_LENGTH_BIT;
+                datatype_info* di = datatype_info::lookup(sc->attrs[attr].type);
+
+                if (std::binary_search(attrs.begin(), attrs.end(), length_attr) &&
+                    di->has_length())
+                {
+                    char buf[sizeof(int64_t)];
+                    e::pack64le(di->length(value[i]), buf);
+                    pa = pa << length_attr << e::slice(buf, sizeof(buf));
+                }
             }
         }
     }
@@ -861,6 +997,97 @@ daemon :: process_req_get_partial(server_id from,
     m_comm.send_client(vto, from, RESP_GET_PARTIAL, msg);
 }
 
+void
+daemon :: process_req_multi_get(server_id from,
+                                virtual_server_id,
+                                virtual_server_id vto,
+                                std::auto_ptr<e::buffer> msg,
+                                e::unpacker up)
+{
+    uint64_t nonce;
+    std::vector<e::slice> keys;
+    bool has_auth = false;
+    auth_wallet aw;
+    up = up >> nonce >> keys;
+
+    if (up.remain())
+    {
+        has_auth = true;
+        up = up >> aw;
+    }
+
+    if (up.error())
+    {
+        LOG(WARNING) << "unpack of REQ_MULTI_GET failed; here's some hex:  " << msg->hex();
+        return;
+    }
+
+    region_id ri = m_config.get_region_id(vto);
+    const schema* sc = m_config.get_schema(ri);
+    std::vector<datalayer::returncode> rcs;
+    std::vector<std::vector<e::slice> > values;
+    std::vector<uint64_t> versions;
+    std::vector<datalayer::reference> refs;
+    m_data.get_many(ri, keys, &rcs, &values, &versions, &refs);
+    std::vector<network_returncode> results(keys.size());
+    size_t sz = HYPERDEX_HEADER_SIZE_VC
+              + sizeof(uint64_t)
+              + sizeof(uint64_t);
+
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        bool has_value = false;
+
+        switch (rcs[i])
+        {
+            case datalayer::SUCCESS:
+                has_value = true;
+                results[i] = NET_SUCCESS;
+                break;
+            case datalayer::NOT_FOUND:
+                results[i] = NET_NOTFOUND;
+                break;
+            case datalayer::BAD_ENCODING:
+            case datalayer::CORRUPTION:
+            case datalayer::IO_ERROR:
+            case datalayer::LEVELDB_ERROR:
+            default:
+                LOG(ERROR) << "MULTI_GET returned unacceptable error code.";
+                results[i] = NET_SERVERERROR;
+                break;
+        }
+
+        if (!auth_verify_read(*sc, has_value, &values[i], (has_auth ? &aw : NULL)))
+        {
+            results[i] = NET_UNAUTHORIZED;
+        }
+
+        if (results[i] == NET_SUCCESS)
+        {
+            sanitize_secrets(*sc, &values[i]);
+            sz += pack_size(values[i]);
+        }
+
+        sz += sizeof(uint16_t);
+    }
+
+    msg.reset(e::buffer::create(sz));
+    e::packer pa = msg->pack_at(HYPERDEX_HEADER_SIZE_VC);
+    pa = pa << nonce << static_cast<uint64_t>(keys.size());
+
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        pa = pa << static_cast<uint16_t>(results[i]);
+
+        if (results[i] == NET_SUCCESS)
+        {
+            pa = pa << values[i];
+        }
+    }
+
+    m_comm.send_client(vto, from, RESP_MULTI_GET, msg);
+}
+
 void
 daemon :: process_req_atomic(server_id from,
                              virtual_server_id,
@@ -883,6 +1110,26 @@ daemon :: process_req_atomic(server_id from,
     m_repl.client_atomic(from, vto, nonce, kc, msg);
 }
 
+void
+daemon :: process_req_multi_atomic(server_id from,
+                                   virtual_server_id,
+                                   virtual_server_id vto,
+                                   std::auto_ptr<e::buffer> msg,
+                                   e::unpacker up)
+{
+    uint64_t nonce;
+    std::vector<e::slice> ops;
+    up = up >> nonce >> ops;
+
+    if (up.error())
+    {
+        LOG(WARNING) << "unpack of REQ_MULTI_ATOMIC failed; here's some hex:  " << msg->hex();
+        return;
+    }
+
+    m_repl.client_atomic_many(from, vto, nonce, ops);
+}
+
 void
 daemon :: process_req_search_start(server_id from,
                                    virtual_server_id,
@@ -963,6 +1210,31 @@ daemon :: process_req_sorted_search(server_id from,
     m_sm.sorted_search(from, vto, nonce, &checks, limit, sort_by, flags & 0x1);
 }
 
+void
+daemon :: process_req_nearest_search(server_id from,
+                                     virtual_server_id,
+                                     virtual_server_id vto,
+                                     std::auto_ptr<e::buffer> msg,
+                                     e::unpacker up)
+{
+    uint64_t nonce;
+    std::vector<attribute_check> checks;
+    uint64_t limit;
+    uint16_t attr;
+    uint8_t metric;
+    e::slice vector;
+
+    if ((up >> nonce >> checks >> limit >> attr >> metric >> vector).error() ||
+        (metric != datatype_vector::L2 && metric != datatype_vector::COSINE))
+    {
+        LOG(WARNING) << "unpack of REQ_NEAREST_SEARCH failed; here's some hex:  " << msg->hex();
+        return;
+    }
+
+    m_sm.nearest_search(from, vto, nonce, &checks, limit, attr,
+                        static_cast<datatype_vector::metric_t>(metric), vector);
+}
+
 void
 daemon :: process_req_count(server_id from,
                             virtual_server_id,
@@ -1020,7 +1292,26 @@ daemon :: process_req_group_atomic(server_id from,
 
     // Only forward the actual atomic operation
     e::slice sl = up.remainder();
-    m_sm.group_keyop(from, vto, nonce, &checks, REQ_ATOMIC, sl, RESP_GROUP_ATOMIC);
+    m_sm.group_keyop(from, vto, msg, nonce, &checks, sl, RESP_GROUP_ATOMIC);
+}
+
+void
+daemon :: process_resp_multi_atomic(server_id from,
+                                    virtual_server_id,
+                                    virtual_server_id,
+                                    std::auto_ptr<e::buffer> msg,
+                                    e::unpacker up)
+{
+    uint64_t nonce;
+
+    if ((up >> nonce).error())
+    {
+        LOG(WARNING) << "unpack of RESP_MULTI_ATOMIC failed; here's some hex:  " << msg->hex();
+        return;
+    }
+
+    // only the batches of group operations are sent by daemons
+    m_sm.group_keyop_response(from, nonce);
 }
 
 void
@@ -1346,6 +1637,7 @@ daemon :: collect_stats()
         std::ostringstream ret;
         ret << target;
         collect_stats_msgs(&ret);
+        collect_stats_objects(&ret);
         collect_stats_leveldb(&ret);
         collect_stats_io(&ret);
         ret << "\n";
@@ -1369,11 +1661,14 @@ daemon :: collect_stats_msgs(std::ostringstream* ret)
 {
     *ret << " msgs.req_get=" << m_perf_req_get.read();
     *ret << " msgs.req_get_partial=" << m_perf_req_get_partial.read();
+    *ret << " msgs.req_multi_get=" << m_perf_req_multi_get.read();
     *ret << " msgs.req_atomic=" << m_perf_req_atomic.read();
+    *ret << " msgs.req_multi_atomic=" << m_perf_req_multi_atomic.read();
     *ret << " msgs.req_search_start=" << m_perf_req_search_start.read();
     *ret << " msgs.req_search_next=" << m_perf_req_search_next.read();
     *ret << " msgs.req_search_stop=" << m_perf_req_search_stop.read();
     *ret << " msgs.req_sorted_search=" << m_perf_req_sorted_search.read();
+    *ret << " msgs.req_nearest_search=" << m_perf_req_nearest_search.read();
     *ret << " msgs.req_count=" << m_perf_req_count.read();
     *ret << " msgs.req_search_describe=" << m_perf_req_search_describe.read();
     *ret << " msgs.req_group_atomic=" << m_perf_req_group_atomic.read();
@@ -1385,6 +1680,12 @@ daemon :: collect_stats_msgs(std::ostringstream* ret)
     *ret << " msgs.perf_counters=" << m_perf_perf_counters.read();
 }
 
+void
+daemon :: collect_stats_objects(std::ostringstream* ret)
+{
+    *ret << " objects.expired=" << m_perf_objects_expired.read();
+}
+
 namespace
 {
 
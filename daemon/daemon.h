@@ -82,14 +82,18 @@ class daemon
         void loop(size_t thread);
         void process_req_get(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
         void process_req_get_partial(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
+        void process_req_multi_get(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
         void process_req_atomic(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
+        void process_req_multi_atomic(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
         void process_req_search_start(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
         void process_req_search_next(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
         void process_req_search_stop(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
         void process_req_sorted_search(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
+        void process_req_nearest_search(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
         void process_req_count(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
         void process_req_search_describe(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
         void process_req_group_atomic(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
+        void process_resp_multi_atomic(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
         void process_chain_op(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
         void process_chain_subspace(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
         void process_chain_ack(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
@@ -103,8 +107,14 @@ class daemon
         void process_perf_counters(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
 
     private:
+        bool replica_may_serve_read(const virtual_server_id& vto,
+                                    const region_id& ri,
+                                    const e::slice& key,
+                                    uint64_t pending_before,
+                                    uint64_t version);
         void collect_stats();
         void collect_stats_msgs(std::ostringstream* ret);
+        void collect_stats_objects(std::ostringstream* ret);
         void collect_stats_leveldb(std::ostringstream* ret);
         void determine_block_stat_path(const std::string& data);
         void collect_stats_io(std::ostringstream* ret);
@@ -140,11 +150,14 @@ class daemon
         // counters
         performance_counter m_perf_req_get;
         performance_counter m_perf_req_get_partial;
+        performance_counter m_perf_req_multi_get;
         performance_counter m_perf_req_atomic;
+        performance_counter m_perf_req_multi_atomic;
         performance_counter m_perf_req_search_start;
         performance_counter m_perf_req_search_next;
         performance_counter m_perf_req_search_stop;
         performance_counter m_perf_req_sorted_search;
+        performance_counter m_perf_req_nearest_search;
         performance_counter m_perf_req_count;
         performance_counter m_perf_req_search_describe;
         performance_counter m_perf_req_group_atomic;
@@ -159,6 +172,8 @@ class daemon
         performance_counter m_perf_xfer_ack;
         performance_counter m_perf_backup;
         performance_counter m_perf_perf_counters;
+        // objects deleted because they outlived their space's TTL
+        performance_counter m_perf_objects_expired;
         // iostat-like stats
         std::string m_block_stat_path;
         // historical data
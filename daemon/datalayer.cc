@@ -31,8 +31,12 @@
 #include "config.h"
 #endif
 
+// C
+#include <string.h>
+
 // POSIX
 #include <signal.h>
+#include <sys/time.h>
 
 // STL
 #include <algorithm>
@@ -66,7 +70,11 @@
 #include "daemon/datalayer_index_state.h"
 #include "daemon/datalayer_indexer_thread.h"
 #include "daemon/datalayer_iterator.h"
+#include "daemon/datalayer_measurer_thread.h"
+#include "daemon/datalayer_sweeper_thread.h"
 #include "daemon/datalayer_wiper_thread.h"
+#include "daemon/index_composite.h"
+#include "daemon/index_document.h"
 
 #define STRLENOF(x)	(sizeof(x)-1)
 
@@ -86,6 +94,8 @@ datalayer :: datalayer(daemon* d)
     , m_mediator(new wiper_indexer_mediator())
     , m_indexer(new indexer_thread(d, m_mediator.get()))
     , m_wiper(new wiper_thread(d, m_mediator.get()))
+    , m_sweeper(new sweeper_thread(d))
+    , m_measurer(new measurer_thread(d))
 {
 }
 
@@ -94,9 +104,12 @@ datalayer :: ~datalayer() throw ()
     m_checkpointer->shutdown();
     m_indexer->shutdown();
     m_wiper->shutdown();
+    m_sweeper->shutdown();
+    m_measurer->shutdown();
 }
 
 #define FORMAT_1_6 "v1.6.0 format"
+#define FORMAT_1_7 "v1.7.0 format"
 
 bool
 datalayer :: initialize(const std::string& path,
@@ -137,12 +150,21 @@ datalayer :: initialize(const std::string& path,
     {
         first_time = false;
 
-        if (rbacking != FORMAT_1_6)
+        if (rbacking == FORMAT_1_6)
+        {
+            LOG(INFO) << "upgrading the existing data to the v1.7.0 format";
+
+            if (!upgrade_16_to_17())
+            {
+                return false;
+            }
+        }
+        else if (rbacking != FORMAT_1_7)
         {
             LOG(ERROR) << "could not restore daemon "
                        << "the existing data was created with"
                        << "HyperDex " << rbacking << " but "
-                       << "this is requires the v1.6.0-compatible format";
+                       << "this is requires the v1.7.0-compatible format";
             return false;
         }
     }
@@ -150,7 +172,7 @@ datalayer :: initialize(const std::string& path,
     {
         first_time = true;
         leveldb::Slice k("hyperdex", 8);
-        leveldb::Slice v(FORMAT_1_6, STRLENOF(FORMAT_1_6));
+        leveldb::Slice v(FORMAT_1_7, STRLENOF(FORMAT_1_7));
         st = m_db->Put(wopts, k, v);
 
         if (!st.ok())
@@ -211,6 +233,8 @@ datalayer :: initialize(const std::string& path,
     m_checkpointer->start();
     m_indexer->start();
     m_wiper->start();
+    m_sweeper->start();
+    m_measurer->start();
     *saved = !first_time;
     return true;
 }
@@ -221,6 +245,8 @@ datalayer :: teardown()
     m_checkpointer->shutdown();
     m_indexer->shutdown();
     m_wiper->shutdown();
+    m_sweeper->shutdown();
+    m_measurer->shutdown();
 }
 
 bool
@@ -255,6 +281,8 @@ datalayer :: pause()
     m_checkpointer->initiate_pause();
     m_indexer->initiate_pause();
     m_wiper->initiate_pause();
+    m_sweeper->initiate_pause();
+    m_measurer->initiate_pause();
 }
 
 void
@@ -263,6 +291,8 @@ datalayer :: unpause()
     m_checkpointer->unpause();
     m_indexer->unpause();
     m_wiper->unpause();
+    m_sweeper->unpause();
+    m_measurer->unpause();
 }
 
 void
@@ -273,6 +303,8 @@ datalayer :: reconfigure(const configuration&,
     m_checkpointer->wait_until_paused();
     m_indexer->wait_until_paused();
     m_wiper->wait_until_paused();
+    m_sweeper->wait_until_paused();
+    m_measurer->wait_until_paused();
 
     // indices that must exist
     std::vector<std::pair<region_id, index_id> > indices;
@@ -388,6 +420,14 @@ datalayer :: debug_dump()
     m_mediator->debug_dump();
     m_indexer->debug_dump();
     m_wiper->debug_dump();
+    m_sweeper->debug_dump();
+    m_measurer->debug_dump();
+}
+
+void
+datalayer :: measure_storage()
+{
+    m_measurer->request_measure();
 }
 
 bool
@@ -423,6 +463,25 @@ datalayer :: get(const region_id& ri,
                  std::vector<e::slice>* value,
                  uint64_t* version,
                  reference* ref)
+{
+    const schema& sc(*m_daemon->m_config.get_schema(ri));
+    returncode rc = get_even_if_expired(ri, key, value, version, ref);
+
+    if (rc == SUCCESS && sc.ttl_attr != 0 && sc.ttl_attr <= value->size() &&
+        has_expired((*value)[sc.ttl_attr - 1], expiry_cutoff(sc)))
+    {
+        return NOT_FOUND;
+    }
+
+    return rc;
+}
+
+datalayer::returncode
+datalayer :: get_even_if_expired(const region_id& ri,
+                                 const e::slice& key,
+                                 std::vector<e::slice>* value,
+                                 uint64_t* version,
+                                 reference* ref)
 {
     const schema& sc(*m_daemon->m_config.get_schema(ri));
     std::vector<char> scratch;
@@ -452,12 +511,156 @@ datalayer :: get(const region_id& ri,
     }
 }
 
+datalayer::returncode
+datalayer :: get_attrs(const region_id& ri,
+                       const e::slice& key,
+                       const std::vector<uint16_t>& attrs,
+                       std::vector<e::slice>* value,
+                       uint64_t* version,
+                       reference* ref)
+{
+    const schema& sc(*m_daemon->m_config.get_schema(ri));
+    std::vector<char> scratch;
+
+    // create the encoded key
+    leveldb::Slice lkey;
+    encode_key(ri, sc.attrs[0].type, key, &scratch, &lkey);
+
+    // perform the read
+    leveldb::ReadOptions opts;
+    opts.fill_cache = true;
+    opts.verify_checksums = true;
+    leveldb::Status st = m_db->Get(opts, lkey, &ref->m_backing);
+
+    if (st.ok())
+    {
+        e::slice v(ref->m_backing.data(), ref->m_backing.size());
+        value_decoder vd;
+        returncode rc = vd.parse(v);
+
+        if (rc == SUCCESS)
+        {
+            *version = vd.version();
+            rc = vd.attrs(attrs, value);
+        }
+
+        if (rc == SUCCESS && sc.ttl_attr != 0)
+        {
+            e::slice ttl_value;
+            rc = vd.attr(sc.ttl_attr - 1, &ttl_value);
+
+            if (rc == SUCCESS && has_expired(ttl_value, expiry_cutoff(sc)))
+            {
+                return NOT_FOUND;
+            }
+        }
+
+        return rc;
+    }
+    else if (st.IsNotFound())
+    {
+        return NOT_FOUND;
+    }
+    else
+    {
+        return handle_error(st);
+    }
+}
+
+namespace
+{
+
+class lkey_order
+{
+    public:
+        lkey_order(const std::vector<leveldb::Slice>* lkeys) : m_lkeys(lkeys) {}
+        bool operator () (size_t lhs, size_t rhs) const
+        { return (*m_lkeys)[lhs].compare((*m_lkeys)[rhs]) < 0; }
+
+    private:
+        const std::vector<leveldb::Slice>* m_lkeys;
+};
+
+} // namespace
+
+void
+datalayer :: get_many(const region_id& ri,
+                      const std::vector<e::slice>& keys,
+                      std::vector<returncode>* rcs,
+                      std::vector<std::vector<e::slice> >* values,
+                      std::vector<uint64_t>* versions,
+                      std::vector<reference>* refs)
+{
+    const schema& sc(*m_daemon->m_config.get_schema(ri));
+    std::vector<std::vector<char> > scratch(keys.size());
+    std::vector<leveldb::Slice> lkeys(keys.size());
+    std::vector<size_t> order(keys.size());
+
+    // create the encoded keys
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        encode_key(ri, sc.attrs[0].type, keys[i], &scratch[i], &lkeys[i]);
+        order[i] = i;
+    }
+
+    // read in key order so that lookups walk the same blocks in sequence
+    std::sort(order.begin(), order.end(), lkey_order(&lkeys));
+    rcs->resize(keys.size());
+    values->resize(keys.size());
+    versions->resize(keys.size());
+    refs->resize(keys.size());
+    snapshot snap = make_snapshot();
+    leveldb::ReadOptions opts;
+    opts.fill_cache = true;
+    opts.verify_checksums = true;
+    opts.snapshot = snap.get();
+    const uint64_t cutoff = expiry_cutoff(sc);
+
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        const size_t idx = order[i];
+        reference* ref = &(*refs)[idx];
+        leveldb::Status st = m_db->Get(opts, lkeys[idx], &ref->m_backing);
+
+        if (st.ok())
+        {
+            e::slice v(ref->m_backing.data(), ref->m_backing.size());
+            (*rcs)[idx] = decode_value(v, &(*values)[idx], &(*versions)[idx]);
+
+            if ((*rcs)[idx] == SUCCESS && sc.ttl_attr != 0 &&
+                sc.ttl_attr <= (*values)[idx].size() &&
+                has_expired((*values)[idx][sc.ttl_attr - 1], cutoff))
+            {
+                (*rcs)[idx] = NOT_FOUND;
+            }
+        }
+        else if (st.IsNotFound())
+        {
+            (*rcs)[idx] = NOT_FOUND;
+        }
+        else
+        {
+            (*rcs)[idx] = handle_error(st);
+        }
+    }
+}
+
 datalayer::returncode
 datalayer :: del(const region_id& ri,
                  const e::slice& key,
                  const std::vector<e::slice>& old_value)
 {
     leveldb::WriteBatch updates;
+    batch_del(ri, key, old_value, &updates);
+    return write_batch(&updates);
+}
+
+void
+datalayer :: batch_del(const region_id& ri,
+                       const e::slice& key,
+                       const std::vector<e::slice>& old_value,
+                       leveldb::WriteBatch* updates)
+{
     const schema& sc(*m_daemon->m_config.get_schema(ri));
     std::vector<char> scratch;
 
@@ -466,17 +669,21 @@ datalayer :: del(const region_id& ri,
     encode_key(ri, sc.attrs[0].type, key, &scratch, &lkey);
 
     // delete the actual object
-    updates.Delete(lkey);
+    updates->Delete(lkey);
 
     // delete the index entries
     std::vector<const index*> indices;
     find_indices(ri, &indices);
-    create_index_changes(sc, ri, indices, key, &old_value, NULL, &updates);
+    create_index_changes(sc, ri, indices, key, &old_value, NULL, updates);
+}
 
+datalayer::returncode
+datalayer :: write_batch(leveldb::WriteBatch* updates)
+{
     // Perform the write
     leveldb::WriteOptions opts;
     opts.sync = false;
-    leveldb::Status st = m_db->Write(opts, &updates);
+    leveldb::Status st = m_db->Write(opts, updates);
 
     if (st.ok())
     {
@@ -687,11 +894,84 @@ datalayer :: make_snapshot()
     return leveldb_snapshot_ptr(m_db, m_db->GetSnapshot());
 }
 
+namespace
+{
+
+// A partial index only holds the objects that pass its predicate, so a search
+// may use it only if each of the index's checks follows from one of its own:
+// the same check, or an equality whose value passes the index's check.
+bool
+search_implies_predicate(const hyperdex::schema& sc,
+                         const hyperdex::index& idx,
+                         const std::vector<hyperdex::attribute_check>& checks)
+{
+    using hyperdex::attribute_check;
+    std::vector<attribute_check> required;
+
+    if (idx.predicate.empty())
+    {
+        return true;
+    }
+
+    if (!hyperdex::decode_index_predicate(idx, &required))
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < required.size(); ++i)
+    {
+        const attribute_check& r(required[i]);
+        bool implied = false;
+
+        if (r.attr >= sc.attrs_sz)
+        {
+            return false;
+        }
+
+        for (size_t j = 0; !implied && j < checks.size(); ++j)
+        {
+            const attribute_check& c(checks[j]);
+
+            if (c.attr != r.attr)
+            {
+                continue;
+            }
+
+            implied = (c.predicate == r.predicate &&
+                       c.datatype == r.datatype &&
+                       c.value == r.value) ||
+                      (c.predicate == HYPERPREDICATE_EQUALS &&
+                       c.datatype == sc.attrs[c.attr].type &&
+                       hyperdex::passes_attribute_check(sc.attrs[r.attr].type, r, c.value));
+        }
+
+        if (!implied)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
 datalayer::iterator*
 datalayer :: make_search_iterator(snapshot snap,
                                   const region_id& ri,
                                   const std::vector<attribute_check>& checks,
                                   std::ostringstream* ostr)
+{
+    const schema& sc(*m_daemon->m_config.get_schema(ri));
+    return make_search_iterator(snap, ri, checks, ostr, expiry_cutoff(sc));
+}
+
+datalayer::iterator*
+datalayer :: make_search_iterator(snapshot snap,
+                                  const region_id& ri,
+                                  const std::vector<attribute_check>& checks,
+                                  std::ostringstream* ostr,
+                                  uint64_t hide_expired_before)
 {
     const schema& sc(*m_daemon->m_config.get_schema(ri));
     std::vector<e::intrusive_ptr<index_iterator> > iterators;
@@ -720,9 +1000,9 @@ datalayer :: make_search_iterator(snapshot snap,
         {
             assert(indices[j]->attr == ranges[i].attr);
             const index* idx = indices[j];
-            const index_info* ii = index_info::lookup(ranges[i].type);
+            const index_info* ii = index_info::lookup(*idx, ranges[i].type);
 
-            if (!ii)
+            if (!ii || !search_implies_predicate(sc, *idx, checks))
             {
                 continue;
             }
@@ -750,9 +1030,11 @@ datalayer :: make_search_iterator(snapshot snap,
         for (size_t j = 0; j < indices.size(); ++j)
         {
             const index* idx = indices[j];
-            const index_info* ii = index_info::lookup(sc.attrs[checks[i].attr].type);
+            const index_info* ii = index_info::lookup(*idx, sc.attrs[checks[i].attr].type);
 
-            if (!ii)
+            if (!ii ||
+                !document_index_covers(*idx, checks[i]) ||
+                !search_implies_predicate(sc, *idx, checks))
             {
                 continue;
             }
@@ -766,6 +1048,27 @@ datalayer :: make_search_iterator(snapshot snap,
         }
     }
 
+    // composite indices turn equalities plus one range into a single scan
+    std::vector<const index*> all_indices;
+    find_indices(ri, &all_indices);
+
+    for (size_t i = 0; i < all_indices.size(); ++i)
+    {
+        if (all_indices[i]->type != index::COMPOSITE ||
+            !search_implies_predicate(sc, *all_indices[i], checks))
+        {
+            continue;
+        }
+
+        e::intrusive_ptr<index_iterator> it;
+        it = composite_iterator_from_ranges(snap, sc, ri, all_indices[i], ranges, key_ie);
+
+        if (it)
+        {
+            iterators.push_back(it);
+        }
+    }
+
     // figure out the cost of accessing all objects
     e::intrusive_ptr<index_iterator> full_scan;
     full_scan = key_ii->iterator_for_keys(snap, ri);
@@ -797,15 +1100,22 @@ datalayer :: make_search_iterator(snapshot snap,
 
     e::intrusive_ptr<index_iterator> best;
 
-    if (!best && !sorted.empty())
+    if (!sorted.empty())
     {
         best = new intersect_iterator(snap, sorted);
     }
-    else if (!best && !unsorted.empty())
+
+    // an unsorted iterator can still beat the intersection, e.g. a composite
+    // index that covers what the intersection would seek between
+    for (size_t i = 0; i < unsorted.size(); ++i)
     {
-        best = unsorted[0];
+        if (!best || unsorted[i]->cost(m_db.get()) < best->cost(m_db.get()))
+        {
+            best = unsorted[i];
+        }
     }
-    else
+
+    if (!best)
     {
         best = full_scan;
     }
@@ -819,7 +1129,7 @@ datalayer :: make_search_iterator(snapshot snap,
     }
 
     if (ostr) *ostr << " choosing to use " << *best << "\n";
-    return new search_iterator(this, ri, best, ostr, &checks);
+    return new search_iterator(this, ri, best, ostr, &checks, hide_expired_before);
 }
 
 bool
@@ -1220,6 +1530,47 @@ datalayer :: has_index_marker(const region_id& ri, const index_id& ii)
     return st.ok();
 }
 
+uint64_t
+datalayer :: wallclock_micros()
+{
+    // timestamps are microseconds since the epoch, so expiry must use the
+    // wall clock rather than po6::monotonic_time
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return static_cast<uint64_t>(tv.tv_sec) * 1000000ULL + tv.tv_usec;
+}
+
+uint64_t
+datalayer :: expiry_cutoff(const schema& sc)
+{
+    if (sc.ttl_attr == 0)
+    {
+        return 0;
+    }
+
+    uint64_t now = wallclock_micros();
+    return now > sc.ttl ? now - sc.ttl : 0;
+}
+
+bool
+datalayer :: has_expired(const e::slice& ttl_value, uint64_t cutoff)
+{
+    if (cutoff == 0 || ttl_value.size() != sizeof(int64_t))
+    {
+        return false;
+    }
+
+    int64_t timestamp;
+    e::unpack64le(ttl_value.data(), &timestamp);
+    return timestamp > 0 && static_cast<uint64_t>(timestamp) < cutoff;
+}
+
+void
+datalayer :: sweep_expired()
+{
+    m_sweeper->request_sweep();
+}
+
 bool
 datalayer :: only_key_is_hyperdex_key()
 {
@@ -1349,6 +1700,57 @@ datalayer :: upgrade_13x_to_14()
     return true;
 }
 
+// v1.7 stores the key size at the end of index entries as a compact varint
+// instead of four bytes.  The index entries cannot be parsed without the
+// schema, which isn't available until the coordinator sends a configuration,
+// so instead of rewriting the entries here we forget every index marker.  The
+// indexer thread then wipes and rebuilds each index in the background, exactly
+// as it does for a newly added index; searches do not use an index until it
+// has been rebuilt.
+bool
+datalayer :: upgrade_16_to_17()
+{
+    leveldb::WriteOptions wopts;
+    wopts.sync = true;
+    leveldb::ReadOptions ropts;
+    ropts.fill_cache = false;
+    ropts.verify_checksums = true;
+    ropts.snapshot = NULL;
+    std::auto_ptr<leveldb::Iterator> it(m_db->NewIterator(ropts));
+    it->Seek(leveldb::Slice("I", 1));
+
+    while (it->Valid() && it->key().starts_with(leveldb::Slice("I", 1)))
+    {
+        leveldb::Status st = m_db->Delete(wopts, it->key());
+
+        if (!st.ok())
+        {
+            LOG(ERROR) << "could not upgrade to 1.7: " << st.ToString();
+            return false;
+        }
+
+        it->Next();
+    }
+
+    if (!it->status().ok())
+    {
+        LOG(ERROR) << "could not upgrade to 1.7: " << it->status().ToString();
+        return false;
+    }
+
+    leveldb::Slice k("hyperdex", 8);
+    leveldb::Slice v(FORMAT_1_7, STRLENOF(FORMAT_1_7));
+    leveldb::Status st = m_db->Put(wopts, k, v);
+
+    if (!st.ok())
+    {
+        LOG(ERROR) << "could not upgrade to 1.7: " << st.ToString();
+        return false;
+    }
+
+    return true;
+}
+
 void
 datalayer :: find_indices(const region_id& rid, std::vector<const index*>* indices)
 {
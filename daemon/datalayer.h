@@ -109,6 +109,10 @@ class datalayer
                          const configuration& new_config,
                          const server_id& us);
         void debug_dump();
+        // log, for every space, the bytes used by object keys and index
+        // entries, and the bytes saved by the compact index entry format;
+        // this scans every key in LevelDB on a background thread
+        void measure_storage();
         // stats
         bool get_property(const e::slice& property,
                           std::string* value);
@@ -116,12 +120,36 @@ class datalayer
         uint64_t approximate_size();
 
     public:
-        // retrieve the current value of a key
+        // retrieve the current value of a key; objects past their space's TTL
+        // are NOT_FOUND
         returncode get(const region_id& ri,
                        const e::slice& key,
                        std::vector<e::slice>* value,
                        uint64_t* version,
                        reference* ref);
+        // retrieve the value of a key as it is on disk, even if it expired
+        // but has not yet been swept
+        returncode get_even_if_expired(const region_id& ri,
+                                       const e::slice& key,
+                                       std::vector<e::slice>* value,
+                                       uint64_t* version,
+                                       reference* ref);
+        // retrieve only the listed attributes (numbered as in the schema) of
+        // the current value of a key; other entries of "value" are empty
+        returncode get_attrs(const region_id& ri,
+                             const e::slice& key,
+                             const std::vector<uint16_t>& attrs,
+                             std::vector<e::slice>* value,
+                             uint64_t* version,
+                             reference* ref);
+        // retrieve the current value of many keys from one snapshot; the keys
+        // are read in sorted order, but results are in the order of "keys"
+        void get_many(const region_id& ri,
+                      const std::vector<e::slice>& keys,
+                      std::vector<returncode>* rcs,
+                      std::vector<std::vector<e::slice> >* values,
+                      std::vector<uint64_t>* versions,
+                      std::vector<reference>* refs);
         // put, overput, or delete a key where the existing value is known
         returncode del(const region_id& ri,
                        const e::slice& key,
@@ -135,6 +163,13 @@ class datalayer
                            const std::vector<e::slice>& old_value,
                            const std::vector<e::slice>& new_value,
                            uint64_t version);
+        // add the delete of a key whose existing value is known to "updates",
+        // to be applied later with write_batch
+        void batch_del(const region_id& ri,
+                       const e::slice& key,
+                       const std::vector<e::slice>& old_value,
+                       leveldb::WriteBatch* updates);
+        returncode write_batch(leveldb::WriteBatch* updates);
         // put or delete where the previous value is unknown
         returncode uncertain_del(const region_id& ri,
                                  const e::slice& key);
@@ -144,7 +179,7 @@ class datalayer
                                  uint64_t version);
         // leveldb provides no failure mechanism for this, neither do we
         snapshot make_snapshot();
-        // create iterators from snapshots
+        // create iterators from snapshots; expired objects are skipped
         iterator* make_search_iterator(snapshot snap,
                                        const region_id& ri,
                                        const std::vector<attribute_check>& checks,
@@ -176,9 +211,17 @@ class datalayer
         // indexing
         void create_index_marker(const region_id& ri, const index_id& ii);
         bool has_index_marker(const region_id& ri, const index_id& ii);
+        // TTL expiry:  an object expired if its TTL attribute is set and
+        // older than the cutoff; a cutoff of zero expires nothing
+        static uint64_t wallclock_micros();
+        static uint64_t expiry_cutoff(const schema& sc);
+        static bool has_expired(const e::slice& ttl_value, uint64_t cutoff);
+        // wake the sweeper to delete expired objects this daemon stores
+        void sweep_expired();
         // used on startup
         bool only_key_is_hyperdex_key();
         bool upgrade_13x_to_14();
+        bool upgrade_16_to_17();
 
     private:
         class index_state;
@@ -186,6 +229,8 @@ class datalayer
         class indexer_thread;
         class wiper_thread;
         class wiper_indexer_mediator;
+        class sweeper_thread;
+        class measurer_thread;
         datalayer(const datalayer&);
         datalayer& operator = (const datalayer&);
 
@@ -199,6 +244,11 @@ class datalayer
                           std::vector<const index*>* indices);
         void find_indices(const region_id& rid, uint16_t attr,
                           std::vector<const index*>* indices);
+        iterator* make_search_iterator(snapshot snap,
+                                       const region_id& ri,
+                                       const std::vector<attribute_check>& checks,
+                                       std::ostringstream* ostr,
+                                       uint64_t hide_expired_before);
 
         returncode handle_error(leveldb::Status st);
         void collect_lower_checkpoints(uint64_t checkpoint_gc);
@@ -215,6 +265,8 @@ class datalayer
         const std::auto_ptr<wiper_indexer_mediator> m_mediator;
         const std::auto_ptr<indexer_thread> m_indexer;
         const std::auto_ptr<wiper_thread> m_wiper;
+        const std::auto_ptr<sweeper_thread> m_sweeper;
+        const std::auto_ptr<measurer_thread> m_measurer;
 };
 
 class datalayer::reference
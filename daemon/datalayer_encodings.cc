@@ -36,9 +36,13 @@
 
 // HyperDex
 #include "daemon/datalayer_encodings.h"
+#include "daemon/index_composite.h"
+#include "daemon/index_document.h"
 #include "daemon/index_info.h"
 
 using hyperdex::datalayer;
+using hyperdex::value_decoder;
+using hyperdex::value_header;
 
 size_t
 hyperdex :: object_prefix_sz(region_id ri)
@@ -136,6 +140,20 @@ hyperdex :: decode_key(const leveldb::Slice& in,
     return true;
 }
 
+// Values come in two formats.  The first (v1) is
+//
+//      version (8B) | num_attrs (2B) | [size (4B) | bytes]*
+//
+// and must be walked attribute-by-attribute.  The second (v2) is
+//
+//      0xff | version (8B) | num_attrs (2B) | offsets (4B * (num_attrs + 1)) | bytes
+//
+// where attribute i occupies bytes [offsets[i], offsets[i + 1]) of the data
+// that follows the offset table.  Versions never reach 2^56, so the leading
+// byte of a v1 value is never 0xff.  All writes produce v2; v1 values are
+// rewritten as v2 the next time the object is written.
+#define VALUE_V2_MAGIC 0xff
+
 void
 hyperdex :: encode_value(const std::vector<e::slice>& attrs,
                          uint64_t version,
@@ -143,21 +161,31 @@ hyperdex :: encode_value(const std::vector<e::slice>& attrs,
                          leveldb::Slice* out)
 {
     assert(attrs.size() < 65536);
-    size_t sz = sizeof(uint64_t) + sizeof(uint16_t);
+    size_t sz = sizeof(uint8_t) + sizeof(uint64_t) + sizeof(uint16_t)
+              + (attrs.size() + 1) * sizeof(uint32_t);
 
     for (size_t i = 0; i < attrs.size(); ++i)
     {
-        sz += sizeof(uint32_t) + attrs[i].size();
+        sz += attrs[i].size();
     }
 
     backing->resize(sz);
     char* ptr = &backing->front();
+    ptr = e::pack8be(VALUE_V2_MAGIC, ptr);
     ptr = e::pack64be(version, ptr);
     ptr = e::pack16be(attrs.size(), ptr);
+    uint32_t offset = 0;
+
+    for (size_t i = 0; i < attrs.size(); ++i)
+    {
+        ptr = e::pack32be(offset, ptr);
+        offset += attrs[i].size();
+    }
+
+    ptr = e::pack32be(offset, ptr);
 
     for (size_t i = 0; i < attrs.size(); ++i)
     {
-        ptr = e::pack32be(attrs[i].size(), ptr);
         memmove(ptr, attrs[i].data(), attrs[i].size());
         ptr += attrs[i].size();
     }
@@ -165,41 +193,86 @@ hyperdex :: encode_value(const std::vector<e::slice>& attrs,
     *out = leveldb::Slice(&backing->front(), sz);
 }
 
+namespace
+{
+
 datalayer::returncode
-hyperdex :: decode_value(const e::slice& in,
-                         std::vector<e::slice>* attrs,
-                         uint64_t* version)
+decode_value_header(const e::slice& in, value_header* vh)
 {
     const uint8_t* ptr = in.data();
     const uint8_t* end = ptr + in.size();
+    vh->v2 = ptr < end && *ptr == VALUE_V2_MAGIC;
 
-    if (ptr + sizeof(uint64_t) <= end)
+    if (vh->v2)
     {
-        ptr = e::unpack64be(ptr, version);
+        ++ptr;
     }
-    else
+
+    if (ptr + sizeof(uint64_t) + sizeof(uint16_t) > end)
     {
         return datalayer::BAD_ENCODING;
     }
 
-    uint16_t num_attrs;
+    ptr = e::unpack64be(ptr, &vh->version);
+    ptr = e::unpack16be(ptr, &vh->num_attrs);
+    vh->end = end;
 
-    if (ptr + sizeof(uint16_t) <= end)
+    if (!vh->v2)
     {
-        ptr = e::unpack16be(ptr, &num_attrs);
+        vh->data = ptr;
+        return datalayer::SUCCESS;
     }
-    else
+
+    size_t table_sz = (vh->num_attrs + 1) * sizeof(uint32_t);
+
+    if (ptr + table_sz > end)
+    {
+        return datalayer::BAD_ENCODING;
+    }
+
+    vh->offsets = ptr;
+    vh->data = ptr + table_sz;
+    uint32_t last;
+    e::unpack32be(vh->offsets + vh->num_attrs * sizeof(uint32_t), &last);
+
+    if (vh->data + last != end)
     {
         return datalayer::BAD_ENCODING;
     }
 
+    return datalayer::SUCCESS;
+}
+
+// O(1) for v2 values:  two reads from the offset table
+datalayer::returncode
+decode_value_v2_attr(const value_header& vh, uint16_t idx, e::slice* attr)
+{
+    uint32_t start;
+    uint32_t limit;
+    e::unpack32be(vh.offsets + idx * sizeof(uint32_t), &start);
+    e::unpack32be(vh.offsets + (idx + 1) * sizeof(uint32_t), &limit);
+
+    if (start > limit || vh.data + limit > vh.end)
+    {
+        return datalayer::BAD_ENCODING;
+    }
+
+    *attr = e::slice(vh.data + start, limit - start);
+    return datalayer::SUCCESS;
+}
+
+// walks the size-prefixed attributes of a v1 value
+datalayer::returncode
+decode_value_v1(const value_header& vh, std::vector<e::slice>* attrs)
+{
+    const uint8_t* ptr = vh.data;
     attrs->clear();
 
-    for (size_t i = 0; i < num_attrs; ++i)
+    for (size_t i = 0; i < vh.num_attrs; ++i)
     {
         uint32_t sz = 0;
 
-        if (ptr + sizeof(uint32_t) <= end)
+        if (ptr + sizeof(uint32_t) <= vh.end)
         {
             ptr = e::unpack32be(ptr, &sz);
         }
@@ -208,14 +281,176 @@ hyperdex :: decode_value(const e::slice& in,
             return datalayer::BAD_ENCODING;
         }
 
-        e::slice s(reinterpret_cast<const uint8_t*>(ptr), sz);
+        if (ptr + sz > vh.end)
+        {
+            return datalayer::BAD_ENCODING;
+        }
+
+        attrs->push_back(e::slice(ptr, sz));
         ptr += sz;
-        attrs->push_back(s);
     }
 
     return datalayer::SUCCESS;
 }
 
+} // namespace
+
+datalayer::returncode
+hyperdex :: decode_value(const e::slice& in,
+                         std::vector<e::slice>* attrs,
+                         uint64_t* version)
+{
+    value_header vh;
+    datalayer::returncode rc = decode_value_header(in, &vh);
+
+    if (rc != datalayer::SUCCESS)
+    {
+        return rc;
+    }
+
+    *version = vh.version;
+
+    if (!vh.v2)
+    {
+        return decode_value_v1(vh, attrs);
+    }
+
+    attrs->resize(vh.num_attrs);
+
+    for (size_t i = 0; i < vh.num_attrs; ++i)
+    {
+        rc = decode_value_v2_attr(vh, i, &(*attrs)[i]);
+
+        if (rc != datalayer::SUCCESS)
+        {
+            return rc;
+        }
+    }
+
+    return datalayer::SUCCESS;
+}
+
+datalayer::returncode
+hyperdex :: decode_value_attr(const e::slice& in,
+                              uint16_t idx,
+                              e::slice* attr)
+{
+    value_decoder vd;
+    datalayer::returncode rc = vd.parse(in);
+    return rc == datalayer::SUCCESS ? vd.attr(idx, attr) : rc;
+}
+
+datalayer::returncode
+hyperdex :: decode_value_attrs(const e::slice& in,
+                               const std::vector<uint16_t>& attrs,
+                               std::vector<e::slice>* value,
+                               uint64_t* version)
+{
+    value_decoder vd;
+    datalayer::returncode rc = vd.parse(in);
+
+    if (rc != datalayer::SUCCESS)
+    {
+        return rc;
+    }
+
+    *version = vd.version();
+    return vd.attrs(attrs, value);
+}
+
+value_decoder :: value_decoder()
+    : m_vh()
+    , m_v1_walked(false)
+    , m_v1_attrs()
+{
+}
+
+value_decoder :: ~value_decoder() throw ()
+{
+}
+
+datalayer::returncode
+value_decoder :: parse(const e::slice& in)
+{
+    m_vh = value_header();
+    m_v1_walked = false;
+    m_v1_attrs.clear();
+    return decode_value_header(in, &m_vh);
+}
+
+datalayer::returncode
+value_decoder :: attr(uint16_t idx, e::slice* attr)
+{
+    if (idx >= m_vh.num_attrs)
+    {
+        return datalayer::BAD_ENCODING;
+    }
+
+    if (m_vh.v2)
+    {
+        return decode_value_v2_attr(m_vh, idx, attr);
+    }
+
+    datalayer::returncode rc = walk_v1();
+
+    if (rc == datalayer::SUCCESS)
+    {
+        *attr = m_v1_attrs[idx];
+    }
+
+    return rc;
+}
+
+datalayer::returncode
+value_decoder :: attrs(const std::vector<uint16_t>& attrs,
+                       std::vector<e::slice>* value)
+{
+    if (!m_vh.v2)
+    {
+        datalayer::returncode rc = walk_v1();
+
+        if (rc == datalayer::SUCCESS)
+        {
+            *value = m_v1_attrs;
+        }
+
+        return rc;
+    }
+
+    value->clear();
+    value->resize(m_vh.num_attrs);
+
+    for (size_t i = 0; i < attrs.size(); ++i)
+    {
+        if (attrs[i] == 0 || attrs[i] > m_vh.num_attrs)
+        {
+            continue;
+        }
+
+        datalayer::returncode rc = decode_value_v2_attr(m_vh, attrs[i] - 1, &(*value)[attrs[i] - 1]);
+
+        if (rc != datalayer::SUCCESS)
+        {
+            return rc;
+        }
+    }
+
+    return datalayer::SUCCESS;
+}
+
+datalayer::returncode
+value_decoder :: walk_v1()
+{
+    if (m_v1_walked)
+    {
+        return datalayer::SUCCESS;
+    }
+
+    datalayer::returncode rc = decode_value_v1(m_vh, &m_v1_attrs);
+    m_v1_walked = rc == datalayer::SUCCESS;
+    return rc;
+}
+
 void
 hyperdex :: encode_version(const region_id& ri, /*region we wrote*/
                            uint64_t version,
@@ -279,6 +514,71 @@ hyperdex :: decode_checkpoint(const e::slice& in,
     return t == 'c' ? datalayer::SUCCESS : datalayer::BAD_ENCODING;
 }
 
+size_t
+hyperdex :: index_entry_key_size_sz(size_t key_sz)
+{
+    return e::varint_length(key_sz);
+}
+
+char*
+hyperdex :: encode_index_entry_key_size(size_t key_sz, char* ptr)
+{
+    char buf[VARINT_64_MAX_SIZE];
+    char* end = e::packvarint64(key_sz, buf);
+
+    while (end > buf)
+    {
+        --end;
+        *ptr = *end;
+        ++ptr;
+    }
+
+    return ptr;
+}
+
+bool
+hyperdex :: decode_index_entry_key_size(const e::slice& entry,
+                                        size_t* key_sz,
+                                        size_t* key_size_sz)
+{
+    const uint8_t* const start = entry.data();
+    const uint8_t* ptr = start + entry.size();
+    uint64_t sz = 0;
+    unsigned shift = 0;
+
+    while (ptr > start && shift < 64)
+    {
+        --ptr;
+        sz |= static_cast<uint64_t>(*ptr & 0x7f) << shift;
+        shift += 7;
+
+        if (!(*ptr & 0x80))
+        {
+            *key_sz = sz;
+            *key_size_sz = start + entry.size() - ptr;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool
+hyperdex :: decode_index_predicate(const index& idx,
+                                   std::vector<attribute_check>* checks)
+{
+    e::unpacker up(idx.predicate.data(), idx.predicate.size());
+    checks->clear();
+
+    while (!up.error() && up.remain())
+    {
+        checks->push_back(attribute_check());
+        up = up >> checks->back();
+    }
+
+    return !up.error();
+}
+
 void
 hyperdex :: create_index_changes(const schema& sc,
                                  const region_id& ri,
@@ -292,6 +592,10 @@ hyperdex :: create_index_changes(const schema& sc,
     assert(!old_value || old_value->size() + 1 == sc.attrs_sz);
     assert(!new_value || new_value->size() + 1 == sc.attrs_sz);
     const index_encoding* key_ie = index_encoding::lookup(sc.attrs[0].type);
+    // document indices are batched so each document gets parsed once
+    std::vector<const index*> doc_indices;
+    std::vector<const e::slice*> doc_old;
+    std::vector<const e::slice*> doc_new;
 
     for (size_t i = 0; i < indices.size(); ++i)
     {
@@ -299,22 +603,66 @@ hyperdex :: create_index_changes(const schema& sc,
 
         assert(idx->attr > 0);
         assert(idx->attr < sc.attrs_sz);
+        const std::vector<e::slice>* old_obj = old_value;
+        const std::vector<e::slice>* new_obj = new_value;
+
+        // a partial index leaves out the objects that fail its predicate
+        if (!idx->predicate.empty())
+        {
+            std::vector<attribute_check> checks;
+
+            if (!decode_index_predicate(*idx, &checks))
+            {
+                continue;
+            }
+
+            if (old_obj && passes_attribute_checks(sc, checks, key, *old_obj) < checks.size())
+            {
+                old_obj = NULL;
+            }
+
+            if (new_obj && passes_attribute_checks(sc, checks, key, *new_obj) < checks.size())
+            {
+                new_obj = NULL;
+            }
+        }
 
-        const index_info* ai = index_info::lookup(sc.attrs[idx->attr].type);
+        if (idx->type == index::COMPOSITE)
+        {
+            composite_index_changes(sc, idx, ri, key_ie, key, old_obj, new_obj, updates);
+            continue;
+        }
+
+        const index_info* ai = index_info::lookup(*idx, sc.attrs[idx->attr].type);
         assert(ai);
 
         const e::slice* old_attr = NULL;
         const e::slice* new_attr = NULL;
-        old_attr = old_value ? &(*old_value)[idx->attr - 1] : NULL;
-        new_attr = new_value ? &(*new_value)[idx->attr - 1] : NULL;
+        old_attr = old_obj ? &(*old_obj)[idx->attr - 1] : NULL;
+        new_attr = new_obj ? &(*new_obj)[idx->attr - 1] : NULL;
 
         if (!old_attr && !new_attr)
         {
             continue;
         }
 
+        if (idx->type == index::DOCUMENT &&
+            ai->datatype() == HYPERDATATYPE_DOCUMENT)
+        {
+            doc_indices.push_back(idx);
+            doc_old.push_back(old_attr);
+            doc_new.push_back(new_attr);
+            continue;
+        }
+
         ai->index_changes(idx, ri, key_ie, key, old_attr, new_attr, updates);
     }
+
+    if (!doc_indices.empty())
+    {
+        const index_document* di = static_cast<const index_document*>(index_info::lookup(HYPERDATATYPE_DOCUMENT));
+        di->index_changes(doc_indices, ri, key_ie, key, doc_old, doc_new, updates);
+    }
 }
 
 void
@@ -76,6 +76,63 @@ datalayer::returncode
 decode_value(const e::slice& in,
              std::vector<e::slice>* attrs,
              uint64_t* version);
+// Decode the single value attribute "idx" (0 is the first attribute after
+// the key).  This is O(1) for values in the v2 format.  To read several
+// attributes of one value, use a value_decoder.
+datalayer::returncode
+decode_value_attr(const e::slice& in,
+                  uint16_t idx,
+                  e::slice* attr);
+// Decode only the attributes in "attrs" (numbered as in the schema, so 1 is
+// the first attribute after the key); the rest of "value" is left empty.
+// Values in the v1 format are decoded fully.
+datalayer::returncode
+decode_value_attrs(const e::slice& in,
+                   const std::vector<uint16_t>& attrs,
+                   std::vector<e::slice>* value,
+                   uint64_t* version);
+
+// The parsed header of a value in either format.  For v2 values, "offsets"
+// points to the offset table and "data" to the attribute bytes; for v1 values,
+// "data" points to the first size-prefixed attribute.
+struct value_header
+{
+    value_header() : v2(false), version(0), num_attrs(0), offsets(NULL), data(NULL), end(NULL) {}
+    bool v2;
+    uint64_t version;
+    uint16_t num_attrs;
+    const uint8_t* offsets;
+    const uint8_t* data;
+    const uint8_t* end;
+};
+
+// Reads the attributes of one value as they are asked for.  The header is
+// parsed once.  A v1 value has to be walked to find any attribute, so it is
+// walked on the first request and the result serves every later one.
+class value_decoder
+{
+    public:
+        value_decoder();
+        ~value_decoder() throw ();
+
+    public:
+        // "in" must stay valid for as long as attributes are read
+        datalayer::returncode parse(const e::slice& in);
+        uint64_t version() const { return m_vh.version; }
+        // as decode_value_attr
+        datalayer::returncode attr(uint16_t idx, e::slice* attr);
+        // as decode_value_attrs
+        datalayer::returncode attrs(const std::vector<uint16_t>& attrs,
+                                    std::vector<e::slice>* value);
+
+    private:
+        datalayer::returncode walk_v1();
+
+    private:
+        value_header m_vh;
+        bool m_v1_walked;
+        std::vector<e::slice> m_v1_attrs;
+};
 
 // Encode the record of an operation for which we have sent an ACK
 #define VERSION_BUF_SIZE (sizeof(uint8_t) + 2 * sizeof(uint64_t))
@@ -99,6 +156,26 @@ decode_checkpoint(const e::slice& in,
                   region_id* ri,
                   uint64_t* checkpoint);
 
+// Index entries whose value and key are both variable-length end with the
+// size of the key, stored as a varint written back-to-front so that it can be
+// read from the end of the entry.
+size_t
+index_entry_key_size_sz(size_t key_sz);
+char*
+encode_index_entry_key_size(size_t key_sz, char* ptr);
+bool
+decode_index_entry_key_size(const e::slice& entry,
+                            size_t* key_sz,
+                            size_t* key_size_sz);
+// The size of the key in index entries written by HyperDex 1.6
+#define INDEX_ENTRY_KEY_SIZE_SZ_1_6 sizeof(uint32_t)
+
+// The checks an object must pass to be in a partial index.  False if the
+// index's predicate does not decode.
+bool
+decode_index_predicate(const index& idx,
+                       std::vector<attribute_check>* checks);
+
 void
 create_index_changes(const schema& sc,
                      const region_id& ri,
@@ -27,6 +27,9 @@
 
 #define __STDC_LIMIT_MACROS
 
+// C
+#include <cstdlib>
+
 // e
 #include <e/endian.h>
 #include <e/varint.h>
@@ -329,6 +332,18 @@ datalayer :: index_iterator :: ~index_iterator() throw ()
 {
 }
 
+bool
+datalayer :: index_iterator :: has_object()
+{
+    return false;
+}
+
+e::slice
+datalayer :: index_iterator :: object()
+{
+    abort();
+}
+
 ////////////////////////// class range_index_iterator //////////////////////////
 
 datalayer :: range_index_iterator :: range_index_iterator(leveldb_snapshot_ptr s,
@@ -337,6 +352,7 @@ datalayer :: range_index_iterator :: range_index_iterator(leveldb_snapshot_ptr s
                                                           const e::slice& range_upper,
                                                           bool has_lower,
                                                           bool has_upper,
+                                                          bool upper_is_prefix,
                                                           const index_encoding* val_ie,
                                                           const index_encoding* key_ie)
     : index_iterator(s)
@@ -352,6 +368,7 @@ datalayer :: range_index_iterator :: range_index_iterator(leveldb_snapshot_ptr s
     , m_scratch()
     , m_has_lower(has_lower)
     , m_has_upper(has_upper)
+    , m_upper_is_prefix(upper_is_prefix)
     , m_invalid(false)
 {
     // setup the iterator
@@ -425,7 +442,9 @@ datalayer :: range_index_iterator :: valid()
             continue;
         }
 
-        if (m_has_upper && internal_key_compare(m_value_upper, iv) < 0)
+        // values that extend a prefix upper bound are still in range
+        if (m_has_upper && internal_key_compare(m_value_upper, iv) < 0 &&
+            !(m_upper_is_prefix && iv.starts_with(m_value_upper)))
         {
             m_iter->Next();
             continue;
@@ -497,7 +516,22 @@ datalayer :: range_index_iterator :: internal_key()
 bool
 datalayer :: range_index_iterator :: sorted()
 {
-    return m_has_lower && m_has_upper && m_value_lower == m_value_upper;
+    return m_has_lower && m_has_upper && !m_upper_is_prefix &&
+           m_value_lower == m_value_upper;
+}
+
+bool
+datalayer :: range_index_iterator :: has_object()
+{
+    // without a value encoding, this iterates the objects' own keys
+    return !m_val_ie;
+}
+
+e::slice
+datalayer :: range_index_iterator :: object()
+{
+    assert(!m_val_ie);
+    return level2e(m_iter->value());
 }
 
 void
@@ -551,20 +585,16 @@ datalayer :: range_index_iterator :: decode_entry(const e::slice& in, e::slice*
     }
     else
     {
-        if (rem < sizeof(uint32_t))
-        {
-            return false;
-        }
-
-        uint32_t k_sz;
-        e::unpack32be(end - sizeof(uint32_t), &k_sz);
+        size_t k_sz;
+        size_t k_sz_sz;
 
-        if (k_sz + sizeof(uint32_t) > rem)
+        if (!decode_index_entry_key_size(e::slice(ptr, rem), &k_sz, &k_sz_sz) ||
+            k_sz + k_sz_sz > rem)
         {
             return false;
         }
 
-        *v = e::slice(ptr, rem - sizeof(uint32_t) - k_sz);
+        *v = e::slice(ptr, rem - k_sz_sz - k_sz);
         *k = e::slice(ptr + v->size(), k_sz);
     }
 
@@ -603,7 +633,7 @@ datalayer :: range_index_iterator :: encode_entry(const e::slice& v,
     }
     else
     {
-        size_t sz = m_prefix.size() + v.size() + k.size() + sizeof(uint32_t);
+        size_t sz = m_prefix.size() + v.size() + k.size() + index_entry_key_size_sz(k.size());
 
         if (scratch->size() < sz)
         {
@@ -620,7 +650,7 @@ datalayer :: range_index_iterator :: encode_entry(const e::slice& v,
 
         if (!m_val_ie->encoding_fixed() && !m_key_ie->encoding_fixed())
         {
-            ptr = e::pack32be(k.size(), ptr);
+            ptr = encode_index_entry_key_size(k.size(), ptr);
         }
 
         *slice = e::slice(&(*scratch)[0], ptr - &(*scratch)[0]);
@@ -763,11 +793,16 @@ datalayer :: intersect_iterator :: seek(const e::slice& k)
 
 ///////////////////////////// class search_iterator ////////////////////////////
 
+// Limits on how much of a full scan is read ahead at once
+#define SEARCH_BATCH_OBJECTS 1024
+#define SEARCH_BATCH_BYTES (1ULL << 20)
+
 datalayer :: search_iterator :: search_iterator(datalayer* dl,
                                                 const region_id& ri,
                                                 e::intrusive_ptr<index_iterator> iter,
                                                 std::ostringstream* ostr,
-                                                const std::vector<attribute_check>* checks)
+                                                const std::vector<attribute_check>* checks,
+                                                uint64_t hide_expired_before)
     : iterator(iter->snap())
     , m_dl(dl)
     , m_ri(ri)
@@ -776,7 +811,31 @@ datalayer :: search_iterator :: search_iterator(datalayer* dl,
     , m_ostr(ostr)
     , m_num_gets(0)
     , m_checks(checks)
+    , m_compiled(checks->size())
+    , m_hide_expired_before(hide_expired_before)
+    , m_batch_mode(iter->has_object())
+    , m_batch_buf()
+    , m_batch_sizes()
+    , m_batch_keys()
+    , m_batch_values()
+    , m_batch_attrs()
+    , m_batch_decoders()
+    , m_batch_mask()
+    , m_batch_idx(0)
 {
+    // attribute types are fixed for the life of a space, so the checks may be
+    // compiled against the schema once, even if the config later changes
+    const schema* sc = m_dl->m_daemon->m_config.get_schema(m_ri);
+
+    for (size_t i = 0; sc && i < m_checks->size(); ++i)
+    {
+        const attribute_check& chk((*m_checks)[i]);
+
+        if (chk.attr < sc->attrs_sz)
+        {
+            m_compiled[i].compile(sc->attrs[chk.attr].type, chk);
+        }
+    }
 }
 
 datalayer :: search_iterator :: ~search_iterator() throw ()
@@ -801,8 +860,35 @@ datalayer :: search_iterator :: valid()
     // won't persist across reconfigurations
     const schema& sc(*m_dl->m_daemon->m_config.get_schema(m_ri));
 
-    uint64_t version;
-    std::vector<e::slice> value;
+    if (m_batch_mode)
+    {
+        while (true)
+        {
+            while (m_batch_idx < m_batch_mask.size())
+            {
+                if (m_batch_mask[m_batch_idx])
+                {
+                    return true;
+                }
+
+                ++m_batch_idx;
+            }
+
+            if (!m_iter->valid())
+            {
+                break;
+            }
+
+            if (!fill_batch(sc))
+            {
+                return false;
+            }
+        }
+
+        if (m_ostr) *m_ostr << " iterator scanned " << m_num_gets << " objects in batches\n";
+        return false;
+    }
+
     reference ref;
 
     // while the most selective iterator is valid and not past the end
@@ -818,8 +904,59 @@ datalayer :: search_iterator :: valid()
 
         if (st.ok())
         {
-            e::slice v(ref.m_backing.data(), ref.m_backing.size());
-            datalayer::returncode rc = decode_value(v, &value, &version);
+            ++m_num_gets;
+        }
+        else
+        {
+            m_error = m_dl->handle_error(st);
+            return false;
+        }
+
+        // evaluate the checks one attribute at a time, so that a failing
+        // check stops us from decoding the rest of the object
+        e::slice v(ref.m_backing.data(), ref.m_backing.size());
+        value_decoder vd;
+        datalayer::returncode rc = vd.parse(v);
+
+        if (rc != SUCCESS)
+        {
+            m_error = rc;
+            return false;
+        }
+
+        bool passes = true;
+
+        for (size_t i = 0; passes && i < m_checks->size(); ++i)
+        {
+            const attribute_check& chk((*m_checks)[i]);
+
+            if (chk.attr >= sc.attrs_sz)
+            {
+                passes = false;
+            }
+            else if (chk.attr == 0)
+            {
+                passes = m_compiled[i].passes(m_iter->key());
+            }
+            else
+            {
+                e::slice attr;
+                rc = vd.attr(chk.attr - 1, &attr);
+
+                if (rc != SUCCESS)
+                {
+                    m_error = rc;
+                    return false;
+                }
+
+                passes = m_compiled[i].passes(attr);
+            }
+        }
+
+        if (passes && m_hide_expired_before > 0 && sc.ttl_attr != 0)
+        {
+            e::slice attr;
+            rc = vd.attr(sc.ttl_attr - 1, &attr);
 
             if (rc != SUCCESS)
             {
@@ -827,15 +964,10 @@ datalayer :: search_iterator :: valid()
                 return false;
             }
 
-            ++m_num_gets;
-        }
-        else
-        {
-            m_error = m_dl->handle_error(st);
-            return false;
+            passes = !datalayer::has_expired(attr, m_hide_expired_before);
         }
 
-        if (passes_attribute_checks(sc, *m_checks, m_iter->key(), value) == m_checks->size())
+        if (passes)
         {
             return true;
         }
@@ -852,7 +984,14 @@ datalayer :: search_iterator :: valid()
 void
 datalayer :: search_iterator :: next()
 {
-    m_iter->next();
+    if (m_batch_mode)
+    {
+        ++m_batch_idx;
+    }
+    else
+    {
+        m_iter->next();
+    }
 }
 
 uint64_t
@@ -864,5 +1003,145 @@ datalayer :: search_iterator :: cost(leveldb::DB* db)
 e::slice
 datalayer :: search_iterator :: key()
 {
+    if (m_batch_mode)
+    {
+        assert(m_batch_idx < m_batch_keys.size());
+        return m_batch_keys[m_batch_idx];
+    }
+
     return m_iter->key();
 }
+
+bool
+datalayer :: search_iterator :: fill_batch(const schema& sc)
+{
+    m_batch_buf.clear();
+    m_batch_sizes.clear();
+    m_batch_keys.clear();
+    m_batch_values.clear();
+    m_batch_idx = 0;
+
+    // copy a block of objects out of the iterator
+    while (m_batch_sizes.size() < SEARCH_BATCH_OBJECTS &&
+           m_batch_buf.size() < SEARCH_BATCH_BYTES &&
+           m_iter->valid())
+    {
+        e::slice k = m_iter->key();
+        e::slice v = m_iter->object();
+        m_batch_buf.insert(m_batch_buf.end(), k.cdata(), k.cdata() + k.size());
+        m_batch_buf.insert(m_batch_buf.end(), v.cdata(), v.cdata() + v.size());
+        m_batch_sizes.push_back(std::make_pair(k.size(), v.size()));
+        m_iter->next();
+    }
+
+    const size_t batch_sz = m_batch_sizes.size();
+    const char* ptr = batch_sz > 0 ? &m_batch_buf[0] : NULL;
+
+    for (size_t i = 0; i < batch_sz; ++i)
+    {
+        m_batch_keys.push_back(e::slice(ptr, m_batch_sizes[i].first));
+        ptr += m_batch_sizes[i].first;
+        m_batch_values.push_back(e::slice(ptr, m_batch_sizes[i].second));
+        ptr += m_batch_sizes[i].second;
+    }
+
+    m_num_gets += batch_sz;
+    m_batch_mask.assign(batch_sz, 1);
+    m_batch_attrs.resize(batch_sz);
+    m_batch_decoders.resize(batch_sz);
+
+    if (batch_sz == 0)
+    {
+        return true;
+    }
+
+    // each object's header is parsed once for all of the checks
+    for (size_t i = 0; i < batch_sz; ++i)
+    {
+        datalayer::returncode rc = m_batch_decoders[i].parse(m_batch_values[i]);
+
+        if (rc != SUCCESS)
+        {
+            m_error = rc;
+            return false;
+        }
+    }
+
+    // the column-wise checks go first, so the rest only see the survivors
+    for (size_t pass = 0; pass < 2; ++pass)
+    {
+        for (size_t i = 0; i < m_checks->size(); ++i)
+        {
+            if (m_compiled[i].batchable() != (pass == 0))
+            {
+                continue;
+            }
+
+            const attribute_check& chk((*m_checks)[i]);
+
+            if (chk.attr >= sc.attrs_sz)
+            {
+                m_batch_mask.assign(batch_sz, 0);
+                return true;
+            }
+
+            if (chk.attr == 0)
+            {
+                m_compiled[i].filter(&m_batch_keys[0], batch_sz, &m_batch_mask[0]);
+                continue;
+            }
+
+            for (size_t j = 0; j < batch_sz; ++j)
+            {
+                m_batch_attrs[j] = e::slice();
+
+                if (!m_batch_mask[j])
+                {
+                    continue;
+                }
+
+                datalayer::returncode rc = m_batch_decoders[j].attr(chk.attr - 1, &m_batch_attrs[j]);
+
+                if (rc != SUCCESS)
+                {
+                    m_error = rc;
+                    return false;
+                }
+            }
+
+            m_compiled[i].filter(&m_batch_attrs[0], batch_sz, &m_batch_mask[0]);
+        }
+    }
+
+    return filter_expired(sc);
+}
+
+bool
+datalayer :: search_iterator :: filter_expired(const schema& sc)
+{
+    if (m_hide_expired_before == 0 || sc.ttl_attr == 0)
+    {
+        return true;
+    }
+
+    for (size_t i = 0; i < m_batch_mask.size(); ++i)
+    {
+        if (!m_batch_mask[i])
+        {
+            continue;
+        }
+
+        e::slice attr;
+        datalayer::returncode rc = m_batch_decoders[i].attr(sc.ttl_attr - 1, &attr);
+
+        if (rc != SUCCESS)
+        {
+            m_error = rc;
+            return false;
+        }
+
+        m_batch_mask[i] = datalayer::has_expired(attr, m_hide_expired_before) ? 0 : 1;
+    }
+
+    return true;
+}
@@ -33,7 +33,9 @@
 
 // HyperDex
 #include "namespace.h"
+#include "common/compiled_check.h"
 #include "daemon/datalayer.h"
+#include "daemon/datalayer_encodings.h"
 #include "daemon/index_info.h"
 
 BEGIN_HYPERDEX_NAMESPACE
@@ -145,6 +147,10 @@ class datalayer::index_iterator : public iterator
         virtual e::slice internal_key() = 0;
         virtual bool sorted() = 0;
         virtual void seek(const e::slice& internal_key) = 0;
+        // Iterators over the objects themselves (rather than an index) can
+        // hand out the stored value without another read
+        virtual bool has_object();
+        virtual e::slice object();
 
     protected:
         friend class e::intrusive_ptr<index_iterator>;
@@ -159,6 +165,7 @@ class datalayer::range_index_iterator : public index_iterator
                              const e::slice& range_upper,
                              bool has_value_lower,
                              bool has_value_upper,
+                             bool upper_is_prefix,
                              const index_encoding* val_ie,
                              const index_encoding* key_ie);
         virtual ~range_index_iterator() throw ();
@@ -172,6 +179,8 @@ class datalayer::range_index_iterator : public index_iterator
         virtual e::slice internal_key();
         virtual bool sorted();
         virtual void seek(const e::slice& internal_key);
+        virtual bool has_object();
+        virtual e::slice object();
 
     private:
         bool decode_entry(const e::slice& in, e::slice* val, e::slice* key);
@@ -198,6 +207,7 @@ class datalayer::range_index_iterator : public index_iterator
         std::vector<char> m_scratch;
         bool m_has_lower;
         bool m_has_upper;
+        bool m_upper_is_prefix;
         bool m_invalid;
 };
 
@@ -231,7 +241,8 @@ class datalayer::search_iterator : public iterator
                         const region_id& ri,
                         e::intrusive_ptr<index_iterator> iter,
                         std::ostringstream* ostr,
-                        const std::vector<attribute_check>* checks);
+                        const std::vector<attribute_check>* checks,
+                        uint64_t hide_expired_before);
         virtual ~search_iterator() throw ();
 
     public:
@@ -241,6 +252,10 @@ class datalayer::search_iterator : public iterator
         virtual e::slice key();
         virtual std::ostream& describe(std::ostream&) const;
 
+    private:
+        bool fill_batch(const schema& sc);
+        bool filter_expired(const schema& sc);
+
     private:
         search_iterator(const search_iterator&);
         search_iterator& operator = (const search_iterator&);
@@ -253,6 +268,19 @@ class datalayer::search_iterator : public iterator
         std::ostringstream* m_ostr;
         uint64_t m_num_gets;
         const std::vector<attribute_check>* m_checks;
+        std::vector<compiled_check> m_compiled;
+        // objects whose TTL attribute is older than this are skipped
+        uint64_t m_hide_expired_before;
+        // when scanning objects directly, read and filter them in blocks
+        bool m_batch_mode;
+        std::vector<char> m_batch_buf;
+        std::vector<std::pair<size_t, size_t> > m_batch_sizes;
+        std::vector<e::slice> m_batch_keys;
+        std::vector<e::slice> m_batch_values;
+        std::vector<e::slice> m_batch_attrs;
+        std::vector<value_decoder> m_batch_decoders;
+        std::vector<uint8_t> m_batch_mask;
+        size_t m_batch_idx;
 };
 
 inline std::ostream&
@@ -0,0 +1,236 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// STL
+#include <memory>
+
+// Google Log
+#include <glog/logging.h>
+
+// e
+#include <e/varint.h>
+
+// HyperDex
+#include "daemon/daemon.h"
+#include "daemon/datalayer_encodings.h"
+#include "daemon/datalayer_measurer_thread.h"
+#include "daemon/index_info.h"
+
+// keys read per batch; the thread may pause between batches
+#define MEASURE_BATCH 65536
+
+using hyperdex::datalayer;
+
+datalayer :: measurer_thread :: measurer_thread(daemon* d)
+    : background_thread(d)
+    , m_daemon(d)
+    , m_measure_requested(false)
+    , m_measuring(false)
+    , m_measurements(0)
+    , m_resume("i", 1)
+    , m_usage()
+{
+}
+
+datalayer :: measurer_thread :: ~measurer_thread() throw ()
+{
+}
+
+const char*
+datalayer :: measurer_thread :: thread_name()
+{
+    return "measurer";
+}
+
+bool
+datalayer :: measurer_thread :: have_work()
+{
+    return m_measure_requested;
+}
+
+void
+datalayer :: measurer_thread :: copy_work()
+{
+    m_measure_requested = false;
+}
+
+void
+datalayer :: measurer_thread :: do_work()
+{
+    leveldb::ReadOptions opts;
+    opts.fill_cache = false;
+    opts.verify_checksums = true;
+    std::auto_ptr<leveldb::Iterator> it(m_daemon->m_data.m_db->NewIterator(opts));
+    it->Seek(leveldb::Slice(m_resume));
+    uint64_t batch = 0;
+
+    // index entries ('i') sort before objects ('o'); nothing after the
+    // objects is measured
+    for (; it->Valid() && batch < MEASURE_BATCH; it->Next(), ++batch)
+    {
+        leveldb::Slice key(it->key());
+
+        if (key.empty() || key[0] > 'o')
+        {
+            break;
+        }
+        else if (key[0] == 'i')
+        {
+            measure_index_entry(key);
+        }
+        else if (key[0] == 'o')
+        {
+            measure_object(key, it->value());
+        }
+    }
+
+    if (!it->status().ok())
+    {
+        LOG(ERROR) << "could not measure storage: " << it->status().ToString();
+    }
+    else if (batch >= MEASURE_BATCH && it->Valid())
+    {
+        m_resume.assign(it->key().data(), it->key().size());
+        this->lock();
+        m_measure_requested = true;
+        this->unlock();
+        return;
+    }
+    else
+    {
+        report();
+    }
+
+    m_resume.assign("i", 1);
+    m_usage.clear();
+    this->lock();
+    m_measuring = false;
+    ++m_measurements;
+    this->unlock();
+}
+
+void
+datalayer :: measurer_thread :: debug_dump()
+{
+    this->lock();
+    LOG(INFO) << "measurer thread ===============================================================";
+    LOG(INFO) << "measure_requested=" << (m_measure_requested ? "yes" : "no");
+    LOG(INFO) << "measuring=" << (m_measuring ? "yes" : "no");
+    LOG(INFO) << "measurements=" << m_measurements;
+    this->unlock();
+}
+
+void
+datalayer :: measurer_thread :: request_measure()
+{
+    this->lock();
+
+    if (m_measuring)
+    {
+        LOG(INFO) << "storage measurement already in progress";
+    }
+    else
+    {
+        m_measuring = true;
+        m_measure_requested = true;
+        this->wakeup();
+    }
+
+    this->unlock();
+}
+
+// index entries:  'i' | region (varint) | index (varint) | entry
+void
+datalayer :: measurer_thread :: measure_index_entry(const leveldb::Slice& key)
+{
+    const configuration& config(m_daemon->m_config);
+    const char* ptr = key.data() + 1;
+    const char* const end = key.data() + key.size();
+    uint64_t ri;
+    uint64_t ii;
+    ptr = e::varint64_decode(ptr, end, &ri);
+    ptr = ptr ? e::varint64_decode(ptr, end, &ii) : NULL;
+    const schema* sc = config.get_schema(region_id(ri));
+    const index* idx = ptr ? config.get_index(index_id(ii)) : NULL;
+    const char* space = config.get_space_name(region_id(ri));
+
+    if (!sc || !idx || idx->attr >= sc->attrs_sz || !space)
+    {
+        return;
+    }
+
+    storage_usage* su = &m_usage[space];
+    ++su->index_entries;
+    su->index_bytes += key.size();
+    const index_info* ai = index_info::lookup(*idx, sc->attrs[idx->attr].type);
+    const index_encoding* key_ie = index_encoding::lookup(sc->attrs[0].type);
+    e::slice entry(ptr, end - ptr);
+    size_t key_sz;
+    size_t key_size_sz;
+
+    if (ai && key_ie && ai->entry_has_key_size(key_ie, entry) &&
+        decode_index_entry_key_size(entry, &key_sz, &key_size_sz))
+    {
+        su->index_bytes_saved += INDEX_ENTRY_KEY_SIZE_SZ_1_6 - key_size_sz;
+    }
+}
+
+void
+datalayer :: measurer_thread :: measure_object(const leveldb::Slice& key,
+                                               const leveldb::Slice& value)
+{
+    region_id ri;
+    e::slice k;
+    const char* space = decode_key(key, &ri, &k)
+                      ? m_daemon->m_config.get_space_name(ri) : NULL;
+
+    if (space)
+    {
+        storage_usage* su = &m_usage[space];
+        ++su->objects;
+        su->object_bytes += key.size() + value.size();
+    }
+}
+
+void
+datalayer :: measurer_thread :: report()
+{
+    LOG(INFO) << "storage by space ==============================================================";
+
+    for (usage_map_t::iterator u = m_usage.begin(); u != m_usage.end(); ++u)
+    {
+        LOG(INFO) << "space=" << u->first
+                  << " objects=" << u->second.objects
+                  << " object_bytes=" << u->second.object_bytes
+                  << " index_entries=" << u->second.index_entries
+                  << " index_bytes=" << u->second.index_bytes
+                  << " index_bytes_saved=" << u->second.index_bytes_saved;
+    }
+
+    LOG(INFO) << "end storage measurement";
+}
@@ -0,0 +1,95 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef hyperdex_daemon_datalayer_measurer_thread_h_
+#define hyperdex_daemon_datalayer_measurer_thread_h_
+
+// STL
+#include <map>
+#include <string>
+
+// HyperDex
+#include "daemon/background_thread.h"
+#include "daemon/datalayer.h"
+
+// Logs, for every space, the bytes used by objects and index entries, and the
+// bytes saved by the compact index entry format.  A measurement reads every
+// index entry and object, so it runs here rather than on the main thread, in
+// batches of keys so that a pause never waits on a whole scan.  Keys written
+// between batches may or may not be counted.
+class hyperdex::datalayer::measurer_thread : public hyperdex::background_thread
+{
+    public:
+        measurer_thread(daemon* d);
+        ~measurer_thread() throw ();
+
+    public:
+        virtual const char* thread_name();
+        virtual bool have_work();
+        virtual void copy_work();
+        virtual void do_work();
+
+    public:
+        void debug_dump();
+        // start a measurement, unless one is already running
+        void request_measure();
+
+    private:
+        struct storage_usage
+        {
+            storage_usage()
+                : objects(0), object_bytes(0)
+                , index_entries(0), index_bytes(0), index_bytes_saved(0) {}
+            uint64_t objects;
+            uint64_t object_bytes;
+            uint64_t index_entries;
+            uint64_t index_bytes;
+            uint64_t index_bytes_saved;
+        };
+        typedef std::map<std::string, storage_usage> usage_map_t;
+
+    private:
+        void measure_index_entry(const leveldb::Slice& key);
+        void measure_object(const leveldb::Slice& key, const leveldb::Slice& value);
+        void report();
+
+    private:
+        daemon* m_daemon;
+        bool m_measure_requested; // under lock
+        bool m_measuring; // under lock
+        uint64_t m_measurements;
+        // where the next batch starts, and the totals so far; do_work only
+        std::string m_resume;
+        usage_map_t m_usage;
+
+    private:
+        measurer_thread(const measurer_thread&);
+        measurer_thread& operator = (const measurer_thread&);
+};
+
+#endif // hyperdex_daemon_datalayer_measurer_thread_h_
@@ -0,0 +1,289 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#define __STDC_LIMIT_MACROS
+
+// STL
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// Google Log
+#include <glog/logging.h>
+
+// e
+#include <e/endian.h>
+
+// HyperDex
+#include "common/index.h"
+#include "daemon/daemon.h"
+#include "daemon/datalayer_iterator.h"
+#include "daemon/datalayer_sweeper_thread.h"
+#include "daemon/index_bucketed.h"
+
+// Upper bound on the expired objects examined by one pass, so that the
+// sweeper never holds up a pause for long; a pass that hits it and makes
+// progress schedules another
+#define SWEEP_BATCH 4096
+// the most objects deleted by a single write
+#define EXPIRE_BATCH 256
+// Replicas compare against their own clocks, so an object is deleted only
+// once it has been expired for this long (in microseconds).  A point leader
+// whose clock lags may still treat a swept object as live; the write it sends
+// then follows a version the replica forgot, which key_state accepts (see
+// key_state::follows_swept_object), but within this margin it never has to.
+#define SWEEP_SKEW (60ULL * 1000000ULL)
+
+using hyperdex::datalayer;
+
+datalayer :: sweeper_thread :: sweeper_thread(daemon* d)
+    : background_thread(d)
+    , m_daemon(d)
+    , m_sweep_requested(false)
+    , m_sweeps(0)
+    , m_expired(0)
+    , m_compactions(0)
+    , m_compacted()
+{
+}
+
+datalayer :: sweeper_thread :: ~sweeper_thread() throw ()
+{
+}
+
+const char*
+datalayer :: sweeper_thread :: thread_name()
+{
+    return "sweeper";
+}
+
+bool
+datalayer :: sweeper_thread :: have_work()
+{
+    return m_sweep_requested;
+}
+
+void
+datalayer :: sweeper_thread :: copy_work()
+{
+    m_sweep_requested = false;
+}
+
+void
+datalayer :: sweeper_thread :: do_work()
+{
+    std::vector<region_id> regions;
+    m_daemon->m_config.mapped_regions(m_daemon->m_us, &regions);
+    uint64_t examined = 0;
+    uint64_t expired = 0;
+
+    for (size_t i = 0; i < regions.size() && examined < SWEEP_BATCH; ++i)
+    {
+        const schema* sc = m_daemon->m_config.get_schema(regions[i]);
+
+        if (!sc || sc->ttl_attr == 0)
+        {
+            continue;
+        }
+
+        sweep_region(regions[i], *sc, SWEEP_BATCH - examined, &examined, &expired);
+    }
+
+    this->lock();
+    ++m_sweeps;
+    m_expired += expired;
+
+    // Every object deleted by this pass is gone from the next pass's
+    // snapshot, so sweeping again right away reaches new objects.  Objects
+    // skipped because a write was in flight are left for the next interval
+    // rather than rescanned in a loop.
+    if (examined >= SWEEP_BATCH && expired > 0)
+    {
+        m_sweep_requested = true;
+    }
+
+    this->unlock();
+}
+
+void
+datalayer :: sweeper_thread :: debug_dump()
+{
+    this->lock();
+    LOG(INFO) << "sweeper thread ================================================================";
+    LOG(INFO) << "sweep_requested=" << (m_sweep_requested ? "yes" : "no");
+    LOG(INFO) << "sweeps=" << m_sweeps;
+    LOG(INFO) << "expired=" << m_expired;
+    LOG(INFO) << "compactions=" << m_compactions;
+    this->unlock();
+}
+
+void
+datalayer :: sweeper_thread :: request_sweep()
+{
+    this->lock();
+    m_sweep_requested = true;
+    this->wakeup();
+    this->unlock();
+}
+
+void
+datalayer :: sweeper_thread :: sweep_region(const region_id& ri,
+                                            const schema& sc,
+                                            uint64_t budget,
+                                            uint64_t* examined,
+                                            uint64_t* expired)
+{
+    uint64_t cutoff = expiry_cutoff(sc);
+
+    if (cutoff <= SWEEP_SKEW)
+    {
+        return;
+    }
+
+    cutoff -= SWEEP_SKEW;
+
+    // select 0 < ttl_attr < cutoff so that an index on the TTL attribute can
+    // narrow the search; a bucketed index reads the run of old buckets from a
+    // single seek
+    char lower[sizeof(int64_t)];
+    char upper[sizeof(int64_t)];
+    e::pack64le(static_cast<int64_t>(0), lower);
+    e::pack64le(static_cast<int64_t>(cutoff), upper);
+    std::vector<attribute_check> checks(2);
+    checks[0].attr = sc.ttl_attr;
+    checks[0].value = e::slice(lower, sizeof(int64_t));
+    checks[0].datatype = sc.attrs[sc.ttl_attr].type;
+    checks[0].predicate = HYPERPREDICATE_GREATER_THAN;
+    checks[1].attr = sc.ttl_attr;
+    checks[1].value = e::slice(upper, sizeof(int64_t));
+    checks[1].datatype = sc.attrs[sc.ttl_attr].type;
+    checks[1].predicate = HYPERPREDICATE_LESS_THAN;
+    std::stable_sort(checks.begin(), checks.end());
+
+    datalayer* dl = &m_daemon->m_data;
+    snapshot snap = dl->make_snapshot();
+    e::intrusive_ptr<iterator> iter;
+    iter = dl->make_search_iterator(snap, ri, checks, NULL, 0);
+    std::vector<std::string> keys;
+    uint64_t seen = 0;
+    uint64_t deleted = 0;
+
+    while (seen < budget && iter->valid())
+    {
+        e::slice key = iter->key();
+        keys.push_back(std::string(reinterpret_cast<const char*>(key.data()), key.size()));
+        iter->next();
+        ++seen;
+
+        if (keys.size() >= EXPIRE_BATCH)
+        {
+            deleted += expire(ri, cutoff, &keys);
+        }
+    }
+
+    if (!keys.empty())
+    {
+        deleted += expire(ri, cutoff, &keys);
+    }
+
+    *examined += seen;
+    *expired += deleted;
+
+    // nothing below the cutoff is left, so its whole buckets hold only
+    // tombstones
+    if (!iter->valid() && deleted == seen)
+    {
+        compact_buckets(ri, sc, cutoff);
+    }
+}
+
+uint64_t
+datalayer :: sweeper_thread :: expire(const region_id& ri,
+                                      uint64_t cutoff,
+                                      std::vector<std::string>* keys)
+{
+    // each replica deletes its own copy; the TTL is a function of the
+    // object, so no replication is needed to agree on what expired
+    uint64_t n = m_daemon->m_repl.expire_objects(ri, cutoff, *keys);
+    keys->clear();
+
+    for (uint64_t i = 0; i < n; ++i)
+    {
+        m_daemon->m_perf_objects_expired.tap();
+    }
+
+    return n;
+}
+
+void
+datalayer :: sweeper_thread :: compact_buckets(const region_id& ri,
+                                               const schema& sc,
+                                               uint64_t cutoff)
+{
+    hyperdatatype dt = sc.attrs[sc.ttl_attr].type;
+
+    if (CONTAINER_TYPE(dt) != HYPERDATATYPE_TIMESTAMP_GENERIC)
+    {
+        return;
+    }
+
+    // bucket 0 also holds the objects without a TTL, and the bucket holding
+    // the cutoff may still gain expired objects
+    const int64_t last = index_bucketed::bucket_for(dt, cutoff);
+    std::vector<const index*> indices;
+    m_daemon->m_data.find_indices(ri, sc.ttl_attr, &indices);
+
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+        const index* idx = indices[i];
+
+        // a partial index may omit objects the sweep never saw
+        if (idx->type != index::BUCKETED || !idx->predicate.empty())
+        {
+            continue;
+        }
+
+        int64_t* compacted = &m_compacted[std::make_pair(ri, idx->id)];
+        const int64_t first = std::max(*compacted, static_cast<int64_t>(1));
+
+        if (first >= last)
+        {
+            continue;
+        }
+
+        const index_bucketed* ib = static_cast<const index_bucketed*>(index_info::lookup(*idx, dt));
+        std::string lower;
+        std::string upper;
+        ib->bucket_bounds(ri, idx->id, first, last, &lower, &upper);
+        leveldb::Slice lo(lower);
+        leveldb::Slice hi(upper);
+        m_daemon->m_data.m_db->CompactRange(&lo, &hi);
+        *compacted = last;
+        ++m_compactions;
+    }
+}
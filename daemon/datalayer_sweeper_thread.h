@@ -0,0 +1,94 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef hyperdex_daemon_datalayer_sweeper_thread_h_
+#define hyperdex_daemon_datalayer_sweeper_thread_h_
+
+// STL
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// HyperDex
+#include "daemon/background_thread.h"
+#include "daemon/datalayer.h"
+
+// Deletes objects that outlived their space's TTL.  HyperLevelDB cannot drop
+// them during compaction, so the sweeper finds them with a search and every
+// replica deletes its own copies, together with their index entries, in
+// batched writes.  Keys with a write in flight are left for the next pass.
+// When a bucketed index covers the TTL attribute, the buckets that a pass
+// left empty are compacted as one range.
+class hyperdex::datalayer::sweeper_thread : public hyperdex::background_thread
+{
+    public:
+        sweeper_thread(daemon* d);
+        ~sweeper_thread() throw ();
+
+    public:
+        virtual const char* thread_name();
+        virtual bool have_work();
+        virtual void copy_work();
+        virtual void do_work();
+
+    public:
+        void debug_dump();
+        void request_sweep();
+
+    private:
+        // examine at most "budget" expired objects of "ri", adding to
+        // "examined" and to "expired" the number deleted
+        void sweep_region(const region_id& ri, const schema& sc,
+                          uint64_t budget, uint64_t* examined, uint64_t* expired);
+        // delete and clear "keys", returning the number deleted
+        uint64_t expire(const region_id& ri, uint64_t cutoff,
+                        std::vector<std::string>* keys);
+        // compact the whole buckets before "cutoff" in every bucketed index
+        // on the TTL attribute of "ri"; the caller deleted their objects
+        void compact_buckets(const region_id& ri, const schema& sc,
+                             uint64_t cutoff);
+
+    private:
+        typedef std::map<std::pair<region_id, index_id>, int64_t> compacted_map_t;
+
+    private:
+        daemon* m_daemon;
+        bool m_sweep_requested; // under lock
+        uint64_t m_sweeps;
+        uint64_t m_expired;
+        uint64_t m_compactions;
+        // the first bucket of each bucketed index not compacted yet
+        compacted_map_t m_compacted;
+
+    private:
+        sweeper_thread(const sweeper_thread&);
+        sweeper_thread& operator = (const sweeper_thread&);
+};
+
+#endif // hyperdex_daemon_datalayer_sweeper_thread_h_
@@ -0,0 +1,89 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// e
+#include <e/endian.h>
+
+// HyperDex
+#include "common/datatype_bitmap.h"
+#include "daemon/index_bitmap.h"
+
+using hyperdex::datatype_bitmap;
+using hyperdex::datatype_info;
+using hyperdex::index_bitmap;
+using hyperdex::index_info;
+
+index_bitmap :: index_bitmap()
+{
+}
+
+index_bitmap :: ~index_bitmap() throw ()
+{
+}
+
+hyperdatatype
+index_bitmap :: datatype() const
+{
+    return HYPERDATATYPE_BITMAP_INT64;
+}
+
+void
+index_bitmap :: extract_elements(const e::slice& bitmap,
+                                 std::vector<char>* scratch,
+                                 std::vector<e::slice>* elems) const
+{
+    std::vector<uint32_t> members;
+    datatype_bitmap::members(bitmap, &members);
+
+    if (members.empty())
+    {
+        return;
+    }
+
+    // size scratch once so the slices into it stay valid
+    scratch->resize(members.size() * sizeof(int64_t));
+    char* ptr = &(*scratch)[0];
+
+    for (size_t i = 0; i < members.size(); ++i)
+    {
+        elems->push_back(e::slice(ptr, sizeof(int64_t)));
+        ptr = e::pack64le(static_cast<uint64_t>(members[i]), ptr);
+    }
+}
+
+const datatype_info*
+index_bitmap :: element_datatype_info() const
+{
+    return datatype_info::lookup(HYPERDATATYPE_INT64);
+}
+
+const index_info*
+index_bitmap :: element_index_info() const
+{
+    return index_info::lookup(HYPERDATATYPE_INT64);
+}
@@ -0,0 +1,58 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef hyperdex_daemon_index_bitmap_h_
+#define hyperdex_daemon_index_bitmap_h_
+
+// HyperDex
+#include "namespace.h"
+#include "common/datatype_info.h"
+#include "daemon/index_container.h"
+
+BEGIN_HYPERDEX_NAMESPACE
+
+// Indexes each member of a bitmap as an int64, so CONTAINS checks on bitmaps
+// use the same index entries as CONTAINS checks on set(int64)
+class index_bitmap : public index_container
+{
+    public:
+        index_bitmap();
+        virtual ~index_bitmap() throw ();
+
+    private:
+        virtual hyperdatatype datatype() const;
+        virtual void extract_elements(const e::slice& container,
+                                      std::vector<char>* scratch,
+                                      std::vector<e::slice>* elems) const;
+        virtual const datatype_info* element_datatype_info() const;
+        virtual const index_info* element_index_info() const;
+};
+
+END_HYPERDEX_NAMESPACE
+
+#endif // hyperdex_daemon_index_bitmap_h_
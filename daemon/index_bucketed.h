@@ -0,0 +1,95 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef hyperdex_daemon_index_bucketed_h_
+#define hyperdex_daemon_index_bucketed_h_
+
+// STL
+#include <string>
+
+// HyperDex
+#include "namespace.h"
+#include "daemon/index_primitive.h"
+
+BEGIN_HYPERDEX_NAMESPACE
+
+// A bucketed index keeps one (bucket, key) entry for every object, where the
+// bucket is the timestamp attribute truncated to the unit of its type.
+// Entries within a bucket are ordered by key, so a write that moves the
+// timestamp within its bucket leaves the index untouched, a range query
+// reads only the buckets it overlaps, and all the entries older than a
+// bucket boundary form one contiguous run of keys.  The TTL sweeper finds
+// expired objects in that run with a single seek and deletes them in batches;
+// once a bucket is wholly expired and empty, it compacts the bucket's run so
+// that its tombstones are dropped together instead of lingering in front of
+// the newer buckets that "last N minutes" queries read.
+class index_bucketed : public index_primitive
+{
+    public:
+        index_bucketed(hyperdatatype datatype);
+        virtual ~index_bucketed() throw ();
+
+    public:
+        // the width of a bucket in microseconds
+        static int64_t bucket_width(hyperdatatype datatype);
+        // the bucket holding timestamp "ts"
+        static int64_t bucket_for(hyperdatatype datatype, int64_t ts);
+        // the entries of buckets [first, last) of index "ii" in "ri" sort at
+        // or after "lower" and before "upper"
+        void bucket_bounds(const region_id& ri,
+                           const index_id& ii,
+                           int64_t first,
+                           int64_t last,
+                           std::string* lower,
+                           std::string* upper) const;
+
+    public:
+        virtual hyperdatatype datatype() const;
+        virtual void index_changes(const index* idx,
+                                   const region_id& ri,
+                                   const index_encoding* key_ie,
+                                   const e::slice& key,
+                                   const e::slice* old_value,
+                                   const e::slice* new_value,
+                                   leveldb::WriteBatch* updates) const;
+        virtual datalayer::index_iterator* iterator_from_range(leveldb_snapshot_ptr snap,
+                                                               const region_id& ri,
+                                                               const index_id& ii,
+                                                               const range& r,
+                                                               const index_encoding* key_ie) const;
+
+    private:
+        int64_t bucket(const e::slice& value) const;
+
+    private:
+        hyperdatatype m_datatype;
+};
+
+END_HYPERDEX_NAMESPACE
+
+#endif // hyperdex_daemon_index_bucketed_h_
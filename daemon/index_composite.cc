@@ -0,0 +1,287 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <cassert>
+#include <cstring>
+
+// e
+#include <e/endian.h>
+#include <e/varint.h>
+
+// HyperDex
+#include "daemon/datalayer_encodings.h"
+#include "daemon/datalayer_iterator.h"
+#include "daemon/index_composite.h"
+
+using hyperdex::datalayer;
+
+inline leveldb::Slice e2level(const e::slice& s) { return leveldb::Slice(reinterpret_cast<const char*>(s.data()), s.size()); }
+
+// Fixed-size encodings already sort like their values.  Strings are written
+// with each NUL escaped as "\x00\xff" and end with "\x00\x01", so a string
+// sorts before every string it is a prefix of and the next attribute starts
+// at a known place.
+void
+hyperdex :: composite_encode_component(hyperdatatype t,
+                                       const e::slice& value,
+                                       std::vector<char>* out)
+{
+    if (t == HYPERDATATYPE_STRING)
+    {
+        for (size_t i = 0; i < value.size(); ++i)
+        {
+            out->push_back(value.data()[i]);
+
+            if (value.data()[i] == 0)
+            {
+                out->push_back('\xff');
+            }
+        }
+
+        out->push_back(0);
+        out->push_back(1);
+        return;
+    }
+
+    const hyperdex::index_encoding* ie = hyperdex::index_encoding::lookup(t);
+    assert(ie && ie->encoding_fixed());
+    size_t off = out->size();
+    out->resize(off + ie->encoded_size(value));
+    ie->encode(value, &(*out)[off]);
+}
+
+static bool
+composite_value(const hyperdex::schema& sc,
+                const hyperdex::index* idx,
+                const std::vector<e::slice>& value,
+                std::vector<char>* out)
+{
+    std::vector<uint16_t> attrs;
+
+    if (!hyperdex::unpack_composite_attrs(idx->extra, &attrs))
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < attrs.size(); ++i)
+    {
+        if (attrs[i] == 0 || attrs[i] >= sc.attrs_sz)
+        {
+            return false;
+        }
+
+        hyperdex::composite_encode_component(sc.attrs[attrs[i]].type, value[attrs[i] - 1], out);
+    }
+
+    return true;
+}
+
+static size_t
+composite_prefix_sz(const hyperdex::region_id& ri, const hyperdex::index_id& ii)
+{
+    return sizeof(uint8_t)
+         + e::varint_length(ri.get())
+         + e::varint_length(ii.get());
+}
+
+// an entry for "key", or just the bound "value" when key_ie is NULL
+static void
+composite_entry(const hyperdex::region_id& ri,
+                const hyperdex::index_id& ii,
+                const std::vector<char>& value,
+                const hyperdex::index_encoding* key_ie,
+                const e::slice& key,
+                std::vector<char>* scratch,
+                e::slice* slice)
+{
+    size_t key_sz = key_ie ? key_ie->encoded_size(key) : 0;
+    bool variable = key_ie && !key_ie->encoding_fixed();
+    size_t sz = composite_prefix_sz(ri, ii)
+              + value.size()
+              + key_sz
+              + (variable ? hyperdex::index_entry_key_size_sz(key_sz) : 0);
+
+    if (scratch->size() < sz)
+    {
+        scratch->resize(sz);
+    }
+
+    char* ptr = &scratch->front();
+    ptr = e::pack8be('i', ptr);
+    ptr = e::packvarint64(ri.get(), ptr);
+    ptr = e::packvarint64(ii.get(), ptr);
+
+    if (!value.empty())
+    {
+        memmove(ptr, &value[0], value.size());
+        ptr += value.size();
+    }
+
+    if (key_ie)
+    {
+        ptr = key_ie->encode(key, ptr);
+    }
+
+    if (variable)
+    {
+        ptr = hyperdex::encode_index_entry_key_size(key_sz, ptr);
+    }
+
+    assert(ptr == &scratch->front() + sz);
+    *slice = e::slice(&scratch->front(), sz);
+}
+
+void
+hyperdex :: composite_index_changes(const schema& sc,
+                                    const index* idx,
+                                    const region_id& ri,
+                                    const index_encoding* key_ie,
+                                    const e::slice& key,
+                                    const std::vector<e::slice>* old_value,
+                                    const std::vector<e::slice>* new_value,
+                                    leveldb::WriteBatch* updates)
+{
+    std::vector<char> old_cv;
+    std::vector<char> new_cv;
+    bool has_old = old_value && composite_value(sc, idx, *old_value, &old_cv);
+    bool has_new = new_value && composite_value(sc, idx, *new_value, &new_cv);
+
+    if (has_old && has_new && old_cv == new_cv)
+    {
+        return;
+    }
+
+    std::vector<char> scratch;
+    e::slice slice;
+
+    if (has_old)
+    {
+        composite_entry(ri, idx->id, old_cv, key_ie, key, &scratch, &slice);
+        updates->Delete(e2level(slice));
+    }
+
+    if (has_new)
+    {
+        composite_entry(ri, idx->id, new_cv, key_ie, key, &scratch, &slice);
+        updates->Put(e2level(slice), leveldb::Slice());
+    }
+}
+
+size_t
+hyperdex :: composite_bounds(const schema& sc,
+                             const index* idx,
+                             const std::vector<range>& ranges,
+                             std::vector<char>* lower,
+                             std::vector<char>* upper)
+{
+    std::vector<uint16_t> attrs;
+
+    if (!unpack_composite_attrs(idx->extra, &attrs))
+    {
+        return 0;
+    }
+
+    size_t used = 0;
+
+    for (size_t i = 0; i < attrs.size(); ++i)
+    {
+        const range* r = NULL;
+
+        for (size_t j = 0; j < ranges.size(); ++j)
+        {
+            if (ranges[j].attr == attrs[i] && !ranges[j].invalid)
+            {
+                r = &ranges[j];
+            }
+        }
+
+        if (!r || attrs[i] >= sc.attrs_sz)
+        {
+            break;
+        }
+
+        hyperdatatype t = sc.attrs[attrs[i]].type;
+        ++used;
+
+        if (r->has_start && r->has_end && r->start == r->end)
+        {
+            composite_encode_component(t, r->start, lower);
+            composite_encode_component(t, r->start, upper);
+            continue;
+        }
+
+        // one trailing range ends the usable prefix
+        if (r->has_start)
+        {
+            composite_encode_component(t, r->start, lower);
+        }
+
+        if (r->has_end)
+        {
+            composite_encode_component(t, r->end, upper);
+        }
+
+        break;
+    }
+
+    return used;
+}
+
+datalayer::index_iterator*
+hyperdex :: composite_iterator_from_ranges(leveldb_snapshot_ptr snap,
+                                           const schema& sc,
+                                           const region_id& ri,
+                                           const index* idx,
+                                           const std::vector<range>& ranges,
+                                           const index_encoding* key_ie)
+{
+    std::vector<char> lower;
+    std::vector<char> upper;
+
+    if (composite_bounds(sc, idx, ranges, &lower, &upper) == 0)
+    {
+        return NULL;
+    }
+
+    // The upper bound is a prefix of the entries it admits, because entries
+    // continue with the attributes past the last constrained one.  The
+    // composite value as a whole is variable-length, which is all the
+    // iterator needs to know to find the key.
+    std::vector<char> scratch_lower;
+    std::vector<char> scratch_upper;
+    e::slice start;
+    e::slice limit;
+    composite_entry(ri, idx->id, lower, NULL, e::slice(), &scratch_lower, &start);
+    composite_entry(ri, idx->id, upper, NULL, e::slice(), &scratch_upper, &limit);
+    return new datalayer::range_index_iterator(snap, composite_prefix_sz(ri, idx->id),
+                                               start, limit,
+                                               true, true, true,
+                                               index_encoding::lookup(HYPERDATATYPE_STRING),
+                                               key_ie);
+}
@@ -0,0 +1,89 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef hyperdex_daemon_index_composite_h_
+#define hyperdex_daemon_index_composite_h_
+
+// STL
+#include <vector>
+
+// HyperDex
+#include "namespace.h"
+#include "common/index.h"
+#include "common/range.h"
+#include "common/schema.h"
+#include "daemon/index_info.h"
+
+BEGIN_HYPERDEX_NAMESPACE
+
+// Entries in a COMPOSITE index hold the index's attributes in order, each in
+// an encoding that both sorts like the value and delimits itself, followed by
+// the key:  'i' | region | index | attr_1 | ... | attr_n | key
+// Like other entries, they end with the key size when the key is variable.
+
+// append the encoding of one attribute of a composite entry to "out"
+void
+composite_encode_component(hyperdatatype t,
+                           const e::slice& value,
+                           std::vector<char>* out);
+
+// fill in the composite values bounding the entries that match "ranges";
+// entries at or above "lower" match if "upper" is at or above their prefix of
+// its length.  Returns the number of leading attributes of "idx" bounded,
+// zero if nothing constrains the first.
+size_t
+composite_bounds(const schema& sc,
+                 const index* idx,
+                 const std::vector<range>& ranges,
+                 std::vector<char>* lower,
+                 std::vector<char>* upper);
+
+void
+composite_index_changes(const schema& sc,
+                        const index* idx,
+                        const region_id& ri,
+                        const index_encoding* key_ie,
+                        const e::slice& key,
+                        const std::vector<e::slice>* old_value,
+                        const std::vector<e::slice>* new_value,
+                        leveldb::WriteBatch* updates);
+
+// return an iterator over the entries whose leading attributes are equal to
+// the equality ranges among "ranges", and whose next attribute falls in its
+// range, if there is one; NULL if nothing constrains the first attribute
+datalayer::index_iterator*
+composite_iterator_from_ranges(leveldb_snapshot_ptr snap,
+                               const schema& sc,
+                               const region_id& ri,
+                               const index* idx,
+                               const std::vector<range>& ranges,
+                               const index_encoding* key_ie);
+
+END_HYPERDEX_NAMESPACE
+
+#endif // hyperdex_daemon_index_composite_h_
@@ -55,17 +55,19 @@ index_container :: index_changes(const index* idx,
                                  const e::slice* new_value,
                                  leveldb::WriteBatch* updates) const
 {
+    std::vector<char> old_scratch;
+    std::vector<char> new_scratch;
     std::vector<e::slice> old_elems;
     std::vector<e::slice> new_elems;
 
     if (old_value)
     {
-        this->extract_elements(*old_value, &old_elems);
+        this->extract_elements(*old_value, &old_scratch, &old_elems);
     }
 
     if (new_value)
     {
-        this->extract_elements(*new_value, &new_elems);
+        this->extract_elements(*new_value, &new_scratch, &new_elems);
     }
 
     std::sort(old_elems.begin(), old_elems.end());
@@ -119,6 +121,13 @@ index_container :: index_changes(const index* idx,
     }
 }
 
+bool
+index_container :: entry_has_key_size(const index_encoding* key_ie,
+                                       const e::slice& entry) const
+{
+    return this->element_index_info()->entry_has_key_size(key_ie, entry);
+}
+
 datalayer::index_iterator*
 index_container :: iterator_from_check(leveldb_snapshot_ptr snap,
                                        const region_id& ri,
@@ -53,9 +53,13 @@ class index_container : public index_info
                                                                const index_id& ii,
                                                                const attribute_check& c,
                                                                const index_encoding* key_ie) const;
+        virtual bool entry_has_key_size(const index_encoding* key_ie,
+                                        const e::slice& entry) const;
 
     private:
+        // elements may point into "container" or into "scratch"
         virtual void extract_elements(const e::slice& container,
+                                      std::vector<char>* scratch,
                                       std::vector<e::slice>* elems) const = 0;
         virtual const datatype_info* element_datatype_info() const = 0;
         virtual const index_info* element_index_info() const = 0;
@@ -29,6 +29,14 @@
 #include "config.h"
 #endif
 
+// C
+#include <string.h>
+
+// STL
+#include <algorithm>
+#include <iterator>
+#include <string>
+
 // e
 #include <e/endian.h>
 #include <e/guard.h>
@@ -45,6 +53,36 @@ using hyperdex::index_encoding_document;
 inline leveldb::Slice e2level(const e::slice& s) { return leveldb::Slice(reinterpret_cast<const char*>(s.data()), s.size()); }
 inline e::slice level2e(const leveldb::Slice& s) { return e::slice(s.data(), s.size()); }
 
+// CONTAINS on a path is an equality on each element, which a "path[*]" index
+// holds.
+bool
+hyperdex :: document_index_covers(const index& idx,
+                                  const attribute_check& check)
+{
+    if (idx.type != index::DOCUMENT)
+    {
+        return true;
+    }
+
+    const char* path = reinterpret_cast<const char*>(check.value.data());
+    size_t path_sz = strnlen(path, check.value.size());
+
+    if (path_sz >= check.value.size())
+    {
+        return false;
+    }
+
+    std::string want(path, path_sz);
+
+    if (check.predicate == HYPERPREDICATE_CONTAINS)
+    {
+        want += "[*]";
+    }
+
+    std::string have(idx.extra.cdata(), strnlen(idx.extra.cdata(), idx.extra.size()));
+    return want == have;
+}
+
 index_document :: index_document()
     : m_di()
 {
@@ -69,27 +107,125 @@ index_document :: index_changes(const index* idx,
                                 const e::slice* new_document,
                                 leveldb::WriteBatch* updates) const
 {
-    type_t t;
-    std::vector<char> scratch_value;
-    e::slice value;
-    std::vector<char> scratch_entry;
-    e::slice entry;
-
     if (old_document && new_document && *old_document == *new_document)
     {
         return;
     }
 
-    if (old_document && parse_path(idx, *old_document, &t, &scratch_value, &value))
+    if (datatype_document::is_wildcard_path(idx->extra.cdata()))
     {
-        index_entry(ri, idx->id, t, key_ie, key, value, &scratch_entry, &entry);
-        updates->Delete(leveldb::Slice(reinterpret_cast<const char*>(entry.data()), entry.size()));
+        array_changes(idx, ri, key_ie, key, old_document, new_document, updates);
+        return;
     }
 
-    if (new_document && parse_path(idx, *new_document, &t, &scratch_value, &value))
+    type_t old_t = STRING;
+    type_t new_t = STRING;
+    std::vector<char> scratch_old;
+    std::vector<char> scratch_new;
+    e::slice old_value;
+    e::slice new_value;
+    bool has_old = old_document && parse_path(idx, *old_document, &old_t, &scratch_old, &old_value);
+    bool has_new = new_document && parse_path(idx, *new_document, &new_t, &scratch_new, &new_value);
+    path_changes(idx, ri, key_ie, key,
+                 has_old, old_t, old_value,
+                 has_new, new_t, new_value, updates);
+}
+
+void
+index_document :: index_changes(const std::vector<const index*>& idxs,
+                                const region_id& ri,
+                                const index_encoding* key_ie,
+                                const e::slice& key,
+                                const std::vector<const e::slice*>& old_documents,
+                                const std::vector<const e::slice*>& new_documents,
+                                leveldb::WriteBatch* updates) const
+{
+    assert(idxs.size() == old_documents.size());
+    assert(idxs.size() == new_documents.size());
+    std::vector<bool> done(idxs.size(), false);
+
+    for (size_t i = 0; i < idxs.size(); ++i)
     {
-        index_entry(ri, idx->id, t, key_ie, key, value, &scratch_entry, &entry);
-        updates->Put(leveldb::Slice(reinterpret_cast<const char*>(entry.data()), entry.size()), leveldb::Slice());
+        if (done[i])
+        {
+            continue;
+        }
+
+        // gather the indices on the same attribute as idxs[i]; they all see
+        // the same document, or none at all when a partial index drops it
+        std::vector<size_t> group;
+        std::vector<const char*> paths;
+        const e::slice* old_document = NULL;
+        const e::slice* new_document = NULL;
+
+        for (size_t j = i; j < idxs.size(); ++j)
+        {
+            if (done[j] || idxs[j]->attr != idxs[i]->attr)
+            {
+                continue;
+            }
+
+            done[j] = true;
+
+            if (old_documents[j] && new_documents[j] &&
+                *old_documents[j] == *new_documents[j])
+            {
+                continue;
+            }
+
+            if (!old_documents[j] && !new_documents[j])
+            {
+                continue;
+            }
+
+            if (datatype_document::is_wildcard_path(idxs[j]->extra.cdata()))
+            {
+                array_changes(idxs[j], ri, key_ie, key,
+                              old_documents[j], new_documents[j], updates);
+                continue;
+            }
+
+            old_document = old_documents[j] ? old_documents[j] : old_document;
+            new_document = new_documents[j] ? new_documents[j] : new_document;
+            group.push_back(j);
+            paths.push_back(idxs[j]->extra.cdata());
+        }
+
+        if (group.empty())
+        {
+            continue;
+        }
+
+        std::vector<hyperdatatype> old_types(paths.size(), HYPERDATATYPE_GARBAGE);
+        std::vector<hyperdatatype> new_types(paths.size(), HYPERDATATYPE_GARBAGE);
+        std::vector<std::vector<char> > old_scratch;
+        std::vector<std::vector<char> > new_scratch;
+        std::vector<e::slice> old_values(paths.size());
+        std::vector<e::slice> new_values(paths.size());
+
+        if (old_document &&
+            !m_di.extract_values(paths, *old_document, &old_types, &old_scratch, &old_values))
+        {
+            old_types.assign(paths.size(), HYPERDATATYPE_GARBAGE);
+        }
+
+        if (new_document &&
+            !m_di.extract_values(paths, *new_document, &new_types, &new_scratch, &new_values))
+        {
+            new_types.assign(paths.size(), HYPERDATATYPE_GARBAGE);
+        }
+
+        for (size_t k = 0; k < group.size(); ++k)
+        {
+            const size_t j = group[k];
+            type_t old_t = STRING;
+            type_t new_t = STRING;
+            bool has_old = old_documents[j] && path_type(old_types[k], &old_t);
+            bool has_new = new_documents[j] && path_type(new_types[k], &new_t);
+            path_changes(idxs[j], ri, key_ie, key,
+                         has_old, old_t, old_values[k],
+                         has_new, new_t, new_values[k], updates);
+        }
     }
 }
 
@@ -116,6 +252,20 @@ index_document :: iterator_from_check(leveldb_snapshot_ptr snap,
         return NULL;
     }
 
+    // an index over array elements holds one entry per distinct element, so
+    // only an equality visits each object at most once
+    hyperpredicate pred = check.predicate;
+
+    if (pred == HYPERPREDICATE_CONTAINS)
+    {
+        pred = HYPERPREDICATE_EQUALS;
+    }
+    else if (datatype_document::is_wildcard_path(path) &&
+             pred != HYPERPREDICATE_EQUALS)
+    {
+        return NULL;
+    }
+
     char scratch_v[sizeof(int64_t) + sizeof(double)];
     e::slice value(path + path_sz + 1, check.value.size() - path_sz - 1);
 
@@ -148,7 +298,7 @@ index_document :: iterator_from_check(leveldb_snapshot_ptr snap,
     }
     else if(check.datatype == HYPERDATATYPE_DOCUMENT)
     {
-        if(check.predicate != HYPERPREDICATE_EQUALS)
+        if(pred != HYPERPREDICATE_EQUALS)
         {
             return NULL;
         }
@@ -163,7 +313,7 @@ index_document :: iterator_from_check(leveldb_snapshot_ptr snap,
     index_entry(ri, ii, t, value, &scratch_a, &a);
     index_entry(ri, ii, t, &scratch_b, &b);
 
-    switch (check.predicate)
+    switch (pred)
     {
         case HYPERPREDICATE_EQUALS:
             start = a;
@@ -186,6 +336,7 @@ index_document :: iterator_from_check(leveldb_snapshot_ptr snap,
         case HYPERPREDICATE_LENGTH_LESS_EQUAL:
         case HYPERPREDICATE_LENGTH_GREATER_EQUAL:
         case HYPERPREDICATE_CONTAINS:
+        case HYPERPREDICATE_STARTS_WITH:
         default:
             return NULL;
     }
@@ -196,7 +347,7 @@ index_document :: iterator_from_check(leveldb_snapshot_ptr snap,
     has_limit = a.data() == limit.data();
     return new datalayer::range_index_iterator(snap, range_prefix_sz,
                                                start, limit,
-                                               has_start, has_limit,
+                                               has_start, has_limit, false,
                                                ie, key_ie);
 }
 
@@ -226,27 +377,141 @@ index_document :: parse_path(const index* idx,
                              e::slice* value) const
 {
     hyperdatatype type;
+    return m_di.extract_value(idx->extra.cdata(), document, &type, scratch, value) &&
+           path_type(type, t);
+}
 
-    if (m_di.extract_value(idx->extra.cdata(), document, &type, scratch, value))
+bool
+index_document :: path_type(hyperdatatype type, type_t* t) const
+{
+    if (type == HYPERDATATYPE_STRING)
     {
-        if (type == HYPERDATATYPE_STRING)
-        {
-            *t = STRING;
-            return true;
-        }
-        else if (type == HYPERDATATYPE_INT64 || type == HYPERDATATYPE_FLOAT)
-        {
-            *t = NUMBER;
-            return true;
-        }
-        else if (type == HYPERDATATYPE_DOCUMENT)
+        *t = STRING;
+        return true;
+    }
+    else if (type == HYPERDATATYPE_INT64 || type == HYPERDATATYPE_FLOAT)
+    {
+        *t = NUMBER;
+        return true;
+    }
+    else if (type == HYPERDATATYPE_DOCUMENT)
+    {
+        *t = DOCUMENT;
+        return true;
+    }
+
+    return false;
+}
+
+void
+index_document :: path_changes(const index* idx,
+                               const region_id& ri,
+                               const index_encoding* key_ie,
+                               const e::slice& key,
+                               bool has_old, type_t old_t, const e::slice& old_value,
+                               bool has_new, type_t new_t, const e::slice& new_value,
+                               leveldb::WriteBatch* updates) const
+{
+    std::vector<char> scratch_entry;
+    e::slice entry;
+
+    if (has_old && has_new && old_t == new_t && old_value == new_value)
+    {
+        return;
+    }
+
+    if (has_old)
+    {
+        index_entry(ri, idx->id, old_t, key_ie, key, old_value, &scratch_entry, &entry);
+        updates->Delete(leveldb::Slice(reinterpret_cast<const char*>(entry.data()), entry.size()));
+    }
+
+    if (has_new)
+    {
+        index_entry(ri, idx->id, new_t, key_ie, key, new_value, &scratch_entry, &entry);
+        updates->Put(leveldb::Slice(reinterpret_cast<const char*>(entry.data()), entry.size()), leveldb::Slice());
+    }
+}
+
+void
+index_document :: array_changes(const index* idx,
+                                const region_id& ri,
+                                const index_encoding* key_ie,
+                                const e::slice& key,
+                                const e::slice* old_document,
+                                const e::slice* new_document,
+                                leveldb::WriteBatch* updates) const
+{
+    std::vector<std::string> old_entries;
+    std::vector<std::string> new_entries;
+
+    if (old_document)
+    {
+        array_entries(idx, ri, key_ie, key, *old_document, &old_entries);
+    }
+
+    if (new_document)
+    {
+        array_entries(idx, ri, key_ie, key, *new_document, &new_entries);
+    }
+
+    // like index_container, touch only the elements that came or went
+    std::vector<std::string> removed;
+    std::vector<std::string> added;
+    std::set_difference(old_entries.begin(), old_entries.end(),
+                        new_entries.begin(), new_entries.end(),
+                        std::back_inserter(removed));
+    std::set_difference(new_entries.begin(), new_entries.end(),
+                        old_entries.begin(), old_entries.end(),
+                        std::back_inserter(added));
+
+    for (size_t i = 0; i < removed.size(); ++i)
+    {
+        updates->Delete(leveldb::Slice(removed[i]));
+    }
+
+    for (size_t i = 0; i < added.size(); ++i)
+    {
+        updates->Put(leveldb::Slice(added[i]), leveldb::Slice());
+    }
+}
+
+void
+index_document :: array_entries(const index* idx,
+                                const region_id& ri,
+                                const index_encoding* key_ie,
+                                const e::slice& key,
+                                const e::slice& document,
+                                std::vector<std::string>* entries) const
+{
+    std::vector<hyperdatatype> types;
+    std::vector<std::vector<char> > scratch_values;
+    std::vector<e::slice> values;
+    std::vector<char> scratch_entry;
+    e::slice entry;
+
+    if (!m_di.extract_elements(idx->extra.cdata(), document, &types, &scratch_values, &values))
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        type_t t;
+
+        if (!path_type(types[i], &t))
         {
-            *t = DOCUMENT;
-            return true;
+            continue;
         }
+
+        index_entry(ri, idx->id, t, key_ie, key, values[i], &scratch_entry, &entry);
+        entries->push_back(std::string(entry.cdata(), entry.size()));
     }
 
-    return false;
+    std::sort(entries->begin(), entries->end());
+    std::vector<std::string>::iterator it;
+    it = std::unique(entries->begin(), entries->end());
+    entries->resize(it - entries->begin());
 }
 
 size_t
@@ -358,6 +623,33 @@ index_document :: iterator_for_keys(leveldb_snapshot_ptr snap,
     return iterator_key(snap, ri, scan, ie);
 }
 
+bool
+index_document :: entry_has_key_size(const index_encoding* key_ie,
+                                      const e::slice& entry) const
+{
+    if (entry.empty() || key_ie->encoding_fixed())
+    {
+        return false;
+    }
+
+    type_t t;
+
+    switch (entry.data()[0])
+    {
+        case 's':
+            t = STRING;
+            break;
+        case 'i':
+            t = NUMBER;
+            break;
+        default:
+            t = DOCUMENT;
+            break;
+    }
+
+    return !lookup_encoding(t)->encoding_fixed();
+}
+
 hyperdex::datalayer::index_iterator*
 index_document :: iterator_key(leveldb_snapshot_ptr snap,
                                 const region_id& ri,
@@ -399,7 +691,7 @@ index_document :: iterator_key(leveldb_snapshot_ptr snap,
 
     return new hyperdex::datalayer::range_index_iterator(snap, range_prefix_sz,
                                                start, limit,
-                                               r.has_start, r.has_end,
+                                               r.has_start, r.has_end, false,
                                                NULL, key_ie);
 }
 
@@ -424,7 +716,7 @@ index_document :: index_entry(const region_id& ri,
               + sizeof(uint8_t)
               + val_sz
               + key_sz
-              + (variable ? sizeof(uint32_t) : 0);
+              + (variable ? index_entry_key_size_sz(key_sz) : 0);
 
     if (scratch->size() < sz)
     {
@@ -455,7 +747,7 @@ index_document :: index_entry(const region_id& ri,
 
     if (variable)
     {
-        ptr = e::pack32be(key_sz, ptr);
+        ptr = encode_index_entry_key_size(key_sz, ptr);
     }
 
     assert(ptr == &scratch->front() + sz);
@@ -30,11 +30,17 @@
 
 // HyperDex
 #include "namespace.h"
+#include "common/attribute_check.h"
 #include "common/datatype_document.h"
 #include "daemon/index_info.h"
 
 BEGIN_HYPERDEX_NAMESPACE
 
+// A document index answers checks on exactly the path it covers; other
+// indices are not restricted by the check's path.
+bool
+document_index_covers(const index& idx, const attribute_check& check);
+
 class index_document : public index_info
 {
     public:
@@ -57,6 +63,20 @@ class index_document : public index_info
                                                                const index_encoding* key_ie) const;
         virtual datalayer::index_iterator* iterator_for_keys(leveldb_snapshot_ptr snap,
                                              const region_id& ri) const;
+        virtual bool entry_has_key_size(const index_encoding* key_ie,
+                                        const e::slice& entry) const;
+
+    public:
+        // index_changes for several document indices at once.  Each version
+        // of a document is parsed once for all paths indexed on it, and
+        // paths whose value did not change generate no updates.
+        void index_changes(const std::vector<const index*>& idxs,
+                           const region_id& ri,
+                           const index_encoding* key_ie,
+                           const e::slice& key,
+                           const std::vector<const e::slice*>& old_documents,
+                           const std::vector<const e::slice*>& new_documents,
+                           leveldb::WriteBatch* updates) const;
 
     private:
         enum type_t { STRING, NUMBER, DOCUMENT };
@@ -65,6 +85,27 @@ class index_document : public index_info
                         type_t* t,
                         std::vector<char>* scratch,
                         e::slice* value) const;
+        bool path_type(hyperdatatype type, type_t* t) const;
+        void array_changes(const index* idx,
+                           const region_id& ri,
+                           const index_encoding* key_ie,
+                           const e::slice& key,
+                           const e::slice* old_document,
+                           const e::slice* new_document,
+                           leveldb::WriteBatch* updates) const;
+        void array_entries(const index* idx,
+                           const region_id& ri,
+                           const index_encoding* key_ie,
+                           const e::slice& key,
+                           const e::slice& document,
+                           std::vector<std::string>* entries) const;
+        void path_changes(const index* idx,
+                          const region_id& ri,
+                          const index_encoding* key_ie,
+                          const e::slice& key,
+                          bool has_old, type_t old_t, const e::slice& old_value,
+                          bool has_new, type_t new_t, const e::slice& new_value,
+                          leveldb::WriteBatch* updates) const;
         size_t index_entry_prefix_size(const region_id& ri, const index_id& ii) const;
         void index_entry(const region_id& ri,
                          const index_id& ii,
@@ -27,15 +27,19 @@
 
 // HyperDex
 #include "common/datatype_info.h"
+#include "daemon/index_bitmap.h"
+#include "daemon/index_bucketed.h"
 #include "daemon/index_document.h"
 #include "daemon/index_float.h"
 #include "daemon/index_info.h"
 #include "daemon/index_int64.h"
+#include "daemon/index_length.h"
 #include "daemon/index_list.h"
 #include "daemon/index_timestamp.h"
 #include "daemon/index_map.h"
 #include "daemon/index_set.h"
 #include "daemon/index_string.h"
+#include "daemon/index_trigram.h"
 
 using hyperdex::datalayer;
 using hyperdex::index_encoding;
@@ -48,6 +52,7 @@ static const hyperdex::index_encoding_float e_float;
 static const hyperdex::index_encoding_timestamp e_timestamp;
 
 static const hyperdex::index_string i_string;
+static const hyperdex::index_trigram i_trigram;
 static const hyperdex::index_int64 i_int64;
 static const hyperdex::index_float i_float;
 static const hyperdex::index_document i_document;
@@ -66,12 +71,36 @@ static const hyperdex::index_map i_map_int64_float(HYPERDATATYPE_INT64, HYPERDAT
 static const hyperdex::index_map i_map_float_string(HYPERDATATYPE_FLOAT, HYPERDATATYPE_STRING);
 static const hyperdex::index_map i_map_float_int64(HYPERDATATYPE_FLOAT, HYPERDATATYPE_INT64);
 static const hyperdex::index_map i_map_float_float(HYPERDATATYPE_FLOAT, HYPERDATATYPE_FLOAT);
+static const hyperdex::index_bitmap i_bitmap_int64;
 static const hyperdex::index_timestamp i_timestamp_second(HYPERDATATYPE_TIMESTAMP_SECOND);
 static const hyperdex::index_timestamp i_timestamp_minute(HYPERDATATYPE_TIMESTAMP_MINUTE);
 static const hyperdex::index_timestamp i_timestamp_hour(HYPERDATATYPE_TIMESTAMP_HOUR);
 static const hyperdex::index_timestamp i_timestamp_day(HYPERDATATYPE_TIMESTAMP_DAY);
 static const hyperdex::index_timestamp i_timestamp_week(HYPERDATATYPE_TIMESTAMP_WEEK);
 static const hyperdex::index_timestamp i_timestamp_month(HYPERDATATYPE_TIMESTAMP_MONTH);
+static const hyperdex::index_bucketed i_bucketed_second(HYPERDATATYPE_TIMESTAMP_SECOND);
+static const hyperdex::index_bucketed i_bucketed_minute(HYPERDATATYPE_TIMESTAMP_MINUTE);
+static const hyperdex::index_bucketed i_bucketed_hour(HYPERDATATYPE_TIMESTAMP_HOUR);
+static const hyperdex::index_bucketed i_bucketed_day(HYPERDATATYPE_TIMESTAMP_DAY);
+static const hyperdex::index_bucketed i_bucketed_week(HYPERDATATYPE_TIMESTAMP_WEEK);
+static const hyperdex::index_bucketed i_bucketed_month(HYPERDATATYPE_TIMESTAMP_MONTH);
+static const hyperdex::index_length i_length_string(HYPERDATATYPE_STRING);
+static const hyperdex::index_length i_length_list_string(HYPERDATATYPE_LIST_STRING);
+static const hyperdex::index_length i_length_list_int64(HYPERDATATYPE_LIST_INT64);
+static const hyperdex::index_length i_length_list_float(HYPERDATATYPE_LIST_FLOAT);
+static const hyperdex::index_length i_length_set_string(HYPERDATATYPE_SET_STRING);
+static const hyperdex::index_length i_length_set_int64(HYPERDATATYPE_SET_INT64);
+static const hyperdex::index_length i_length_set_float(HYPERDATATYPE_SET_FLOAT);
+static const hyperdex::index_length i_length_map_string_string(HYPERDATATYPE_MAP_STRING_STRING);
+static const hyperdex::index_length i_length_map_string_int64(HYPERDATATYPE_MAP_STRING_INT64);
+static const hyperdex::index_length i_length_map_string_float(HYPERDATATYPE_MAP_STRING_FLOAT);
+static const hyperdex::index_length i_length_map_int64_string(HYPERDATATYPE_MAP_INT64_STRING);
+static const hyperdex::index_length i_length_map_int64_int64(HYPERDATATYPE_MAP_INT64_INT64);
+static const hyperdex::index_length i_length_map_int64_float(HYPERDATATYPE_MAP_INT64_FLOAT);
+static const hyperdex::index_length i_length_map_float_string(HYPERDATATYPE_MAP_FLOAT_STRING);
+static const hyperdex::index_length i_length_map_float_int64(HYPERDATATYPE_MAP_FLOAT_INT64);
+static const hyperdex::index_length i_length_map_float_float(HYPERDATATYPE_MAP_FLOAT_FLOAT);
+static const hyperdex::index_length i_length_bitmap_int64(HYPERDATATYPE_BITMAP_INT64);
 
 const index_encoding*
 index_encoding :: lookup(hyperdatatype datatype)
@@ -116,6 +145,12 @@ index_encoding :: lookup(hyperdatatype datatype)
         case HYPERDATATYPE_MAP_FLOAT_STRING:
         case HYPERDATATYPE_MAP_FLOAT_INT64:
         case HYPERDATATYPE_MAP_FLOAT_FLOAT:
+        case HYPERDATATYPE_VECTOR_GENERIC:
+        case HYPERDATATYPE_VECTOR_FLOAT:
+        case HYPERDATATYPE_BITMAP_GENERIC:
+        case HYPERDATATYPE_BITMAP_INT64:
+        case HYPERDATATYPE_HYPERLOGLOG:
+        case HYPERDATATYPE_COUNTMIN:
         case HYPERDATATYPE_MACAROON_SECRET:
         case HYPERDATATYPE_GARBAGE:
         default:
@@ -186,6 +221,8 @@ index_info :: lookup(hyperdatatype datatype)
             return &i_map_float_int64;
         case HYPERDATATYPE_MAP_FLOAT_FLOAT:
             return &i_map_float_float;
+        case HYPERDATATYPE_BITMAP_INT64:
+            return &i_bitmap_int64;
         case HYPERDATATYPE_GENERIC:
         case HYPERDATATYPE_LIST_GENERIC:
         case HYPERDATATYPE_SET_GENERIC:
@@ -194,6 +231,11 @@ index_info :: lookup(hyperdatatype datatype)
         case HYPERDATATYPE_MAP_INT64_KEYONLY:
         case HYPERDATATYPE_MAP_FLOAT_KEYONLY:
         case HYPERDATATYPE_TIMESTAMP_GENERIC:
+        case HYPERDATATYPE_VECTOR_GENERIC:
+        case HYPERDATATYPE_VECTOR_FLOAT:
+        case HYPERDATATYPE_BITMAP_GENERIC:
+        case HYPERDATATYPE_HYPERLOGLOG:
+        case HYPERDATATYPE_COUNTMIN:
         case HYPERDATATYPE_MACAROON_SECRET:
         case HYPERDATATYPE_GARBAGE:
         default:
@@ -201,6 +243,99 @@ index_info :: lookup(hyperdatatype datatype)
     }
 }
 
+static const hyperdex::index_info*
+lookup_length(hyperdatatype datatype)
+{
+    switch (datatype)
+    {
+        case HYPERDATATYPE_STRING:
+            return &i_length_string;
+        case HYPERDATATYPE_LIST_STRING:
+            return &i_length_list_string;
+        case HYPERDATATYPE_LIST_INT64:
+            return &i_length_list_int64;
+        case HYPERDATATYPE_LIST_FLOAT:
+            return &i_length_list_float;
+        case HYPERDATATYPE_SET_STRING:
+            return &i_length_set_string;
+        case HYPERDATATYPE_SET_INT64:
+            return &i_length_set_int64;
+        case HYPERDATATYPE_SET_FLOAT:
+            return &i_length_set_float;
+        case HYPERDATATYPE_MAP_STRING_STRING:
+            return &i_length_map_string_string;
+        case HYPERDATATYPE_MAP_STRING_INT64:
+            return &i_length_map_string_int64;
+        case HYPERDATATYPE_MAP_STRING_FLOAT:
+            return &i_length_map_string_float;
+        case HYPERDATATYPE_MAP_INT64_STRING:
+            return &i_length_map_int64_string;
+        case HYPERDATATYPE_MAP_INT64_INT64:
+            return &i_length_map_int64_int64;
+        case HYPERDATATYPE_MAP_INT64_FLOAT:
+            return &i_length_map_int64_float;
+        case HYPERDATATYPE_MAP_FLOAT_STRING:
+            return &i_length_map_float_string;
+        case HYPERDATATYPE_MAP_FLOAT_INT64:
+            return &i_length_map_float_int64;
+        case HYPERDATATYPE_MAP_FLOAT_FLOAT:
+            return &i_length_map_float_float;
+        case HYPERDATATYPE_BITMAP_INT64:
+            return &i_length_bitmap_int64;
+        default:
+            return NULL;
+    }
+}
+
+static const hyperdex::index_info*
+lookup_bucketed(hyperdatatype datatype)
+{
+    switch (datatype)
+    {
+        case HYPERDATATYPE_TIMESTAMP_SECOND:
+            return &i_bucketed_second;
+        case HYPERDATATYPE_TIMESTAMP_MINUTE:
+            return &i_bucketed_minute;
+        case HYPERDATATYPE_TIMESTAMP_HOUR:
+            return &i_bucketed_hour;
+        case HYPERDATATYPE_TIMESTAMP_DAY:
+            return &i_bucketed_day;
+        case HYPERDATATYPE_TIMESTAMP_WEEK:
+            return &i_bucketed_week;
+        case HYPERDATATYPE_TIMESTAMP_MONTH:
+            return &i_bucketed_month;
+        default:
+            return NULL;
+    }
+}
+
+const index_info*
+index_info :: lookup(const index& idx, hyperdatatype datatype)
+{
+    if (idx.type == index::TRIGRAM)
+    {
+        return datatype == HYPERDATATYPE_STRING ? &i_trigram : NULL;
+    }
+
+    // composite indices span attributes; see index_composite.h
+    if (idx.type == index::COMPOSITE)
+    {
+        return NULL;
+    }
+
+    if (idx.type == index::LENGTH)
+    {
+        return lookup_length(datatype);
+    }
+
+    if (idx.type == index::BUCKETED)
+    {
+        return lookup_bucketed(datatype);
+    }
+
+    return lookup(datatype);
+}
+
 index_info :: index_info()
 {
 }
@@ -209,6 +344,13 @@ index_info :: ~index_info() throw ()
 {
 }
 
+bool
+index_info :: entry_has_key_size(const index_encoding*,
+                                 const e::slice&) const
+{
+    return false;
+}
+
 datalayer::index_iterator*
 index_info :: iterator_for_keys(leveldb_snapshot_ptr,
                                 const region_id&) const
@@ -75,6 +75,8 @@ class index_info
     public:
         // return NULL for unindexable type
         static const index_info* lookup(hyperdatatype datatype);
+        // the index_info that maintains idx on an attribute of this datatype
+        static const index_info* lookup(const index& idx, hyperdatatype datatype);
 
     public:
         index_info();
@@ -110,6 +112,10 @@ class index_info
                                                                const index_id& ii,
                                                                const attribute_check& c,
                                                                const index_encoding* key_ie) const;
+        // does this index entry (everything after the region and index id)
+        // end with the size of the key?
+        virtual bool entry_has_key_size(const index_encoding* key_ie,
+                                        const e::slice& entry) const;
 };
 
 END_HYPERDEX_NAMESPACE
@@ -0,0 +1,174 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <assert.h>
+#include <string.h>
+
+// STL
+#include <algorithm>
+
+// e
+#include <e/endian.h>
+
+// HyperDex
+#include "common/datatype_info.h"
+#include "daemon/datalayer_iterator.h"
+#include "daemon/index_length.h"
+
+using hyperdex::datalayer;
+using hyperdex::index_length;
+
+inline leveldb::Slice e2level(const e::slice& s) { return leveldb::Slice(reinterpret_cast<const char*>(s.data()), s.size()); }
+
+index_length :: index_length(hyperdatatype dt)
+    : index_primitive(index_encoding::lookup(HYPERDATATYPE_INT64))
+    , m_datatype(dt)
+{
+}
+
+index_length :: ~index_length() throw ()
+{
+}
+
+hyperdatatype
+index_length :: datatype() const
+{
+    return m_datatype;
+}
+
+void
+index_length :: index_changes(const index* idx,
+                              const region_id& ri,
+                              const index_encoding* key_ie,
+                              const e::slice& key,
+                              const e::slice* old_value,
+                              const e::slice* new_value,
+                              leveldb::WriteBatch* updates) const
+{
+    datatype_info* di = datatype_info::lookup(m_datatype);
+    assert(di->has_length());
+    char old_len[sizeof(int64_t)];
+    char new_len[sizeof(int64_t)];
+
+    if (old_value)
+    {
+        e::pack64le(static_cast<int64_t>(di->length(*old_value)), old_len);
+    }
+
+    if (new_value)
+    {
+        e::pack64le(static_cast<int64_t>(di->length(*new_value)), new_len);
+    }
+
+    // most writes leave the length alone
+    if (old_value && new_value &&
+        memcmp(old_len, new_len, sizeof(int64_t)) == 0)
+    {
+        return;
+    }
+
+    std::vector<char> scratch;
+    e::slice slice;
+
+    if (old_value)
+    {
+        index_entry(ri, idx->id, key_ie, key, e::slice(old_len, sizeof(int64_t)), &scratch, &slice);
+        updates->Delete(e2level(slice));
+    }
+
+    if (new_value)
+    {
+        index_entry(ri, idx->id, key_ie, key, e::slice(new_len, sizeof(int64_t)), &scratch, &slice);
+        updates->Put(e2level(slice), leveldb::Slice());
+    }
+}
+
+datalayer::index_iterator*
+index_length :: iterator_from_range(leveldb_snapshot_ptr,
+                                    const region_id&,
+                                    const index_id&,
+                                    const range&,
+                                    const index_encoding*) const
+{
+    // ranges are over values, not their lengths
+    return NULL;
+}
+
+datalayer::index_iterator*
+index_length :: iterator_from_check(leveldb_snapshot_ptr snap,
+                                    const region_id& ri,
+                                    const index_id& ii,
+                                    const attribute_check& c,
+                                    const index_encoding* key_ie) const
+{
+    if (c.datatype != HYPERDATATYPE_INT64)
+    {
+        return NULL;
+    }
+
+    char len[sizeof(int64_t)];
+    memset(len, 0, sizeof(int64_t));
+    memmove(len, c.value.data(), std::min(c.value.size(), sizeof(int64_t)));
+    range r;
+    r.attr = c.attr;
+    r.type = HYPERDATATYPE_INT64;
+    r.start = e::slice(len, sizeof(int64_t));
+    r.end = e::slice(len, sizeof(int64_t));
+    r.invalid = false;
+
+    switch (c.predicate)
+    {
+        case HYPERPREDICATE_LENGTH_EQUALS:
+            r.has_start = true;
+            r.has_end = true;
+            break;
+        case HYPERPREDICATE_LENGTH_LESS_EQUAL:
+        case HYPERPREDICATE_CONTAINS_LESS_THAN:
+            r.has_start = false;
+            r.has_end = true;
+            break;
+        case HYPERPREDICATE_LENGTH_GREATER_EQUAL:
+            r.has_start = true;
+            r.has_end = false;
+            break;
+        case HYPERPREDICATE_FAIL:
+        case HYPERPREDICATE_EQUALS:
+        case HYPERPREDICATE_LESS_THAN:
+        case HYPERPREDICATE_LESS_EQUAL:
+        case HYPERPREDICATE_GREATER_EQUAL:
+        case HYPERPREDICATE_GREATER_THAN:
+        case HYPERPREDICATE_REGEX:
+        case HYPERPREDICATE_CONTAINS:
+        case HYPERPREDICATE_STARTS_WITH:
+        default:
+            return NULL;
+    }
+
+    return iterator_attr(snap, ri, ii, r, key_ie);
+}
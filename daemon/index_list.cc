@@ -52,6 +52,7 @@ index_list :: datatype() const
 
 void
 index_list :: extract_elements(const e::slice& list,
+                              std::vector<char>*,
                               std::vector<e::slice>* elems) const
 {
     datatype_info* elem = datatype_info::lookup(m_datatype);
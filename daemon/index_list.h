@@ -44,6 +44,7 @@ class index_list : public index_container
     private:
         virtual hyperdatatype datatype() const;
         virtual void extract_elements(const e::slice& container,
+                                      std::vector<char>* scratch,
                                       std::vector<e::slice>* elems) const;
         virtual const datatype_info* element_datatype_info() const;
         virtual const index_info* element_index_info() const;
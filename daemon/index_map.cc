@@ -56,6 +56,7 @@ index_map :: datatype() const
 
 void
 index_map :: extract_elements(const e::slice& map,
+                              std::vector<char>*,
                               std::vector<e::slice>* elems) const
 {
     datatype_info* elem_k = datatype_info::lookup(m_key_datatype);
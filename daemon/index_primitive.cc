@@ -156,7 +156,7 @@ index_primitive :: iterator_key(leveldb_snapshot_ptr snap,
 
     return new datalayer::range_index_iterator(snap, range_prefix_sz,
                                                start, limit,
-                                               r.has_start, r.has_end,
+                                               r.has_start, r.has_end, false,
                                                NULL, key_ie);
 }
 
@@ -194,10 +194,34 @@ index_primitive :: iterator_attr(leveldb_snapshot_ptr snap,
 
     return new datalayer::range_index_iterator(snap, range_prefix_sz,
                                                start, limit,
-                                               r.has_start, r.has_end,
+                                               r.has_start, r.has_end, false,
                                                m_ie, key_ie);
 }
 
+datalayer::index_iterator*
+index_primitive :: iterator_prefix(leveldb_snapshot_ptr snap,
+                                   const region_id& ri,
+                                   const index_id& ii,
+                                   const e::slice& prefix,
+                                   const index_encoding* key_ie) const
+{
+    std::vector<char> scratch;
+    e::slice bound;
+    size_t range_prefix_sz = index_entry_prefix_size(ri, ii);
+    index_entry(ri, ii, prefix, &scratch, &bound);
+    return new datalayer::range_index_iterator(snap, range_prefix_sz,
+                                               bound, bound,
+                                               true, true, true,
+                                               m_ie, key_ie);
+}
+
+bool
+index_primitive :: entry_has_key_size(const index_encoding* key_ie,
+                                      const e::slice&) const
+{
+    return !key_ie->encoding_fixed() && !m_ie->encoding_fixed();
+}
+
 size_t
 index_primitive :: index_entry_prefix_size(const region_id& ri, const index_id& ii) const
 {
@@ -305,7 +329,7 @@ index_primitive :: index_entry(const region_id& ri,
               + e::varint_length(ii.get())
               + val_sz
               + key_sz
-              + (variable ? sizeof(uint32_t) : 0);
+              + (variable ? index_entry_key_size_sz(key_sz) : 0);
 
     if (scratch->size() < sz)
     {
@@ -321,7 +345,7 @@ index_primitive :: index_entry(const region_id& ri,
 
     if (variable)
     {
-        ptr = e::pack32be(key_sz, ptr);
+        ptr = encode_index_entry_key_size(key_sz, ptr);
     }
 
     assert(ptr == &scratch->front() + sz);
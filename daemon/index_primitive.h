@@ -55,41 +55,52 @@ class index_primitive : public index_info
                                                                const index_id& ii,
                                                                const range& r,
                                                                const index_encoding* key_ie) const;
+        virtual bool entry_has_key_size(const index_encoding* key_ie,
+                                        const e::slice& entry) const;
 
-    private:
-        class range_iterator;
-        class key_iterator;
-
-    private:
-        datalayer::index_iterator* iterator_key(leveldb_snapshot_ptr snap,
-                                                const region_id& ri,
-                                                const range& r,
-                                                const index_encoding* key_ie) const;
+    protected:
+        // every value that starts with "prefix"
+        datalayer::index_iterator* iterator_prefix(leveldb_snapshot_ptr snap,
+                                                   const region_id& ri,
+                                                   const index_id& ii,
+                                                   const e::slice& prefix,
+                                                   const index_encoding* key_ie) const;
         datalayer::index_iterator* iterator_attr(leveldb_snapshot_ptr snap,
                                                  const region_id& ri,
                                                  const index_id& ii,
                                                  const range& r,
                                                  const index_encoding* key_ie) const;
-        size_t index_entry_prefix_size(const region_id& ri, const index_id& ii) const;
         void index_entry(const region_id& ri,
                          const index_id& ii,
+                         const index_encoding* key_ie,
+                         const e::slice& key,
+                         const e::slice& value,
                          std::vector<char>* scratch,
                          e::slice* slice) const;
+        // the prefix shared by every entry for "value"
         void index_entry(const region_id& ri,
                          const index_id& ii,
                          const e::slice& value,
                          std::vector<char>* scratch,
                          e::slice* slice) const;
+
+    private:
+        class range_iterator;
+        class key_iterator;
+
+    private:
+        datalayer::index_iterator* iterator_key(leveldb_snapshot_ptr snap,
+                                                const region_id& ri,
+                                                const range& r,
+                                                const index_encoding* key_ie) const;
+        size_t index_entry_prefix_size(const region_id& ri, const index_id& ii) const;
         void index_entry(const region_id& ri,
                          const index_id& ii,
-                         const e::slice& internal_key,
-                         const e::slice& value,
                          std::vector<char>* scratch,
                          e::slice* slice) const;
         void index_entry(const region_id& ri,
                          const index_id& ii,
-                         const index_encoding* key_ie,
-                         const e::slice& key,
+                         const e::slice& internal_key,
                          const e::slice& value,
                          std::vector<char>* scratch,
                          e::slice* slice) const;
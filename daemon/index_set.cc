@@ -52,6 +52,7 @@ index_set :: datatype() const
 
 void
 index_set :: extract_elements(const e::slice& set,
+                              std::vector<char>*,
                               std::vector<e::slice>* elems) const
 {
     datatype_info* elem = datatype_info::lookup(m_datatype);
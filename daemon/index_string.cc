@@ -25,11 +25,16 @@
 // ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
 // POSSIBILITY OF SUCH DAMAGE.
 
+// STL
+#include <string>
+
 // e
 #include <e/endian.h>
 
 // HyperDex
+#include "common/regex_match.h"
 #include "daemon/datalayer_encodings.h"
+#include "daemon/datalayer_iterator.h"
 #include "daemon/index_string.h"
 
 using hyperdex::datalayer;
@@ -51,6 +56,37 @@ index_string :: datatype() const
     return HYPERDATATYPE_STRING;
 }
 
+// Prefix searches become a scan of the values that share the prefix.  A regex
+// is only narrowed to its anchored literal prefix, so the search still applies
+// the regex itself to what the index returns.
+datalayer::index_iterator*
+index_string :: iterator_from_check(leveldb_snapshot_ptr snap,
+                                    const region_id& ri,
+                                    const index_id& ii,
+                                    const attribute_check& c,
+                                    const index_encoding* key_ie) const
+{
+    if (c.datatype != HYPERDATATYPE_STRING)
+    {
+        return NULL;
+    }
+
+    if (c.predicate == HYPERPREDICATE_STARTS_WITH && !c.value.empty())
+    {
+        return iterator_prefix(snap, ri, ii, c.value, key_ie);
+    }
+
+    std::string prefix;
+
+    if (c.predicate == HYPERPREDICATE_REGEX &&
+        regex_literal_prefix(c.value.data(), c.value.size(), &prefix))
+    {
+        return iterator_prefix(snap, ri, ii, e::slice(prefix), key_ie);
+    }
+
+    return NULL;
+}
+
 index_encoding_string :: index_encoding_string()
 {
 }
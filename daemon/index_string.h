@@ -42,6 +42,11 @@ class index_string : public index_primitive
 
     public:
         virtual hyperdatatype datatype() const;
+        virtual datalayer::index_iterator* iterator_from_check(leveldb_snapshot_ptr snap,
+                                                               const region_id& ri,
+                                                               const index_id& ii,
+                                                               const attribute_check& c,
+                                                               const index_encoding* key_ie) const;
 };
 
 class index_encoding_string : public index_encoding
@@ -0,0 +1,294 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <cassert>
+#include <cstring>
+
+// STL
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+// HyperDex
+#include "common/regex_match.h"
+#include "daemon/datalayer_iterator.h"
+#include "daemon/index_trigram.h"
+
+using hyperdex::datalayer;
+using hyperdex::index_trigram;
+using hyperdex::index_encoding_trigram;
+
+// How many posting lists a search intersects.  The cheapest few bound the
+// candidates about as well as all of them, and each extra list costs a seek
+// per candidate.
+#define TRIGRAM_MAX_POSTING_LISTS 4
+
+static const index_encoding_trigram e_trigram;
+
+inline leveldb::Slice e2level(const e::slice& s) { return leveldb::Slice(reinterpret_cast<const char*>(s.data()), s.size()); }
+
+static void
+pack_trigram(uint32_t t, char* out)
+{
+    out[0] = (t >> 16) & 0xff;
+    out[1] = (t >> 8) & 0xff;
+    out[2] = t & 0xff;
+}
+
+// every distinct trigram of s, sorted
+static void
+trigrams(const e::slice& s, std::vector<uint32_t>* ts)
+{
+    const uint8_t* ptr = s.data();
+
+    for (size_t i = 0; i + 3 <= s.size(); ++i)
+    {
+        ts->push_back((uint32_t(ptr[i]) << 16) |
+                      (uint32_t(ptr[i + 1]) << 8) |
+                      uint32_t(ptr[i + 2]));
+    }
+
+    std::sort(ts->begin(), ts->end());
+    ts->erase(std::unique(ts->begin(), ts->end()), ts->end());
+}
+
+index_trigram :: index_trigram()
+    : index_primitive(&e_trigram)
+{
+}
+
+index_trigram :: ~index_trigram() throw ()
+{
+}
+
+hyperdatatype
+index_trigram :: datatype() const
+{
+    return HYPERDATATYPE_STRING;
+}
+
+void
+index_trigram :: index_changes(const index* idx,
+                               const region_id& ri,
+                               const index_encoding* key_ie,
+                               const e::slice& key,
+                               const e::slice* old_value,
+                               const e::slice* new_value,
+                               leveldb::WriteBatch* updates) const
+{
+    if (old_value && new_value && *old_value == *new_value)
+    {
+        return;
+    }
+
+    std::vector<uint32_t> old_ts;
+    std::vector<uint32_t> new_ts;
+
+    if (old_value)
+    {
+        trigrams(*old_value, &old_ts);
+    }
+
+    if (new_value)
+    {
+        trigrams(*new_value, &new_ts);
+    }
+
+    // only touch the trigrams that came or went
+    std::vector<uint32_t> dels;
+    std::vector<uint32_t> puts;
+    std::set_difference(old_ts.begin(), old_ts.end(),
+                        new_ts.begin(), new_ts.end(),
+                        std::back_inserter(dels));
+    std::set_difference(new_ts.begin(), new_ts.end(),
+                        old_ts.begin(), old_ts.end(),
+                        std::back_inserter(puts));
+    std::vector<char> scratch;
+    e::slice slice;
+    char t[3];
+
+    for (size_t i = 0; i < dels.size(); ++i)
+    {
+        pack_trigram(dels[i], t);
+        index_entry(ri, idx->id, key_ie, key, e::slice(t, 3), &scratch, &slice);
+        updates->Delete(e2level(slice));
+    }
+
+    for (size_t i = 0; i < puts.size(); ++i)
+    {
+        pack_trigram(puts[i], t);
+        index_entry(ri, idx->id, key_ie, key, e::slice(t, 3), &scratch, &slice);
+        updates->Put(e2level(slice), leveldb::Slice());
+    }
+}
+
+datalayer::index_iterator*
+index_trigram :: iterator_from_range(leveldb_snapshot_ptr,
+                                     const region_id&,
+                                     const index_id&,
+                                     const range&,
+                                     const index_encoding*) const
+{
+    // trigrams say nothing about the order of whole values
+    return NULL;
+}
+
+datalayer::index_iterator*
+index_trigram :: iterator_from_check(leveldb_snapshot_ptr snap,
+                                     const region_id& ri,
+                                     const index_id& ii,
+                                     const attribute_check& c,
+                                     const index_encoding* key_ie) const
+{
+    if (c.datatype != HYPERDATATYPE_STRING)
+    {
+        return NULL;
+    }
+
+    std::vector<std::string> runs;
+
+    switch (c.predicate)
+    {
+        case HYPERPREDICATE_EQUALS:
+        case HYPERPREDICATE_STARTS_WITH:
+            runs.push_back(c.value.str());
+            break;
+        case HYPERPREDICATE_REGEX:
+            regex_literal_runs(c.value.data(), c.value.size(), &runs);
+            break;
+        case HYPERPREDICATE_FAIL:
+        case HYPERPREDICATE_LESS_THAN:
+        case HYPERPREDICATE_LESS_EQUAL:
+        case HYPERPREDICATE_GREATER_EQUAL:
+        case HYPERPREDICATE_GREATER_THAN:
+        case HYPERPREDICATE_CONTAINS_LESS_THAN:
+        case HYPERPREDICATE_LENGTH_EQUALS:
+        case HYPERPREDICATE_LENGTH_LESS_EQUAL:
+        case HYPERPREDICATE_LENGTH_GREATER_EQUAL:
+        case HYPERPREDICATE_CONTAINS:
+        default:
+            return NULL;
+    }
+
+    std::vector<uint32_t> ts;
+
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        trigrams(e::slice(runs[i]), &ts);
+    }
+
+    std::sort(ts.begin(), ts.end());
+    ts.erase(std::unique(ts.begin(), ts.end()), ts.end());
+
+    if (ts.empty())
+    {
+        return NULL;
+    }
+
+    typedef std::pair<uint64_t, e::intrusive_ptr<datalayer::index_iterator> > costed;
+    std::vector<costed> lists;
+
+    for (size_t i = 0; i < ts.size(); ++i)
+    {
+        char t[3];
+        pack_trigram(ts[i], t);
+        range r;
+        r.attr = c.attr;
+        r.type = HYPERDATATYPE_STRING;
+        r.start = e::slice(t, 3);
+        r.end = e::slice(t, 3);
+        r.has_start = true;
+        r.has_end = true;
+        r.invalid = false;
+        e::intrusive_ptr<datalayer::index_iterator> it;
+        it = iterator_attr(snap, ri, ii, r, key_ie);
+        assert(it->sorted());
+        lists.push_back(std::make_pair(it->cost(snap.db()), it));
+    }
+
+    std::sort(lists.begin(), lists.end());
+
+    if (lists.size() > TRIGRAM_MAX_POSTING_LISTS)
+    {
+        lists.resize(TRIGRAM_MAX_POSTING_LISTS);
+    }
+
+    std::vector<e::intrusive_ptr<datalayer::index_iterator> > iterators;
+
+    for (size_t i = 0; i < lists.size(); ++i)
+    {
+        iterators.push_back(lists[i].second);
+    }
+
+    return new datalayer::intersect_iterator(snap, iterators);
+}
+
+index_encoding_trigram :: index_encoding_trigram()
+{
+}
+
+index_encoding_trigram :: ~index_encoding_trigram() throw ()
+{
+}
+
+bool
+index_encoding_trigram :: encoding_fixed() const
+{
+    return true;
+}
+
+size_t
+index_encoding_trigram :: encoded_size(const e::slice&) const
+{
+    return 3;
+}
+
+char*
+index_encoding_trigram :: encode(const e::slice& decoded, char* encoded) const
+{
+    assert(decoded.size() == 3);
+    memmove(encoded, decoded.data(), 3);
+    return encoded + 3;
+}
+
+size_t
+index_encoding_trigram :: decoded_size(const e::slice&) const
+{
+    return 3;
+}
+
+char*
+index_encoding_trigram :: decode(const e::slice& encoded, char* decoded) const
+{
+    assert(encoded.size() == 3);
+    memmove(decoded, encoded.data(), 3);
+    return decoded + 3;
+}
@@ -27,6 +27,9 @@
 
 #define __STDC_LIMIT_MACROS
 
+// STL
+#include <algorithm>
+
 // Google Log
 #include <glog/logging.h>
 
@@ -51,6 +54,8 @@ key_operation :: key_operation(uint64_t old_version,
     , m_recv()
     , m_sent_config_version()
     , m_sent()
+    , m_sent_fanout(false)
+    , m_fanout_pending()
     , m_value(_value)
     , m_memory(memory)
     , m_type(UNKNOWN)
@@ -58,6 +63,7 @@ key_operation :: key_operation(uint64_t old_version,
     , m_this_new_region()
     , m_prev_region()
     , m_next_region()
+    , m_fanout_regions()
 {
 }
 
@@ -65,6 +71,42 @@ key_operation :: ~key_operation() throw ()
 {
 }
 
+void
+key_operation :: set_sent_fanout(uint64_t version,
+                                 const std::vector<virtual_server_id>& vsis)
+{
+    assert(!vsis.empty());
+    m_sent_config_version = version;
+    m_sent = vsis[0];
+    m_sent_fanout = true;
+    m_fanout_pending = vsis;
+}
+
+bool
+key_operation :: ack_from(uint64_t version, const virtual_server_id& vsi)
+{
+    if (!m_sent_fanout)
+    {
+        return sent_to(version, vsi);
+    }
+
+    if (m_sent_config_version != version)
+    {
+        return false;
+    }
+
+    std::vector<virtual_server_id>::iterator it;
+    it = std::find(m_fanout_pending.begin(), m_fanout_pending.end(), vsi);
+
+    if (it == m_fanout_pending.end())
+    {
+        return false;
+    }
+
+    m_fanout_pending.erase(it);
+    return m_fanout_pending.empty();
+}
+
 void
 key_operation :: set_continuous()
 {
@@ -122,4 +164,14 @@ key_operation :: debug_dump()
     LOG(INFO) << "    this_old: " << m_this_old_region;
     LOG(INFO) << "    this_new: " << m_this_new_region;
     LOG(INFO) << "    next: " << m_next_region;
+
+    for (size_t i = 0; i < m_fanout_regions.size(); ++i)
+    {
+        LOG(INFO) << "    fanout: " << m_fanout_regions[i];
+    }
+
+    for (size_t i = 0; i < m_fanout_pending.size(); ++i)
+    {
+        LOG(INFO) << "    awaiting ack: " << m_fanout_pending[i];
+    }
 }
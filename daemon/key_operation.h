@@ -30,6 +30,7 @@
 
 // STL
 #include <memory>
+#include <vector>
 
 // e
 #include <e/arena.h>
@@ -67,11 +68,16 @@ class key_operation
         bool recv_from(uint64_t version) const { return version == m_recv_config_version; }
         virtual_server_id recv_from() const { return m_recv; }
         void set_sent(uint64_t version, const virtual_server_id& vsi)
-        { m_sent_config_version = version; m_sent = vsi; }
+        { m_sent_config_version = version; m_sent = vsi; m_sent_fanout = false; }
         virtual_server_id sent_to() const { return m_sent; }
         uint64_t sent_version() const { return m_sent_config_version; }
         bool sent_to(uint64_t version, const virtual_server_id& vsi) const
         { return m_sent_config_version == version && m_sent == vsi; }
+        // parallel subspaces: the op is sent to the head of every subspace in
+        // the fanout and is ackable once each of them has acked it
+        void set_sent_fanout(uint64_t version, const std::vector<virtual_server_id>& vsis);
+        // does an ack from vsi complete the op we sent?
+        bool ack_from(uint64_t version, const virtual_server_id& vsi);
 
         // the path of the op through the value-dependent chain
         bool is_continuous() { return m_type == CONTINUOUS; }
@@ -91,9 +97,14 @@ class key_operation
         region_id this_old_region() const { return m_this_old_region; }
         region_id this_new_region() const { return m_this_new_region; }
         region_id next_region() const { return m_next_region; }
+        // call after hashing for parallel subspaces
+        void set_fanout_regions(const std::vector<region_id>& fanout)
+        { m_fanout_regions = fanout; }
+        const std::vector<region_id>& fanout_regions() const { return m_fanout_regions; }
 
         // the value set by this op
         bool is_fresh() { return m_fresh; }
+        void mark_fresh() { m_fresh = true; }
         bool has_value() { return m_has_value; }
         const std::vector<e::slice>& value() { return m_value; }
 
@@ -116,6 +127,8 @@ class key_operation
         virtual_server_id m_recv; // we recv from here
         uint64_t m_sent_config_version;
         virtual_server_id m_sent; // we sent to here
+        bool m_sent_fanout;
+        std::vector<virtual_server_id> m_fanout_pending; // waiting on acks
 
         const std::vector<e::slice> m_value;
         const std::auto_ptr<e::arena> m_memory;
@@ -125,6 +138,7 @@ class key_operation
         region_id m_this_new_region;
         region_id m_prev_region;
         region_id m_next_region;
+        std::vector<region_id> m_fanout_regions;
 
     private:
         key_operation(const key_operation&);
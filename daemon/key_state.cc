@@ -30,6 +30,10 @@
 // Google Log
 #include <glog/logging.h>
 
+// e
+#include <e/atomic.h>
+#include <e/endian.h>
+
 // HyperDex
 #include "common/hash.h"
 #include "common/network_returncode.h"
@@ -116,6 +120,7 @@ key_state :: key_state(const key_region& kr)
     , m_chain_ops()
     , m_chain_subspaces()
     , m_chain_acks()
+    , m_pending_version(0)
     , m_lock()
     , m_avail(&m_lock)
     , m_someone_is_working_the_state_machine(false)
@@ -193,7 +198,9 @@ key_state :: initialize(datalayer* data,
         return datalayer::SUCCESS;
     }
 
-    datalayer::returncode rc = data->get(ri, m_key, &m_old_value, &m_old_version, &m_old_disk_ref);
+    // expired objects are still on disk, and their index entries must be
+    // removed by whatever write replaces them
+    datalayer::returncode rc = data->get_even_if_expired(ri, m_key, &m_old_value, &m_old_version, &m_old_disk_ref);
 
     switch (rc)
     {
@@ -216,6 +223,83 @@ key_state :: initialize(datalayer* data,
     return rc;
 }
 
+bool
+key_state :: begin_expire(datalayer* data,
+                          const schema& sc,
+                          uint64_t cutoff,
+                          leveldb::WriteBatch* updates)
+{
+    {
+        po6::threads::mutex::hold hold(&m_lock);
+
+        // a write in flight decides for itself whether the object expired
+        if (!m_initialized ||
+            m_someone_is_working_the_state_machine ||
+            m_someone_needs_to_work_the_state_machine ||
+            !m_committable_empty || !m_blocked_empty ||
+            !m_deferred_empty || !m_changes_empty)
+        {
+            return false;
+        }
+
+        if (!m_has_old_value ||
+            sc.ttl_attr == 0 ||
+            sc.ttl_attr > m_old_value.size() ||
+            !datalayer::has_expired(m_old_value[sc.ttl_attr - 1], cutoff))
+        {
+            return false;
+        }
+
+        // hold the state machine so that no write to this key reaches the
+        // disk before "updates" does
+        m_someone_is_working_the_state_machine = true;
+    }
+
+    data->batch_del(m_ri, m_key, m_old_value, updates);
+    return true;
+}
+
+void
+key_state :: finish_expire(replication_manager* rm,
+                           const virtual_server_id& us,
+                           const schema& sc,
+                           bool deleted)
+{
+    if (deleted)
+    {
+        po6::threads::mutex::hold hold(&m_lock);
+        // keep m_old_version so that chain ops that follow still line up; if
+        // this key_state is dropped, follows_swept_object takes over
+        m_has_old_value = false;
+        m_old_value.clear();
+        datalayer::reference ref;
+        m_old_disk_ref.swap(&ref);
+        m_old_op = e::intrusive_ptr<key_operation>();
+        CHECK_INVARIANTS();
+    }
+
+    // apply whatever arrived while the state machine was held
+    work_state_machine_with_work_bit(rm, us, sc);
+}
+
+bool
+key_state :: follows_swept_object(const schema& sc,
+                                  bool has_old_value,
+                                  uint64_t old_version,
+                                  bool fresh,
+                                  bool has_value,
+                                  uint64_t prev_version)
+{
+    // a key_state that is still in memory kept the swept version, and a
+    // delete is a no-op for a replica that has nothing to delete
+    return sc.ttl_attr != 0 &&
+           !has_old_value &&
+           old_version == 0 &&
+           !fresh &&
+           has_value &&
+           prev_version > 0;
+}
+
 struct key_state::stub_client_atomic
 {
     stub_client_atomic(const server_id& f,
@@ -429,37 +513,19 @@ key_state :: max_version()
         m_avail.wait();
     }
 
-    uint64_t ret = 0;
-
-    for (key_operation_list_t::const_iterator it = m_committable.begin();
-            it != m_committable.end(); ++it)
-    {
-        ret = std::max(ret, (*it)->this_version());
-    }
-
-    for (key_operation_list_t::const_iterator it = m_blocked.begin();
-            it != m_blocked.end(); ++it)
-    {
-        ret = std::max(ret, (*it)->this_version());
-    }
-
-    for (key_operation_list_t::const_iterator it = m_deferred.begin();
-            it != m_deferred.end(); ++it)
-    {
-        ret = std::max(ret, (*it)->this_version());
-    }
-
-    for (key_change_list_t::const_iterator it = m_changes.begin();
-            it != m_changes.end(); ++it)
-    {
-        ret = std::max(ret, (*it)->version);
-    }
+    return m_pending_version;
+}
 
-    return ret;
+uint64_t
+key_state :: pending_version()
+{
+    return e::atomic::load_64_acquire(&m_pending_version);
 }
 
 void
-key_state :: reconfigure(e::garbage_collector* gc)
+key_state :: reconfigure(e::garbage_collector* gc,
+                         const server_id& us,
+                         std::vector<uint64_t>* dropped)
 {
     po6::threads::mutex::hold hold(&m_lock);
 
@@ -475,6 +541,11 @@ key_state :: reconfigure(e::garbage_collector* gc)
 
     while (m_client_atomics.pop(gc, &sca))
     {
+        if (sca->from == us)
+        {
+            dropped->push_back(sca->nonce);
+        }
+
         delete sca;
     }
 
@@ -494,6 +565,7 @@ key_state :: reconfigure(e::garbage_collector* gc)
     }
 
     m_deferred.clear();
+    publish_pending_version();
     CHECK_INVARIANTS();
 }
 
@@ -540,6 +612,7 @@ key_state :: reset(e::garbage_collector* gc)
     m_blocked.clear();
     m_deferred.clear();
     m_changes.clear();
+    publish_pending_version();
     CHECK_INVARIANTS();
 }
 
@@ -790,6 +863,7 @@ key_state :: work_state_machine_with_work_bit(replication_manager* rm,
         }
 
         bool did_work = false;
+        publish_pending_version();
         CHECK_INVARIANTS();
 
         // Drain the blocked and deferred items first, because order does not
@@ -843,6 +917,7 @@ key_state :: work_state_machine_with_work_bit(replication_manager* rm,
 
         if (done)
         {
+            publish_pending_version();
             m_committable_empty = m_committable.empty();
             m_blocked_empty = m_blocked.empty();
             m_deferred_empty = m_deferred.empty();
@@ -957,7 +1032,7 @@ key_state :: do_chain_ack(replication_manager* rm,
         return;
     }
 
-    if (!op->sent_to(rm->m_daemon->m_config.version(), from))
+    if (!op->ack_from(rm->m_daemon->m_config.version(), from))
     {
         return;
     }
@@ -1116,6 +1191,44 @@ key_state :: get_latest(bool* has_old_value,
     }
 }
 
+// Readers of pending_version do not take m_lock, so the lists cannot be walked
+// on their behalf.  Instead, whoever holds the work bit stores their largest
+// version here after pulling in new work and before draining it to disk.  A
+// write is thus published before it can be read from disk, and stays
+// published until it is retired from the lists.
+void
+key_state :: publish_pending_version()
+{
+    uint64_t ret = 0;
+
+    for (key_operation_list_t::const_iterator it = m_committable.begin();
+            it != m_committable.end(); ++it)
+    {
+        ret = std::max(ret, (*it)->this_version());
+    }
+
+    for (key_operation_list_t::const_iterator it = m_blocked.begin();
+            it != m_blocked.end(); ++it)
+    {
+        ret = std::max(ret, (*it)->this_version());
+    }
+
+    for (key_operation_list_t::const_iterator it = m_deferred.begin();
+            it != m_deferred.end(); ++it)
+    {
+        ret = std::max(ret, (*it)->this_version());
+    }
+
+    for (key_change_list_t::const_iterator it = m_changes.begin();
+            it != m_changes.end(); ++it)
+    {
+        ret = std::max(ret, (*it)->version);
+    }
+
+    e::atomic::store_64_release(&m_pending_version, ret);
+    e::atomic::memory_barrier();
+}
+
 bool
 key_state :: drain_queue(replication_manager* rm,
                          const virtual_server_id& us,
@@ -1200,13 +1313,21 @@ key_state :: drain_changes(replication_manager*,
     m_changes.pop_front();
     key_change* kc = dkc->kc.get();
 
-    if (!auth_verify_write(sc, has_old_value, old_value, *kc))
+    // an object past its space's TTL stays on disk until the sweeper deletes
+    // it, but clients must find it missing, exactly as a get would
+    const bool expired = has_old_value && sc.ttl_attr != 0 &&
+                         sc.ttl_attr <= old_value->size() &&
+                         datalayer::has_expired((*old_value)[sc.ttl_attr - 1],
+                                                datalayer::expiry_cutoff(sc));
+    const bool visible = has_old_value && !expired;
+
+    if (!auth_verify_write(sc, visible, old_value, *kc))
     {
         add_response(client_response(old_version, dkc->from, dkc->nonce, NET_UNAUTHORIZED));
         return;
     }
 
-    network_returncode nrc = kc->check(sc, has_old_value, old_value);
+    network_returncode nrc = kc->check(sc, visible, old_value);
 
     if (nrc != NET_SUCCESS)
     {
@@ -1231,7 +1352,7 @@ key_state :: drain_changes(replication_manager*,
 
     // if there is no old value, pretend it is "new_value" which is
     // zero-initialized
-    if (!has_old_value)
+    if (!visible)
     {
         old_value = &new_value;
     }
@@ -1244,8 +1365,19 @@ key_state :: drain_changes(replication_manager*,
         return;
     }
 
+    // the point leader stamps every write with the time the TTL counts from
+    if (sc.ttl_on_write)
+    {
+        uint8_t* ptr = NULL;
+        memory->allocate(sizeof(int64_t), &ptr);
+        e::pack64le(static_cast<int64_t>(datalayer::wallclock_micros()), ptr);
+        new_value[sc.ttl_attr - 1] = e::slice(ptr, sizeof(int64_t));
+    }
+
+    // a write over an expired object is fresh:  a replica that has already
+    // swept the object has lost its version and must not wait for it
     e::intrusive_ptr<key_operation> op;
-    op = new key_operation(old_version, dkc->version, !has_old_value,
+    op = new key_operation(old_version, dkc->version, !visible,
                            true, new_value, memory);
     op->set_continuous();
     add_response(client_response(dkc->version, dkc->from, dkc->nonce, NET_SUCCESS));
@@ -1288,7 +1420,13 @@ key_state :: drain_deferred(replication_manager* rm,
     // version numbers), then it cannot be applied yet
     if (op->is_continuous() && !op->is_fresh() && old_version != op->prev_version())
     {
-        return;
+        if (!follows_swept_object(sc, has_old_value, old_version,
+                                  op->is_fresh(), op->has_value(), op->prev_version()))
+        {
+            return;
+        }
+
+        op->mark_fresh();
     }
 
     if (op->is_continuous())
@@ -1540,4 +1678,21 @@ key_state :: hash_objects(const configuration* config,
     }
 
     op->set_continuous_hashes(prev_region, this_old_region, this_new_region, next_region);
+
+    // with parallel subspaces, the key subspace forwards to the region that
+    // currently holds the object in every other subspace
+    std::vector<subspace_id> fanout;
+    config->subspace_fanout(subspace_this, &fanout);
+
+    if (!fanout.empty())
+    {
+        std::vector<region_id> fanout_regions(fanout.size());
+
+        for (size_t i = 0; i < fanout.size(); ++i)
+        {
+            config->lookup_region(fanout[i], old_hashes, &fanout_regions[i]);
+        }
+
+        op->set_fanout_regions(fanout_regions);
+    }
 }
@@ -97,9 +97,44 @@ class key_state
                                 const schema& sc);
 
         uint64_t max_version();
-        void reconfigure(e::garbage_collector* gc);
+        // The newest version of any write in flight for the key, or 0 if
+        // nothing is in flight.  This does not take the key's lock and may
+        // overstate what is in flight, but never understates a write that
+        // could already be on disk.
+        uint64_t pending_version();
+        // Drop queued work that the new configuration invalidates.  The
+        // nonces of queued client ops sent by "us" itself (the ops of a
+        // multi-atomic) are appended to "dropped" because nobody will answer
+        // them.
+        void reconfigure(e::garbage_collector* gc,
+                         const server_id& us,
+                         std::vector<uint64_t>* dropped);
         void reset(e::garbage_collector* gc);
 
+        // TTL expiry:  if nothing is in flight for the key and the object on
+        // disk expired before "cutoff", claim the state machine and add the
+        // object's deletion to "updates".  A true return means the caller
+        // must call finish_expire once "updates" has been written.
+        bool begin_expire(datalayer* data,
+                          const schema& sc,
+                          uint64_t cutoff,
+                          leveldb::WriteBatch* updates);
+        void finish_expire(replication_manager* rm,
+                           const virtual_server_id& us,
+                           const schema& sc,
+                           bool deleted);
+
+        // A replica that swept an expired object and then dropped the key's
+        // key_state has forgotten the object's version, yet a point leader
+        // whose clock lags may still send a write that follows it.  Such a
+        // write carries the whole object, so it is applied as if fresh.
+        static bool follows_swept_object(const schema& sc,
+                                         bool has_old_value,
+                                         uint64_t old_version,
+                                         bool fresh,
+                                         bool has_value,
+                                         uint64_t prev_version);
+
         void resend_committable(replication_manager* rm,
                                 const virtual_server_id& us);
 
@@ -189,6 +224,7 @@ class key_state
         void get_latest(bool* has_old_value,
                         uint64_t* old_version,
                         const std::vector<e::slice>** old_value);
+        void publish_pending_version();
         bool drain_queue(replication_manager* rm,
                          const virtual_server_id& us,
                          const schema& sc,
@@ -238,6 +274,11 @@ class key_state
         e::lockfree_mpsc_fifo<stub_chain_subspace> m_chain_subspaces;
         e::lockfree_mpsc_fifo<stub_chain_ack> m_chain_acks;
 
+        // The largest version in the committable, blocked, deferred and
+        // changes lists, stored by the thread with the work bit before it
+        // drains them, so a reader that finds a write on disk finds it here
+        uint64_t m_pending_version;
+
     // protected state, synchronized by m_lock;
     private:
         po6::threads::mutex m_lock;
@@ -36,6 +36,9 @@
 // Google Log
 #include <glog/logging.h>
 
+// e
+#include <e/array_ptr.h>
+
 // HyperDex
 #include "common/datatype_info.h"
 #include "common/hash.h"
@@ -73,6 +76,39 @@ class replication_manager::retransmitter_thread : public hyperdex::background_th
         retransmitter_thread& operator = (const retransmitter_thread&);
 };
 
+class replication_manager::multi_atomic
+{
+    public:
+        multi_atomic(const server_id& client,
+                     const virtual_server_id& us,
+                     uint64_t nonce,
+                     size_t ops);
+        ~multi_atomic() throw ();
+
+    public:
+        // returns true when every op has an outcome
+        bool record(size_t idx, network_returncode ret);
+        std::auto_ptr<e::buffer> response();
+
+    public:
+        const server_id client;
+        const virtual_server_id us;
+        const uint64_t nonce;
+
+    private:
+        friend class e::intrusive_ptr<multi_atomic>;
+        void inc() { __sync_add_and_fetch(&m_ref, 1); }
+        void dec() { if (__sync_sub_and_fetch(&m_ref, 1) == 0) delete this; }
+        size_t m_ref;
+        po6::threads::mutex m_mtx;
+        std::vector<uint16_t> m_results;
+        size_t m_outstanding;
+
+    private:
+        multi_atomic(const multi_atomic&);
+        multi_atomic& operator = (const multi_atomic&);
+};
+
 replication_manager :: replication_manager(daemon* d)
     : m_daemon(d)
     , m_key_states(&d->m_gc)
@@ -85,6 +121,9 @@ replication_manager :: replication_manager(daemon* d)
     , m_need_check(0)
     , m_timestamps()
     , m_unstable()
+    , m_protect_multi_atomic()
+    , m_next_multi_atomic(1)
+    , m_multi_atomic()
 {
     po6::threads::mutex::hold hold(&m_protect_stable_stuff);
     check_is_needed();
@@ -137,11 +176,14 @@ replication_manager :: reconfigure(const configuration&,
     std::vector<region_id> transfers_in_regions;
     new_config.transfers_in_regions(m_daemon->m_us, &transfers_in_regions);
 
+    // the nonces of our own multi-atomic ops the key states drop
+    std::vector<uint64_t> dropped;
+
     // iterate over all key states; cleanup dead ones, and bump idgen
     for (key_map_t::iterator it(&m_key_states); it.valid(); ++it)
     {
         key_state* ks = *it;
-        ks->reconfigure(&m_daemon->m_gc);
+        ks->reconfigure(&m_daemon->m_gc, m_daemon->m_us, &dropped);
         region_id ri = ks->state_key().region;
 
         if (std::binary_search(transfers_in_regions.begin(),
@@ -157,6 +199,10 @@ replication_manager :: reconfigure(const configuration&,
         }
     }
 
+    // the ops lost above will never respond; don't strand their requests
+    std::sort(dropped.begin(), dropped.end());
+    fail_multi_atomics(new_config, transfers_in_regions, dropped);
+
     // iterate over all regions on disk/lb, and bump idgen
     for (size_t i = 0; i < key_regions.size(); ++i)
     {
@@ -265,6 +311,76 @@ replication_manager :: client_atomic(const server_id& from,
     ks->enqueue_client_atomic(this, to, sc, from, nonce, kc, backing);
 }
 
+void
+replication_manager :: client_atomic_many(const server_id& from,
+                                          const virtual_server_id& to,
+                                          uint64_t nonce,
+                                          const std::vector<e::slice>& ops)
+{
+    e::intrusive_ptr<multi_atomic> ma(new multi_atomic(from, to, nonce, ops.size()));
+    region_id ri(m_daemon->m_config.get_region_id(to));
+    std::vector<uint64_t> nonces(ops.size());
+    std::vector<e::buffer*> backings(ops.size(), NULL);
+    std::vector<key_change*> kcs(ops.size(), NULL);
+
+    for (size_t i = 0; i < ops.size(); ++i)
+    {
+        // every op owns a private copy of its bytes, just like a REQ_ATOMIC
+        std::auto_ptr<e::buffer> backing(e::buffer::create(ops[i].size()));
+        backing->pack_at(0) << e::pack_memmove(ops[i].data(), ops[i].size());
+        std::auto_ptr<key_change> kc(new key_change());
+
+        if ((backing->unpack_from(0) >> *kc).error())
+        {
+            LOG(WARNING) << "unpack of op " << i << " in REQ_MULTI_ATOMIC failed";
+            continue;
+        }
+
+        backings[i] = backing.release();
+        kcs[i] = kc.release();
+    }
+
+    {
+        po6::threads::mutex::hold hold(&m_protect_multi_atomic);
+
+        for (size_t i = 0; i < ops.size(); ++i)
+        {
+            nonces[i] = m_next_multi_atomic++;
+            multi_atomic_op& mao(m_multi_atomic[nonces[i]]);
+            mao.ma = ma;
+            mao.idx = i;
+            mao.region = ri;
+
+            if (kcs[i])
+            {
+                mao.key.assign(reinterpret_cast<const char*>(kcs[i]->key.data()),
+                               kcs[i]->key.size());
+            }
+        }
+    }
+
+    if (ops.empty())
+    {
+        std::auto_ptr<e::buffer> msg(ma->response());
+        m_daemon->m_comm.send_client(to, from, RESP_MULTI_ATOMIC, msg);
+        return;
+    }
+
+    for (size_t i = 0; i < ops.size(); ++i)
+    {
+        if (!kcs[i])
+        {
+            complete_multi_atomic(nonces[i], NET_BADDIMSPEC);
+            continue;
+        }
+
+        // responses addressed to ourselves are routed back to "ma"
+        std::auto_ptr<key_change> kc(kcs[i]);
+        std::auto_ptr<e::buffer> backing(backings[i]);
+        client_atomic(m_daemon->m_us, to, nonces[i], kc, backing);
+    }
+}
+
 void
 replication_manager :: chain_op(const virtual_server_id& from,
                                 const virtual_server_id& to,
@@ -359,6 +475,61 @@ replication_manager :: chain_ack(const virtual_server_id& from,
     ks->enqueue_chain_ack(this, to, sc, from, version);
 }
 
+uint64_t
+replication_manager :: max_pending_version(const region_id& ri, const e::slice& key)
+{
+    key_map_t::state_reference ksr;
+    key_state* ks = get_key_state(ri, key, &ksr);
+    return ks ? ks->pending_version() : 0;
+}
+
+size_t
+replication_manager :: expire_objects(const region_id& ri,
+                                      uint64_t cutoff,
+                                      const std::vector<std::string>& keys)
+{
+    const schema* sc = m_daemon->m_config.get_schema(ri);
+    const virtual_server_id us = m_daemon->m_config.get_virtual(ri, m_daemon->m_us);
+
+    if (!sc || us == virtual_server_id() || m_daemon->m_config.read_only())
+    {
+        return 0;
+    }
+
+    // every claimed key_state holds back writes to its key until the batch
+    // that deletes the key is on disk
+    e::array_ptr<key_map_t::state_reference> ksrs(new key_map_t::state_reference[keys.size()]);
+    std::vector<key_state*> claimed;
+    leveldb::WriteBatch updates;
+
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        e::slice key(keys[i].data(), keys[i].size());
+        key_state* ks = get_or_create_key_state(ri, key, &ksrs[i]);
+
+        if (ks && ks->begin_expire(&m_daemon->m_data, *sc, cutoff, &updates))
+        {
+            claimed.push_back(ks);
+        }
+    }
+
+    bool deleted = claimed.empty() ||
+                   m_daemon->m_data.write_batch(&updates) == datalayer::SUCCESS;
+
+    if (!deleted)
+    {
+        LOG(ERROR) << "could not delete " << claimed.size()
+                   << " expired objects from " << ri;
+    }
+
+    for (size_t i = 0; i < claimed.size(); ++i)
+    {
+        claimed[i]->finish_expire(this, us, *sc, deleted);
+    }
+
+    return deleted ? claimed.size() : 0;
+}
+
 void
 replication_manager :: begin_checkpoint(uint64_t checkpoint_num)
 {
@@ -476,6 +647,14 @@ replication_manager :: respond_to_client(const virtual_server_id& us,
                                          uint64_t nonce,
                                          network_returncode ret)
 {
+    if (client == m_daemon->m_us)
+    {
+        // an op of a multi-atomic run by this daemon, e.g., for a group
+        // operation; it may already have been failed by a reconfiguration
+        complete_multi_atomic(nonce, ret);
+        return;
+    }
+
     size_t sz = HYPERDEX_HEADER_SIZE_VC
               + sizeof(uint64_t)
               + sizeof(uint16_t);
@@ -485,6 +664,61 @@ replication_manager :: respond_to_client(const virtual_server_id& us,
     m_daemon->m_comm.send_client(us, client, RESP_ATOMIC, msg);
 }
 
+bool
+replication_manager :: complete_multi_atomic(uint64_t nonce, network_returncode ret)
+{
+    multi_atomic_op mao;
+
+    {
+        po6::threads::mutex::hold hold(&m_protect_multi_atomic);
+        multi_atomic_map_t::iterator it = m_multi_atomic.find(nonce);
+
+        if (it == m_multi_atomic.end())
+        {
+            return false;
+        }
+
+        mao = it->second;
+        m_multi_atomic.erase(it);
+    }
+
+    if (mao.ma->record(mao.idx, ret))
+    {
+        std::auto_ptr<e::buffer> msg(mao.ma->response());
+        m_daemon->m_comm.send_client(mao.ma->us, mao.ma->client, RESP_MULTI_ATOMIC, msg);
+    }
+
+    return true;
+}
+
+void
+replication_manager :: fail_multi_atomics(const configuration& config,
+                                          const std::vector<region_id>& reset_regions,
+                                          const std::vector<uint64_t>& dropped)
+{
+    multi_atomic_map_t pending;
+
+    {
+        po6::threads::mutex::hold hold(&m_protect_multi_atomic);
+        pending = m_multi_atomic;
+    }
+
+    // ops that survive keep their place in a key state and will respond
+    for (multi_atomic_map_t::iterator it = pending.begin();
+            it != pending.end(); ++it)
+    {
+        const multi_atomic_op& mao(it->second);
+        e::slice key(mao.key.data(), mao.key.size());
+
+        if (std::binary_search(reset_regions.begin(), reset_regions.end(), mao.region) ||
+            std::binary_search(dropped.begin(), dropped.end(), it->first) ||
+            config.point_leader(mao.region, key) != mao.ma->us)
+        {
+            complete_multi_atomic(it->first, NET_NOTUS);
+        }
+    }
+}
+
 bool
 replication_manager :: send_message(const virtual_server_id& us,
                                     const e::slice& key,
@@ -519,6 +753,10 @@ replication_manager :: send_message(const virtual_server_id& us,
                 dest = m_daemon->m_config.head_of_region(op->next_region());
                 type = CHAIN_OP;
             }
+            else if (!op->fanout_regions().empty())
+            {
+                return send_fanout(us, key, op);
+            }
             else
             {
                 if (!op->ackable())
@@ -628,6 +866,43 @@ replication_manager :: send_message(const virtual_server_id& us,
     return m_daemon->m_comm.send_exact(us, dest, type, msg);
 }
 
+bool
+replication_manager :: send_fanout(const virtual_server_id& us,
+                                   const e::slice& key,
+                                   e::intrusive_ptr<key_operation> op)
+{
+    const std::vector<region_id>& fanout(op->fanout_regions());
+    std::vector<virtual_server_id> dests(fanout.size());
+
+    for (size_t i = 0; i < fanout.size(); ++i)
+    {
+        dests[i] = m_daemon->m_config.head_of_region(fanout[i]);
+    }
+
+    uint8_t flags = (op->is_fresh() ? 1 : 0)
+                  | (op->has_value() ? 2 : 0);
+    size_t sz = HYPERDEX_HEADER_SIZE_VV
+              + sizeof(uint8_t)
+              + sizeof(uint64_t)
+              + sizeof(uint64_t)
+              + pack_size(key)
+              + pack_size(op->value());
+    std::auto_ptr<e::buffer> msg(e::buffer::create(sz));
+    msg->pack_at(HYPERDEX_HEADER_SIZE_VV)
+        << flags << op->prev_version() << op->this_version()
+        << key << op->value();
+    op->set_sent_fanout(m_daemon->m_config.version(), dests);
+    bool sent = true;
+
+    for (size_t i = 0; i < dests.size(); ++i)
+    {
+        std::auto_ptr<e::buffer> copy(msg->copy());
+        sent = m_daemon->m_comm.send_exact(us, dests[i], CHAIN_OP, copy) && sent;
+    }
+
+    return sent;
+}
+
 bool
 replication_manager :: send_ack(const virtual_server_id& us,
                                 const e::slice& key,
@@ -899,3 +1174,52 @@ replication_manager :: retransmitter_thread :: trigger()
     this->wakeup();
     this->unlock();
 }
+
+replication_manager :: multi_atomic :: multi_atomic(const server_id& c,
+                                                    const virtual_server_id& u,
+                                                    uint64_t n,
+                                                    size_t ops)
+    : client(c)
+    , us(u)
+    , nonce(n)
+    , m_ref(0)
+    , m_mtx()
+    , m_results(ops, static_cast<uint16_t>(NET_SERVERERROR))
+    , m_outstanding(ops)
+{
+}
+
+replication_manager :: multi_atomic :: ~multi_atomic() throw ()
+{
+}
+
+bool
+replication_manager :: multi_atomic :: record(size_t idx, network_returncode ret)
+{
+    po6::threads::mutex::hold hold(&m_mtx);
+    assert(idx < m_results.size());
+    assert(m_outstanding > 0);
+    m_results[idx] = static_cast<uint16_t>(ret);
+    --m_outstanding;
+    return m_outstanding == 0;
+}
+
+std::auto_ptr<e::buffer>
+replication_manager :: multi_atomic :: response()
+{
+    po6::threads::mutex::hold hold(&m_mtx);
+    size_t sz = HYPERDEX_HEADER_SIZE_VC
+              + sizeof(uint64_t)
+              + sizeof(uint64_t)
+              + m_results.size() * sizeof(uint16_t);
+    std::auto_ptr<e::buffer> msg(e::buffer::create(sz));
+    e::packer pa = msg->pack_at(HYPERDEX_HEADER_SIZE_VC);
+    pa = pa << nonce << static_cast<uint64_t>(m_results.size());
+
+    for (size_t i = 0; i < m_results.size(); ++i)
+    {
+        pa = pa << m_results[i];
+    }
+
+    return msg;
+}
@@ -30,6 +30,8 @@
 
 // STL
 #include <list>
+#include <map>
+#include <string>
 
 // po6
 #include <po6/threads/cond.h>
@@ -89,6 +91,12 @@ class replication_manager
                            uint64_t nonce,
                            std::auto_ptr<key_change> kc,
                            std::auto_ptr<e::buffer> backing);
+        // Each op is a packed key_change.  The ops are enqueued individually,
+        // but the client gets one RESP_MULTI_ATOMIC once all have finished.
+        void client_atomic_many(const server_id& from,
+                                const virtual_server_id& to,
+                                uint64_t nonce,
+                                const std::vector<e::slice>& ops);
         // These are called in response to messages from other hosts.
         void chain_op(const virtual_server_id& from,
                       const virtual_server_id& to,
@@ -114,12 +122,33 @@ class replication_manager
                        const virtual_server_id& to,
                        uint64_t version,
                        const e::slice& key);
+        // The newest version of key that is in flight at this replica, or 0
+        // if there is none.  This waits neither for the key's lock nor for
+        // its state machine, so the read path may call it.
+        uint64_t max_pending_version(const region_id& ri, const e::slice& key);
+        // Delete from this replica's disk, in one write, each of "keys" that
+        // expired before "cutoff" and has no operation in flight.  Returns
+        // the number of objects deleted.
+        size_t expire_objects(const region_id& ri,
+                              uint64_t cutoff,
+                              const std::vector<std::string>& keys);
         void begin_checkpoint(uint64_t seq);
         void end_checkpoint(uint64_t seq);
 
     private:
         class retransmitter_thread;
+        class multi_atomic;
         typedef state_hash_table<key_region, key_state> key_map_t;
+        // op "idx" of "ma", which changes "key" in "region"
+        struct multi_atomic_op
+        {
+            multi_atomic_op() : ma(), idx(), region(), key() {}
+            e::intrusive_ptr<multi_atomic> ma;
+            size_t idx;
+            region_id region;
+            std::string key;
+        };
+        typedef std::map<uint64_t, multi_atomic_op> multi_atomic_map_t;
         friend class key_state;
 
     private:
@@ -139,9 +168,24 @@ class replication_manager
                                const server_id& client,
                                uint64_t nonce,
                                network_returncode ret);
+        // record the outcome of an op issued by client_atomic_many; returns
+        // false if "nonce" does not belong to any such op
+        bool complete_multi_atomic(uint64_t nonce, network_returncode ret);
+        // fail the ops issued by client_atomic_many that the reconfiguration
+        // to "config" lost, i.e., those whose region was reset, whose point
+        // leader moved, or whose queued work was dropped ("dropped" holds
+        // their nonces, sorted), and answer the clients whose request is now
+        // complete
+        void fail_multi_atomics(const configuration& config,
+                                const std::vector<region_id>& reset_regions,
+                                const std::vector<uint64_t>& dropped);
         bool send_message(const virtual_server_id& us,
                           const e::slice& key,
                           e::intrusive_ptr<key_operation> op);
+        // parallel subspaces: send op to the head of every fanout region
+        bool send_fanout(const virtual_server_id& us,
+                         const e::slice& key,
+                         e::intrusive_ptr<key_operation> op);
         bool send_ack(const virtual_server_id& us,
                       const e::slice& key,
                       e::intrusive_ptr<key_operation> op);
@@ -172,6 +216,9 @@ class replication_manager
         uint32_t m_need_check;
         std::vector<region_timestamp> m_timestamps;
         std::vector<region_id> m_unstable;
+        po6::threads::mutex m_protect_multi_atomic;
+        uint64_t m_next_multi_atomic;
+        multi_atomic_map_t m_multi_atomic;
 
     private:
         replication_manager(const replication_manager&);
@@ -29,7 +29,9 @@
 
 // STL
 #include <algorithm>
+#include <map>
 #include <sstream>
+#include <string>
 
 // Google Log
 #include <glog/logging.h>
@@ -43,6 +45,7 @@
 // HyperDex
 #include "common/attribute_check.h"
 #include "common/datatype_info.h"
+#include "common/ordered_encoding.h"
 #include "common/serialization.h"
 #include "daemon/daemon.h"
 #include "daemon/datalayer_iterator.h"
@@ -52,6 +55,18 @@ using hyperdex::datatype_info;
 using hyperdex::search_manager;
 using hyperdex::reconfigure_returncode;
 
+// ops per REQ_MULTI_ATOMIC sent by a group operation
+#define GROUP_KEYOP_BATCH 256
+// ops a group operation may have in flight; the scan pauses at this many
+#define GROUP_KEYOP_WINDOW 4096
+// how often a group operation tells the client its progress, in ops
+#define GROUP_KEYOP_REPORT 4096
+// how often a group operation logs its progress, in ops
+#define GROUP_KEYOP_PROGRESS 65536
+// the most results a nearest search reserves room for up front; "limit"
+// comes from the client and the heap grows past this only as objects match
+#define NEAREST_SEARCH_RESERVE 1024
+
 /////////////////////////////// Search Manager ID //////////////////////////////
 
 class search_manager::id
@@ -152,11 +167,93 @@ search_manager :: state :: ~state() throw ()
 {
 }
 
+///////////////////////////// Search Manager Group /////////////////////////////
+
+class search_manager::group
+{
+    public:
+        group(const server_id& client,
+              const virtual_server_id& us,
+              uint64_t nonce,
+              network_msgtype resp,
+              const region_id& region,
+              std::auto_ptr<e::buffer> msg,
+              std::vector<attribute_check>* checks,
+              const e::slice& remain);
+        ~group() throw ();
+
+    public:
+        po6::threads::mutex lock;
+        const server_id client;
+        const virtual_server_id us;
+        const uint64_t nonce;
+        const network_msgtype resp;
+        const region_id region;
+        const std::auto_ptr<e::buffer> backing;
+        std::vector<attribute_check> checks;
+        const e::slice remain;
+        datalayer::snapshot snap;
+        e::intrusive_ptr<datalayer::iterator> iter;
+        // set when the scan has issued an op for every matching key
+        bool exhausted;
+        bool done;
+        uint64_t issued;
+        uint64_t completed;
+        uint64_t reported;
+
+    private:
+        friend class e::intrusive_ptr<group>;
+
+    private:
+        void inc() { __sync_add_and_fetch(&m_ref, 1); }
+        void dec() { if (__sync_sub_and_fetch(&m_ref, 1) == 0) delete this; }
+
+    private:
+        size_t m_ref;
+};
+
+search_manager :: group :: group(const server_id& c,
+                                 const virtual_server_id& u,
+                                 uint64_t n,
+                                 network_msgtype r,
+                                 const region_id& re,
+                                 std::auto_ptr<e::buffer> msg,
+                                 std::vector<attribute_check>* ch,
+                                 const e::slice& rem)
+    : lock()
+    , client(c)
+    , us(u)
+    , nonce(n)
+    , resp(r)
+    , region(re)
+    , backing(msg)
+    , checks()
+    , remain(rem)
+    , snap()
+    , iter()
+    , exhausted(false)
+    , done(false)
+    , issued(0)
+    , completed(0)
+    , reported(0)
+    , m_ref(0)
+{
+    checks.swap(*ch);
+}
+
+search_manager :: group :: ~group() throw ()
+{
+}
+
 //////////////////////////////// Search Manager ////////////////////////////////
 
 search_manager :: search_manager(daemon* d)
     : m_daemon(d)
     , m_searches(10)
+    , m_protect_groups()
+    , m_next_group_nonce(1)
+    , m_group_batches()
+    , m_stalled_groups()
 {
 }
 
@@ -173,6 +270,9 @@ search_manager :: setup()
 void
 search_manager :: teardown()
 {
+    po6::threads::mutex::hold hold(&m_protect_groups);
+    m_group_batches.clear();
+    m_stalled_groups.clear();
 }
 
 void
@@ -183,14 +283,61 @@ search_manager :: pause()
 void
 search_manager :: unpause()
 {
+    std::vector<e::intrusive_ptr<group> > stalled;
+
+    {
+        po6::threads::mutex::hold hold(&m_protect_groups);
+        stalled.swap(m_stalled_groups);
+    }
+
+    // the new configuration is in place, so the scans may issue again
+    for (size_t i = 0; i < stalled.size(); ++i)
+    {
+        po6::threads::mutex::hold hold(&stalled[i]->lock);
+        group_keyop_complete(stalled[i], 0);
+    }
 }
 
 void
 search_manager :: reconfigure(const configuration&,
-                              const configuration&,
+                              const configuration& new_config,
                               const server_id&)
 {
     // XXX cleanup dead or old searches
+
+    // a batch sent to a server that left its virtual server will never be
+    // answered; count its ops as done so the group operation can finish
+    std::vector<group_batch> lost;
+
+    {
+        po6::threads::mutex::hold hold(&m_protect_groups);
+        group_batch_map_t::iterator it = m_group_batches.begin();
+
+        while (it != m_group_batches.end())
+        {
+            if (new_config.get_server_id(it->second.vsi) == it->second.server)
+            {
+                ++it;
+                continue;
+            }
+
+            lost.push_back(it->second);
+            m_group_batches.erase(it++);
+        }
+    }
+
+    for (size_t i = 0; i < lost.size(); ++i)
+    {
+        po6::threads::mutex::hold hold(&lost[i].g->lock);
+        lost[i].g->completed += lost[i].ops;
+    }
+
+    po6::threads::mutex::hold hold(&m_protect_groups);
+
+    for (size_t i = 0; i < lost.size(); ++i)
+    {
+        m_stalled_groups.push_back(lost[i].g);
+    }
 }
 
 void
@@ -501,12 +648,149 @@ search_manager :: sorted_search(const server_id& from,
     m_daemon->m_comm.send_client(to, from, RESP_SORTED_SEARCH, msg);
 }
 
+namespace hyperdex
+{
+
+struct _nearest_search_item
+{
+    _nearest_search_item()
+        : distance(), key(), value(), version(), ref() {}
+    _nearest_search_item(const _nearest_search_item& other);
+    ~_nearest_search_item() throw () {}
+    _nearest_search_item& operator = (const _nearest_search_item& other);
+    double distance;
+    e::slice key;
+    std::vector<e::slice> value;
+    uint64_t version;
+    datalayer::reference ref;
+};
+
+_nearest_search_item :: _nearest_search_item(const _nearest_search_item& other)
+    : distance(other.distance)
+    , key(other.key)
+    , value(other.value)
+    , version(other.version)
+    , ref(other.ref)
+{
+}
+
+_nearest_search_item&
+_nearest_search_item :: operator = (const _nearest_search_item& other)
+{
+    distance = other.distance;
+    key = other.key;
+    value = other.value;
+    version = other.version;
+    ref = other.ref;
+    return *this;
+}
+
+bool
+operator < (const _nearest_search_item& lhs, const _nearest_search_item& rhs)
+{
+    return lhs.distance < rhs.distance;
+}
+
+} // namespace hyperdex
+
+void
+search_manager :: nearest_search(const server_id& from,
+                                 const virtual_server_id& to,
+                                 uint64_t nonce,
+                                 std::vector<attribute_check>* checks,
+                                 uint64_t limit,
+                                 uint16_t attr,
+                                 datatype_vector::metric_t metric,
+                                 const e::slice& vector)
+{
+    region_id ri(m_daemon->m_config.get_region_id(to));
+    const schema* sc = m_daemon->m_config.get_schema(ri);
+
+    if (sc->authorization)
+    {
+        return;
+    }
+
+    std::vector<float> query;
+    std::vector<float> candidate;
+    std::vector<_nearest_search_item> top_n;
+    bool searchable = attr > 0 && attr < sc->attrs_sz &&
+                      sc->attrs[attr].type == HYPERDATATYPE_VECTOR_FLOAT &&
+                      datatype_vector::static_validate(vector) &&
+                      datatype_vector::dimension(vector) > 0;
+
+    if (searchable)
+    {
+        datatype_vector::unpack(vector, &query);
+        std::stable_sort(checks->begin(), checks->end());
+        datalayer::snapshot snap = m_daemon->m_data.make_snapshot();
+        e::intrusive_ptr<datalayer::iterator> iter;
+        iter = m_daemon->m_data.make_search_iterator(snap, ri, *checks, NULL);
+        // a max-heap on distance, so the farthest of the best "limit" is on
+        // top and is the one evicted
+        top_n.reserve(std::min<uint64_t>(limit, NEAREST_SEARCH_RESERVE) + 1);
+
+        while (iter->valid())
+        {
+            _nearest_search_item item;
+            m_daemon->m_data.get_from_iterator(ri, *sc, iter.get(), &item.key, &item.value, &item.version, &item.ref);
+            iter->next();
+            const e::slice& v(item.value[attr - 1]);
+
+            // vectors of another dimension are incomparable with the query
+            if (datatype_vector::dimension(v) != query.size())
+            {
+                continue;
+            }
+
+            datatype_vector::unpack(v, &candidate);
+            item.distance = datatype_vector::distance(metric, &query[0], &candidate[0], query.size());
+
+            if (top_n.size() >= limit &&
+                (top_n.empty() || !(item.distance < top_n.front().distance)))
+            {
+                continue;
+            }
+
+            top_n.push_back(item);
+            std::push_heap(top_n.begin(), top_n.end());
+
+            if (top_n.size() > limit)
+            {
+                std::pop_heap(top_n.begin(), top_n.end());
+                top_n.pop_back();
+            }
+        }
+
+        std::sort(top_n.begin(), top_n.end());
+    }
+
+    size_t sz = HYPERDEX_HEADER_SIZE_VC + sizeof(uint64_t) + sizeof(uint64_t);
+
+    for (size_t i = 0; i < top_n.size(); ++i)
+    {
+        sz += pack_size(top_n[i].key) + pack_size(top_n[i].value) + sizeof(uint64_t);
+    }
+
+    std::auto_ptr<e::buffer> msg(e::buffer::create(sz));
+    e::packer pa = msg->pack_at(HYPERDEX_HEADER_SIZE_VC);
+    pa = pa << nonce << static_cast<uint64_t>(top_n.size());
+
+    for (size_t i = 0; i < top_n.size(); ++i)
+    {
+        pa = pa << top_n[i].key << top_n[i].value
+                << ordered_encode_double(top_n[i].distance);
+    }
+
+    m_daemon->m_comm.send_client(to, from, RESP_NEAREST_SEARCH, msg);
+}
+
 void
 search_manager :: group_keyop(const server_id& from,
                               const virtual_server_id& to,
+                              std::auto_ptr<e::buffer> msg,
                               uint64_t nonce,
                               std::vector<attribute_check>* checks,
-                              network_msgtype mt,
                               const e::slice& remain,
                               network_msgtype resp)
 {
@@ -519,59 +803,183 @@ search_manager :: group_keyop(const server_id& from,
     }
 
     std::stable_sort(checks->begin(), checks->end());
-    datalayer::returncode rc = datalayer::SUCCESS;
-    datalayer::snapshot snap = m_daemon->m_data.make_snapshot();
-    e::intrusive_ptr<datalayer::iterator> iter;
-    iter = m_daemon->m_data.make_search_iterator(snap, ri, *checks, NULL);
-    uint64_t result = 0;
+    e::intrusive_ptr<group> g(new group(from, to, nonce, resp, ri, msg, checks, remain));
+    po6::threads::mutex::hold hold(&g->lock);
+    g->snap = m_daemon->m_data.make_snapshot();
+    g->iter = m_daemon->m_data.make_search_iterator(g->snap, ri, g->checks, NULL);
+    group_keyop_complete(g, 0);
+}
+
+void
+search_manager :: group_keyop_response(const server_id& from, uint64_t nonce)
+{
+    group_batch batch;
 
-    switch (rc)
     {
-        case datalayer::SUCCESS:
-            break;
-        case datalayer::NOT_FOUND:
-        case datalayer::BAD_ENCODING:
-        case datalayer::CORRUPTION:
-        case datalayer::IO_ERROR:
-        case datalayer::LEVELDB_ERROR:
-            LOG(ERROR) << "could not make snapshot for search:  " << rc;
-            result = UINT64_MAX;
-            break;
-        default:
-            abort();
+        po6::threads::mutex::hold hold(&m_protect_groups);
+        group_batch_map_t::iterator it = m_group_batches.find(nonce);
+
+        if (it == m_group_batches.end() || it->second.server != from)
+        {
+            return;
+        }
+
+        batch = it->second;
+        m_group_batches.erase(it);
     }
 
-    while (iter->valid() && result < UINT64_MAX)
+    po6::threads::mutex::hold hold(&batch.g->lock);
+    group_keyop_complete(batch.g, batch.ops);
+}
+
+void
+search_manager :: group_keyop_issue(e::intrusive_ptr<group> g)
+{
+    const schema* sc = m_daemon->m_config.get_schema(g->region);
+    typedef std::map<virtual_server_id, std::vector<std::string> > batch_map_t;
+    batch_map_t batches;
+
+    while (!g->exhausted && g->issued - g->completed < GROUP_KEYOP_WINDOW)
     {
+        if (!sc || !g->iter->valid())
+        {
+            g->exhausted = true;
+            break;
+        }
+
         e::slice key;
         std::vector<e::slice> val;
         uint64_t ver;
         datalayer::reference tmp;
-        m_daemon->m_data.get_from_iterator(ri, *sc, iter.get(), &key, &val, &ver, &tmp);
+        m_daemon->m_data.get_from_iterator(g->region, *sc, g->iter.get(), &key, &val, &ver, &tmp);
+        virtual_server_id vsi = m_daemon->m_config.point_leader(g->region, key);
+        g->iter->next();
+
+        if (vsi == virtual_server_id())
+        {
+            continue;
+        }
+
+        // the op is the body of a REQ_ATOMIC:  the key, then the client's op
+        std::auto_ptr<e::buffer> op(e::buffer::create(pack_size(key) + g->remain.size()));
+        op->pack_at(0) << key << e::pack_memmove(g->remain.data(), g->remain.size());
+        std::vector<std::string>* ops = &batches[vsi];
+        e::slice packed = op->as_slice();
+        ops->push_back(std::string(reinterpret_cast<const char*>(packed.data()), packed.size()));
+        ++g->issued;
+
+        if (g->issued % GROUP_KEYOP_PROGRESS == 0)
+        {
+            LOG(INFO) << "group operation from " << g->client << " on " << g->region
+                      << " has issued " << g->issued << " ops ("
+                      << g->completed << " completed)";
+        }
+
+        if (ops->size() >= GROUP_KEYOP_BATCH)
+        {
+            group_keyop_flush(g, vsi, ops);
+        }
+    }
+
+    for (batch_map_t::iterator it = batches.begin(); it != batches.end(); ++it)
+    {
+        group_keyop_flush(g, it->first, &it->second);
+    }
+}
+
+void
+search_manager :: group_keyop_flush(e::intrusive_ptr<group> g,
+                                    const virtual_server_id& vsi,
+                                    std::vector<std::string>* ops)
+{
+    if (ops->empty())
+    {
+        return;
+    }
+
+    std::vector<e::slice> slices;
+    slices.reserve(ops->size());
+
+    for (size_t i = 0; i < ops->size(); ++i)
+    {
+        slices.push_back(e::slice((*ops)[i].data(), (*ops)[i].size()));
+    }
+
+    uint64_t nonce;
+    group_batch batch;
+    batch.g = g;
+    batch.vsi = vsi;
+    batch.server = m_daemon->m_config.get_server_id(vsi);
+    batch.ops = ops->size();
+
+    {
+        po6::threads::mutex::hold hold(&m_protect_groups);
+        nonce = m_next_group_nonce++;
+        m_group_batches[nonce] = batch;
+    }
+
+    bool sent = true;
+
+    if (batch.server == m_daemon->m_us)
+    {
+        // answered with a RESP_MULTI_ATOMIC delivered to ourselves
+        m_daemon->m_repl.client_atomic_many(m_daemon->m_us, vsi, nonce, slices);
+    }
+    else
+    {
         size_t sz = HYPERDEX_HEADER_SIZE_SV // SV because we imitate a client
                   + sizeof(uint64_t)
-                  + pack_size(key)
-                  + remain.size();
+                  + pack_size(slices);
         std::auto_ptr<e::buffer> msg(e::buffer::create(sz));
-        msg->pack_at(HYPERDEX_HEADER_SIZE_SV)
-            << uint64_t(0) << key << e::pack_memmove(remain.data(), remain.size());
-        virtual_server_id vsi = m_daemon->m_config.point_leader(ri, key);
+        msg->pack_at(HYPERDEX_HEADER_SIZE_SV) << nonce << slices;
+        sent = m_daemon->m_comm.send(vsi, REQ_MULTI_ATOMIC, msg);
+    }
 
-        if (vsi != virtual_server_id())
+    ops->clear();
+
+    if (!sent)
+    {
+        po6::threads::mutex::hold hold(&m_protect_groups);
+
+        if (m_group_batches.erase(nonce) > 0)
         {
-            m_daemon->m_comm.send(vsi, mt, msg);
-            result++;
+            g->completed += batch.ops;
         }
+    }
+}
 
-        iter->next();
+void
+search_manager :: group_keyop_complete(e::intrusive_ptr<group> g, uint64_t ops)
+{
+    g->completed += ops;
+
+    if (g->done)
+    {
+        return;
     }
 
-    size_t sz = HYPERDEX_HEADER_SIZE_VC
-              + sizeof(uint64_t)
-              + sizeof(uint64_t);
-    std::auto_ptr<e::buffer> msg(e::buffer::create(sz));
-    msg->pack_at(HYPERDEX_HEADER_SIZE_VC) << nonce << result;
-    m_daemon->m_comm.send_client(to, from, resp, msg);
+    group_keyop_issue(g);
+
+    if (g->exhausted && g->issued == g->completed)
+    {
+        size_t sz = HYPERDEX_HEADER_SIZE_VC
+                  + sizeof(uint64_t)
+                  + sizeof(uint64_t);
+        std::auto_ptr<e::buffer> msg(e::buffer::create(sz));
+        msg->pack_at(HYPERDEX_HEADER_SIZE_VC) << g->nonce << g->issued;
+        m_daemon->m_comm.send_client(g->us, g->client, g->resp, msg);
+        g->done = true;
+    }
+    else if (g->completed - g->reported >= GROUP_KEYOP_REPORT)
+    {
+        size_t sz = HYPERDEX_HEADER_SIZE_VC
+                  + sizeof(uint64_t)
+                  + sizeof(uint64_t);
+        std::auto_ptr<e::buffer> msg(e::buffer::create(sz));
+        msg->pack_at(HYPERDEX_HEADER_SIZE_VC) << g->nonce << g->completed;
+        m_daemon->m_comm.send_client(g->us, g->client, RESP_GROUP_ATOMIC_PROGRESS, msg);
+        g->reported = g->completed;
+    }
 }
 
 void
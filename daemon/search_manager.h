@@ -28,12 +28,22 @@
 #ifndef hyperdex_daemon_search_manager_h_
 #define hyperdex_daemon_search_manager_h_
 
+// STL
+#include <map>
+#include <memory>
+#include <vector>
+
+// po6
+#include <po6/threads/mutex.h>
+
 // e
+#include <e/buffer.h>
 #include <e/intrusive_ptr.h>
 #include <e/lockfree_hash_map.h>
 
 // HyperDex
 #include "namespace.h"
+#include "common/datatype_vector.h"
 #include "common/ids.h"
 #include "common/network_msgtype.h"
 #include "daemon/datalayer.h"
@@ -78,17 +88,36 @@ class search_manager
                            uint64_t limit,
                            uint16_t sort_by,
                            bool maximize);
+        // the "limit" objects matching checks whose vector attribute "attr"
+        // is closest to "vector", nearest first
+        void nearest_search(const server_id& from,
+                            const virtual_server_id& to,
+                            uint64_t nonce,
+                            std::vector<attribute_check>* checks,
+                            uint64_t limit,
+                            uint16_t attr,
+                            datatype_vector::metric_t metric,
+                            const e::slice& vector);
 
         // Find keys that match the check and forward ops to the corresponding servers
         // Essentially this splits out the group operation in several seperate operations
-        // (by acting like it was a client)
+        // (by acting like it was a client).  Ops go out in batches of
+        // REQ_MULTI_ATOMIC, one batch per point leader at a time; batches
+        // for keys this daemon leads go straight to the replication manager.
+        // At most a window of ops is in flight, and the scan resumes as
+        // their responses arrive, so memory stays bounded however many keys
+        // match.  The client hears of the ops completed so far along the
+        // way, and of the total when the last op completes.
         void group_keyop(const server_id& from,
                          const virtual_server_id& to,
+                         std::auto_ptr<e::buffer> msg,
                          uint64_t nonce,
                          std::vector<attribute_check>* checks,
-                         network_msgtype mt,
                          const e::slice& remain,
                          network_msgtype resp);
+        // a RESP_MULTI_ATOMIC from "from" answering a batch issued by
+        // group_keyop
+        void group_keyop_response(const server_id& from, uint64_t nonce);
 
         // Calculate the amount of entries that match the checks
         void count(const server_id& from,
@@ -104,6 +133,17 @@ class search_manager
     private:
         class id;
         class state;
+        class group;
+        // a REQ_MULTI_ATOMIC of "ops" ops sent to "vsi" on "server"
+        struct group_batch
+        {
+            group_batch() : g(), vsi(), server(), ops() {}
+            e::intrusive_ptr<group> g;
+            virtual_server_id vsi;
+            server_id server;
+            uint64_t ops;
+        };
+        typedef std::map<uint64_t, group_batch> group_batch_map_t;
 
     private:
         search_manager(const search_manager&);
@@ -111,10 +151,21 @@ class search_manager
 
     private:
         static uint64_t hash(const id&);
+        // issue, flush and complete expect the caller to hold g->lock
+        void group_keyop_issue(e::intrusive_ptr<group> g);
+        void group_keyop_flush(e::intrusive_ptr<group> g,
+                               const virtual_server_id& vsi,
+                               std::vector<std::string>* ops);
+        void group_keyop_complete(e::intrusive_ptr<group> g, uint64_t ops);
 
     private:
         daemon* m_daemon;
         e::lockfree_hash_map<id, e::intrusive_ptr<state>, hash> m_searches;
+        po6::threads::mutex m_protect_groups;
+        uint64_t m_next_group_nonce;
+        group_batch_map_t m_group_batches;
+        // groups whose batches a reconfiguration lost; resumed on unpause
+        std::vector<e::intrusive_ptr<group> > m_stalled_groups;
 };
 
 END_HYPERDEX_NAMESPACE
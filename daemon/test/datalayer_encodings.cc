@@ -0,0 +1,303 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <stdint.h>
+#include <string.h>
+
+// STL
+#include <string>
+#include <vector>
+
+// e
+#include <e/endian.h>
+#include <e/slice.h>
+#include <e/varint.h>
+
+// HyperDex
+#include "test/th.h"
+#include "daemon/datalayer_encodings.h"
+
+using hyperdex::datalayer;
+using hyperdex::decode_index_entry_key_size;
+using hyperdex::decode_value;
+using hyperdex::decode_value_attr;
+using hyperdex::decode_value_attrs;
+using hyperdex::encode_index_entry_key_size;
+using hyperdex::encode_value;
+using hyperdex::index_entry_key_size_sz;
+using hyperdex::value_decoder;
+
+namespace
+{
+
+// "prefix" stands in for the rest of the index entry; its bytes have the high
+// bit set so that a decoder which read past the trailer would misparse them
+void
+round_trip_key_size(size_t key_sz, size_t expected_sz)
+{
+    std::string prefix(5, '\xff');
+    char buf[32];
+    memmove(buf, prefix.data(), prefix.size());
+    char* end = encode_index_entry_key_size(key_sz, buf + prefix.size());
+    ASSERT_EQ(expected_sz, index_entry_key_size_sz(key_sz));
+    ASSERT_EQ(expected_sz, static_cast<size_t>(end - buf) - prefix.size());
+
+    size_t decoded_sz = 0;
+    size_t decoded_size_sz = 0;
+    ASSERT_TRUE(decode_index_entry_key_size(e::slice(buf, end - buf),
+                                            &decoded_sz, &decoded_size_sz));
+    ASSERT_EQ(key_sz, decoded_sz);
+    ASSERT_EQ(expected_sz, decoded_size_sz);
+}
+
+std::vector<e::slice>
+three_attrs()
+{
+    std::vector<e::slice> attrs;
+    attrs.push_back(e::slice("a", 1));
+    attrs.push_back(e::slice("", 0));
+    attrs.push_back(e::slice("hello", 5));
+    return attrs;
+}
+
+// the format written before the offset table:
+// version (8B) | num_attrs (2B) | [size (4B) | bytes]*
+std::string
+encode_value_v1(const std::vector<e::slice>& attrs, uint64_t version)
+{
+    std::string out(sizeof(uint64_t) + sizeof(uint16_t), '\0');
+    char* ptr = &out[0];
+    ptr = e::pack64be(version, ptr);
+    ptr = e::pack16be(attrs.size(), ptr);
+
+    for (size_t i = 0; i < attrs.size(); ++i)
+    {
+        char sz[sizeof(uint32_t)];
+        e::pack32be(attrs[i].size(), sz);
+        out.append(sz, sizeof(uint32_t));
+        out.append(reinterpret_cast<const char*>(attrs[i].data()), attrs[i].size());
+    }
+
+    return out;
+}
+
+bool
+same_attr(const e::slice& lhs, const e::slice& rhs)
+{
+    return lhs.size() == rhs.size() &&
+           memcmp(lhs.data(), rhs.data(), lhs.size()) == 0;
+}
+
+} // namespace
+
+// each seven bits of the key size take one more byte
+TEST(DatalayerEncodings, KeySizeBoundaries)
+{
+    round_trip_key_size(0, 1);
+    round_trip_key_size(1, 1);
+    round_trip_key_size(127, 1);
+    round_trip_key_size(128, 2);
+    round_trip_key_size(16383, 2);
+    round_trip_key_size(16384, 3);
+    round_trip_key_size((1ULL << 21) - 1, 3);
+    round_trip_key_size(1ULL << 21, 4);
+    round_trip_key_size((1ULL << 28) - 1, 4);
+    round_trip_key_size(1ULL << 28, 5);
+    round_trip_key_size(0xffffffffULL, 5);
+}
+
+// the trailer is the varint written back-to-front: the byte that ends the
+// varint comes first and the entry's last byte holds the lowest seven bits
+TEST(DatalayerEncodings, KeySizeIsReversedVarint)
+{
+    char varint[VARINT_64_MAX_SIZE];
+    char trailer[VARINT_64_MAX_SIZE];
+    char* vend = e::packvarint64(300, varint);
+    char* tend = encode_index_entry_key_size(300, trailer);
+    ASSERT_EQ(2, vend - varint);
+    ASSERT_EQ(2, tend - trailer);
+    ASSERT_EQ(varint[0], trailer[1]);
+    ASSERT_EQ(varint[1], trailer[0]);
+    ASSERT_EQ(0, trailer[0] & 0x80);
+    ASSERT_NE(0, trailer[1] & 0x80);
+}
+
+TEST(DatalayerEncodings, KeySizeMalformed)
+{
+    size_t key_sz = 0;
+    size_t key_size_sz = 0;
+    ASSERT_FALSE(decode_index_entry_key_size(e::slice("", 0), &key_sz, &key_size_sz));
+    // every byte continues the varint, so it never ends
+    const char unterminated[] = "\x80\x81\x82";
+    ASSERT_FALSE(decode_index_entry_key_size(e::slice(unterminated, 3), &key_sz, &key_size_sz));
+    // a single byte without the continuation bit is a complete trailer
+    const char one[] = "abc\x05";
+    ASSERT_TRUE(decode_index_entry_key_size(e::slice(one, 4), &key_sz, &key_size_sz));
+    ASSERT_EQ(5U, key_sz);
+    ASSERT_EQ(1U, key_size_sz);
+}
+
+TEST(DatalayerEncodings, ValueRoundTrip)
+{
+    std::vector<e::slice> attrs(three_attrs());
+    std::vector<char> backing;
+    leveldb::Slice out;
+    encode_value(attrs, 42, &backing, &out);
+    e::slice v(out.data(), out.size());
+    ASSERT_EQ(0xff, v.data()[0]);
+
+    std::vector<e::slice> decoded;
+    uint64_t version = 0;
+    ASSERT_EQ(datalayer::SUCCESS, decode_value(v, &decoded, &version));
+    ASSERT_EQ(42U, version);
+    ASSERT_EQ(attrs.size(), decoded.size());
+
+    for (size_t i = 0; i < attrs.size(); ++i)
+    {
+        ASSERT_TRUE(same_attr(attrs[i], decoded[i]));
+        e::slice attr;
+        ASSERT_EQ(datalayer::SUCCESS, decode_value_attr(v, i, &attr));
+        ASSERT_TRUE(same_attr(attrs[i], attr));
+    }
+
+    // only the requested attribute (numbered from the key) is filled in
+    std::vector<uint16_t> which(1, 3);
+    ASSERT_EQ(datalayer::SUCCESS, decode_value_attrs(v, which, &decoded, &version));
+    ASSERT_EQ(3U, decoded.size());
+    ASSERT_EQ(0U, decoded[0].size());
+    ASSERT_TRUE(same_attr(attrs[2], decoded[2]));
+
+    e::slice attr;
+    ASSERT_EQ(datalayer::BAD_ENCODING, decode_value_attr(v, 3, &attr));
+}
+
+TEST(DatalayerEncodings, ValueRoundTripEmpty)
+{
+    std::vector<e::slice> attrs;
+    std::vector<char> backing;
+    leveldb::Slice out;
+    encode_value(attrs, 7, &backing, &out);
+    std::vector<e::slice> decoded(1);
+    uint64_t version = 0;
+    ASSERT_EQ(datalayer::SUCCESS, decode_value(e::slice(out.data(), out.size()), &decoded, &version));
+    ASSERT_EQ(7U, version);
+    ASSERT_EQ(0U, decoded.size());
+}
+
+// values written before the offset table stay readable through every path
+TEST(DatalayerEncodings, ValueV1Compatible)
+{
+    std::vector<e::slice> attrs(three_attrs());
+    // the largest version a v1 value may carry keeps its first byte below 0xff
+    const uint64_t version = (1ULL << 56) - 1;
+    std::string v1(encode_value_v1(attrs, version));
+    e::slice v(v1.data(), v1.size());
+
+    std::vector<e::slice> decoded;
+    uint64_t decoded_version = 0;
+    ASSERT_EQ(datalayer::SUCCESS, decode_value(v, &decoded, &decoded_version));
+    ASSERT_EQ(version, decoded_version);
+    ASSERT_EQ(attrs.size(), decoded.size());
+
+    for (size_t i = 0; i < attrs.size(); ++i)
+    {
+        ASSERT_TRUE(same_attr(attrs[i], decoded[i]));
+        e::slice attr;
+        ASSERT_EQ(datalayer::SUCCESS, decode_value_attr(v, i, &attr));
+        ASSERT_TRUE(same_attr(attrs[i], attr));
+    }
+
+    // v1 values are decoded in full
+    std::vector<uint16_t> which(1, 1);
+    ASSERT_EQ(datalayer::SUCCESS, decode_value_attrs(v, which, &decoded, &decoded_version));
+    ASSERT_EQ(attrs.size(), decoded.size());
+    ASSERT_TRUE(same_attr(attrs[2], decoded[2]));
+
+    // rewriting a v1 value produces the same attributes in v2
+    std::vector<char> backing;
+    leveldb::Slice out;
+    encode_value(decoded, decoded_version, &backing, &out);
+    std::vector<e::slice> rewritten;
+    ASSERT_EQ(datalayer::SUCCESS, decode_value(e::slice(out.data(), out.size()), &rewritten, &decoded_version));
+    ASSERT_EQ(version, decoded_version);
+    ASSERT_EQ(attrs.size(), rewritten.size());
+
+    for (size_t i = 0; i < attrs.size(); ++i)
+    {
+        ASSERT_TRUE(same_attr(attrs[i], rewritten[i]));
+    }
+}
+
+// one decoder answers every attribute of a value, in any order
+TEST(DatalayerEncodings, ValueDecoder)
+{
+    std::vector<e::slice> attrs(three_attrs());
+    std::string v1(encode_value_v1(attrs, 9));
+    std::vector<char> backing;
+    leveldb::Slice out;
+    encode_value(attrs, 9, &backing, &out);
+    e::slice values[2] = { e::slice(v1.data(), v1.size()),
+                           e::slice(out.data(), out.size()) };
+
+    for (size_t v = 0; v < 2; ++v)
+    {
+        value_decoder vd;
+        ASSERT_EQ(datalayer::SUCCESS, vd.parse(values[v]));
+        ASSERT_EQ(9U, vd.version());
+
+        for (size_t i = attrs.size(); i > 0; --i)
+        {
+            e::slice attr;
+            ASSERT_EQ(datalayer::SUCCESS, vd.attr(i - 1, &attr));
+            ASSERT_TRUE(same_attr(attrs[i - 1], attr));
+        }
+
+        e::slice attr;
+        ASSERT_EQ(datalayer::SUCCESS, vd.attr(2, &attr));
+        ASSERT_TRUE(same_attr(attrs[2], attr));
+        ASSERT_EQ(datalayer::BAD_ENCODING, vd.attr(3, &attr));
+    }
+}
+
+TEST(DatalayerEncodings, ValueTruncated)
+{
+    std::vector<e::slice> attrs(three_attrs());
+    std::vector<char> backing;
+    leveldb::Slice out;
+    encode_value(attrs, 42, &backing, &out);
+    std::string v1(encode_value_v1(attrs, 42));
+    std::vector<e::slice> decoded;
+    uint64_t version;
+
+    ASSERT_EQ(datalayer::BAD_ENCODING, decode_value(e::slice("", 0), &decoded, &version));
+    ASSERT_EQ(datalayer::BAD_ENCODING, decode_value(e::slice(out.data(), out.size() - 1), &decoded, &version));
+    ASSERT_EQ(datalayer::BAD_ENCODING, decode_value(e::slice(v1.data(), v1.size() - 1), &decoded, &version));
+    e::slice attr;
+    ASSERT_EQ(datalayer::BAD_ENCODING, decode_value_attr(e::slice(v1.data(), v1.size() - 1), 0, &attr));
+}
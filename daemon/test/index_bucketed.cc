@@ -0,0 +1,133 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// C
+#include <stdint.h>
+
+// STL
+#include <string>
+#include <vector>
+
+// e
+#include <e/endian.h>
+
+// LevelDB
+#include <hyperleveldb/write_batch.h>
+
+// HyperDex
+#include "test/th.h"
+#include "common/index.h"
+#include "daemon/index_bucketed.h"
+
+using hyperdex::index_bucketed;
+using hyperdex::index_encoding;
+using hyperdex::index_id;
+using hyperdex::region_id;
+
+namespace
+{
+
+const int64_t HOUR = 3600LL * 1000000LL;
+
+// the index entries a WriteBatch puts
+class puts : public leveldb::WriteBatch::Handler
+{
+    public:
+        puts() : keys() {}
+        virtual ~puts() throw () {}
+
+    public:
+        virtual void Put(const leveldb::Slice& key, const leveldb::Slice&)
+        { keys.push_back(key.ToString()); }
+        virtual void Delete(const leveldb::Slice&) {}
+
+    public:
+        std::vector<std::string> keys;
+};
+
+// the entry that indexes "key" under timestamp "ts"
+std::string
+entry(const index_bucketed& ib, const hyperdex::index& idx,
+      const std::string& key, int64_t ts)
+{
+    const index_encoding* key_ie = index_encoding::lookup(HYPERDATATYPE_STRING);
+    char value[sizeof(int64_t)];
+    e::pack64le(ts, value);
+    e::slice v(value, sizeof(int64_t));
+    leveldb::WriteBatch updates;
+    ib.index_changes(&idx, region_id(1), key_ie, e::slice(key), NULL, &v, &updates);
+    puts p;
+    updates.Iterate(&p);
+    ASSERT_EQ(1U, p.keys.size());
+    return p.keys.empty() ? std::string() : p.keys[0];
+}
+
+bool
+within(const std::string& e, const std::string& lower, const std::string& upper)
+{
+    return lower <= e && e < upper;
+}
+
+} // namespace
+
+// The bounds of a run of buckets contain exactly the entries in those
+// buckets, whatever the key, so compacting between them touches no other
+// bucket
+TEST(IndexBucketed, BucketBounds)
+{
+    index_bucketed ib(HYPERDATATYPE_TIMESTAMP_HOUR);
+    hyperdex::index idx(hyperdex::index::BUCKETED, index_id(7), 1, e::slice());
+    std::string lower;
+    std::string upper;
+    ib.bucket_bounds(region_id(1), idx.id, 5, 7, &lower, &upper);
+
+    const char* keys[] = {"", "a", "zzzzzzzz", "\xff\xff"};
+
+    for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); ++i)
+    {
+        ASSERT_FALSE(within(entry(ib, idx, keys[i], 5 * HOUR - 1), lower, upper));
+        ASSERT_TRUE(within(entry(ib, idx, keys[i], 5 * HOUR), lower, upper));
+        ASSERT_TRUE(within(entry(ib, idx, keys[i], 6 * HOUR + HOUR / 2), lower, upper));
+        ASSERT_TRUE(within(entry(ib, idx, keys[i], 7 * HOUR - 1), lower, upper));
+        ASSERT_FALSE(within(entry(ib, idx, keys[i], 7 * HOUR), lower, upper));
+    }
+}
+
+// Entries of other indices and regions never fall within the bounds
+TEST(IndexBucketed, BucketBoundsStayInIndex)
+{
+    index_bucketed ib(HYPERDATATYPE_TIMESTAMP_HOUR);
+    hyperdex::index idx(hyperdex::index::BUCKETED, index_id(7), 1, e::slice());
+    hyperdex::index other(hyperdex::index::BUCKETED, index_id(8), 1, e::slice());
+    std::string lower;
+    std::string upper;
+    ib.bucket_bounds(region_id(1), idx.id, 1, 1000, &lower, &upper);
+    ASSERT_TRUE(within(entry(ib, idx, "k", 10 * HOUR), lower, upper));
+    ASSERT_FALSE(within(entry(ib, other, "k", 10 * HOUR), lower, upper));
+    ib.bucket_bounds(region_id(2), idx.id, 1, 1000, &lower, &upper);
+    ASSERT_FALSE(within(entry(ib, idx, "k", 10 * HOUR), lower, upper));
+}
@@ -0,0 +1,289 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#define __STDC_LIMIT_MACROS
+
+// C
+#include <cstring>
+#include <stdint.h>
+
+// STL
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// e
+#include <e/endian.h>
+
+// HyperDex
+#include "test/th.h"
+#include "common/attribute.h"
+#include "common/index.h"
+#include "common/range.h"
+#include "common/schema.h"
+#include "daemon/index_composite.h"
+
+using hyperdex::attribute;
+using hyperdex::composite_bounds;
+using hyperdex::composite_encode_component;
+using hyperdex::index_id;
+using hyperdex::range;
+using hyperdex::schema;
+
+namespace
+{
+
+std::string
+encode_string(const std::string& s)
+{
+    std::vector<char> out;
+    composite_encode_component(HYPERDATATYPE_STRING, e::slice(s.data(), s.size()), &out);
+    return std::string(out.begin(), out.end());
+}
+
+std::string
+pack_int(int64_t x)
+{
+    char buf[sizeof(int64_t)];
+    e::pack64le(static_cast<uint64_t>(x), buf);
+    return std::string(buf, sizeof(buf));
+}
+
+std::string
+encode_int(int64_t x)
+{
+    std::string packed(pack_int(x));
+    std::vector<char> out;
+    composite_encode_component(HYPERDATATYPE_INT64, e::slice(packed.data(), packed.size()), &out);
+    return std::string(out.begin(), out.end());
+}
+
+int
+compare(const std::string& lhs, const std::string& rhs)
+{
+    int cmp = memcmp(lhs.data(), rhs.data(), std::min(lhs.size(), rhs.size()));
+
+    if (cmp != 0)
+    {
+        return cmp;
+    }
+
+    return lhs.size() < rhs.size() ? -1 : (lhs.size() > rhs.size() ? 1 : 0);
+}
+
+// would the iterator built from these bounds visit "entry"?
+bool
+admits(const std::vector<char>& lower,
+       const std::vector<char>& upper,
+       const std::string& entry)
+{
+    std::string lo(lower.begin(), lower.end());
+    std::string up(upper.begin(), upper.end());
+    return compare(entry, lo) >= 0 &&
+           (up.empty() || compare(entry.substr(0, up.size()), up) <= 0);
+}
+
+// a space with a string key and a COMPOSITE index over (s, n)
+class composite_fixture
+{
+    public:
+        composite_fixture();
+
+    public:
+        attribute attrs[3];
+        schema sc;
+        std::string extra;
+        hyperdex::index idx;
+};
+
+composite_fixture :: composite_fixture()
+    : sc()
+    , extra()
+    , idx()
+{
+    attrs[0] = attribute("k", HYPERDATATYPE_STRING);
+    attrs[1] = attribute("s", HYPERDATATYPE_STRING);
+    attrs[2] = attribute("n", HYPERDATATYPE_INT64);
+    sc.attrs = attrs;
+    sc.attrs_sz = 3;
+    std::vector<uint16_t> covered;
+    covered.push_back(1);
+    covered.push_back(2);
+    hyperdex::pack_composite_attrs(covered, &extra);
+    idx = hyperdex::index(hyperdex::index::COMPOSITE, index_id(1), 1,
+                          e::slice(extra.data(), extra.size()));
+}
+
+range
+make_range(uint16_t attr, hyperdatatype type,
+           const std::string* start, const std::string* end)
+{
+    range r;
+    r.attr = attr;
+    r.type = type;
+    r.has_start = start != NULL;
+    r.has_end = end != NULL;
+    r.start = start ? e::slice(start->data(), start->size()) : e::slice();
+    r.end = end ? e::slice(end->data(), end->size()) : e::slice();
+    r.invalid = false;
+    return r;
+}
+
+} // namespace
+
+TEST(IndexComposite, StringEscapesNul)
+{
+    ASSERT_TRUE(encode_string("") == std::string("\x00\x01", 2));
+    ASSERT_TRUE(encode_string("ab") == std::string("ab\x00\x01", 4));
+    ASSERT_TRUE(encode_string(std::string("a\x00" "b", 3)) ==
+                std::string("a\x00\xff" "b\x00\x01", 6));
+    ASSERT_TRUE(encode_string(std::string("\x00", 1)) ==
+                std::string("\x00\xff\x00\x01", 4));
+}
+
+TEST(IndexComposite, StringOrderAndPrefix)
+{
+    // in ascending order of their raw bytes
+    std::vector<std::string> strs;
+    strs.push_back("");
+    strs.push_back(std::string("\x00", 1));
+    strs.push_back(std::string("\x00\x00", 2));
+    strs.push_back(std::string("\x00\x01", 2));
+    strs.push_back("a");
+    strs.push_back(std::string("a\x00", 2));
+    strs.push_back(std::string("a\x00" "b", 3));
+    strs.push_back("a\x01");
+    strs.push_back("ab");
+    strs.push_back("abc");
+    strs.push_back("b");
+    strs.push_back("\xff");
+
+    for (size_t i = 0; i < strs.size(); ++i)
+    {
+        for (size_t j = i + 1; j < strs.size(); ++j)
+        {
+            ASSERT_LT(compare(strs[i], strs[j]), 0);
+            // a string sorts before the strings it prefixes, whatever
+            // attributes follow either of them in the entry
+            std::string lhs = encode_string(strs[i]) + encode_int(INT64_MAX);
+            std::string rhs = encode_string(strs[j]) + encode_int(INT64_MIN);
+            ASSERT_LT(compare(lhs, rhs), 0);
+        }
+    }
+}
+
+TEST(IndexComposite, IntOrder)
+{
+    int64_t ints[] = {INT64_MIN, -1000, -1, 0, 1, 255, 256, 1000, INT64_MAX};
+    size_t ints_sz = sizeof(ints) / sizeof(int64_t);
+
+    for (size_t i = 0; i + 1 < ints_sz; ++i)
+    {
+        ASSERT_LT(compare(encode_int(ints[i]), encode_int(ints[i + 1])), 0);
+        ASSERT_EQ(encode_int(ints[i]).size(), sizeof(int64_t));
+    }
+}
+
+TEST(IndexComposite, EqualityThenRange)
+{
+    composite_fixture f;
+    std::string x("x");
+    std::string three(pack_int(3));
+    std::string seven(pack_int(7));
+    std::vector<range> ranges;
+    ranges.push_back(make_range(1, HYPERDATATYPE_STRING, &x, &x));
+    ranges.push_back(make_range(2, HYPERDATATYPE_INT64, &three, &seven));
+    std::vector<char> lower;
+    std::vector<char> upper;
+    ASSERT_EQ(composite_bounds(f.sc, &f.idx, ranges, &lower, &upper), 2U);
+
+    const char* strs[] = {"w", "x", "x\x01", "xy", "y"};
+    size_t strs_sz = sizeof(strs) / sizeof(const char*);
+
+    for (size_t i = 0; i < strs_sz; ++i)
+    {
+        for (int64_t n = -2; n <= 10; ++n)
+        {
+            std::string entry = encode_string(strs[i]) + encode_int(n);
+            bool expected = strcmp(strs[i], "x") == 0 && n >= 3 && n <= 7;
+            ASSERT_EQ(admits(lower, upper, entry), expected);
+        }
+    }
+
+    // an embedded NUL must not make "x\0" look like "x"
+    std::string nul = encode_string(std::string("x\x00", 2)) + encode_int(5);
+    ASSERT_FALSE(admits(lower, upper, nul));
+}
+
+TEST(IndexComposite, EqualityOnly)
+{
+    composite_fixture f;
+    std::string x("x");
+    std::vector<range> ranges;
+    ranges.push_back(make_range(1, HYPERDATATYPE_STRING, &x, &x));
+    std::vector<char> lower;
+    std::vector<char> upper;
+    ASSERT_EQ(composite_bounds(f.sc, &f.idx, ranges, &lower, &upper), 1U);
+    ASSERT_TRUE(admits(lower, upper, encode_string("x") + encode_int(INT64_MIN)));
+    ASSERT_TRUE(admits(lower, upper, encode_string("x") + encode_int(INT64_MAX)));
+    ASSERT_FALSE(admits(lower, upper, encode_string("xa") + encode_int(0)));
+    ASSERT_FALSE(admits(lower, upper, encode_string("") + encode_int(0)));
+}
+
+TEST(IndexComposite, RangeEndsPrefix)
+{
+    composite_fixture f;
+    std::string a("a");
+    std::string c("c");
+    std::string three(pack_int(3));
+    std::vector<range> ranges;
+    // a range on the first attribute means the second cannot narrow the scan
+    ranges.push_back(make_range(1, HYPERDATATYPE_STRING, &a, &c));
+    ranges.push_back(make_range(2, HYPERDATATYPE_INT64, &three, &three));
+    std::vector<char> lower;
+    std::vector<char> upper;
+    ASSERT_EQ(composite_bounds(f.sc, &f.idx, ranges, &lower, &upper), 1U);
+    ASSERT_TRUE(admits(lower, upper, encode_string("a") + encode_int(-5)));
+    ASSERT_TRUE(admits(lower, upper, encode_string("bzz") + encode_int(100)));
+    ASSERT_TRUE(admits(lower, upper, encode_string("c") + encode_int(INT64_MAX)));
+    ASSERT_FALSE(admits(lower, upper, encode_string("ca") + encode_int(0)));
+    ASSERT_FALSE(admits(lower, upper, encode_string("") + encode_int(3)));
+}
+
+TEST(IndexComposite, Unconstrained)
+{
+    composite_fixture f;
+    std::string three(pack_int(3));
+    std::vector<range> ranges;
+    // the planner skips a composite index whose first attribute is free
+    ranges.push_back(make_range(2, HYPERDATATYPE_INT64, &three, &three));
+    std::vector<char> lower;
+    std::vector<char> upper;
+    ASSERT_EQ(composite_bounds(f.sc, &f.idx, ranges, &lower, &upper), 0U);
+    ranges.clear();
+    ASSERT_EQ(composite_bounds(f.sc, &f.idx, ranges, &lower, &upper), 0U);
+}
@@ -0,0 +1,341 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <cstring>
+
+// STL
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// e
+#include <e/arena.h>
+
+// LevelDB
+#include <hyperleveldb/write_batch.h>
+
+// HyperDex
+#include "test/th.h"
+#include "common/attribute_check.h"
+#include "common/datatype_document.h"
+#include "common/index.h"
+#include "daemon/index_document.h"
+
+using hyperdex::attribute_check;
+using hyperdex::datatype_document;
+using hyperdex::document_index_covers;
+using hyperdex::index_document;
+using hyperdex::index_encoding;
+using hyperdex::index_id;
+using hyperdex::region_id;
+
+namespace
+{
+
+// records a batch as sorted "put:<key>" and "del:<key>" strings
+class batch_recorder : public leveldb::WriteBatch::Handler
+{
+    public:
+        batch_recorder() : ops() {}
+        virtual ~batch_recorder() throw () {}
+
+    public:
+        virtual void Put(const leveldb::Slice& key, const leveldb::Slice&)
+        { ops.push_back("put:" + key.ToString()); }
+        virtual void Delete(const leveldb::Slice& key)
+        { ops.push_back("del:" + key.ToString()); }
+
+    public:
+        std::vector<std::string> ops;
+};
+
+std::vector<std::string>
+recorded(const leveldb::WriteBatch& updates)
+{
+    batch_recorder br;
+    ASSERT_TRUE(updates.Iterate(&br).ok());
+    std::sort(br.ops.begin(), br.ops.end());
+    return br.ops;
+}
+
+e::slice
+to_server(const char* json, e::arena* memory)
+{
+    datatype_document dd;
+    e::slice server;
+    ASSERT_TRUE(dd.client_to_server(e::slice(json, strlen(json)), memory, &server));
+    return server;
+}
+
+// document indices on attribute 1 over "paths", numbered from 1
+void
+make_indices(const std::vector<const char*>& paths,
+             std::vector<hyperdex::index>* idxs)
+{
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+        e::slice extra(paths[i], strlen(paths[i]) + 1);
+        idxs->push_back(hyperdex::index(hyperdex::index::DOCUMENT, index_id(i + 1), 1, extra));
+    }
+}
+
+// the updates from indexing every path at once must match indexing each
+// path on its own
+void
+assert_batched_matches_single(const std::vector<hyperdex::index>& idxs,
+                              const e::slice* old_document,
+                              const e::slice* new_document)
+{
+    index_document id;
+    region_id ri(1);
+    const index_encoding* key_ie = index_encoding::lookup(HYPERDATATYPE_STRING);
+    e::slice key("key", 3);
+    leveldb::WriteBatch single;
+    leveldb::WriteBatch batched;
+    std::vector<const hyperdex::index*> ptrs;
+    std::vector<const e::slice*> olds;
+    std::vector<const e::slice*> news;
+
+    for (size_t i = 0; i < idxs.size(); ++i)
+    {
+        id.index_changes(&idxs[i], ri, key_ie, key, old_document, new_document, &single);
+        ptrs.push_back(&idxs[i]);
+        olds.push_back(old_document);
+        news.push_back(new_document);
+    }
+
+    id.index_changes(ptrs, ri, key_ie, key, olds, news, &batched);
+    ASSERT_TRUE(recorded(single) == recorded(batched));
+}
+
+std::vector<std::string>
+wildcard_changes(const char* path,
+                 const e::slice* old_document,
+                 const e::slice* new_document)
+{
+    std::vector<const char*> paths(1, path);
+    std::vector<hyperdex::index> idxs;
+    make_indices(paths, &idxs);
+    index_document id;
+    const index_encoding* key_ie = index_encoding::lookup(HYPERDATATYPE_STRING);
+    leveldb::WriteBatch updates;
+    id.index_changes(&idxs[0], region_id(1), key_ie, e::slice("key", 3),
+                     old_document, new_document, &updates);
+    return recorded(updates);
+}
+
+size_t
+count_ops(const std::vector<std::string>& ops, const char* prefix)
+{
+    size_t count = 0;
+
+    for (size_t i = 0; i < ops.size(); ++i)
+    {
+        count += ops[i].compare(0, strlen(prefix), prefix) == 0 ? 1 : 0;
+    }
+
+    return count;
+}
+
+// a document check on "path" whose value is "value"
+attribute_check
+path_check(const std::string& path_and_value, hyperpredicate pred)
+{
+    attribute_check check;
+    check.attr = 1;
+    check.value = e::slice(path_and_value.data(), path_and_value.size());
+    check.datatype = HYPERDATATYPE_STRING;
+    check.predicate = pred;
+    return check;
+}
+
+} // namespace
+
+TEST(IndexDocument, ExtractValues)
+{
+    e::arena memory;
+    e::slice doc = to_server("{\"a\": \"x\", \"b\": {\"c\": 1}, \"n\": 2.5}", &memory);
+    datatype_document dd;
+    std::vector<const char*> paths;
+    paths.push_back("a");
+    paths.push_back("b.c");
+    paths.push_back("missing");
+    paths.push_back("b");
+    std::vector<hyperdatatype> types(paths.size());
+    std::vector<std::vector<char> > scratch;
+    std::vector<e::slice> values(paths.size());
+    ASSERT_TRUE(dd.extract_values(paths, doc, &types, &scratch, &values));
+
+    // one parse must agree with a parse per path
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+        hyperdatatype type = HYPERDATATYPE_GARBAGE;
+        std::vector<char> one_scratch;
+        e::slice value;
+
+        if (dd.extract_value(paths[i], doc, &type, &one_scratch, &value))
+        {
+            ASSERT_EQ(types[i], type);
+            ASSERT_TRUE(values[i] == value);
+        }
+        else
+        {
+            ASSERT_EQ(types[i], HYPERDATATYPE_GARBAGE);
+        }
+    }
+
+    ASSERT_EQ(types[0], HYPERDATATYPE_STRING);
+    ASSERT_EQ(types[2], HYPERDATATYPE_GARBAGE);
+}
+
+TEST(IndexDocument, BatchedMatchesSingle)
+{
+    e::arena memory;
+    e::slice old_doc = to_server("{\"a\": \"x\", \"b\": {\"c\": 1}, \"n\": 5}", &memory);
+    e::slice new_doc = to_server("{\"a\": \"y\", \"b\": {\"c\": 1}, \"n\": \"five\"}", &memory);
+    std::vector<const char*> paths;
+    paths.push_back("a");
+    paths.push_back("b.c");
+    paths.push_back("missing");
+    paths.push_back("n");
+    std::vector<hyperdex::index> idxs;
+    make_indices(paths, &idxs);
+    assert_batched_matches_single(idxs, &old_doc, &new_doc);
+    assert_batched_matches_single(idxs, NULL, &new_doc);
+    assert_batched_matches_single(idxs, &old_doc, NULL);
+    assert_batched_matches_single(idxs, &old_doc, &old_doc);
+}
+
+TEST(IndexDocument, UnchangedPathsWriteNothing)
+{
+    e::arena memory;
+    e::slice old_doc = to_server("{\"a\": \"x\", \"b\": {\"c\": 1}}", &memory);
+    e::slice new_doc = to_server("{\"a\": \"y\", \"b\": {\"c\": 1}}", &memory);
+    std::vector<const char*> paths;
+    paths.push_back("a");
+    paths.push_back("b.c");
+    std::vector<hyperdex::index> idxs;
+    make_indices(paths, &idxs);
+    index_document id;
+    const index_encoding* key_ie = index_encoding::lookup(HYPERDATATYPE_STRING);
+    std::vector<const hyperdex::index*> ptrs;
+    ptrs.push_back(&idxs[0]);
+    ptrs.push_back(&idxs[1]);
+    std::vector<const e::slice*> olds(2, &old_doc);
+    std::vector<const e::slice*> news(2, &new_doc);
+    leveldb::WriteBatch updates;
+    id.index_changes(ptrs, region_id(1), key_ie, e::slice("key", 3), olds, news, &updates);
+    // "a" moves from "x" to "y"; "b.c" stays put
+    std::vector<std::string> ops = recorded(updates);
+    ASSERT_EQ(ops.size(), 2U);
+    ASSERT_EQ(ops[0].substr(0, 4), "del:");
+    ASSERT_EQ(ops[1].substr(0, 4), "put:");
+}
+
+TEST(IndexDocument, WildcardElements)
+{
+    e::arena memory;
+    e::slice old_doc = to_server("{\"tags\": [\"a\", \"b\"]}", &memory);
+    e::slice new_doc = to_server("{\"tags\": [\"b\", \"c\", \"c\"]}", &memory);
+    e::slice flat_doc = to_server("{\"tags\": \"a\"}", &memory);
+    e::slice nested_doc = to_server("{\"items\": [{\"id\": 1}, {\"id\": 2}, {\"x\": 3}]}", &memory);
+
+    // one entry per distinct element
+    std::vector<std::string> ops = wildcard_changes("tags[*]", NULL, &new_doc);
+    ASSERT_EQ(count_ops(ops, "put:"), 2U);
+    ASSERT_EQ(count_ops(ops, "del:"), 0U);
+
+    // only the elements that came or went are touched
+    ops = wildcard_changes("tags[*]", &old_doc, &new_doc);
+    ASSERT_EQ(count_ops(ops, "put:"), 1U);
+    ASSERT_EQ(count_ops(ops, "del:"), 1U);
+
+    ops = wildcard_changes("tags[*]", &new_doc, NULL);
+    ASSERT_EQ(count_ops(ops, "put:"), 0U);
+    ASSERT_EQ(count_ops(ops, "del:"), 2U);
+
+    ops = wildcard_changes("tags[*]", &old_doc, &old_doc);
+    ASSERT_TRUE(ops.empty());
+
+    // a value that is not an array has no elements
+    ops = wildcard_changes("tags[*]", NULL, &flat_doc);
+    ASSERT_TRUE(ops.empty());
+
+    // a wildcard in the middle of a path reaches into each element
+    ops = wildcard_changes("items[*].id", NULL, &nested_doc);
+    ASSERT_EQ(count_ops(ops, "put:"), 2U);
+}
+
+TEST(IndexDocument, ExtractElements)
+{
+    e::arena memory;
+    e::slice doc = to_server("{\"tags\": [\"a\", \"b\", 3]}", &memory);
+    datatype_document dd;
+    std::vector<hyperdatatype> types;
+    std::vector<std::vector<char> > scratch;
+    std::vector<e::slice> values;
+    ASSERT_TRUE(dd.extract_elements("tags[*]", doc, &types, &scratch, &values));
+    ASSERT_EQ(values.size(), 3U);
+    ASSERT_EQ(types.size(), 3U);
+    ASSERT_EQ(types[0], HYPERDATATYPE_STRING);
+    ASSERT_TRUE(values[0] == e::slice("a", 1));
+    ASSERT_EQ(types[1], HYPERDATATYPE_STRING);
+    ASSERT_TRUE(values[1] == e::slice("b", 1));
+    ASSERT_TRUE(datatype_document::is_wildcard_path("tags[*]"));
+    ASSERT_TRUE(datatype_document::is_wildcard_path("items[*].id"));
+    ASSERT_FALSE(datatype_document::is_wildcard_path("tags"));
+}
+
+TEST(IndexDocument, Covers)
+{
+    std::vector<const char*> paths;
+    paths.push_back("a.b");
+    paths.push_back("tags[*]");
+    std::vector<hyperdex::index> idxs;
+    make_indices(paths, &idxs);
+    std::string ab("a.b\x00" "x", 5);
+    std::string tags("tags\x00" "x", 6);
+    std::string unterminated("a.b", 3);
+
+    // equality on a path needs an index on exactly that path
+    ASSERT_TRUE(document_index_covers(idxs[0], path_check(ab, HYPERPREDICATE_EQUALS)));
+    ASSERT_FALSE(document_index_covers(idxs[1], path_check(ab, HYPERPREDICATE_EQUALS)));
+    ASSERT_FALSE(document_index_covers(idxs[1], path_check(tags, HYPERPREDICATE_EQUALS)));
+
+    // CONTAINS is answered by the path's element index
+    ASSERT_TRUE(document_index_covers(idxs[1], path_check(tags, HYPERPREDICATE_CONTAINS)));
+    ASSERT_FALSE(document_index_covers(idxs[0], path_check(ab, HYPERPREDICATE_CONTAINS)));
+
+    // a check without a path covers nothing
+    ASSERT_FALSE(document_index_covers(idxs[0], path_check(unterminated, HYPERPREDICATE_EQUALS)));
+
+    // other index types are not restricted by paths
+    hyperdex::index normal(hyperdex::index::NORMAL, index_id(3), 1, e::slice());
+    ASSERT_TRUE(document_index_covers(normal, path_check(tags, HYPERPREDICATE_CONTAINS)));
+}
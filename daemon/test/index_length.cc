@@ -0,0 +1,252 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <stdint.h>
+#include <stdlib.h>
+
+// POSIX
+#include <unistd.h>
+
+// STL
+#include <set>
+#include <string>
+#include <vector>
+
+// e
+#include <e/endian.h>
+#include <e/intrusive_ptr.h>
+
+// LevelDB
+#include <hyperleveldb/db.h>
+#include <hyperleveldb/write_batch.h>
+
+// HyperDex
+#include "test/th.h"
+#include "common/attribute_check.h"
+#include "common/index.h"
+#include "common/range.h"
+#include "daemon/datalayer_iterator.h"
+#include "daemon/index_length.h"
+
+using hyperdex::attribute_check;
+using hyperdex::datalayer;
+using hyperdex::index_encoding;
+using hyperdex::index_id;
+using hyperdex::index_length;
+using hyperdex::leveldb_db_ptr;
+using hyperdex::leveldb_snapshot_ptr;
+using hyperdex::region_id;
+
+namespace
+{
+
+// objects "k0" through "k9", where the value of "kN" has length N until
+// "k3" is rewritten to length 8
+class length_fixture
+{
+    public:
+        length_fixture();
+        ~length_fixture() throw ();
+
+    public:
+        void write(const std::string& key,
+                   const std::string* old_value,
+                   const std::string* new_value);
+        std::set<std::string> search(hyperpredicate pred, int64_t len);
+        std::set<std::string> expected(hyperpredicate pred, int64_t len);
+
+    public:
+        std::string path;
+        leveldb_db_ptr db;
+        index_length il;
+        hyperdex::index idx;
+        std::vector<std::pair<std::string, std::string> > objects;
+
+    private:
+        length_fixture(const length_fixture&);
+        length_fixture& operator = (const length_fixture&);
+};
+
+length_fixture :: length_fixture()
+    : path()
+    , db()
+    , il(HYPERDATATYPE_STRING)
+    , idx(hyperdex::index::LENGTH, index_id(1), 1, e::slice())
+    , objects()
+{
+    char tmpl[] = "/tmp/hyperdex-index-length-XXXXXX";
+    ASSERT_TRUE(mkdtemp(tmpl) != NULL);
+    path = tmpl;
+    leveldb::Options opts;
+    opts.create_if_missing = true;
+    leveldb::DB* tmp_db = NULL;
+    ASSERT_TRUE(leveldb::DB::Open(opts, path, &tmp_db).ok());
+    db.reset(tmp_db);
+
+    for (size_t i = 0; i < 10; ++i)
+    {
+        std::string key("k");
+        key.push_back('0' + i);
+        objects.push_back(std::make_pair(key, std::string(i, 'x')));
+        write(key, NULL, &objects.back().second);
+    }
+
+    std::string old_value(objects[3].second);
+    objects[3].second = std::string(8, 'y');
+    write(objects[3].first, &old_value, &objects[3].second);
+}
+
+length_fixture :: ~length_fixture() throw ()
+{
+    db.reset();
+    leveldb::DestroyDB(path, leveldb::Options());
+    rmdir(path.c_str());
+}
+
+void
+length_fixture :: write(const std::string& key,
+                        const std::string* old_value,
+                        const std::string* new_value)
+{
+    const index_encoding* key_ie = index_encoding::lookup(HYPERDATATYPE_STRING);
+    e::slice old_slice = old_value ? e::slice(*old_value) : e::slice();
+    e::slice new_slice = new_value ? e::slice(*new_value) : e::slice();
+    leveldb::WriteBatch updates;
+    il.index_changes(&idx, region_id(1), key_ie, e::slice(key),
+                     old_value ? &old_slice : NULL,
+                     new_value ? &new_slice : NULL,
+                     &updates);
+    ASSERT_TRUE(db->Write(leveldb::WriteOptions(), &updates).ok());
+}
+
+attribute_check
+length_check(hyperpredicate pred, const char* len)
+{
+    attribute_check check;
+    check.attr = 1;
+    check.value = e::slice(len, sizeof(int64_t));
+    check.datatype = HYPERDATATYPE_INT64;
+    check.predicate = pred;
+    return check;
+}
+
+std::set<std::string>
+length_fixture :: search(hyperpredicate pred, int64_t len)
+{
+    char buf[sizeof(int64_t)];
+    e::pack64le(static_cast<uint64_t>(len), buf);
+    attribute_check check = length_check(pred, buf);
+    const index_encoding* key_ie = index_encoding::lookup(HYPERDATATYPE_STRING);
+    leveldb_snapshot_ptr snap(db, db->GetSnapshot());
+    datalayer::index_iterator* raw;
+    raw = il.iterator_from_check(snap, region_id(1), idx.id, check, key_ie);
+    std::set<std::string> keys;
+    ASSERT_TRUE(raw != NULL);
+
+    if (!raw)
+    {
+        return keys;
+    }
+
+    e::intrusive_ptr<datalayer::index_iterator> it(raw);
+
+    while (it->valid())
+    {
+        e::slice key = it->key();
+        keys.insert(std::string(key.cdata(), key.size()));
+        it->next();
+    }
+
+    return keys;
+}
+
+std::set<std::string>
+length_fixture :: expected(hyperpredicate pred, int64_t len)
+{
+    char buf[sizeof(int64_t)];
+    e::pack64le(static_cast<uint64_t>(len), buf);
+    attribute_check check = length_check(pred, buf);
+    std::set<std::string> keys;
+
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        if (hyperdex::passes_attribute_check(HYPERDATATYPE_STRING, check, e::slice(objects[i].second)))
+        {
+            keys.insert(objects[i].first);
+        }
+    }
+
+    return keys;
+}
+
+} // namespace
+
+TEST(IndexLength, MatchesChecks)
+{
+    length_fixture f;
+    hyperpredicate preds[] = {HYPERPREDICATE_LENGTH_EQUALS,
+                              HYPERPREDICATE_LENGTH_LESS_EQUAL,
+                              HYPERPREDICATE_LENGTH_GREATER_EQUAL};
+
+    for (size_t p = 0; p < sizeof(preds) / sizeof(hyperpredicate); ++p)
+    {
+        for (int64_t len = 0; len <= 11; ++len)
+        {
+            ASSERT_TRUE(f.search(preds[p], len) == f.expected(preds[p], len));
+        }
+    }
+}
+
+TEST(IndexLength, RewriteMovesEntry)
+{
+    length_fixture f;
+    // "k3" now has length 8, so nothing has length 3 and two objects have 8
+    ASSERT_TRUE(f.search(HYPERPREDICATE_LENGTH_EQUALS, 3).empty());
+    std::set<std::string> eight = f.search(HYPERPREDICATE_LENGTH_EQUALS, 8);
+    ASSERT_EQ(eight.size(), 2U);
+    ASSERT_EQ(eight.count("k3"), 1U);
+    ASSERT_EQ(eight.count("k8"), 1U);
+    // the empty value is indexed too
+    ASSERT_EQ(f.search(HYPERPREDICATE_LENGTH_LESS_EQUAL, 0).size(), 1U);
+    ASSERT_EQ(f.search(HYPERPREDICATE_LENGTH_GREATER_EQUAL, 0).size(), 10U);
+}
+
+TEST(IndexLength, OtherPredicatesUnsupported)
+{
+    length_fixture f;
+    char buf[sizeof(int64_t)];
+    e::pack64le(3, buf);
+    attribute_check check = length_check(HYPERPREDICATE_EQUALS, buf);
+    leveldb_snapshot_ptr snap(f.db, f.db->GetSnapshot());
+    const index_encoding* key_ie = index_encoding::lookup(HYPERDATATYPE_STRING);
+    ASSERT_TRUE(f.il.iterator_from_check(snap, region_id(1), f.idx.id, check, key_ie) == NULL);
+    // ranges are over values, not lengths
+    hyperdex::range r;
+    ASSERT_TRUE(f.il.iterator_from_range(snap, region_id(1), f.idx.id, r, key_ie) == NULL);
+}
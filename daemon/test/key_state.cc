@@ -0,0 +1,113 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <stdint.h>
+
+// e
+#include <e/endian.h>
+#include <e/slice.h>
+
+// HyperDex
+#include "test/th.h"
+#include "common/schema.h"
+#include "daemon/datalayer.h"
+#include "daemon/key_state.h"
+
+using hyperdex::datalayer;
+using hyperdex::key_state;
+using hyperdex::schema;
+
+namespace
+{
+
+const uint64_t SECOND = 1000000ULL;
+
+schema
+ttl_schema()
+{
+    schema sc;
+    sc.ttl_attr = 1;
+    sc.ttl = 3600 * SECOND;
+    return sc;
+}
+
+} // namespace
+
+// A replica whose clock runs two minutes ahead of the point leader's sweeps
+// an object the leader still considers live.  Once the replica drops the
+// key_state, the leader's next write names a version the replica forgot.
+TEST(KeyStateTest, SkewedClocks)
+{
+    const uint64_t leader_now = 100000 * SECOND;
+    const uint64_t replica_now = leader_now + 120 * SECOND;
+    const uint64_t ttl = 3600 * SECOND;
+    char buf[sizeof(int64_t)];
+    e::pack64le(static_cast<int64_t>(leader_now - ttl - 30 * SECOND), buf);
+    e::slice ts(buf, sizeof(int64_t));
+
+    // the leader's visibility check versus the replica's sweep cutoff
+    ASSERT_TRUE(datalayer::has_expired(ts, leader_now - ttl));
+    ASSERT_TRUE(datalayer::has_expired(ts, replica_now - ttl - 60 * SECOND));
+
+    e::pack64le(static_cast<int64_t>(leader_now - ttl + 30 * SECOND), buf);
+    ASSERT_FALSE(datalayer::has_expired(ts, leader_now - ttl));
+    ASSERT_TRUE(datalayer::has_expired(ts, replica_now - ttl - 60 * SECOND));
+
+    // the rebuilt key_state has no value and version zero, so the leader's
+    // non-fresh write of version 8 after version 7 must still be applied
+    ASSERT_TRUE(key_state::follows_swept_object(ttl_schema(), false, 0, false, true, 7));
+}
+
+TEST(KeyStateTest, EvictedKeyStateAcceptsWrite)
+{
+    schema sc(ttl_schema());
+    ASSERT_TRUE(key_state::follows_swept_object(sc, false, 0, false, true, 1));
+    ASSERT_TRUE(key_state::follows_swept_object(sc, false, 0, false, true, 1ULL << 40));
+}
+
+TEST(KeyStateTest, KnownVersionKeepsOrdering)
+{
+    schema sc(ttl_schema());
+    // an object is on disk, or the key_state remembers the swept version:
+    // an out-of-order op waits for its predecessor as before
+    ASSERT_FALSE(key_state::follows_swept_object(sc, true, 0, false, true, 7));
+    ASSERT_FALSE(key_state::follows_swept_object(sc, true, 5, false, true, 7));
+    ASSERT_FALSE(key_state::follows_swept_object(sc, false, 5, false, true, 7));
+}
+
+TEST(KeyStateTest, OnlyNonFreshWritesInTTLSpaces)
+{
+    schema plain;
+    ASSERT_FALSE(key_state::follows_swept_object(plain, false, 0, false, true, 7));
+    schema sc(ttl_schema());
+    // deletes and fresh writes never wait, and version zero has no predecessor
+    ASSERT_FALSE(key_state::follows_swept_object(sc, false, 0, false, false, 7));
+    ASSERT_FALSE(key_state::follows_swept_object(sc, false, 0, true, true, 7));
+    ASSERT_FALSE(key_state::follows_swept_object(sc, false, 0, false, true, 0));
+}
@@ -57,6 +57,8 @@ enum hyperdatatype
     HYPERDATATYPE_STRING    = 9217,
     HYPERDATATYPE_INT64     = 9218,
     HYPERDATATYPE_FLOAT     = 9219,
+    HYPERDATATYPE_HYPERLOGLOG = 9220,
+    HYPERDATATYPE_COUNTMIN  = 9221,
     HYPERDATATYPE_DOCUMENT  = 9223,
 
     /* List types */
@@ -95,6 +97,14 @@ enum hyperdatatype
     HYPERDATATYPE_TIMESTAMP_WEEK     = 9477,
     HYPERDATATYPE_TIMESTAMP_MONTH    = 9478,
 
+    /* Vector types */
+    HYPERDATATYPE_VECTOR_GENERIC     = 9536,
+    HYPERDATATYPE_VECTOR_FLOAT       = 9539,
+
+    /* Bitmap types */
+    HYPERDATATYPE_BITMAP_GENERIC     = 9600,
+    HYPERDATATYPE_BITMAP_INT64       = 9602,
+
     /* Special (internal) types */
     HYPERDATATYPE_MACAROON_SECRET    = 9664,
 
@@ -116,8 +126,9 @@ enum hyperpredicate
     HYPERPREDICATE_LENGTH_EQUALS        = 9734,
     HYPERPREDICATE_LENGTH_LESS_EQUAL    = 9735,
     HYPERPREDICATE_LENGTH_GREATER_EQUAL = 9736,
-    HYPERPREDICATE_CONTAINS      = 9737
-    /* NEXT = 9740 */
+    HYPERPREDICATE_CONTAINS      = 9737,
+    HYPERPREDICATE_STARTS_WITH   = 9740
+    /* NEXT = 9741 */
 };
 
 #ifdef __cplusplus
@@ -189,6 +189,19 @@ hyperdex_admin_enable_perf_counters(struct hyperdex_admin* admin,
 void
 hyperdex_admin_disable_perf_counters(struct hyperdex_admin* admin);
 
+/* An index holding only the objects that pass every check; the checks are
+ * built as for client searches (see hyperdex/client.h) and may only compare
+ * primitive attributes */
+struct hyperdex_client_attribute_check;
+
+int64_t
+hyperdex_admin_add_partial_index(struct hyperdex_admin* admin,
+                                 const char* space,
+                                 const char* attribute,
+                                 const struct hyperdex_client_attribute_check* checks,
+                                 size_t checks_sz,
+                                 enum hyperdex_admin_returncode* status);
+
 int64_t
 hyperdex_admin_loop(struct hyperdex_admin* admin, int timeout,
                     enum hyperdex_admin_returncode* status);
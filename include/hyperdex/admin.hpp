@@ -82,6 +82,11 @@ class Admin
         int64_t add_index(const char* space, const char* attr,
                           enum hyperdex_admin_returncode* status)
             { return hyperdex_admin_add_index(m_adm, space, attr, status); }
+        int64_t add_partial_index(const char* space, const char* attr,
+                                  const struct hyperdex_client_attribute_check* checks,
+                                  size_t checks_sz,
+                                  enum hyperdex_admin_returncode* status)
+            { return hyperdex_admin_add_partial_index(m_adm, space, attr, checks, checks_sz, status); }
         int64_t rm_index(uint64_t idxid, enum hyperdex_admin_returncode* status)
             { return hyperdex_admin_rm_index(m_adm, idxid, status); }
         int64_t server_register(uint64_t token, const char* address,
@@ -106,6 +106,28 @@ enum hyperdex_client_returncode
 };
 
 #define HYPERDEX_ATTRIBUTE_SECRET "__secret"
+#define HYPERDEX_ATTRIBUTE_WRITTEN "__written"
+
+/* Where the client sends GET and GET_PARTIAL operations */
+enum hyperdex_client_read_policy
+{
+    /* the point leader (head) of the key's chain */
+    HYPERDEX_CLIENT_READ_POINT_LEADER = 0,
+    /* the tail of the key's chain; consistent with the point leader */
+    HYPERDEX_CLIENT_READ_TAIL         = 1,
+    /* any replica in the key's chain; a replica with writes in flight for
+     * the key redirects the read to the tail */
+    HYPERDEX_CLIENT_READ_ANY_REPLICA  = 2
+};
+
+/* How hyperdex_client_nearest_search measures distance between vectors */
+enum hyperdex_client_distance
+{
+    /* euclidean distance */
+    HYPERDEX_CLIENT_DISTANCE_L2     = 0,
+    /* one minus the cosine similarity */
+    HYPERDEX_CLIENT_DISTANCE_COSINE = 1
+};
 
 struct hyperdex_client*
 hyperdex_client_create(const char* coordinator, uint16_t port);
@@ -742,6 +764,29 @@ hyperdex_client_group_set_union(struct hyperdex_client* client,
                                 enum hyperdex_client_returncode* status,
                                 uint64_t* count);
 
+int64_t
+hyperdex_client_set_difference(struct hyperdex_client* client,
+                               const char* space,
+                               const char* key, size_t key_sz,
+                               const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                               enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_cond_set_difference(struct hyperdex_client* client,
+                                    const char* space,
+                                    const char* key, size_t key_sz,
+                                    const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                    const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                    enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_set_difference(struct hyperdex_client* client,
+                                     const char* space,
+                                     const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                     enum hyperdex_client_returncode* status,
+                                     uint64_t* count);
+
 int64_t
 hyperdex_client_document_rename(struct hyperdex_client* client,
                                 const char* space,
@@ -798,6 +843,52 @@ hyperdex_client_group_document_unset(struct hyperdex_client* client,
                                      enum hyperdex_client_returncode* status,
                                      uint64_t* count);
 
+int64_t
+hyperdex_client_sketch_add(struct hyperdex_client* client,
+                           const char* space,
+                           const char* key, size_t key_sz,
+                           const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                           enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_cond_sketch_add(struct hyperdex_client* client,
+                                const char* space,
+                                const char* key, size_t key_sz,
+                                const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_sketch_add(struct hyperdex_client* client,
+                                 const char* space,
+                                 const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 enum hyperdex_client_returncode* status,
+                                 uint64_t* count);
+
+int64_t
+hyperdex_client_sketch_merge(struct hyperdex_client* client,
+                             const char* space,
+                             const char* key, size_t key_sz,
+                             const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                             enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_cond_sketch_merge(struct hyperdex_client* client,
+                                  const char* space,
+                                  const char* key, size_t key_sz,
+                                  const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                  const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                  enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_sketch_merge(struct hyperdex_client* client,
+                                   const char* space,
+                                   const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                   const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                   enum hyperdex_client_returncode* status,
+                                   uint64_t* count);
+
 int64_t
 hyperdex_client_map_add(struct hyperdex_client* client,
                         const char* space,
@@ -1161,6 +1252,33 @@ hyperdex_client_count(struct hyperdex_client* client,
                       enum hyperdex_client_returncode* status,
                       uint64_t* count);
 
+int64_t
+hyperdex_client_get_many(struct hyperdex_client* client,
+                         const char* space,
+                         const char** keys, const size_t* keys_sz, size_t keys_num,
+                         enum hyperdex_client_returncode* status,
+                         enum hyperdex_client_returncode* statuses,
+                         const struct hyperdex_client_attribute** attrs, size_t* attrs_sz);
+
+int64_t
+hyperdex_client_put_many(struct hyperdex_client* client,
+                         const char* space,
+                         const char** keys, const size_t* keys_sz, size_t keys_num,
+                         const struct hyperdex_client_attribute** attrs, const size_t* attrs_sz,
+                         enum hyperdex_client_returncode* status,
+                         enum hyperdex_client_returncode* statuses);
+
+int64_t
+hyperdex_client_nearest_search(struct hyperdex_client* client,
+                               const char* space,
+                               const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                               const char* attr,
+                               const float* vector, size_t vector_sz,
+                               enum hyperdex_client_distance distance,
+                               uint64_t limit,
+                               enum hyperdex_client_returncode* status,
+                               const struct hyperdex_client_attribute** attrs, size_t* attrs_sz);
+
 int64_t
 hyperdex_client_loop(struct hyperdex_client* client, int timeout,
                      enum hyperdex_client_returncode* status);
@@ -1171,6 +1289,10 @@ hyperdex_client_poll_fd(struct hyperdex_client* client);
 int
 hyperdex_client_block(struct hyperdex_client* client, int timeout);
 
+void
+hyperdex_client_set_read_policy(struct hyperdex_client* client,
+                                enum hyperdex_client_read_policy policy);
+
 enum hyperdatatype
 hyperdex_client_attribute_type(struct hyperdex_client* client,
                                const char* space, const char* name,
@@ -454,6 +454,23 @@ class Client
                                 hyperdex_client_returncode* status,
                                 uint64_t* count)
             { return hyperdex_client_group_set_union(m_cl, space, checks, checks_sz, attrs, attrs_sz, status, count); }
+        int64_t set_difference(const char* space,
+                               const char* key, size_t key_sz,
+                               const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                               hyperdex_client_returncode* status)
+            { return hyperdex_client_set_difference(m_cl, space, key, key_sz, attrs, attrs_sz, status); }
+        int64_t cond_set_difference(const char* space,
+                                    const char* key, size_t key_sz,
+                                    const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                    const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                    hyperdex_client_returncode* status)
+            { return hyperdex_client_cond_set_difference(m_cl, space, key, key_sz, checks, checks_sz, attrs, attrs_sz, status); }
+        int64_t group_set_difference(const char* space,
+                                     const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                     hyperdex_client_returncode* status,
+                                     uint64_t* count)
+            { return hyperdex_client_group_set_difference(m_cl, space, checks, checks_sz, attrs, attrs_sz, status, count); }
         int64_t document_rename(const char* space,
                                 const char* key, size_t key_sz,
                                 const hyperdex_client_attribute* attrs, size_t attrs_sz,
@@ -488,6 +505,40 @@ class Client
                                      hyperdex_client_returncode* status,
                                      uint64_t* count)
             { return hyperdex_client_group_document_unset(m_cl, space, checks, checks_sz, attrs, attrs_sz, status, count); }
+        int64_t sketch_add(const char* space,
+                           const char* key, size_t key_sz,
+                           const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                           hyperdex_client_returncode* status)
+            { return hyperdex_client_sketch_add(m_cl, space, key, key_sz, attrs, attrs_sz, status); }
+        int64_t cond_sketch_add(const char* space,
+                                const char* key, size_t key_sz,
+                                const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                hyperdex_client_returncode* status)
+            { return hyperdex_client_cond_sketch_add(m_cl, space, key, key_sz, checks, checks_sz, attrs, attrs_sz, status); }
+        int64_t group_sketch_add(const char* space,
+                                 const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 hyperdex_client_returncode* status,
+                                 uint64_t* count)
+            { return hyperdex_client_group_sketch_add(m_cl, space, checks, checks_sz, attrs, attrs_sz, status, count); }
+        int64_t sketch_merge(const char* space,
+                             const char* key, size_t key_sz,
+                             const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                             hyperdex_client_returncode* status)
+            { return hyperdex_client_sketch_merge(m_cl, space, key, key_sz, attrs, attrs_sz, status); }
+        int64_t cond_sketch_merge(const char* space,
+                                  const char* key, size_t key_sz,
+                                  const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                  const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                  hyperdex_client_returncode* status)
+            { return hyperdex_client_cond_sketch_merge(m_cl, space, key, key_sz, checks, checks_sz, attrs, attrs_sz, status); }
+        int64_t group_sketch_merge(const char* space,
+                                   const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                   const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                   hyperdex_client_returncode* status,
+                                   uint64_t* count)
+            { return hyperdex_client_group_sketch_merge(m_cl, space, checks, checks_sz, attrs, attrs_sz, status, count); }
         int64_t map_add(const char* space,
                         const char* key, size_t key_sz,
                         const hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
@@ -750,6 +801,29 @@ class Client
                       uint64_t* count)
             { return hyperdex_client_count(m_cl, space, checks, checks_sz, status, count); }
 
+    public:
+        int64_t get_many(const char* space,
+                         const char** keys, const size_t* keys_sz, size_t keys_num,
+                         hyperdex_client_returncode* status,
+                         hyperdex_client_returncode* statuses,
+                         const hyperdex_client_attribute** attrs, size_t* attrs_sz)
+            { return hyperdex_client_get_many(m_cl, space, keys, keys_sz, keys_num, status, statuses, attrs, attrs_sz); }
+        int64_t put_many(const char* space,
+                         const char** keys, const size_t* keys_sz, size_t keys_num,
+                         const hyperdex_client_attribute** attrs, const size_t* attrs_sz,
+                         hyperdex_client_returncode* status,
+                         hyperdex_client_returncode* statuses)
+            { return hyperdex_client_put_many(m_cl, space, keys, keys_sz, keys_num, attrs, attrs_sz, status, statuses); }
+        int64_t nearest_search(const char* space,
+                               const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                               const char* attr,
+                               const float* vector, size_t vector_sz,
+                               hyperdex_client_distance distance,
+                               uint64_t limit,
+                               hyperdex_client_returncode* status,
+                               const hyperdex_client_attribute** attrs, size_t* attrs_sz)
+            { return hyperdex_client_nearest_search(m_cl, space, checks, checks_sz, attr, vector, vector_sz, distance, limit, status, attrs, attrs_sz); }
+
     public:
         void clear_auth_context()
             { return hyperdex_client_clear_auth_context(m_cl); }
@@ -763,6 +837,8 @@ class Client
             { return hyperdex_client_poll_fd(m_cl); }
         int block(int timeout)
             { return hyperdex_client_block(m_cl, timeout); }
+        void set_read_policy(hyperdex_client_read_policy policy)
+            { hyperdex_client_set_read_policy(m_cl, policy); }
         std::string error_message()
             { return hyperdex_client_error_message(m_cl); }
         std::string error_location()
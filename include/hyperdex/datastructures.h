@@ -93,6 +93,13 @@ hyperdex_ds_pack_float(double num, char* buf);
 int
 hyperdex_ds_unpack_float(const char* buf, size_t buf_sz, double* num);
 
+/* estimate how often "elem" (a string, or an int/float packed as above) was
+ * added to a countmin sketch */
+int
+hyperdex_ds_countmin_estimate(const char* sketch, size_t sketch_sz,
+                              const char* elem, size_t elem_sz,
+                              uint64_t* count);
+
 /* copy strings/ints/floats */
 int
 hyperdex_ds_copy_string(struct hyperdex_ds_arena* arena,
@@ -99,6 +99,14 @@ hyperspace_set_number_of_partitions(struct hyperspace* space, uint64_t num);
 enum hyperspace_returncode
 hyperspace_use_authorization(struct hyperspace* space);
 
+enum hyperspace_returncode
+hyperspace_use_parallel_subspaces(struct hyperspace* space);
+
+/* expire objects "seconds" after the timestamp in "attr", or after they were
+ * last written if "attr" is NULL */
+enum hyperspace_returncode
+hyperspace_set_ttl(struct hyperspace* space, const char* attr, uint64_t seconds);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif /* __cplusplus */
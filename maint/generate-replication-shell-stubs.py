@@ -11,6 +11,7 @@ run "${{HYPERDEX_BUILDDIR}}"/test/replication-stress-test -n {daemons} -h 127.0.
 SIMPLE = "space replication key int A attributes int B, int C subspace B subspace C"
 REVERSE = "space replication key int A attributes int B, int C subspace C subspace B"
 COMPOSITE = "space replication key int A attributes int B, int C subspace B, C"
+PARALLEL = "space replication key int A attributes int B, int C subspace B subspace C with parallel subspaces"
 
 configs = [("simple", SIMPLE, 1, 0),
            ("simple", SIMPLE, 4, 0),
@@ -24,6 +25,10 @@ configs = [("simple", SIMPLE, 1, 0),
            ("composite", COMPOSITE, 4, 0),
            ("composite", COMPOSITE, 4, 1),
            ("composite", COMPOSITE, 4, 2),
+           ("parallel", PARALLEL, 1, 0),
+           ("parallel", PARALLEL, 4, 0),
+           ("parallel", PARALLEL, 4, 1),
+           ("parallel", PARALLEL, 4, 2),
            ]
 
 for name, space, daemons, ft in configs:
@@ -0,0 +1,183 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// Compare HYPERPREDICATE_CONTAINS on sets and maps with the linear walk it
+// replaced.  Half of the needles are present and half are absent.
+
+// C
+#include <cstdio>
+#include <cstdlib>
+
+// STL
+#include <vector>
+
+// po6
+#include <po6/time.h>
+
+// e
+#include <e/endian.h>
+#include <e/popt.h>
+
+// HyperDex
+#include "common/datatype_info.h"
+
+using hyperdex::datatype_info;
+
+static long _iterations = 100000;
+
+// the linear walk over every element
+static bool
+baseline_contains(const datatype_info* k,
+                  const datatype_info* v,
+                  const e::slice& container,
+                  const e::slice& needle)
+{
+    const uint8_t* ptr = container.data();
+    const uint8_t* end = container.data() + container.size();
+    e::slice key;
+    e::slice val;
+
+    while (ptr < end && k->step(&ptr, end, &key) &&
+           (!v || v->step(&ptr, end, &val)))
+    {
+        if (key == needle)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void
+encode(const datatype_info* di, int64_t x, std::vector<uint8_t>* out)
+{
+    std::vector<uint8_t> tmp(sizeof(int64_t));
+    e::pack64le(x, &tmp[0]);
+    e::slice s(&tmp[0], tmp.size());
+    char buf[32];
+
+    if (di->datatype() == HYPERDATATYPE_STRING)
+    {
+        int sz = snprintf(buf, sizeof(buf), "tag-%012lld", static_cast<long long>(x));
+        s = e::slice(buf, sz);
+    }
+
+    size_t off = out->size();
+    out->resize(off + di->write_sz(s));
+    di->write(s, &(*out)[off]);
+}
+
+static void
+run(const char* name, hyperdatatype container, hyperdatatype k, hyperdatatype v, size_t n)
+{
+    const datatype_info* di = datatype_info::lookup(container);
+    const datatype_info* ki = datatype_info::lookup(k);
+    const datatype_info* vi = v == HYPERDATATYPE_GARBAGE ? NULL : datatype_info::lookup(v);
+    std::vector<uint8_t> encoded;
+
+    // even numbers are present
+    for (size_t i = 0; i < n; ++i)
+    {
+        encode(ki, 2 * i, &encoded);
+
+        if (vi)
+        {
+            encode(vi, i, &encoded);
+        }
+    }
+
+    // the needles are sampled across the range
+    std::vector<std::vector<uint8_t> > needles(64);
+
+    for (size_t i = 0; i < needles.size(); ++i)
+    {
+        encode(ki, (2 * n * i) / needles.size() + (i & 1), &needles[i]);
+    }
+
+    e::slice c(&encoded[0], encoded.size());
+    uint64_t found = 0;
+    uint64_t start = po6::monotonic_time();
+
+    for (long i = 0; i < _iterations; ++i)
+    {
+        const std::vector<uint8_t>& nd(needles[i % needles.size()]);
+        found += di->contains(c, e::slice(&nd[0], nd.size())) ? 1 : 0;
+    }
+
+    uint64_t fast = po6::monotonic_time() - start;
+    start = po6::monotonic_time();
+
+    for (long i = 0; i < _iterations; ++i)
+    {
+        const std::vector<uint8_t>& nd(needles[i % needles.size()]);
+        found -= baseline_contains(ki, vi, c, e::slice(&nd[0], nd.size())) ? 1 : 0;
+    }
+
+    uint64_t baseline = po6::monotonic_time() - start;
+
+    if (found != 0)
+    {
+        fprintf(stderr, "%s: results differ from the linear walk\n", name);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%-20s %10lu %14.1f %14.1f\n", name, static_cast<unsigned long>(n),
+           static_cast<double>(fast) / _iterations,
+           static_cast<double>(baseline) / _iterations);
+}
+
+int
+main(int argc, const char* argv[])
+{
+    e::argparser ap;
+    ap.autohelp();
+    ap.arg().name('n', "iterations")
+            .description("number of lookups to time per size (default: 100000)")
+            .metavar("N").as_long(&_iterations);
+
+    if (!ap.parse(argc, argv))
+    {
+        return EXIT_FAILURE;
+    }
+
+    const size_t sizes[] = {10, 100, 1000, 10000, 100000};
+    printf("%-20s %10s %14s %14s\n", "container", "elements", "ns/lookup", "linear ns/lookup");
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        run("set(int64)", HYPERDATATYPE_SET_INT64,
+            HYPERDATATYPE_INT64, HYPERDATATYPE_GARBAGE, sizes[s]);
+        run("set(string)", HYPERDATATYPE_SET_STRING,
+            HYPERDATATYPE_STRING, HYPERDATATYPE_GARBAGE, sizes[s]);
+        run("map(int64,int64)", HYPERDATATYPE_MAP_INT64_INT64,
+            HYPERDATATYPE_INT64, HYPERDATATYPE_INT64, sizes[s]);
+    }
+
+    return EXIT_SUCCESS;
+}
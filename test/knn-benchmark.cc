@@ -0,0 +1,218 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// Time a brute-force k-nearest-neighbor scan over packed float vectors, the
+// work a server does per object for a nearest_search.  The datatype's
+// kernels are compared with a plain scalar loop over the same data.
+
+#define __STDC_LIMIT_MACROS
+
+// C
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+
+// STL
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// po6
+#include <po6/time.h>
+
+// e
+#include <e/endian.h>
+#include <e/popt.h>
+
+// HyperDex
+#include "common/datatype_vector.h"
+
+using hyperdex::datatype_vector;
+
+static long _vectors = 100000;
+static long _dimension = 128;
+static long _k = 10;
+
+static double
+baseline_distance(datatype_vector::metric_t m, const float* a, const float* b, size_t n)
+{
+    double ab = 0;
+    double aa = 0;
+    double bb = 0;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (m == datatype_vector::L2)
+        {
+            double d = a[i] - b[i];
+            ab += d * d;
+        }
+        else
+        {
+            ab += a[i] * b[i];
+            aa += a[i] * a[i];
+            bb += b[i] * b[i];
+        }
+    }
+
+    if (m == datatype_vector::L2)
+    {
+        return ab;
+    }
+
+    return aa == 0 || bb == 0 ? 1 : 1 - ab / sqrt(aa * bb);
+}
+
+// the server's loop:  unpack each stored value, then keep the k nearest
+static uint64_t
+scan(datatype_vector::metric_t m, bool baseline,
+     const std::vector<e::slice>& values,
+     const std::vector<float>& query,
+     std::vector<std::pair<double, size_t> >* top)
+{
+    std::vector<float> candidate;
+    top->clear();
+    uint64_t start = po6::monotonic_time();
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        datatype_vector::unpack(values[i], &candidate);
+        double d = baseline
+                 ? baseline_distance(m, &query[0], &candidate[0], query.size())
+                 : datatype_vector::distance(m, &query[0], &candidate[0], query.size());
+
+        if (top->size() >= static_cast<size_t>(_k) &&
+            (top->empty() || !(d < top->front().first)))
+        {
+            continue;
+        }
+
+        top->push_back(std::make_pair(d, i));
+        std::push_heap(top->begin(), top->end());
+
+        if (top->size() > static_cast<size_t>(_k))
+        {
+            std::pop_heap(top->begin(), top->end());
+            top->pop_back();
+        }
+    }
+
+    uint64_t elapsed = po6::monotonic_time() - start;
+    std::sort(top->begin(), top->end());
+    return elapsed;
+}
+
+static void
+run(const char* name, datatype_vector::metric_t m,
+    const std::vector<e::slice>& values,
+    const std::vector<float>& query)
+{
+    std::vector<std::pair<double, size_t> > fast;
+    std::vector<std::pair<double, size_t> > slow;
+    uint64_t fast_ns = scan(m, false, values, query, &fast);
+    uint64_t slow_ns = scan(m, true, values, query, &slow);
+
+    for (size_t i = 0; i < fast.size() && i < slow.size(); ++i)
+    {
+        if (fast[i].second != slow[i].second &&
+            fabs(fast[i].first - slow[i].first) > 1e-4)
+        {
+            fprintf(stderr, "%s: neighbor %lu differs from the baseline\n",
+                    name, static_cast<unsigned long>(i));
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    printf("%-8s %10lu %6ld %14.1f %14.1f\n", name,
+           static_cast<unsigned long>(values.size()), _dimension,
+           static_cast<double>(fast_ns) / values.size(),
+           static_cast<double>(slow_ns) / values.size());
+}
+
+int
+main(int argc, const char* argv[])
+{
+    e::argparser ap;
+    ap.autohelp();
+    ap.arg().name('n', "vectors")
+            .description("number of stored vectors (default: 100000)")
+            .metavar("N").as_long(&_vectors);
+    ap.arg().name('d', "dimension")
+            .description("dimension of each vector (default: 128)")
+            .metavar("D").as_long(&_dimension);
+    ap.arg().name('k', "neighbors")
+            .description("number of nearest neighbors to keep (default: 10)")
+            .metavar("K").as_long(&_k);
+
+    if (!ap.parse(argc, argv))
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (_vectors <= 0 || _dimension <= 0 || _k <= 0)
+    {
+        fprintf(stderr, "vectors, dimension, and neighbors must be positive\n");
+        return EXIT_FAILURE;
+    }
+
+    // one contiguous arena of little-endian floats, sliced per object
+    const size_t stride = _dimension * sizeof(float);
+    std::vector<uint8_t> storage(_vectors * stride);
+    std::vector<e::slice> values;
+    values.reserve(_vectors);
+    srand(0xdeadbeef);
+
+    for (long i = 0; i < _vectors; ++i)
+    {
+        uint8_t* ptr = &storage[i * stride];
+
+        for (long j = 0; j < _dimension; ++j)
+        {
+            float f = static_cast<float>(rand()) / RAND_MAX - 0.5f;
+            uint32_t bits;
+            memmove(&bits, &f, sizeof(bits));
+            ptr = e::pack32le(bits, ptr);
+        }
+
+        values.push_back(e::slice(&storage[i * stride], stride));
+    }
+
+    std::vector<float> query(_dimension);
+
+    for (long j = 0; j < _dimension; ++j)
+    {
+        query[j] = static_cast<float>(rand()) / RAND_MAX - 0.5f;
+    }
+
+    printf("%-8s %10s %6s %14s %14s\n", "metric", "vectors", "dim", "ns/vector", "baseline ns/vector");
+    run("l2", datatype_vector::L2, values, query);
+    run("cosine", datatype_vector::COSINE, values, query);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,127 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// Time FUNC_LIST_RPUSH and FUNC_LIST_LPUSH against lists of increasing size.
+// Each push should cost time proportional to copying the list, with no
+// allocation per element.
+
+// C
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// STL
+#include <vector>
+
+// po6
+#include <po6/time.h>
+
+// e
+#include <e/arena.h>
+#include <e/popt.h>
+
+// HyperDex
+#include "common/datatype_info.h"
+#include "common/funcall.h"
+
+using hyperdex::datatype_info;
+using hyperdex::funcall;
+
+static long _iterations = 1000;
+
+static double
+time_push(const datatype_info* list, const e::slice& old_value, const funcall& func)
+{
+    uint64_t start = po6::monotonic_time();
+
+    for (long i = 0; i < _iterations; ++i)
+    {
+        e::arena memory;
+        e::slice new_value;
+        list->apply(old_value, &func, 1, &memory, &new_value);
+    }
+
+    uint64_t end = po6::monotonic_time();
+    return static_cast<double>(end - start) / _iterations;
+}
+
+int
+main(int argc, const char* argv[])
+{
+    e::argparser ap;
+    ap.autohelp();
+    ap.arg().name('n', "iterations")
+            .description("number of pushes to time per list size (default: 1000)")
+            .metavar("N").as_long(&_iterations);
+
+    if (!ap.parse(argc, argv))
+    {
+        return EXIT_FAILURE;
+    }
+
+    const datatype_info* list = datatype_info::lookup(HYPERDATATYPE_LIST_STRING);
+    const datatype_info* elem = datatype_info::lookup(HYPERDATATYPE_STRING);
+    const char* pushed = "a newly pushed element";
+    funcall rpush;
+    rpush.attr = 1;
+    rpush.name = hyperdex::FUNC_LIST_RPUSH;
+    rpush.arg1 = e::slice(pushed, strlen(pushed));
+    rpush.arg1_datatype = HYPERDATATYPE_STRING;
+    funcall lpush(rpush);
+    lpush.name = hyperdex::FUNC_LIST_LPUSH;
+    const size_t sizes[] = {10, 100, 1000, 10000, 100000};
+    printf("%10s %16s %16s\n", "elements", "rpush ns/op", "lpush ns/op");
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        std::vector<uint8_t> encoded;
+        char buf[32];
+
+        for (size_t i = 0; i < sizes[s]; ++i)
+        {
+            int sz = snprintf(buf, sizeof(buf), "element-%08lu", static_cast<unsigned long>(i));
+            e::slice e(buf, sz);
+            size_t off = encoded.size();
+            encoded.resize(off + elem->write_sz(e));
+            elem->write(e, &encoded[off]);
+        }
+
+        e::slice old_value;
+
+        if (!encoded.empty())
+        {
+            old_value = e::slice(&encoded[0], encoded.size());
+        }
+
+        double r = time_push(list, old_value, rpush);
+        double l = time_push(list, old_value, lpush);
+        printf("%10lu %16.1f %16.1f\n", static_cast<unsigned long>(sizes[s]), r, l);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,300 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// Write batches with put_many and read every key back.  The keys of a batch
+// hash to every point leader in the space, so each batch is split into one
+// REQ_MULTI_ATOMIC per point leader and the per-key results are reassembled
+// at the caller's indices.
+
+// This code does 0 endianness conversion because it should be run on exactly
+// one host.
+
+// C
+#include <cstdlib>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Popt
+#include <popt.h>
+
+// C++
+#include <iostream>
+
+// STL
+#include <string>
+#include <vector>
+
+// e
+#include <e/guard.h>
+
+// HyperDex
+#include <hyperdex/client.hpp>
+
+static long batch = 1000;
+static long rounds = 16;
+static const char* space = "putmany";
+static const char* host = "127.0.0.1";
+static long port = 1982;
+
+extern "C"
+{
+
+static struct poptOption popts[] = {
+    POPT_AUTOHELP
+    {"batch-size", 'b', POPT_ARG_LONG, &batch, 'b',
+        "the number of keys written by each put_many",
+        "keys"},
+    {"rounds", 'r', POPT_ARG_LONG, &rounds, 'r',
+        "the number of batches to write",
+        "number"},
+    {"space", 's', POPT_ARG_STRING, &space, 's',
+        "the HyperDex space to use",
+        "space"},
+    {"host", 'h', POPT_ARG_STRING, &host, 'h',
+        "the IP address of the coordinator",
+        "IP"},
+    {"port", 'p', POPT_ARG_LONG, &port, 'p',
+        "the port number of the coordinator",
+        "port"},
+    POPT_TABLEEND
+};
+
+} // extern "C"
+
+static std::string
+key_for(long r, long i)
+{
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%ld:%ld", r, i);
+    return std::string(buf);
+}
+
+static bool
+wait_for(hyperdex::Client* cl, int64_t id, hyperdex_client_returncode* lstatus)
+{
+    int64_t lid = cl->loop(-1, lstatus);
+
+    if (lid < 0)
+    {
+        std::cerr << "loop failed: " << *lstatus << std::endl;
+        return false;
+    }
+
+    if (lid != id)
+    {
+        std::cerr << "loop returned " << lid << " while waiting for " << id << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+static bool
+write_round(hyperdex::Client* cl, long r)
+{
+    std::vector<std::string> keys(batch);
+    std::vector<const char*> key_ptrs(batch);
+    std::vector<size_t> keys_sz(batch);
+    std::vector<int64_t> values(batch);
+    std::vector<hyperdex_client_attribute> attrs(batch);
+    std::vector<const hyperdex_client_attribute*> attr_ptrs(batch);
+    std::vector<size_t> attrs_sz(batch, 1);
+    std::vector<hyperdex_client_returncode> statuses(batch, HYPERDEX_CLIENT_GARBAGE);
+
+    for (long i = 0; i < batch; ++i)
+    {
+        keys[i] = key_for(r, i);
+        key_ptrs[i] = keys[i].data();
+        keys_sz[i] = keys[i].size();
+        values[i] = r * batch + i;
+        attrs[i].attr = "v";
+        attrs[i].value = reinterpret_cast<const char*>(&values[i]);
+        attrs[i].value_sz = sizeof(int64_t);
+        attrs[i].datatype = HYPERDATATYPE_INT64;
+        attr_ptrs[i] = &attrs[i];
+    }
+
+    hyperdex_client_returncode status;
+    int64_t id = cl->put_many(space, &key_ptrs[0], &keys_sz[0], batch,
+                              &attr_ptrs[0], &attrs_sz[0],
+                              &status, &statuses[0]);
+
+    if (id < 0)
+    {
+        std::cerr << "put_many failed: " << status << std::endl;
+        return false;
+    }
+
+    hyperdex_client_returncode lstatus;
+
+    if (!wait_for(cl, id, &lstatus))
+    {
+        return false;
+    }
+
+    if (status != HYPERDEX_CLIENT_SUCCESS)
+    {
+        std::cerr << "put_many of round " << r << " returned " << status << std::endl;
+        return false;
+    }
+
+    for (long i = 0; i < batch; ++i)
+    {
+        if (statuses[i] != HYPERDEX_CLIENT_SUCCESS)
+        {
+            std::cerr << "put of " << keys[i] << " returned " << statuses[i] << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool
+check_round(hyperdex::Client* cl, long r)
+{
+    for (long i = 0; i < batch; ++i)
+    {
+        std::string key(key_for(r, i));
+        hyperdex_client_returncode status;
+        const hyperdex_client_attribute* attrs = NULL;
+        size_t attrs_sz = 0;
+        int64_t id = cl->get(space, key.data(), key.size(), &status, &attrs, &attrs_sz);
+
+        if (id < 0)
+        {
+            std::cerr << "get failed: " << status << std::endl;
+            return false;
+        }
+
+        hyperdex_client_returncode lstatus;
+
+        if (!wait_for(cl, id, &lstatus))
+        {
+            return false;
+        }
+
+        e::guard g = e::makeguard(hyperdex_client_destroy_attrs, attrs, attrs_sz);
+        g.use_variable();
+        int64_t value = 0;
+
+        if (status != HYPERDEX_CLIENT_SUCCESS ||
+            attrs_sz != 1 || attrs[0].value_sz != sizeof(int64_t))
+        {
+            std::cerr << "get of " << key << " returned " << status << std::endl;
+            return false;
+        }
+
+        memcpy(&value, attrs[0].value, sizeof(int64_t));
+
+        if (value != r * batch + i)
+        {
+            std::cerr << key << " holds " << value << " instead of "
+                      << r * batch + i << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int
+main(int argc, const char* argv[])
+{
+    poptContext poptcon;
+    poptcon = poptGetContext(NULL, argc, argv, popts, POPT_CONTEXT_POSIXMEHARDER);
+    e::guard g = e::makeguard(poptFreeContext, poptcon);
+    g.use_variable();
+    int rc;
+
+    while ((rc = poptGetNextOpt(poptcon)) != -1)
+    {
+        switch (rc)
+        {
+            case 'b':
+                if (batch <= 0)
+                {
+                    std::cerr << "batch-size must be > 0" << std::endl;
+                    return EXIT_FAILURE;
+                }
+
+                break;
+            case 'r':
+                if (rounds < 0)
+                {
+                    std::cerr << "rounds must be >= 0" << std::endl;
+                    return EXIT_FAILURE;
+                }
+
+                break;
+            case 's':
+            case 'h':
+                break;
+            case 'p':
+                if (port >= (1 << 16))
+                {
+                    std::cerr << "port number out of range for TCP" << std::endl;
+                    return EXIT_FAILURE;
+                }
+
+                break;
+            case POPT_ERROR_NOARG:
+            case POPT_ERROR_BADOPT:
+            case POPT_ERROR_BADNUMBER:
+            case POPT_ERROR_OVERFLOW:
+                std::cerr << poptStrerror(rc) << " " << poptBadOption(poptcon, 0) << std::endl;
+                return EXIT_FAILURE;
+            case POPT_ERROR_OPTSTOODEEP:
+            case POPT_ERROR_BADQUOTE:
+            case POPT_ERROR_ERRNO:
+            default:
+                std::cerr << "logic error in argument parsing" << std::endl;
+                return EXIT_FAILURE;
+        }
+    }
+
+    try
+    {
+        hyperdex::Client cl(host, port);
+
+        for (long r = 0; r < rounds; ++r)
+        {
+            if (!write_round(&cl, r) || !check_round(&cl, r))
+            {
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
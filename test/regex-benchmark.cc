@@ -0,0 +1,229 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// Compare the regex automaton with the recursive backtracking matcher it
+// replaced.  Each pattern runs against texts of growing length; the
+// pathological ones are only timed on the baseline while it stays tractable.
+
+#define __STDC_LIMIT_MACROS
+
+// C
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+
+// STL
+#include <string>
+
+// po6
+#include <po6/time.h>
+
+// e
+#include <e/popt.h>
+
+// HyperDex
+#include "common/regex_match.h"
+
+using hyperdex::regex_dfa;
+
+static long _iterations = 1000;
+
+// the recursive matcher, kept here as the baseline
+static bool
+baseline_anchored(const char* regex, const char* regex_end,
+                  const char* text,  const char* text_end);
+
+static bool
+baseline_starred(int c,
+                 const char* regex, const char* regex_end,
+                 const char* text,  const char* text_end)
+{
+    for (; text <= text_end; ++text)
+    {
+        if (baseline_anchored(regex, regex_end, text, text_end))
+        {
+            return true;
+        }
+
+        if (text < text_end && *text != c && c != '.')
+        {
+            break;
+        }
+    }
+
+    return false;
+}
+
+static bool
+baseline_anchored(const char* regex, const char* regex_end,
+                  const char* text,  const char* text_end)
+{
+    if (regex == regex_end)
+    {
+        return true;
+    }
+
+    if (regex[0] == '\\')
+    {
+        if (regex + 1 < regex_end &&
+            text < text_end &&
+            regex[1] == text[0])
+        {
+            return baseline_anchored(regex + 2, regex_end, text + 1, text_end);
+        }
+
+        return false;
+    }
+
+    if (regex + 1 < regex_end && regex[1] == '*')
+    {
+        return baseline_starred(regex[0], regex + 2, regex_end, text, text_end);
+    }
+
+    if (regex[0] == '$' && regex + 1 == regex_end)
+    {
+        return text == text_end;
+    }
+
+    if (text < text_end && (regex[0] == '.' || regex[0] == text[0]))
+    {
+        return baseline_anchored(regex + 1, regex_end, text + 1, text_end);
+    }
+
+    return false;
+}
+
+static bool
+baseline_match(const std::string& regex, const std::string& text)
+{
+    const char* r = regex.data();
+    const char* r_end = r + regex.size();
+    const char* t = text.data();
+    const char* t_end = t + text.size();
+
+    if (regex.empty())
+    {
+        return true;
+    }
+
+    if (r[0] == '^')
+    {
+        return baseline_anchored(r + 1, r_end, t, t_end);
+    }
+
+    for (; t <= t_end; ++t)
+    {
+        if (baseline_anchored(r, r_end, t, t_end))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void
+run(const char* regex, size_t text_sz, size_t baseline_limit)
+{
+    // the text almost matches, so neither matcher can stop early
+    std::string text(text_sz, 'a');
+    std::string pattern(regex);
+    const uint8_t* t = reinterpret_cast<const uint8_t*>(text.data());
+    regex_dfa dfa(reinterpret_cast<const uint8_t*>(pattern.data()), pattern.size());
+    bool expected = dfa.match(t, text.size());
+    uint64_t start = po6::monotonic_time();
+
+    for (long i = 0; i < _iterations; ++i)
+    {
+        if (dfa.match(t, text.size()) != expected)
+        {
+            abort();
+        }
+    }
+
+    uint64_t automaton = po6::monotonic_time() - start;
+    double baseline = -1;
+
+    if (text_sz <= baseline_limit)
+    {
+        start = po6::monotonic_time();
+
+        for (long i = 0; i < _iterations; ++i)
+        {
+            if (baseline_match(pattern, text) != expected)
+            {
+                fprintf(stderr, "%s: results differ from the baseline\n", regex);
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        baseline = static_cast<double>(po6::monotonic_time() - start) / _iterations;
+    }
+
+    printf("%-24s %10lu %14.1f ", regex, static_cast<unsigned long>(text_sz),
+           static_cast<double>(automaton) / _iterations);
+
+    if (baseline >= 0)
+    {
+        printf("%14.1f\n", baseline);
+    }
+    else
+    {
+        printf("%14s\n", "-");
+    }
+}
+
+int
+main(int argc, const char* argv[])
+{
+    e::argparser ap;
+    ap.autohelp();
+    ap.arg().name('n', "iterations")
+            .description("number of matches to time per text (default: 1000)")
+            .metavar("N").as_long(&_iterations);
+
+    if (!ap.parse(argc, argv))
+    {
+        return EXIT_FAILURE;
+    }
+
+    const size_t sizes[] = {16, 256, 4096, 65536};
+    printf("%-24s %10s %14s %14s\n", "pattern", "text", "ns/match", "baseline ns/match");
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        run("^aaaa", sizes[s], SIZE_MAX);
+        run("ab", sizes[s], SIZE_MAX);
+        run("^a*b$", sizes[s], SIZE_MAX);
+        run(".*a.*a.*b", sizes[s], 16);
+        run("^.*a.*a.*a.*b", sizes[s], 16);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,170 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// Compare the per-object evaluation of a full scan's checks with the blocked
+// evaluation used when a search reads objects directly.  Each object has an
+// int64 and a float attribute, and the search is a range on the first plus a
+// lower bound on the second.  Both paths run over the same decoded
+// attributes, so this times the predicate evaluation alone.
+
+// C
+#include <cstdio>
+#include <cstdlib>
+
+// STL
+#include <algorithm>
+#include <vector>
+
+// po6
+#include <po6/time.h>
+
+// e
+#include <e/endian.h>
+#include <e/popt.h>
+
+// HyperDex
+#include "common/attribute_check.h"
+#include "common/compiled_check.h"
+
+using hyperdex::attribute_check;
+using hyperdex::compiled_check;
+
+static long _objects = 10000000;
+static long _block = 1024;
+
+int
+main(int argc, const char* argv[])
+{
+    e::argparser ap;
+    ap.autohelp();
+    ap.arg().name('n', "objects")
+            .description("number of objects in the region (default: 10000000)")
+            .metavar("N").as_long(&_objects);
+    ap.arg().name('b', "block")
+            .description("objects filtered per block (default: 1024)")
+            .metavar("B").as_long(&_block);
+
+    if (!ap.parse(argc, argv) || _objects <= 0 || _block <= 0)
+    {
+        return EXIT_FAILURE;
+    }
+
+    const size_t n = _objects;
+    std::vector<char> ints(n * sizeof(int64_t));
+    std::vector<char> floats(n * sizeof(double));
+    std::vector<e::slice> col_i(n);
+    std::vector<e::slice> col_f(n);
+    srand(0x5eed);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        e::pack64le(static_cast<int64_t>(rand() % 1000), &ints[i * sizeof(int64_t)]);
+        e::packdoublele(static_cast<double>(rand() % 1000) / 10., &floats[i * sizeof(double)]);
+        col_i[i] = e::slice(&ints[i * sizeof(int64_t)], sizeof(int64_t));
+        col_f[i] = e::slice(&floats[i * sizeof(double)], sizeof(double));
+    }
+
+    // 250 <= a < 350 && b >= 50.0
+    char lo[sizeof(int64_t)];
+    char hi[sizeof(int64_t)];
+    char fl[sizeof(double)];
+    e::pack64le(250, lo);
+    e::pack64le(350, hi);
+    e::packdoublele(50., fl);
+    attribute_check checks[3];
+    checks[0].attr = 1;
+    checks[0].value = e::slice(lo, sizeof(lo));
+    checks[0].datatype = HYPERDATATYPE_INT64;
+    checks[0].predicate = HYPERPREDICATE_GREATER_EQUAL;
+    checks[1].attr = 1;
+    checks[1].value = e::slice(hi, sizeof(hi));
+    checks[1].datatype = HYPERDATATYPE_INT64;
+    checks[1].predicate = HYPERPREDICATE_LESS_THAN;
+    checks[2].attr = 2;
+    checks[2].value = e::slice(fl, sizeof(fl));
+    checks[2].datatype = HYPERDATATYPE_FLOAT;
+    checks[2].predicate = HYPERPREDICATE_GREATER_EQUAL;
+    compiled_check compiled[3];
+    compiled[0].compile(HYPERDATATYPE_INT64, checks[0]);
+    compiled[1].compile(HYPERDATATYPE_INT64, checks[1]);
+    compiled[2].compile(HYPERDATATYPE_FLOAT, checks[2]);
+
+    // per object, the way search_iterator evaluates an index-driven search
+    uint64_t matched_object = 0;
+    uint64_t start = po6::monotonic_time();
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (compiled[0].passes(col_i[i]) &&
+            compiled[1].passes(col_i[i]) &&
+            compiled[2].passes(col_f[i]))
+        {
+            ++matched_object;
+        }
+    }
+
+    uint64_t per_object = po6::monotonic_time() - start;
+
+    // per block, the way search_iterator evaluates a full scan
+    std::vector<uint8_t> mask(_block);
+    uint64_t matched_block = 0;
+    start = po6::monotonic_time();
+
+    for (size_t off = 0; off < n; off += _block)
+    {
+        size_t sz = std::min(n - off, static_cast<size_t>(_block));
+        mask.assign(sz, 1);
+        compiled[0].filter(&col_i[off], sz, &mask[0]);
+        compiled[1].filter(&col_i[off], sz, &mask[0]);
+        compiled[2].filter(&col_f[off], sz, &mask[0]);
+
+        for (size_t i = 0; i < sz; ++i)
+        {
+            matched_block += mask[i];
+        }
+    }
+
+    uint64_t per_block = po6::monotonic_time() - start;
+
+    if (matched_object != matched_block)
+    {
+        fprintf(stderr, "blocked evaluation matched %lu objects, not %lu\n",
+                static_cast<unsigned long>(matched_block),
+                static_cast<unsigned long>(matched_object));
+        return EXIT_FAILURE;
+    }
+
+    printf("%-12s %12s %12s %12s\n", "path", "objects", "matched", "ns/object");
+    printf("%-12s %12lu %12lu %12.2f\n", "per-object",
+           static_cast<unsigned long>(n), static_cast<unsigned long>(matched_object),
+           static_cast<double>(per_object) / n);
+    printf("%-12s %12lu %12lu %12.2f\n", "batched",
+           static_cast<unsigned long>(n), static_cast<unsigned long>(matched_block),
+           static_cast<double>(per_block) / n);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,299 @@
+// Copyright (c) 2014, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// Compare the sorted-merge kernels behind set and map funcalls to the
+// approach they replaced:  decode into a std::set/std::map, mutate, re-encode.
+
+// C
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// STL
+#include <map>
+#include <set>
+#include <vector>
+
+// po6
+#include <po6/time.h>
+
+// e
+#include <e/arena.h>
+#include <e/endian.h>
+#include <e/popt.h>
+
+// HyperDex
+#include "common/datatype_info.h"
+#include "common/funcall.h"
+
+using hyperdex::datatype_info;
+using hyperdex::funcall;
+
+static long _iterations = 1000;
+
+// the std::set implementation of FUNC_SET_ADD
+static void
+baseline_set_add(const datatype_info* elem,
+                 const e::slice& old_value,
+                 const funcall& func,
+                 e::arena* new_memory,
+                 e::slice* new_value)
+{
+    typedef std::set<e::slice, datatype_info::compares_less> set_t;
+    set_t set(elem->compare_less());
+    const uint8_t* ptr = old_value.data();
+    const uint8_t* end = old_value.data() + old_value.size();
+    e::slice x;
+
+    while (ptr < end && elem->step(&ptr, end, &x))
+    {
+        set.insert(x);
+    }
+
+    set.insert(func.arg1);
+    size_t sz = 0;
+
+    for (set_t::iterator i = set.begin(); i != set.end(); ++i)
+    {
+        sz += elem->write_sz(*i);
+    }
+
+    uint8_t* write_to = NULL;
+    new_memory->allocate(sz, &write_to);
+    *new_value = e::slice(write_to, sz);
+
+    for (set_t::iterator i = set.begin(); i != set.end(); ++i)
+    {
+        write_to = elem->write(*i, write_to);
+    }
+}
+
+// the std::map implementation of FUNC_MAP_ADD
+static void
+baseline_map_add(const datatype_info* k,
+                 const datatype_info* v,
+                 const e::slice& old_value,
+                 const funcall& func,
+                 e::arena* new_memory,
+                 e::slice* new_value)
+{
+    typedef std::map<e::slice, e::slice, datatype_info::compares_less> map_t;
+    map_t map(k->compare_less());
+    const uint8_t* ptr = old_value.data();
+    const uint8_t* end = old_value.data() + old_value.size();
+    e::slice key;
+    e::slice val;
+
+    while (ptr < end && k->step(&ptr, end, &key) && v->step(&ptr, end, &val))
+    {
+        map.insert(std::make_pair(key, val));
+    }
+
+    map[func.arg2] = func.arg1;
+    size_t sz = 0;
+
+    for (map_t::iterator i = map.begin(); i != map.end(); ++i)
+    {
+        sz += k->write_sz(i->first) + v->write_sz(i->second);
+    }
+
+    uint8_t* write_to = NULL;
+    new_memory->allocate(sz, &write_to);
+    *new_value = e::slice(write_to, sz);
+
+    for (map_t::iterator i = map.begin(); i != map.end(); ++i)
+    {
+        write_to = k->write(i->first, write_to);
+        write_to = v->write(i->second, write_to);
+    }
+}
+
+static void
+encode_int(int64_t x, std::vector<uint8_t>* out)
+{
+    size_t off = out->size();
+    out->resize(off + sizeof(int64_t));
+    e::pack64le(x, &(*out)[off]);
+}
+
+static void
+encode_string(const datatype_info* str, int64_t x, std::vector<uint8_t>* out)
+{
+    char buf[32];
+    int sz = snprintf(buf, sizeof(buf), "element-%012lld", static_cast<long long>(x));
+    e::slice s(buf, sz);
+    size_t off = out->size();
+    out->resize(off + str->write_sz(s));
+    str->write(s, &(*out)[off]);
+}
+
+static e::slice
+as_slice(const std::vector<uint8_t>& v)
+{
+    return v.empty() ? e::slice() : e::slice(&v[0], v.size());
+}
+
+static void
+report(const char* name, size_t n, uint64_t merge, uint64_t baseline)
+{
+    printf("%-24s %10lu %14.1f %14.1f\n", name, static_cast<unsigned long>(n),
+           static_cast<double>(merge) / _iterations,
+           static_cast<double>(baseline) / _iterations);
+}
+
+int
+main(int argc, const char* argv[])
+{
+    e::argparser ap;
+    ap.autohelp();
+    ap.arg().name('n', "iterations")
+            .description("number of operations to time per size (default: 1000)")
+            .metavar("N").as_long(&_iterations);
+
+    if (!ap.parse(argc, argv))
+    {
+        return EXIT_FAILURE;
+    }
+
+    const datatype_info* i64 = datatype_info::lookup(HYPERDATATYPE_INT64);
+    const datatype_info* str = datatype_info::lookup(HYPERDATATYPE_STRING);
+    const datatype_info* set_i64 = datatype_info::lookup(HYPERDATATYPE_SET_INT64);
+    const datatype_info* set_str = datatype_info::lookup(HYPERDATATYPE_SET_STRING);
+    const datatype_info* map_str_i64 = datatype_info::lookup(HYPERDATATYPE_MAP_STRING_INT64);
+    const size_t sizes[] = {10, 100, 1000, 10000, 100000};
+    printf("%-24s %10s %14s %14s\n", "operation", "elements", "merge ns/op", "std ns/op");
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        const size_t n = sizes[s];
+        // even numbers are present; the odd one in the middle gets added
+        std::vector<uint8_t> ints;
+        std::vector<uint8_t> strs;
+        std::vector<uint8_t> map;
+        std::vector<uint8_t> new_int;
+        std::vector<uint8_t> new_str;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            encode_int(2 * i, &ints);
+            encode_string(str, 2 * i, &strs);
+            encode_string(str, 2 * i, &map);
+            encode_int(i, &map);
+        }
+
+        encode_int(n | 1, &new_int);
+        char buf[32];
+        int sz = snprintf(buf, sizeof(buf), "element-%012lld", static_cast<long long>(n | 1));
+        funcall f;
+        f.attr = 1;
+        uint64_t start;
+        uint64_t merge;
+        uint64_t baseline;
+
+        // set(int64) add
+        f.name = hyperdex::FUNC_SET_ADD;
+        f.arg1 = as_slice(new_int);
+        f.arg1_datatype = HYPERDATATYPE_INT64;
+        start = po6::monotonic_time();
+
+        for (long i = 0; i < _iterations; ++i)
+        {
+            e::arena a;
+            e::slice out;
+            set_i64->apply(as_slice(ints), &f, 1, &a, &out);
+        }
+
+        merge = po6::monotonic_time() - start;
+        start = po6::monotonic_time();
+
+        for (long i = 0; i < _iterations; ++i)
+        {
+            e::arena a;
+            e::slice out;
+            baseline_set_add(i64, as_slice(ints), f, &a, &out);
+        }
+
+        baseline = po6::monotonic_time() - start;
+        report("set(int64) add", n, merge, baseline);
+
+        // set(string) add
+        f.arg1 = e::slice(buf, sz);
+        f.arg1_datatype = HYPERDATATYPE_STRING;
+        start = po6::monotonic_time();
+
+        for (long i = 0; i < _iterations; ++i)
+        {
+            e::arena a;
+            e::slice out;
+            set_str->apply(as_slice(strs), &f, 1, &a, &out);
+        }
+
+        merge = po6::monotonic_time() - start;
+        start = po6::monotonic_time();
+
+        for (long i = 0; i < _iterations; ++i)
+        {
+            e::arena a;
+            e::slice out;
+            baseline_set_add(str, as_slice(strs), f, &a, &out);
+        }
+
+        baseline = po6::monotonic_time() - start;
+        report("set(string) add", n, merge, baseline);
+
+        // map(string, int64) add
+        f.name = hyperdex::FUNC_MAP_ADD;
+        f.arg1 = as_slice(new_int);
+        f.arg1_datatype = HYPERDATATYPE_INT64;
+        f.arg2 = e::slice(buf, sz);
+        f.arg2_datatype = HYPERDATATYPE_STRING;
+        start = po6::monotonic_time();
+
+        for (long i = 0; i < _iterations; ++i)
+        {
+            e::arena a;
+            e::slice out;
+            map_str_i64->apply(as_slice(map), &f, 1, &a, &out);
+        }
+
+        merge = po6::monotonic_time() - start;
+        start = po6::monotonic_time();
+
+        for (long i = 0; i < _iterations; ++i)
+        {
+            e::arena a;
+            e::slice out;
+            baseline_map_add(str, i64, as_slice(map), f, &a, &out);
+        }
+
+        baseline = po6::monotonic_time() - start;
+        report("map(string,int64) add", n, merge, baseline);
+    }
+
+    return EXIT_SUCCESS;
+}